@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <iostream>
+#include <cxxtools/cache.h>
+#include <cxxtools/lrucache.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/arg.h>
+
+// Measures the time for random lookups in full caches of different sizes.
+// With the default index the time per operation grows logarithmic with the
+// size of the cache, with the hashed index it stays about constant.
+
+template <typename CacheType>
+void run(const char* name, unsigned maxElements, unsigned ops)
+{
+  CacheType cache(maxElements);
+  for (unsigned n = 0; n < maxElements; ++n)
+    cache.put(n, n);
+
+  cxxtools::Clock clock;
+  clock.start();
+
+  unsigned key = 1;
+  for (unsigned n = 0; n < ops; ++n)
+  {
+    key = key * 1103515245 + 12345;
+    unsigned k = (key >> 8) % (maxElements * 2);
+    if (!cache.getptr(k))
+      cache.put(k, n);
+  }
+
+  cxxtools::Timespan t = clock.stop();
+
+  std::cout << name << ' ' << maxElements << " elements: "
+            << ops << " operations in " << t.totalMSecs() << " ms; hits "
+            << cache.getHits() << " misses " << cache.getMisses() << std::endl;
+}
+
+template <typename CacheType>
+void runAll(const char* name, unsigned ops)
+{
+  for (unsigned maxElements = 1000; maxElements <= 1000000; maxElements *= 10)
+    run<CacheType>(name, maxElements, ops);
+}
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    // -n <ops> sets the number of operations per run
+    cxxtools::Arg<unsigned> ops(argc, argv, 'n', 1000000);
+
+    runAll<cxxtools::Cache<unsigned, unsigned> >("Cache", ops);
+    runAll<cxxtools::LruCache<unsigned, unsigned> >("LruCache", ops);
+
+#if __cplusplus >= 201103L
+    runAll<cxxtools::Cache<unsigned, unsigned, cxxtools::HashedCacheIndex<unsigned> > >("Cache(hashed)", ops);
+    runAll<cxxtools::LruCache<unsigned, unsigned, cxxtools::HashedCacheIndex<unsigned> > >("LruCache(hashed)", ops);
+#endif
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+  }
+}
@@ -31,7 +31,10 @@
 
 #include <cxxtools/config.h>
 
-#if defined(CXXTOOLS_ATOMICITY_SUN)
+#if defined(CXXTOOLS_ATOMICITY_STDCXX)
+    #include <cxxtools/atomicity.stdcxx.h>
+
+#elif defined(CXXTOOLS_ATOMICITY_SUN)
     #include <cxxtools/atomicity.sun.h>
 
 #elif defined(CXXTOOLS_ATOMICITY_WINDOWS)
@@ -181,6 +184,31 @@ atomic_t atomicExchange(volatile atomic_t& val, atomic_t exch);
 */
 void* atomicExchange(void* volatile& dest, void* exch);
 
+/** @brief Increases a reference count by one as an atomic operation
+
+    Returns the resulting incremented value. Unlike atomicIncrement no
+    memory ordering is guaranteed, which is not needed for taking another
+    reference to an object.
+*/
+atomic_t atomicRefIncrement(volatile atomic_t& val);
+
+/** @brief Decreases a reference count by one as an atomic operation
+
+    Returns the resulting decremented value. All memory accesses of the
+    thread happen before the count is decremented and, when the result is
+    0, all accesses of other owners are visible, so that the object may be
+    destroyed.
+*/
+atomic_t atomicRefDecrement(volatile atomic_t& val);
+
+#if !defined(CXXTOOLS_ATOMICITY_STDCXX)
+inline atomic_t atomicRefIncrement(volatile atomic_t& val)
+{ return atomicIncrement(val); }
+
+inline atomic_t atomicRefDecrement(volatile atomic_t& val)
+{ return atomicDecrement(val); }
+#endif
+
 }
 
 #endif
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_ATOMICITY_STDCXX_H
+#define CXXTOOLS_ATOMICITY_STDCXX_H
+
+#include <unistd.h>
+
+namespace cxxtools {
+
+typedef ssize_t atomic_t;
+
+} // namespace cxxtools
+
+// With C++11 the operations are implemented inline using std::atomic.
+// Otherwise the library provides them as functions.
+#if __cplusplus >= 201103L
+
+#include <atomic>
+
+#ifndef CXXTOOLS_ATOMICITY_STDCXX_INLINE
+#define CXXTOOLS_ATOMICITY_STDCXX_INLINE inline
+#endif
+
+namespace cxxtools {
+
+static_assert(sizeof(std::atomic<atomic_t>) == sizeof(atomic_t)
+           && alignof(std::atomic<atomic_t>) == alignof(atomic_t),
+    "std::atomic<atomic_t> must have the layout of atomic_t");
+
+static_assert(sizeof(std::atomic<void*>) == sizeof(void*)
+           && alignof(std::atomic<void*>) == alignof(void*),
+    "std::atomic<void*> must have the layout of void*");
+
+inline volatile std::atomic<atomic_t>& atomicCast(volatile atomic_t& val)
+{ return reinterpret_cast<volatile std::atomic<atomic_t>&>(val); }
+
+inline volatile std::atomic<void*>& atomicCast(void* volatile& ptr)
+{ return reinterpret_cast<volatile std::atomic<void*>&>(ptr); }
+
+CXXTOOLS_ATOMICITY_STDCXX_INLINE atomic_t atomicGet(volatile atomic_t& val)
+{ return atomicCast(val).load(std::memory_order_seq_cst); }
+
+CXXTOOLS_ATOMICITY_STDCXX_INLINE void atomicSet(volatile atomic_t& val, atomic_t n)
+{ atomicCast(val).store(n, std::memory_order_seq_cst); }
+
+CXXTOOLS_ATOMICITY_STDCXX_INLINE atomic_t atomicIncrement(volatile atomic_t& val)
+{ return atomicCast(val).fetch_add(1, std::memory_order_acq_rel) + 1; }
+
+CXXTOOLS_ATOMICITY_STDCXX_INLINE atomic_t atomicDecrement(volatile atomic_t& val)
+{ return atomicCast(val).fetch_sub(1, std::memory_order_acq_rel) - 1; }
+
+CXXTOOLS_ATOMICITY_STDCXX_INLINE atomic_t atomicExchangeAdd(volatile atomic_t& val, atomic_t add)
+{ return atomicCast(val).fetch_add(add, std::memory_order_acq_rel); }
+
+CXXTOOLS_ATOMICITY_STDCXX_INLINE atomic_t atomicCompareExchange(volatile atomic_t& val, atomic_t exch, atomic_t comp)
+{
+    atomicCast(val).compare_exchange_strong(comp, exch, std::memory_order_acq_rel, std::memory_order_acquire);
+    return comp;
+}
+
+CXXTOOLS_ATOMICITY_STDCXX_INLINE void* atomicCompareExchange(void* volatile& ptr, void* exch, void* comp)
+{
+    atomicCast(ptr).compare_exchange_strong(comp, exch, std::memory_order_acq_rel, std::memory_order_acquire);
+    return comp;
+}
+
+CXXTOOLS_ATOMICITY_STDCXX_INLINE atomic_t atomicExchange(volatile atomic_t& val, atomic_t exch)
+{ return atomicCast(val).exchange(exch, std::memory_order_acq_rel); }
+
+CXXTOOLS_ATOMICITY_STDCXX_INLINE void* atomicExchange(void* volatile& dest, void* exch)
+{ return atomicCast(dest).exchange(exch, std::memory_order_acq_rel); }
+
+CXXTOOLS_ATOMICITY_STDCXX_INLINE atomic_t atomicRefIncrement(volatile atomic_t& val)
+{ return atomicCast(val).fetch_add(1, std::memory_order_relaxed) + 1; }
+
+CXXTOOLS_ATOMICITY_STDCXX_INLINE atomic_t atomicRefDecrement(volatile atomic_t& val)
+{ return atomicCast(val).fetch_sub(1, std::memory_order_acq_rel) - 1; }
+
+} // namespace cxxtools
+
+#endif
+
+#endif
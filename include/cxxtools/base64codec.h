@@ -98,22 +98,21 @@ class Base64Codec : public TextCodec<char, char>
               std::string data = cxxtools::Base64Codec::decode(base64dataptr, base64datasize);
             @endcode
          */
-        static std::string decode(const char* data, unsigned size)
-        { return cxxtools::decode<Base64Codec>(data, size); }
+        static std::string decode(const char* data, unsigned size);
+
         /** @brief shortcut for converting base64 encoded std::string to std::string
          */
         static std::string decode(const std::string& data)
-        { return cxxtools::decode<Base64Codec>(data); }
+        { return decode(data.data(), data.size()); }
 
         /** @brief shortcut for converting data to base64 encoded std::string
          */
-        static std::string encode(const char* data, unsigned size)
-        { return cxxtools::encode<Base64Codec>(data, size); }
+        static std::string encode(const char* data, unsigned size);
 
         /** @brief shortcut for converting std::string to base64 encoded std::string
          */
         static std::string encode(const std::string& data)
-        { return cxxtools::encode<Base64Codec>(data); }
+        { return encode(data.data(), data.size()); }
 };
 
 
@@ -0,0 +1,290 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_BIN_REMOTESTREAM_H
+#define CXXTOOLS_BIN_REMOTESTREAM_H
+
+#include <cxxtools/bin/rpcclient.h>
+#include <cxxtools/remoteprocedure.h>
+#include <cxxtools/remoteexception.h>
+#include <cxxtools/composer.h>
+#include <cxxtools/decomposer.h>
+#include <cxxtools/signal.h>
+#include <cxxtools/void.h>
+
+namespace cxxtools
+{
+namespace bin
+{
+
+/// Interface of a remote procedure, which receives its result element by element.
+class IRemoteStream : public IRemoteProcedure
+{
+    public:
+        IRemoteStream(RpcClient& client, const String& name)
+            : IRemoteProcedure(client, name),
+              _paused(false)
+        { }
+
+        /// Called, when an element is received.
+        virtual void onElement() = 0;
+
+        bool paused() const
+        { return _paused; }
+
+    protected:
+        bool _paused;
+};
+
+/**
+ * Calls a remote procedure returning a ResultStream<T> and receives the elements one by one.
+
+   The server sends the elements as soon as the procedure generates them.
+   Each element is signaled through the signal `element`. When the last
+   element is received, the signal `finished` is sent. Procedures, which
+   return a container instead of a stream can be called the same way.
+
+   In asynchronous mode the consumer can stop the stream with pause() when it
+   can't keep up with it. No more input is read until resume() is called.
+   The server then blocks, when the socket buffers are full, so that memory
+   usage is bounded on both sides. When the stream is paused longer than the
+   write timeout of the server (see RpcServer::writeTimeout), the server
+   closes the connection and the stream fails.
+
+   @code
+   cxxtools::bin::RpcClient client(loop, "", 7002);
+   cxxtools::bin::RemoteStream<std::string, std::string> lines(client, "readLines");
+   cxxtools::connect(lines.element, processLine);
+   lines.begin("/var/log/messages");
+   lines.end();
+   @endcode
+
+   The arguments are passed to begin() and call(); only the overload matching
+   the number of arguments of the procedure should be used.
+ */
+template <typename T,
+          typename A1 = cxxtools::Void,
+          typename A2 = cxxtools::Void,
+          typename A3 = cxxtools::Void,
+          typename A4 = cxxtools::Void,
+          typename A5 = cxxtools::Void>
+class RemoteStream : public IRemoteStream
+{
+    public:
+        RemoteStream(RpcClient& client, const String& name)
+            : IRemoteStream(client, name),
+              _client(&client),
+              _rc(0),
+              _failed(false)
+        { }
+
+        RemoteStream(RpcClient& client, const char* name)
+            : IRemoteStream(client, String(name)),
+              _client(&client),
+              _rc(0),
+              _failed(false)
+        { }
+
+        /// Sent for each received element.
+        Signal<const T&> element;
+
+        /// Sent, when the stream is finished or failed.
+        Signal<RemoteStream&> finished;
+
+        void begin()
+        { start(0, 0); }
+
+        void begin(const A1& a1)
+        {
+            _a1.begin(a1);
+            IDecomposer* argv[1] = { &_a1 };
+            start(argv, 1);
+        }
+
+        void begin(const A1& a1, const A2& a2)
+        {
+            _a1.begin(a1);
+            _a2.begin(a2);
+            IDecomposer* argv[2] = { &_a1, &_a2 };
+            start(argv, 2);
+        }
+
+        void begin(const A1& a1, const A2& a2, const A3& a3)
+        {
+            _a1.begin(a1);
+            _a2.begin(a2);
+            _a3.begin(a3);
+            IDecomposer* argv[3] = { &_a1, &_a2, &_a3 };
+            start(argv, 3);
+        }
+
+        void begin(const A1& a1, const A2& a2, const A3& a3, const A4& a4)
+        {
+            _a1.begin(a1);
+            _a2.begin(a2);
+            _a3.begin(a3);
+            _a4.begin(a4);
+            IDecomposer* argv[4] = { &_a1, &_a2, &_a3, &_a4 };
+            start(argv, 4);
+        }
+
+        void begin(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5)
+        {
+            _a1.begin(a1);
+            _a2.begin(a2);
+            _a3.begin(a3);
+            _a4.begin(a4);
+            _a5.begin(a5);
+            IDecomposer* argv[5] = { &_a1, &_a2, &_a3, &_a4, &_a5 };
+            start(argv, 5);
+        }
+
+        /// Calls the procedure synchronously. The elements are signaled
+        /// before the method returns.
+        void call()
+        { run(0, 0); }
+
+        void call(const A1& a1)
+        {
+            _a1.begin(a1);
+            IDecomposer* argv[1] = { &_a1 };
+            run(argv, 1);
+        }
+
+        void call(const A1& a1, const A2& a2)
+        {
+            _a1.begin(a1);
+            _a2.begin(a2);
+            IDecomposer* argv[2] = { &_a1, &_a2 };
+            run(argv, 2);
+        }
+
+        void call(const A1& a1, const A2& a2, const A3& a3)
+        {
+            _a1.begin(a1);
+            _a2.begin(a2);
+            _a3.begin(a3);
+            IDecomposer* argv[3] = { &_a1, &_a2, &_a3 };
+            run(argv, 3);
+        }
+
+        void call(const A1& a1, const A2& a2, const A3& a3, const A4& a4)
+        {
+            _a1.begin(a1);
+            _a2.begin(a2);
+            _a3.begin(a3);
+            _a4.begin(a4);
+            IDecomposer* argv[4] = { &_a1, &_a2, &_a3, &_a4 };
+            run(argv, 4);
+        }
+
+        void call(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5)
+        {
+            _a1.begin(a1);
+            _a2.begin(a2);
+            _a3.begin(a3);
+            _a4.begin(a4);
+            _a5.begin(a5);
+            IDecomposer* argv[5] = { &_a1, &_a2, &_a3, &_a4, &_a5 };
+            run(argv, 5);
+        }
+
+        /// Waits until the stream started with begin() is finished. Throws
+        /// the exception, which terminated the stream if any.
+        void end(Milliseconds msecs = RemoteClient::WaitInfinite)
+        {
+            _client->wait(msecs);
+            _client->endCall();
+            if (_failed)
+                throw RemoteException(_msg, _rc);
+        }
+
+        /// Stops reading elements until resume() is called.
+        void pause()
+        { _paused = true; }
+
+        /// Continues reading elements. Pending elements may be signaled
+        /// before the method returns.
+        void resume()
+        {
+            _paused = false;
+            _client->resumeStream();
+        }
+
+        virtual void setFault(int rc, const std::string& msg)
+        {
+            _rc = rc;
+            _msg = msg;
+            _failed = true;
+        }
+
+        virtual bool failed() const
+        { return _failed; }
+
+        virtual void onElement()
+        { element.send(_value); }
+
+    protected:
+        virtual void onFinished()
+        { finished.send(*this); }
+
+    private:
+        void start(IDecomposer** argv, unsigned argc)
+        {
+            _failed = false;
+            _paused = false;
+            _r.begin(_value);
+            _client->beginStream(_r, *this, argv, argc);
+        }
+
+        void run(IDecomposer** argv, unsigned argc)
+        {
+            _failed = false;
+            _r.begin(_value);
+            _client->callStream(_r, *this, argv, argc);
+            _client->endCall();
+        }
+
+        RpcClient* _client;
+        T _value;
+        Composer<T> _r;
+        Decomposer<A1> _a1;
+        Decomposer<A2> _a2;
+        Decomposer<A3> _a3;
+        Decomposer<A4> _a4;
+        Decomposer<A5> _a5;
+
+        int _rc;
+        std::string _msg;
+        bool _failed;
+};
+
+}
+}
+
+#endif // CXXTOOLS_BIN_REMOTESTREAM_H
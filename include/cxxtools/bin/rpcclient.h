@@ -30,6 +30,8 @@
 #define CXXTOOLS_BIN_CLIENT_H
 
 #include <cxxtools/remoteclient.h>
+#include <cxxtools/decomposer.h>
+#include <cxxtools/string.h>
 #include <string>
 
 namespace cxxtools
@@ -49,6 +51,7 @@ namespace bin
 {
 
 class RpcClientImpl;
+class IRemoteStream;
 
 class RpcClient : public RemoteClient
 {
@@ -104,6 +107,92 @@ class RpcClient : public RemoteClient
 
         void call(IComposer& r, IRemoteProcedure& method, IDecomposer** argv, unsigned argc);
 
+        /// Starts a call, which receives the result element by element.
+        /// Used by RemoteStream.
+        void beginStream(IComposer& element, IRemoteStream& stream, IDecomposer** argv, unsigned argc);
+
+        /// Calls a procedure and receives the result element by element.
+        /// Used by RemoteStream.
+        void callStream(IComposer& element, IRemoteStream& stream, IDecomposer** argv, unsigned argc);
+
+        /// Continues reading the elements of a paused stream.
+        void resumeStream();
+
+        /** Sends a one way call.
+
+            The server executes the procedure but does not send a reply, so
+            the client does neither wait for it nor learn about failures.
+         */
+        void notify(const String& method, IDecomposer** argv, unsigned argc);
+
+        void notify(const std::string& method)
+        { notify(String(method), 0, 0); }
+
+        template <typename A1>
+        void notify(const std::string& method, const A1& a1)
+        {
+            Decomposer<A1> d1;
+            d1.begin(a1);
+            IDecomposer* argv[1] = { &d1 };
+            notify(String(method), argv, 1);
+        }
+
+        template <typename A1, typename A2>
+        void notify(const std::string& method, const A1& a1, const A2& a2)
+        {
+            Decomposer<A1> d1;
+            Decomposer<A2> d2;
+            d1.begin(a1);
+            d2.begin(a2);
+            IDecomposer* argv[2] = { &d1, &d2 };
+            notify(String(method), argv, 2);
+        }
+
+        template <typename A1, typename A2, typename A3>
+        void notify(const std::string& method, const A1& a1, const A2& a2, const A3& a3)
+        {
+            Decomposer<A1> d1;
+            Decomposer<A2> d2;
+            Decomposer<A3> d3;
+            d1.begin(a1);
+            d2.begin(a2);
+            d3.begin(a3);
+            IDecomposer* argv[3] = { &d1, &d2, &d3 };
+            notify(String(method), argv, 3);
+        }
+
+        template <typename A1, typename A2, typename A3, typename A4>
+        void notify(const std::string& method, const A1& a1, const A2& a2, const A3& a3, const A4& a4)
+        {
+            Decomposer<A1> d1;
+            Decomposer<A2> d2;
+            Decomposer<A3> d3;
+            Decomposer<A4> d4;
+            d1.begin(a1);
+            d2.begin(a2);
+            d3.begin(a3);
+            d4.begin(a4);
+            IDecomposer* argv[4] = { &d1, &d2, &d3, &d4 };
+            notify(String(method), argv, 4);
+        }
+
+        template <typename A1, typename A2, typename A3, typename A4, typename A5>
+        void notify(const std::string& method, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5)
+        {
+            Decomposer<A1> d1;
+            Decomposer<A2> d2;
+            Decomposer<A3> d3;
+            Decomposer<A4> d4;
+            Decomposer<A5> d5;
+            d1.begin(a1);
+            d2.begin(a2);
+            d3.begin(a3);
+            d4.begin(a4);
+            d5.begin(a5);
+            IDecomposer* argv[5] = { &d1, &d2, &d3, &d4, &d5 };
+            notify(String(method), argv, 5);
+        }
+
         Milliseconds timeout() const;
         void timeout(Milliseconds t);
 
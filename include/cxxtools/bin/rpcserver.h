@@ -31,8 +31,10 @@
 
 #include <string>
 #include <cxxtools/signal.h>
+#include <cxxtools/net/socketoptions.h>
 #include <cxxtools/callable.h>
 #include <cxxtools/serviceregistry.h>
+#include <cxxtools/timespan.h>
 
 namespace cxxtools
 {
@@ -65,6 +67,21 @@ namespace cxxtools
                 unsigned maxThreads() const;
                 void maxThreads(unsigned m);
 
+                /// Sets the options for the sockets of the following listen
+                /// calls and the connections accepted there.
+                void socketOptions(const net::SocketOptions& options);
+                const net::SocketOptions& socketOptions() const;
+
+                /// Returns the time a client may take to receive sent data.
+                Milliseconds writeTimeout() const;
+
+                /// Sets the time a client may take to receive sent data. When
+                /// a client does not read a streamed result for that time, e.g.
+                /// because it paused the stream, the connection is closed, so
+                /// that the client does not block a worker thread. The default
+                /// is 20 seconds.
+                void writeTimeout(Milliseconds ms);
+
                 enum Runmode {
                   Stopped,
                   Starting,
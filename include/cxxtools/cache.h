@@ -29,8 +29,8 @@
 #ifndef CXXTOOLS_CACHE_H
 #define CXXTOOLS_CACHE_H
 
-#include <map>
-#include <limits>
+#include <cxxtools/cacheindex.h>
+#include <utility>
 
 #ifdef DEBUG
 #include <iostream>
@@ -57,96 +57,161 @@ namespace cxxtools
        - when getting a value and the value is found, it is put to the
          beginning of the list
 
-     When elements are searched, a linear search is done using the ==-operator
-     of the key type.
-
      The caching algorithm keeps elements, which are fetched more than once in
      the first half of the list. In the second half the elements are either new
      or the elements are pushed from the first half to the second half by other
      elements, which are found in the cache.
 
-     You should be aware, that the key type should be simple. Comparing keys
-     must be cheap. Copying elements (both key and value) must be possible and
-     should be cheap, since they are moved in the underlying container.
+     The two halves are kept as linked lists ordered by the last access, so
+     that moving and dropping elements takes constant time. The elements are
+     found using the Index, which is a std::map by default (see
+     OrderedCacheIndex), so that lookup takes logarithmic time. Pass a
+     HashedCacheIndex to find them in a hash table in constant average time
+     instead.
 
    */
-  template <typename Key, typename Value>
+  template <typename Key, typename Value, typename Index = OrderedCacheIndex<Key> >
   class Cache
   {
       struct Data
       {
         bool winner;
-        unsigned serial;
         Value value;
+        const Key* key;
+        Data* newer;
+        Data* older;
         Data() { }
-        Data(bool winner_, unsigned serial_, const Value& value_)
+        Data(bool winner_, const Value& value_)
           : winner(winner_),
-            serial(serial_),
-            value(value_)
+            value(value_),
+            key(0),
+            newer(0),
+            older(0)
             { }
       };
 
-      typedef std::map<Key, Data> DataType;
+      // list of elements ordered by the last access
+      struct List
+      {
+        Data* newest;
+        Data* oldest;
+        unsigned count;
+
+        List()
+          : newest(0),
+            oldest(0),
+            count(0)
+            { }
+
+        void unlink(Data* d)
+        {
+          if (d->newer)
+            d->newer->older = d->older;
+          else
+            newest = d->older;
+
+          if (d->older)
+            d->older->newer = d->newer;
+          else
+            oldest = d->newer;
+
+          --count;
+        }
+
+        void pushNewest(Data* d)
+        {
+          d->newer = 0;
+          d->older = newest;
+          if (newest)
+            newest->newer = d;
+          else
+            oldest = d;
+          newest = d;
+          ++count;
+        }
+      };
+
+      typedef typename Index::template Map<Data>::type DataType;
       DataType data;
 
       typename DataType::size_type maxElements;
-      unsigned serial;
+      List winnerList;
+      List looserList;
       unsigned hits;
       unsigned misses;
 
-      unsigned _nextSerial()
-      {
-        if (serial == std::numeric_limits<unsigned>::max())
-        {
-          for (typename DataType::iterator it = data.begin(); it != data.end(); ++it)
-            it->second.serial = 0;
-          serial = 1;
-        }
+      List& _list(const Data* d)
+      { return d->winner ? winnerList : looserList; }
 
-        return serial++;
+      Data* _insert(const Key& key, const Value& value, bool winner)
+      {
+        typename DataType::iterator it = data.insert(typename DataType::value_type(key, Data(winner, value))).first;
+        Data* d = &it->second;
+        d->key = &it->first;
+        _list(d).pushNewest(d);
+        return d;
       }
 
-      typename DataType::iterator _getOldest(bool winner)
+      void _erase(Data* d)
       {
-        typename DataType::iterator foundElement = data.begin();
-
-        typename DataType::iterator it = data.begin();
-
-        for (++it; it != data.end(); ++it)
-          if (it->second.winner == winner
-            && (foundElement->second.winner != winner || it->second.serial < foundElement->second.serial))
-              foundElement = it;
-
-        return foundElement;
+        _list(d).unlink(d);
+        data.erase(data.find(*d->key));
       }
 
-      typename DataType::iterator _getNewest(bool winner)
+      // moves a element to the top of the list of winners
+      void _promote(Data* d)
       {
-        typename DataType::iterator foundElement = data.begin();
-
-        typename DataType::iterator it = data.begin();
-
-        for (++it; it != data.end(); ++it)
-          if (it->second.winner == winner
-            && (foundElement->second.winner != winner || it->second.serial > foundElement->second.serial))
-              foundElement = it;
-
-        return foundElement;
+        _list(d).unlink(d);
+        d->winner = true;
+        winnerList.pushNewest(d);
       }
 
       // drop one element
       void _dropLooser()
       {
-        // look for the oldest element in the list of loosers to drop it
-        data.erase(_getOldest(false));
+        // drop the oldest element in the list of loosers
+        Data* d = looserList.oldest ? looserList.oldest : winnerList.oldest;
+        if (d)
+          _erase(d);
       }
 
       void _makeLooser()
       {
-        // look for the oldest element in the list of winners to make it a looser
-        typename DataType::iterator it = _getOldest(true);
-        it->second.winner = false;
-        it->second.serial = _nextSerial();
+        // the oldest element in the list of winners becomes the newest looser
+        Data* d = winnerList.oldest ? winnerList.oldest : looserList.oldest;
+        if (d)
+        {
+          _list(d).unlink(d);
+          d->winner = false;
+          looserList.pushNewest(d);
+        }
+      }
+
+      // a found element is pushed to the top of the list of winners
+      void _hit(Data* d)
+      {
+        if (d->winner)
+        {
+          if (d != winnerList.newest)
+          {
+            winnerList.unlink(d);
+            winnerList.pushNewest(d);
+          }
+        }
+        else
+        {
+          // move element to the winner part
+          _promote(d);
+          _makeLooser();
+        }
+      }
+
+      void _copy(const Cache& c)
+      {
+        for (const Data* d = c.looserList.oldest; d; d = d->newer)
+          _insert(*d->key, d->value, false);
+        for (const Data* d = c.winnerList.oldest; d; d = d->newer)
+          _insert(*d->key, d->value, true);
       }
 
     public:
@@ -155,11 +220,29 @@ namespace cxxtools
 
       explicit Cache(size_type maxElements_)
         : maxElements(maxElements_ + (maxElements_ & 1)),
-          serial(0),
           hits(0),
           misses(0)
         { }
 
+      Cache(const Cache& c)
+        : maxElements(c.maxElements),
+          hits(c.hits),
+          misses(c.misses)
+        { _copy(c); }
+
+      Cache& operator= (const Cache& c)
+      {
+        if (this != &c)
+        {
+          clear();
+          maxElements = c.maxElements;
+          hits = c.hits;
+          misses = c.misses;
+          _copy(c);
+        }
+        return *this;
+      }
+
       /// returns the number of elements currently in the cache
       size_type size() const        { return data.size(); }
 
@@ -168,16 +251,25 @@ namespace cxxtools
 
       void setMaxElements(size_type maxElements_)
       {
-        size_type numWinners = winners();
-
         maxElements_ += (maxElements_ & 1);
 
         if (maxElements_ > maxElements)
         {
-          while (numWinners < maxElements_ / 2)
+          // the newest loosers become winners
+          size_type n = 0;
+          Data* d = 0;
+          for (Data* l = looserList.newest; l && winnerList.count + n < maxElements_ / 2; l = l->older)
+          {
+            d = l;
+            ++n;
+          }
+
+          // promote them starting with the oldest, so that they keep their order
+          for ( ; n > 0; --n)
           {
-            _getNewest(false)->second.winner = true;
-            ++numWinners;
+            Data* next = d->newer;
+            _promote(d);
+            d = next;
           }
         }
         else
@@ -185,12 +277,8 @@ namespace cxxtools
           while (size() > maxElements_)
             _dropLooser();
 
-          numWinners = winners();
-          while (numWinners > maxElements_ / 2)
-          {
+          while (winnerList.count > maxElements_ / 2)
             _makeLooser();
-            --numWinners;
-          }
         }
 
         maxElements = maxElements_;
@@ -203,8 +291,11 @@ namespace cxxtools
         if (it == data.end())
           return false;
 
-        if (it->second.winner)
-          _getNewest(false)->second.winner = true;
+        Data* d = &it->second;
+        _list(d).unlink(d);
+
+        if (d->winner && looserList.newest)
+          _promote(looserList.newest);
 
         data.erase(it);
         return true;
@@ -214,6 +305,8 @@ namespace cxxtools
       void clear(bool stats = false)
       {
         data.clear();
+        winnerList = List();
+        looserList = List();
         if (stats)
           hits = misses = 0;
       }
@@ -227,34 +320,18 @@ namespace cxxtools
         if (it == data.end())
         {
           if (data.size() < maxElements)
-          {
-            it = data.insert(data.begin(),
-              typename DataType::value_type(key,
-                Data(data.size() < maxElements / 2, _nextSerial(), value)));
-          }
-          else
-          {
-            // element not found
-            _dropLooser();
-            it = data.insert(data.begin(),
-              typename DataType::value_type(key,
-                Data(false, _nextSerial(), value)));
-          }
-        }
-        else
-        {
-          // element found
-          it->second.serial = _nextSerial();
-          if (!it->second.winner)
-          {
-            // move element to the winner part
-            it->second.winner = true;
-            _makeLooser();
-          }
-          it->second.value = value;
+            return _insert(key, value, data.size() < maxElements / 2)->value;
+
+          // element not found
+          _dropLooser();
+          return _insert(key, value, false)->value;
         }
 
-        return it->second.value;
+        // element found
+        Data* d = &it->second;
+        _hit(d);
+        d->value = value;
+        return d->value;
       }
 
       /// puts a new element on the top of the cache. If the element is already
@@ -263,35 +340,25 @@ namespace cxxtools
       /// needs a hit to get to the top of the cache.
       void put_top(const Key& key, const Value& value)
       {
-        typename DataType::iterator it;
-        if (data.size() < maxElements)
+        typename DataType::iterator it = data.find(key);
+        if (it != data.end())
+        {
+          // element found
+          _hit(&it->second);
+        }
+        else if (data.size() < maxElements)
         {
           if (data.size() >= maxElements / 2)
             _makeLooser();
 
-          data.insert(data.begin(),
-            typename DataType::value_type(key,
-              Data(true, _nextSerial(), value)));
+          _insert(key, value, true);
         }
-        else if ((it = data.find(key)) == data.end())
+        else
         {
           // element not found
           _dropLooser();
           _makeLooser();
-          data.insert(data.begin(),
-            typename DataType::value_type(key,
-              Data(true, _nextSerial(), value)));
-        }
-        else
-        {
-          // element found
-          it->second.serial = _nextSerial();
-          if (!it->second.winner)
-          {
-            // move element to the winner part
-            it->second.winner = true;
-            _makeLooser();
-          }
+          _insert(key, value, true);
         }
       }
 
@@ -304,18 +371,24 @@ namespace cxxtools
           return 0;
         }
 
-        it->second.serial = _nextSerial();
-
-        if (!it->second.winner)
-        {
-          // move element to the winner part
-          it->second.winner = true;
-          _makeLooser();
-        }
+        _hit(&it->second);
 
         ++hits;
         return &it->second.value;
       }
+      /// returns a pointer to the value without counting a hit or changing the
+      /// order of the elements. If winner is given, it is set to true, when the
+      /// element is in the first half of the list.
+      const Value* peek(const Key& key, bool* winner = 0) const
+      {
+        typename DataType::const_iterator it = data.find(key);
+        if (it == data.end())
+          return 0;
+
+        if (winner)
+          *winner = it->second.winner;
+        return &it->second.value;
+      }
 
       /// returns a pair of values - a flag, if the value was found and the
       /// value if found or the passed default otherwise. If the value is
@@ -344,32 +417,19 @@ namespace cxxtools
       /// returns the ratio, between held elements and maximum elements.
       double fillfactor() const   { return static_cast<double>(data.size()) / static_cast<double>(maxElements); }
 
-      unsigned winners() const
-      {
-        unsigned w = 0;
-        for (typename DataType::const_iterator it = data.begin(); it != data.end(); ++it)
-          if (it->second.winner)
-            ++w;
-        return w;
-      }
-
-      unsigned loosers() const
-      {
-        unsigned l = 0;
-        for (typename DataType::const_iterator it = data.begin(); it != data.end(); ++it)
-          if (!it->second.winner)
-            ++l;
-        return l;
-      }
+      /// returns the number of elements in the first half of the list.
+      unsigned winners() const    { return winnerList.count; }
+      /// returns the number of elements in the second half of the list.
+      unsigned loosers() const    { return looserList.count; }
 
 #ifdef DEBUG
       void dump(std::ostream& out) const
       {
         out << "cache max size=" << maxElements << " current size=" << size() << '\n';
-        for (typename DataType::const_iterator it = data.begin(); it != data.end(); ++it)
-        {
-          out << "\tkey=\"" << it->first << "\" value=\"" << it->second.value << "\" serial=" << it->second.serial << " winner=" << it->second.winner << '\n';
-        }
+        for (const Data* d = winnerList.newest; d; d = d->older)
+          out << "\tkey=\"" << *d->key << "\" value=\"" << d->value << "\" winner=1\n";
+        for (const Data* d = looserList.newest; d; d = d->older)
+          out << "\tkey=\"" << *d->key << "\" value=\"" << d->value << "\" winner=0\n";
         out << "--------\n";
       }
 #endif
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_CACHEINDEX_H
+#define CXXTOOLS_CACHEINDEX_H
+
+#include <functional>
+#include <map>
+#if __cplusplus >= 201103L
+#include <unordered_map>
+#endif
+
+namespace cxxtools
+{
+  /**
+     Index of a Cache or LruCache, which finds the keys in a std::map
+     ordered by Compare.
+
+     This is the default index. Lookup takes logarithmic time and the key
+     type needs just a less than operator or a comparator.
+   */
+  template <typename Key, typename Compare = std::less<Key> >
+  struct OrderedCacheIndex
+  {
+    template <typename T>
+    struct Map
+    {
+      typedef std::map<Key, T, Compare> type;
+    };
+  };
+
+#if __cplusplus >= 201103L
+  /**
+     Index of a Cache or LruCache, which finds the keys in a
+     std::unordered_map using Hash and Equal.
+
+     Lookup takes constant time on average. The class needs C++11.
+
+     Example:
+     \code
+      cxxtools::LruCache<std::string, Page, cxxtools::HashedCacheIndex<std::string> > pages(1000);
+     \endcode
+   */
+  template <typename Key, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key> >
+  struct HashedCacheIndex
+  {
+    template <typename T>
+    struct Map
+    {
+      typedef std::unordered_map<Key, T, Hash, Equal> type;
+    };
+  };
+#endif
+
+}
+
+#endif // CXXTOOLS_CACHEINDEX_H
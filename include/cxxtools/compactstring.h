@@ -0,0 +1,314 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_COMPACTSTRING_H
+#define CXXTOOLS_COMPACTSTRING_H
+
+#include <cxxtools/string.h>
+#include <iterator>
+#include <iosfwd>
+#include <string>
+#include <stdint.h>
+
+namespace cxxtools
+{
+    /**
+       Compact unicode string.
+
+       A String stores 4 bytes per character. The CompactString stores the
+       characters latin-1 encoded, if all of them are in the range 0 to 255
+       and utf-8 encoded otherwise. The number of characters is kept, so that
+       length() is O(1). Strings with up to 23 bytes are stored in the object
+       itself without allocating memory.
+
+       The representation is canonical: a string is stored utf-8 encoded only
+       if it contains at least one character above 255. Since latin-1 uses a
+       fixed size, indexing is O(1) in that case; for utf-8 encoded strings
+       it is O(n).
+
+       Characters, which are not valid unicode code points (negative values,
+       surrogates and values above 0x10ffff) are replaced by U+FFFD.
+
+       Example:
+       \code
+        cxxtools::CompactString s(cxxtools::String(L"K\xf6ln"));
+        std::cout << s.length() << ' ' << s.isLatin1() << '\n';   // 4 1
+        s += cxxtools::Char(0x20ac);
+        std::cout << s << '\n';                                    // Köln€ utf-8 encoded
+        cxxtools::String w = s.toString();
+       \endcode
+     */
+    class CompactString
+    {
+        public:
+            typedef std::size_t size_type;
+            typedef Char value_type;
+
+            /// Forward iterator, which yields the characters of the string.
+            class const_iterator : public std::iterator<std::forward_iterator_tag, Char, std::ptrdiff_t, const Char*, Char>
+            {
+                    friend class CompactString;
+
+                    const char* _p;
+                    bool _latin1;
+
+                    const_iterator(const char* p, bool latin1)
+                        : _p(p),
+                          _latin1(latin1)
+                    { }
+
+                public:
+                    const_iterator()
+                        : _p(0),
+                          _latin1(true)
+                    { }
+
+                    Char operator*() const;
+                    const_iterator& operator++();
+
+                    const_iterator operator++(int)
+                    {
+                        const_iterator ret = *this;
+                        ++*this;
+                        return ret;
+                    }
+
+                    bool operator== (const const_iterator& it) const
+                    { return _p == it._p; }
+
+                    bool operator!= (const const_iterator& it) const
+                    { return _p != it._p; }
+            };
+
+            typedef const_iterator iterator;
+
+            CompactString()
+                : _size(0),
+                  _length(0)
+            { _u._short[0] = '\0'; }
+
+            CompactString(const CompactString& s);
+
+#if __cplusplus >= 201103L
+            CompactString(CompactString&& s) noexcept;
+#endif
+
+            explicit CompactString(const String& s);
+
+            CompactString(const Char* s, size_type n);
+
+            ~CompactString()
+            {
+                if (isLong())
+                    delete[] _u._long._ptr;
+            }
+
+            CompactString& operator= (const CompactString& s);
+
+#if __cplusplus >= 201103L
+            CompactString& operator= (CompactString&& s) noexcept;
+#endif
+
+            CompactString& operator= (const String& s)
+            { return assign(s); }
+
+            /// Creates a string from utf-8 encoded data; throws ConversionError on illegal utf-8.
+            static CompactString fromUtf8(const char* data, size_type size);
+
+            static CompactString fromUtf8(const std::string& s)
+            { return fromUtf8(s.data(), s.size()); }
+
+            /// Creates a string from latin-1 encoded data.
+            static CompactString fromLatin1(const char* data, size_type size);
+
+            static CompactString fromLatin1(const std::string& s)
+            { return fromLatin1(s.data(), s.size()); }
+
+            /// Returns the number of characters.
+            size_type length() const
+            { return _length; }
+
+            size_type size() const
+            { return _length; }
+
+            bool empty() const
+            { return _length == 0; }
+
+            /// Returns true, if the string is stored latin-1 encoded.
+            bool isLatin1() const
+            { return byteSize() == _length; }
+
+            /// Returns true, if all characters are below 128; the check is O(n).
+            bool isAscii() const;
+
+            /// Returns the encoded data; it is latin-1 or utf-8 depending on isLatin1().
+            const char* data() const
+            { return isLong() ? _u._long._ptr : _u._short; }
+
+            /// Returns the number of bytes of the encoded data.
+            size_type byteSize() const
+            { return _size & ~LongFlag; }
+
+            /// Returns the number of bytes, which can be stored without reallocation.
+            size_type capacity() const
+            { return isLong() ? _u._long._capacity : ShortCapacity; }
+
+            /// Reserves space for at least n bytes of encoded data.
+            void reserve(size_type n);
+
+            void clear()
+            {
+                setSize(0);
+                _length = 0;
+            }
+
+            const_iterator begin() const
+            { return const_iterator(data(), isLatin1()); }
+
+            const_iterator end() const
+            { return const_iterator(data() + byteSize(), isLatin1()); }
+
+            /// Returns the n-th character; O(1) for latin-1 and O(n) for utf-8 encoded strings.
+            Char operator[](size_type n) const;
+
+            /// Like operator[] but throws std::out_of_range if n is not less than length().
+            Char at(size_type n) const;
+
+            CompactString& assign(const String& s)
+            { return assign(s.data(), s.size()); }
+
+            CompactString& assign(const Char* s, size_type n);
+
+            CompactString& append(Char ch);
+
+            CompactString& append(const CompactString& s);
+
+            CompactString& append(const String& s)
+            { return append(s.data(), s.size()); }
+
+            CompactString& append(const Char* s, size_type n);
+
+            CompactString& operator+= (Char ch)
+            { return append(ch); }
+
+            CompactString& operator+= (const CompactString& s)
+            { return append(s); }
+
+            CompactString& operator+= (const String& s)
+            { return append(s); }
+
+            /// Converts the string to a String.
+            String toString() const;
+
+            /// Returns the utf-8 encoded string.
+            std::string toUtf8() const;
+
+            /// Returns the string with one byte per character; characters above 255 are replaced by dfault.
+            std::string narrow(char dfault = '?') const;
+
+            /// Compares the characters like String::compare.
+            int compare(const CompactString& s) const;
+
+            int compare(const String& s) const;
+
+            void swap(CompactString& s);
+
+        private:
+            static const uint32_t LongFlag = 0x80000000u;
+            static const size_type ShortCapacity = 23;
+
+            union
+            {
+                char _short[ShortCapacity + 1];
+                struct
+                {
+                    char* _ptr;
+                    size_type _capacity;
+                } _long;
+            } _u;
+
+            // number of bytes; the highest bit is set, when the data is allocated
+            uint32_t _size;
+            // number of characters
+            uint32_t _length;
+
+            bool isLong() const
+            { return (_size & LongFlag) != 0; }
+
+            char* buffer()
+            { return isLong() ? _u._long._ptr : _u._short; }
+
+            void setSize(size_type n)
+            {
+                _size = static_cast<uint32_t>(n) | (_size & LongFlag);
+                buffer()[n] = '\0';
+            }
+
+            void appendBytes(const char* data, size_type n);
+            void appendLatin1AsUtf8(const char* data, size_type n);
+            void toUtf8Encoding();
+    };
+
+    inline bool operator== (const CompactString& a, const CompactString& b)
+    { return a.length() == b.length() && a.byteSize() == b.byteSize() && a.compare(b) == 0; }
+
+    inline bool operator!= (const CompactString& a, const CompactString& b)
+    { return !(a == b); }
+
+    inline bool operator< (const CompactString& a, const CompactString& b)
+    { return a.compare(b) < 0; }
+
+    inline bool operator> (const CompactString& a, const CompactString& b)
+    { return a.compare(b) > 0; }
+
+    inline bool operator<= (const CompactString& a, const CompactString& b)
+    { return a.compare(b) <= 0; }
+
+    inline bool operator>= (const CompactString& a, const CompactString& b)
+    { return a.compare(b) >= 0; }
+
+    inline bool operator== (const CompactString& a, const String& b)
+    { return a.length() == b.length() && a.compare(b) == 0; }
+
+    inline bool operator== (const String& a, const CompactString& b)
+    { return b == a; }
+
+    inline bool operator!= (const CompactString& a, const String& b)
+    { return !(a == b); }
+
+    inline bool operator!= (const String& a, const CompactString& b)
+    { return !(b == a); }
+
+    inline void swap(CompactString& a, CompactString& b)
+    { a.swap(b); }
+
+    /// Writes the utf-8 encoded string.
+    std::ostream& operator<< (std::ostream& out, const CompactString& s);
+}
+
+#endif // CXXTOOLS_COMPACTSTRING_H
@@ -0,0 +1,400 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_CONCURRENTCACHE_H
+#define CXXTOOLS_CONCURRENTCACHE_H
+
+#include <cxxtools/cache.h>
+#include <cxxtools/cacheindex.h>
+#include <cxxtools/mutex.h>
+#include <cxxtools/condition.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/timespan.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace cxxtools
+{
+  /**
+     Thread safe cache with a reader/writer lock per shard.
+
+     The elements are distributed by the hash of the key to a number of
+     shards. Each shard is a Cache with its own ReadWriteMutex, so that
+     threads accessing different shards do not block each other. Within a
+     shard the elements are found in a hash table using Hash and Equal.
+
+     Reads are not lock free. Even a shared lock writes to the cache line of
+     the lock, so threads on different cores reading the same shard still
+     contend for it. Use more shards than threads, when many threads read
+     the cache at the same time.
+
+     Lookups of elements, which are in the first half of the list of their
+     shard (see Cache) take only a shared lock and do not change the order
+     of the elements. Other elements are moved to the top of the list as in
+     Cache, which needs an exclusive lock. So elements, which are read often
+     move to the second half of the list from time to time and get promoted
+     again on the next read.
+
+     Elements may have a time to live. Expired elements are not returned and
+     removed on the next access.
+
+     getOrCompute creates missing elements using a passed function. When
+     multiple threads request the same missing key, only one of them
+     computes the value and the others wait for the result.
+
+     Example:
+     \code
+      cxxtools::ConcurrentCache<std::string, Page> pages(1000, 16, cxxtools::Seconds(60));
+
+      Page page = pages.getOrCompute(url, [&url] () { return loadPage(url); });
+     \endcode
+
+     The class needs C++11.
+   */
+  template <typename Key, typename Value, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key> >
+  class ConcurrentCache
+  {
+      struct Entry
+      {
+        Value value;
+        Timespan expires;   // 0 if the entry does not expire
+
+        Entry() { }
+        Entry(const Value& value_, Timespan expires_)
+          : value(value_),
+            expires(expires_)
+            { }
+      };
+
+      // a running computation in getOrCompute
+      struct Pending
+      {
+        Condition finished;
+        Value value;
+        bool done;
+        bool failed;
+        unsigned waiters;
+
+        Pending()
+          : done(false),
+            failed(false),
+            waiters(0)
+            { }
+      };
+
+      typedef Cache<Key, Entry, HashedCacheIndex<Key, Hash, Equal> > ShardCache;
+      typedef std::unordered_map<Key, Pending*, Hash, Equal> PendingMap;
+
+      struct Shard
+      {
+        ReadWriteMutex mutex;
+        ShardCache cache;
+        Mutex pendingMutex;
+        PendingMap pending;
+        std::atomic<unsigned> hits;
+        std::atomic<unsigned> misses;
+
+        explicit Shard(unsigned maxElements)
+          : cache(maxElements),
+            hits(0),
+            misses(0)
+            { }
+      };
+
+      std::vector<std::unique_ptr<Shard> > _shards;
+      Hash _hash;
+      Timespan _ttl;
+
+      ConcurrentCache(const ConcurrentCache&);
+      ConcurrentCache& operator= (const ConcurrentCache&);
+
+      Shard& _shard(const Key& key)
+      { return *_shards[_hash(key) % _shards.size()]; }
+
+      Timespan _expires(Timespan ttl) const
+      { return ttl > Timespan(0) ? Clock::getSystemTicks() + ttl : Timespan(0); }
+
+      static bool _expired(const Entry& e)
+      { return e.expires > Timespan(0) && e.expires <= Clock::getSystemTicks(); }
+
+      // looks up the key without counting hits and misses
+      bool _lookup(Shard& s, const Key& key, Value& value)
+      {
+        {
+          ReadLock lock(s.mutex);
+          bool winner = false;
+          const Entry* e = s.cache.peek(key, &winner);
+          if (e == 0)
+            return false;
+
+          if (winner && !_expired(*e))
+          {
+            value = e->value;
+            return true;
+          }
+        }
+
+        // the element needs to be moved to the top or removed
+        WriteLock lock(s.mutex);
+        Entry* e = s.cache.getptr(key);
+        if (e == 0)
+          return false;
+
+        if (_expired(*e))
+        {
+          s.cache.erase(key);
+          return false;
+        }
+
+        value = e->value;
+        return true;
+      }
+
+      bool _get(Shard& s, const Key& key, Value& value)
+      {
+        if (_lookup(s, key, value))
+        {
+          s.hits.fetch_add(1, std::memory_order_relaxed);
+          return true;
+        }
+
+        s.misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+
+      void _put(Shard& s, const Key& key, const Value& value, Timespan ttl)
+      {
+        WriteLock lock(s.mutex);
+        s.cache.put(key, Entry(value, _expires(ttl)));
+      }
+
+      // finishes a computation in getOrCompute; the pendingMutex must be locked
+      static void _finish(Shard& s, const Key& key, Pending* p)
+      {
+        p->done = true;
+        s.pending.erase(key);
+        if (p->waiters == 0)
+          delete p;
+        else
+          p->finished.broadcast();
+      }
+
+    public:
+      typedef typename ShardCache::size_type size_type;
+      typedef Value value_type;
+
+      /// Creates a cache with about maxElements elements distributed to the
+      /// passed number of shards. The ttl is the default time to live of the
+      /// elements; 0 means, that elements do not expire.
+      explicit ConcurrentCache(size_type maxElements, unsigned shards = 16, Timespan ttl = Timespan(0))
+        : _ttl(ttl)
+      {
+        if (shards == 0)
+          shards = 1;
+
+        unsigned maxPerShard = (maxElements + shards - 1) / shards;
+        for (unsigned n = 0; n < shards; ++n)
+          _shards.push_back(std::unique_ptr<Shard>(new Shard(maxPerShard)));
+      }
+
+      /// returns the number of elements currently in the cache
+      size_type size() const
+      {
+        size_type ret = 0;
+        for (unsigned n = 0; n < _shards.size(); ++n)
+        {
+          ReadLock lock(_shards[n]->mutex);
+          ret += _shards[n]->cache.size();
+        }
+        return ret;
+      }
+
+      /// returns the maximum number of elements in the cache
+      size_type getMaxElements() const
+      { return _shards.size() * _shards[0]->cache.getMaxElements(); }
+
+      unsigned shards() const
+      { return _shards.size(); }
+
+      /// returns the default time to live of new elements
+      Timespan ttl() const
+      { return _ttl; }
+
+      /// removes a element from the cache and returns true, if found
+      bool erase(const Key& key)
+      {
+        Shard& s = _shard(key);
+        WriteLock lock(s.mutex);
+        return s.cache.erase(key);
+      }
+
+      /// clears the cache. The hit and miss counters are reset, if stats
+      /// is set.
+      void clear(bool stats = false)
+      {
+        for (unsigned n = 0; n < _shards.size(); ++n)
+        {
+          Shard& s = *_shards[n];
+          WriteLock lock(s.mutex);
+          s.cache.clear(stats);
+          if (stats)
+          {
+            s.hits.store(0, std::memory_order_relaxed);
+            s.misses.store(0, std::memory_order_relaxed);
+          }
+        }
+      }
+
+      /// puts a new element into the cache with the default time to live.
+      void put(const Key& key, const Value& value)
+      { _put(_shard(key), key, value, _ttl); }
+
+      /// puts a new element into the cache, which expires after ttl.
+      void put(const Key& key, const Value& value, Timespan ttl)
+      { _put(_shard(key), key, value, ttl); }
+
+      /// returns a pair of values - a flag, if the value was found and the
+      /// value if found or the passed default otherwise.
+      std::pair<bool, Value> getx(const Key& key, Value def = Value())
+      {
+        bool found = _get(_shard(key), key, def);
+        return std::pair<bool, Value>(found, def);
+      }
+
+      /// returns the value to a key or the passed default value if not found.
+      Value get(const Key& key, Value def = Value())
+      {
+        _get(_shard(key), key, def);
+        return def;
+      }
+
+      /// Returns the value to a key. If the key is not found, the value is
+      /// computed by calling compute() and put into the cache with the
+      /// default time to live. Other threads requesting the same key in the
+      /// meantime wait for the result. If compute throws an exception, it is
+      /// passed to the caller and one of the waiting threads computes the
+      /// value again.
+      template <typename Compute>
+      Value getOrCompute(const Key& key, Compute compute)
+      { return getOrCompute(key, compute, _ttl); }
+
+      template <typename Compute>
+      Value getOrCompute(const Key& key, Compute compute, Timespan ttl)
+      {
+        Shard& s = _shard(key);
+
+        Value value;
+        if (_get(s, key, value))
+          return value;
+
+        MutexLock lock(s.pendingMutex);
+
+        while (true)
+        {
+          typename PendingMap::iterator it = s.pending.find(key);
+          if (it == s.pending.end())
+          {
+            // another thread may have put the value in the meantime
+            if (_lookup(s, key, value))
+              return value;
+            break;
+          }
+
+          Pending* p = it->second;
+          ++p->waiters;
+          while (!p->done)
+            p->finished.wait(lock);
+
+          bool failed = p->failed;
+          if (!failed)
+            value = p->value;
+
+          if (--p->waiters == 0)
+            delete p;
+
+          if (!failed)
+            return value;
+        }
+
+        Pending* p = new Pending();
+        s.pending[key] = p;
+        lock.unlock();
+
+        try
+        {
+          value = compute();
+          _put(s, key, value, ttl);
+        }
+        catch (...)
+        {
+          lock.lock();
+          p->failed = true;
+          _finish(s, key, p);
+          throw;
+        }
+
+        lock.lock();
+        p->value = value;
+        _finish(s, key, p);
+
+        return value;
+      }
+
+      /// returns the number of hits.
+      unsigned getHits() const
+      {
+        unsigned ret = 0;
+        for (unsigned n = 0; n < _shards.size(); ++n)
+          ret += _shards[n]->hits.load(std::memory_order_relaxed);
+        return ret;
+      }
+
+      /// returns the number of misses.
+      unsigned getMisses() const
+      {
+        unsigned ret = 0;
+        for (unsigned n = 0; n < _shards.size(); ++n)
+          ret += _shards[n]->misses.load(std::memory_order_relaxed);
+        return ret;
+      }
+
+      /// returns the cache hit ratio between 0 and 1.
+      double hitRatio() const
+      {
+        unsigned hits = getHits();
+        unsigned misses = getMisses();
+        return hits+misses > 0 ? static_cast<double>(hits)/static_cast<double>(hits+misses) : 0;
+      }
+  };
+
+}
+
+#endif // CXXTOOLS_CONCURRENTCACHE_H
@@ -54,8 +54,23 @@ namespace cxxtools {
             , _sender(&sender)
             { }
 
+            // Copies the slot into the connection data, when it is small
+            // enough, so that connecting needs a single allocation and
+            // sending a signal touches a single block of memory.
+            ConnectionData(Connectable& sender, const Slot& slot)
+            : RefCounted(1)
+            , _valid(true)
+            , _slot(slot.cloneTo(&_buffer, sizeof(_buffer)))
+            , _sender(&sender)
+            { }
+
             ~ConnectionData()
-            { delete _slot; }
+            {
+                if (static_cast<void*>(_slot) == static_cast<void*>(&_buffer))
+                    _slot->~Slot();
+                else
+                    delete _slot;
+            }
 
             bool valid() const
             { return _valid; }
@@ -79,6 +94,15 @@ namespace cxxtools {
             bool _valid;
             Slot* _slot;
             Connectable* _sender;
+
+            // large enough for slots of functions, member functions and signals
+            union
+            {
+                char _data[6 * sizeof(void*)];
+                void* _ptr;
+                double _double;
+                void (*_func)();
+            } _buffer;
     };
 
     /** @brief Represents a connection between a Signal/Delegate and a slot
@@ -98,6 +122,9 @@ namespace cxxtools {
 
             Connection(Connectable& sender, Slot* slot);
 
+            /// Connects a copy of the slot.
+            Connection(Connectable& sender, const Slot& slot);
+
             Connection(const Connection& connection);
 
             Connection& operator=(const Connection& connection);
@@ -122,6 +149,8 @@ namespace cxxtools {
             { return _data == connection._data; }
 
         private:
+            void open(Connectable& sender);
+
             ConnectionData* _data;
     };
 
@@ -42,6 +42,7 @@
 #include <iterator>
 #include <cctype>
 #include <cmath>
+#include <stdint.h>
 
 #include <cxxtools/config.h>
 
@@ -295,6 +296,24 @@ OutIterT putFloat(OutIterT it, T d, const FormatT& fmt, int precision);
 template <typename OutIterT, typename T>
 OutIterT putFloat(OutIterT it, T d);
 
+/** @brief Formats a float with the shortest representation, which reads back to the same value.
+ */
+template <typename OutIterT>
+OutIterT putFloat(OutIterT it, float d);
+
+/** @brief Formats a double with the shortest representation, which reads back to the same value.
+ */
+template <typename OutIterT>
+OutIterT putFloat(OutIterT it, double d);
+
+/** @brief Formats a long double in default format.
+
+    Values, which are exactly representable as double are formatted like a
+    double with the shortest representation.
+ */
+template <typename OutIterT>
+OutIterT putFloat(OutIterT it, long double d);
+
 //
 // number parsing
 //
@@ -319,6 +338,46 @@ InIterT getFloat(InIterT it, InIterT end, bool& ok, T& n, const FormatT& fmt);
 template <typename InIterT, typename T>
 InIterT getFloat(InIterT it, InIterT end, bool& ok, T& n);
 
+//! @internal @brief Significant digits and exponent of a parsed decimal number.
+//
+//  The value is mantissa * 10^exponent. If the number has more than 19
+//  significant digits, the mantissa holds the first 19 digits and the
+//  remaining digits are kept in \a more.
+struct DecimalFloat
+{
+    uint64_t mantissa;
+    long exponent;
+    std::string more;
+
+    DecimalFloat()
+        : mantissa(0),
+          exponent(0)
+    { }
+};
+
+//! @internal @brief Converts a decimal number to the nearest float value.
+void decimalToFloat(float& n, const DecimalFloat& d);
+
+//! @internal @brief Converts a decimal number to the nearest double value.
+void decimalToFloat(double& n, const DecimalFloat& d);
+
+//! @internal @brief Converts a decimal number to the nearest long double value.
+void decimalToFloat(long double& n, const DecimalFloat& d);
+
+//! @internal @brief Calculates the shortest digits, which read back as \a d.
+//
+//  The value must be finite and greater than 0. The digits are written
+//  without leading and trailing zeros into \a digits, which must have room
+//  for 17 characters. The value is 0.<digits> * 10^exp. Returns the number
+//  of digits.
+unsigned shortestDigits(double d, char* digits, int& exp);
+
+//! @internal @brief Calculates the shortest digits, which read back as \a d.
+//
+//  Like the double variant but the digits read back as float. At most 9
+//  digits are written.
+unsigned shortestDigits(float d, char* digits, int& exp);
+
 
 template <typename CharType>
 struct NumberFormat
@@ -762,6 +821,122 @@ inline OutIterT putFloat(OutIterT it, T value)
 }
 
 
+//! @internal @brief Writes the value 0.<digits> * 10^exp without exponent.
+template <typename OutIterT, typename FormatT>
+OutIterT putFloatDigits(OutIterT it, const char* digits, unsigned count, int exp, const FormatT& fmt)
+{
+    if (exp <= 0)
+    {
+        *it = fmt.toChar(0); ++it;
+        *it = fmt.point(); ++it;
+
+        for ( ; exp < 0; ++exp)
+        {
+            *it = fmt.toChar(0); ++it;
+        }
+
+        for (unsigned dd = 0; dd < count; ++dd)
+        {
+            *it = fmt.toChar(digits[dd] - '0'); ++it;
+        }
+    }
+    else
+    {
+        for (unsigned dd = 0; dd < count; ++dd)
+        {
+            if (exp-- == 0)
+            {
+                *it = fmt.point();
+                ++it;
+            }
+            *it = fmt.toChar(digits[dd] - '0'); ++it;
+        }
+
+        while (exp-- > 0)
+        {
+            *it = fmt.toChar(0); ++it;
+        }
+    }
+
+    return it;
+}
+
+
+//! @internal @brief Formats a float or double with the shortest representation.
+template <typename OutIterT, typename T, typename FormatT>
+OutIterT putShortestFloat(OutIterT it, T value, const FormatT& fmt)
+{
+    typedef typename FormatT::CharT CharT;
+
+    if (value != value)
+    {
+        for (const CharT* nanstr = fmt.nan(); *nanstr != 0; ++nanstr)
+        {
+            *it = *nanstr;
+            ++it;
+        }
+
+        return it;
+    }
+
+    if (value < 0)
+    {
+        *it = fmt.minus();
+        ++it;
+        value = -value;
+    }
+
+    if (value == std::numeric_limits<T>::infinity())
+    {
+        for (const CharT* infstr = fmt.inf(); *infstr != 0; ++infstr)
+        {
+            *it = *infstr;
+            ++it;
+        }
+
+        return it;
+    }
+
+    if (value == 0)
+    {
+        *it = fmt.toChar(0);
+        ++it;
+        return it;
+    }
+
+    char digits[17];
+    int exp;
+    unsigned count = shortestDigits(value, digits, exp);
+    return putFloatDigits(it, digits, count, exp, fmt);
+}
+
+
+template <typename OutIterT>
+inline OutIterT putFloat(OutIterT it, float value)
+{
+    return putShortestFloat(it, value, FloatFormat<char>());
+}
+
+
+template <typename OutIterT>
+inline OutIterT putFloat(OutIterT it, double value)
+{
+    return putShortestFloat(it, value, FloatFormat<char>());
+}
+
+
+template <typename OutIterT>
+inline OutIterT putFloat(OutIterT it, long double value)
+{
+    double d = static_cast<double>(value);
+    if (d == value)
+        return putShortestFloat(it, d, FloatFormat<char>());
+
+    const int precision = std::numeric_limits<long double>::digits10 - 1;
+    return putFloat(it, value, FloatFormat<char>(), precision);
+}
+
+
 template <typename InIterT, typename FormatT>
 InIterT getSign(InIterT it, InIterT end, bool& pos, const FormatT& fmt)
 {
@@ -856,7 +1031,6 @@ template <typename InIterT, typename T, typename FormatT>
 InIterT getFloat(InIterT it, InIterT end, bool& ok, T& n, const FormatT& fmt)
 {
     typedef typename FormatT::CharT CharT;
-    CharT zero = fmt.toChar(0);
     n = 0.0;
     ok = false;
 
@@ -975,79 +1149,60 @@ InIterT getFloat(InIterT it, InIterT end, bool& ok, T& n, const FormatT& fmt)
         ++it;
     }
 
-    // integral part
-    bool withFractional = false;
+    // collect significant digits, skip leading zeros
+    DecimalFloat d;
+    unsigned significants = 0;
+    bool withDigits = false;
     for( ; it != end; ++it)
     {
-        if( *it == fmt.point() || *it == fmt.e() || *it == fmt.E() )
+        unsigned digit = fmt.toDigit(*it);
+        if(digit >= fmt.base)
+            break;
+
+        withDigits = true;
+        if (significants < 19)
         {
-            if( *it == fmt.point())
+            if (significants > 0 || digit != 0)
             {
-                withFractional = true;
-                ++it;
+                d.mantissa = d.mantissa * 10 + digit;
+                ++significants;
             }
-            break;
         }
-        
-        unsigned digit = fmt.toDigit(*it); 
-        if(digit >= fmt.base)
-            return it;
-        
-        ok = true;
-        n *= 10;
-        n += digit; 
-    }
-    
-    // it is ok, if fraction is missing
-    if(it == end)
-    {
-        if( ! pos )
-            n *= -1;
-
-        ok = true;
-        return it;
+        else
+        {
+            d.more += static_cast<char>('0' + digit);
+            ++d.exponent;
+        }
     }
 
-    T base = 10.0;
-    if( withFractional)
+    if (it != end && *it == fmt.point())
     {
-        // fractional part, ignore 0 digits after dot
-        unsigned short fractDigits = 0;
-        size_t maxDigits = std::numeric_limits<unsigned short>::max() - std::numeric_limits<T>::digits10;
-        while(it != end && *it == zero)
+        for (++it; it != end; ++it)
         {
-            if( fractDigits > maxDigits )
-                return it;
-            
-            ++fractDigits;
-            ++it;
-        }
- 
-        // fractional part, parse like integer, skip insignificant digits
-        unsigned short significants = 0;
-        T fraction = 0.0;
-        for( ; it != end; ++it)
-        {
-            unsigned digit = fmt.toDigit(*it); 
+            unsigned digit = fmt.toDigit(*it);
             if(digit >= fmt.base)
                 break;
-            
-            if( significants <= std::numeric_limits<T>::digits10 )
+
+            withDigits = true;
+            if (significants < 19)
             {
-                fraction *= 10;
-                fraction += digit;
-                
-                ++fractDigits;
-                ++significants;
+                if (significants > 0 || digit != 0)
+                {
+                    d.mantissa = d.mantissa * 10 + digit;
+                    ++significants;
+                }
+                --d.exponent;
+            }
+            else
+            {
+                d.more += static_cast<char>('0' + digit);
             }
         }
-    
-
-        // fractional part, scale down
-        fraction /= std::pow(base, T(fractDigits));
-        n += fraction;
     }
 
+    if (!withDigits)
+        return it;
+
     // exponent [e|E][+|-][0-9]*
     if(it != end && (*it == fmt.e() || *it == fmt.E()) )
     {
@@ -1058,12 +1213,16 @@ InIterT getFloat(InIterT it, InIterT end, bool& ok, T& n, const FormatT& fmt)
         it = getInt(it, end, ok, exp, fmt);
         if( ! ok )
             return it;
-            
-        n *= std::pow(base, T(exp));
+
+        // large exponents result in 0 or infinity anyway
+        const long maxExp = 100000;
+        d.exponent += exp < -maxExp ? -maxExp : exp > maxExp ? maxExp : exp;
     }
 
+    decimalToFloat(n, d);
+
     if( ! pos )
-        n *= -1;
+        n = -n;
 
     ok = true;
     return it;
@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2016 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_CSVREADER_H
+#define CXXTOOLS_CSVREADER_H
+
+#include <cxxtools/noncopyable.h>
+#include <cxxtools/mappedfile.h>
+#include <cxxtools/string.h>
+#include <cxxtools/convert.h>
+#include <string>
+#include <vector>
+
+namespace cxxtools
+{
+    /**
+       A single field of a csv file read by CsvReader.
+
+       The field references the utf-8 encoded input of the reader directly. It
+       is valid as long as the reader, which returned it, exists. Conversion
+       into a value is done only when requested.
+     */
+    class CsvField
+    {
+            const char* _begin;
+            const char* _end;
+            char _quote;
+
+        public:
+            CsvField()
+                : _begin(0),
+                  _end(0),
+                  _quote(0)
+            { }
+
+            CsvField(const char* begin, const char* end, char quote)
+                : _begin(begin),
+                  _end(end),
+                  _quote(quote)
+            { }
+
+            /// Returns the begin of the raw field data without surrounding quotes.
+            const char* begin() const
+            { return _begin; }
+
+            /// Returns the end of the raw field data without surrounding quotes.
+            const char* end() const
+            { return _end; }
+
+            /// Returns the size of the raw field data in bytes.
+            std::size_t size() const
+            { return _end - _begin; }
+
+            bool empty() const
+            { return _begin == _end; }
+
+            /// Returns true, if the field was quoted in the input.
+            bool quoted() const
+            { return _quote != 0; }
+
+            /// Returns the utf-8 encoded value with doubled quotes unescaped.
+            std::string str() const;
+
+            /// Returns the decoded value.
+            String toString() const;
+
+            void get(std::string& value) const
+            { value = str(); }
+
+            void get(String& value) const
+            { value = toString(); }
+
+            void get(bool& value) const;
+            void get(short& value) const;
+            void get(unsigned short& value) const;
+            void get(int& value) const;
+            void get(unsigned int& value) const;
+            void get(long& value) const;
+            void get(unsigned long& value) const;
+#ifdef HAVE_LONG_LONG
+            void get(long long& value) const;
+#endif
+#ifdef HAVE_UNSIGNED_LONG_LONG
+            void get(unsigned long long& value) const;
+#endif
+            void get(float& value) const;
+            void get(double& value) const;
+            void get(long double& value) const;
+
+            /// Converts the value using the generic convert functions.
+            template <typename T>
+            void get(T& value) const
+            { convert(value, str()); }
+
+            template <typename T>
+            T get() const
+            {
+                T value = T();
+                get(value);
+                return value;
+            }
+    };
+
+    /**
+       Reader for large utf-8 encoded csv files.
+
+       Unlike the CsvDeserializer, the reader does not decode the input into a
+       SerializationInfo but splits the data into fields, which reference the
+       input directly. The fields are stored column wise, so that a single
+       column can be processed without touching the rest of the data. Values
+       are converted only when requested.
+
+       The input is either a memory region owned by the caller or a file, which
+       is mapped into memory. Large inputs are split into chunks, which are
+       parsed in parallel.
+
+       Fields may be quoted with the quote character, which defaults to '"'.
+       A quote within a quoted field is escaped by doubling it. Quote
+       characters within unquoted fields are not supported when the input is
+       parsed in parallel.
+
+       Example:
+       \code
+        cxxtools::CsvReader reader("data.csv");
+        reader.parse();
+        cxxtools::CsvReader::Column price = reader.column("price");
+        double sum = 0;
+        for (std::size_t n = 0; n < price.size(); ++n)
+          sum += price.get<double>(n);
+       \endcode
+     */
+    class CsvReader : private NonCopyable
+    {
+        public:
+            struct FieldPos
+            {
+                std::size_t offset;
+                unsigned size;
+                char quote;
+            };
+
+            typedef std::vector<FieldPos> FieldPosVector;
+
+            /// A view to a single column of the csv data.
+            class Column
+            {
+                    const CsvReader* _reader;
+                    unsigned _column;
+
+                public:
+                    Column(const CsvReader& reader, unsigned column)
+                        : _reader(&reader),
+                          _column(column)
+                    { }
+
+                    /// Returns the number of rows.
+                    std::size_t size() const
+                    { return _reader->_columns[_column].size(); }
+
+                    const std::string& title() const;
+
+                    CsvField operator[] (std::size_t row) const
+                    { return _reader->field(row, _column); }
+
+                    template <typename T>
+                    T get(std::size_t row) const
+                    { return (*this)[row].template get<T>(); }
+
+                    /// Converts all values of the column and appends them to the passed vector.
+                    template <typename T>
+                    void values(std::vector<T>& v) const
+                    {
+                        v.reserve(v.size() + size());
+                        for (std::size_t n = 0; n < size(); ++n)
+                            v.push_back(get<T>(n));
+                    }
+            };
+
+            /// Creates a reader for the memory region, which must exist as long as the reader.
+            CsvReader(const char* data, std::size_t size);
+
+            /// Creates a reader for a file. The file is mapped into memory.
+            explicit CsvReader(const std::string& fname);
+
+            ~CsvReader();
+
+            static const char autoDelimiter;
+
+            char delimiter() const
+            { return _delimiter; }
+
+            /// Sets the delimiter; autoDelimiter detects it from the title line.
+            void delimiter(char ch)
+            { _delimiter = ch; }
+
+            char quote() const
+            { return _quote; }
+
+            void quote(char ch)
+            { _quote = ch; }
+
+            bool readTitle() const
+            { return _readTitle; }
+
+            void readTitle(bool sw)
+            { _readTitle = sw; }
+
+            unsigned threads() const
+            { return _threads; }
+
+            /// Sets the number of parser threads; 0 uses one thread per cpu.
+            void threads(unsigned n)
+            { _threads = n; }
+
+            /// Splits the input into fields. Throws SerializationError on invalid input.
+            void parse();
+
+            std::size_t rowCount() const
+            { return _columns.empty() ? 0 : _columns[0].size(); }
+
+            unsigned columnCount() const
+            { return _columns.size(); }
+
+            const std::vector<std::string>& titles() const
+            { return _titles; }
+
+            Column column(unsigned n) const;
+
+            /// Returns the column with the given title. Throws std::out_of_range if not found.
+            Column column(const std::string& title) const;
+
+            CsvField field(std::size_t row, unsigned column) const
+            {
+                const FieldPos& f = _columns[column][row];
+                return CsvField(_data + f.offset, _data + f.offset + f.size, f.quote);
+            }
+
+        private:
+            const char* _data;
+            std::size_t _size;
+            MappedFile _file;
+
+            char _delimiter;
+            char _quote;
+            bool _readTitle;
+            unsigned _threads;
+
+            std::vector<std::string> _titles;
+            std::vector<FieldPosVector> _columns;
+    };
+}
+
+#endif // CXXTOOLS_CSVREADER_H
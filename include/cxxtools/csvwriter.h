@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2016 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_CSVWRITER_H
+#define CXXTOOLS_CSVWRITER_H
+
+#include <cxxtools/formatter.h>
+#include <cxxtools/decomposer.h>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace cxxtools
+{
+    /**
+       Formatter, which writes utf-8 encoded csv data directly into a stream buffer.
+
+       The CsvWriter produces the same format as the CsvFormatter but does not
+       collect the rows in unicode strings. The columns of object members are
+       resolved once using the first object. Values are quoted and escaped
+       directly into the output and numbers are formatted without converting
+       them to strings first. Only values, which arrive in a different order
+       than the columns are buffered until the row is complete. A member,
+       which occurs twice in one object, raises a SerializationError.
+
+       Example:
+       \code
+        std::vector<MyObject> data = ...;
+        cxxtools::CsvWriter writer(std::cout);
+        writer.serialize(data);
+       \endcode
+     */
+    class CsvWriter : public Formatter
+    {
+            CsvWriter(const CsvWriter&);
+            CsvWriter& operator= (const CsvWriter&);
+
+        public:
+            explicit CsvWriter(std::ostream& os);
+
+            void selectColumn(const std::string& title);
+
+            void selectColumn(const std::string& memberName, const std::string& title);
+
+            /// Sets the utf-8 encoded delimiter.
+            void delimiter(const std::string& delimiter)
+            { _delimiter = delimiter; }
+
+            void delimiter(char delimiter)
+            { _delimiter = std::string(1, delimiter); }
+
+            void quote(char quote)
+            { _quote = quote; }
+
+            void lineEnding(const std::string& le)
+            { _lineEnding = le; }
+
+            template <typename T>
+            void serialize(const T& type)
+            {
+                Decomposer<T> decomposer;
+                decomposer.begin(type);
+                decomposer.format(*this);
+                finish();
+            }
+
+            virtual void addValueString(const std::string& name, const std::string& type,
+                                  const String& value);
+
+            virtual void addValueStdString(const std::string& name, const std::string& type,
+                                  const std::string& value);
+
+            virtual void addValueBool(const std::string& name, const std::string& type,
+                                  bool value);
+
+            virtual void addValueInt(const std::string& name, const std::string& type,
+                                  int_type value);
+
+            virtual void addValueUnsigned(const std::string& name, const std::string& type,
+                                  unsigned_type value);
+
+            virtual void addValueFloat(const std::string& name, const std::string& type,
+                                  long double value);
+
+            virtual void addNull(const std::string& name, const std::string& type);
+
+            virtual void beginArray(const std::string& name, const std::string& type);
+
+            virtual void finishArray();
+
+            virtual void beginObject(const std::string& name, const std::string& type);
+
+            virtual void beginMember(const std::string& name);
+
+            virtual void finishMember();
+
+            virtual void finishObject();
+
+            virtual void finish();
+
+        private:
+            int columnIndex();
+            void valueOut(const char* data, std::size_t size);
+            void titlesOut();
+            void dataOut();
+
+            std::streambuf* _sb;
+
+            bool _firstline;
+            bool _collectTitles;
+            unsigned _level;
+
+            std::string _delimiter;
+            char _quote;
+            std::string _lineEnding;
+
+            // titles and member names
+            struct Title
+            {
+                std::string _memberName;
+                std::string _title;
+            };
+
+            std::vector<Title> _titles;
+
+            // column of the n-th member of the objects; -1 if not selected
+            struct MemberColumn
+            {
+                std::string _memberName;
+                int _column;
+            };
+
+            std::vector<MemberColumn> _memberColumns;
+            unsigned _memberNo;
+            std::string _memberName;
+            // nesting level of members
+            unsigned _memberDepth;
+
+            // next column to be written into the output
+            unsigned _outColumn;
+            // next column for values without member name
+            unsigned _plainColumn;
+
+            // values, which could not be written yet
+            std::vector<std::string> _pending;
+            std::vector<bool> _pendingSet;
+
+            std::string _buffer;
+    };
+}
+
+#endif // CXXTOOLS_CSVWRITER_H
@@ -60,7 +60,7 @@ namespace cxxtools {
                     return *this;
 
                 const Slot& slot = other._target.slot();
-                _target = Connection( *this, slot.clone()  );
+                _target = Connection( *this, slot );
 
                 return *this;
             }
@@ -22,7 +22,7 @@ class Delegate : public DelegateBase
             /** Connects this object to the given slot and returns that Connection. */
             Connection connect(const BasicSlot<R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10>& slot)
             {
-                return Connection(*this, slot.clone() );
+                return Connection(*this, slot);
             }
 
             /**
@@ -71,6 +71,13 @@ class DelegateSlot : public BasicSlot<R, A1,A2,A3,A4,A5,A6,A7,A8,A9,A10>
             Slot* clone() const
             { return new DelegateSlot(*this); }
 
+            /** Creates a copy of this object in buffer, if it fits and this is not a subclass. */
+            Slot* cloneTo(void* buffer, std::size_t size) const
+            {
+                return sizeof(DelegateSlot) <= size && typeid(*this) == typeid(DelegateSlot)
+                    ? new (buffer) DelegateSlot(*this) : clone();
+            }
+
             /** Returns a pointer to this object's internal Callable. */
             virtual const void* callable() const
             {
@@ -167,7 +174,7 @@ class Delegate<R, A1,A2,A3,A4,A5,A6,A7,A8,A9,Void> : public DelegateBase
             /** Connects this object to the given slot and returns that Connection. */
             Connection connect(const BasicSlot<R,A1,A2,A3,A4,A5,A6,A7,A8,A9>& slot)
             {
-                return Connection(*this, slot.clone() );
+                return Connection(*this, slot);
             }
 
             /**
@@ -265,7 +272,7 @@ class Delegate<R, A1,A2,A3,A4,A5,A6,A7,A8,Void,Void> : public DelegateBase
             /** Connects this object to the given slot and returns that Connection. */
             Connection connect(const BasicSlot<R,A1,A2,A3,A4,A5,A6,A7,A8>& slot)
             {
-                return Connection(*this, slot.clone() );
+                return Connection(*this, slot);
             }
 
             /**
@@ -363,7 +370,7 @@ class Delegate<R, A1,A2,A3,A4,A5,A6,A7,Void,Void,Void> : public DelegateBase
             /** Connects this object to the given slot and returns that Connection. */
             Connection connect(const BasicSlot<R,A1,A2,A3,A4,A5,A6,A7>& slot)
             {
-                return Connection(*this, slot.clone() );
+                return Connection(*this, slot);
             }
 
             /**
@@ -461,7 +468,7 @@ class Delegate<R, A1,A2,A3,A4,A5,A6,Void,Void,Void,Void> : public DelegateBase
             /** Connects this object to the given slot and returns that Connection. */
             Connection connect(const BasicSlot<R,A1,A2,A3,A4,A5,A6>& slot)
             {
-                return Connection(*this, slot.clone() );
+                return Connection(*this, slot);
             }
 
             /**
@@ -559,7 +566,7 @@ class Delegate<R, A1,A2,A3,A4,A5,Void,Void,Void,Void,Void> : public DelegateBase
             /** Connects this object to the given slot and returns that Connection. */
             Connection connect(const BasicSlot<R,A1,A2,A3,A4,A5>& slot)
             {
-                return Connection(*this, slot.clone() );
+                return Connection(*this, slot);
             }
 
             /**
@@ -657,7 +664,7 @@ class Delegate<R, A1,A2,A3,A4,Void,Void,Void,Void,Void,Void> : public DelegateBa
             /** Connects this object to the given slot and returns that Connection. */
             Connection connect(const BasicSlot<R,A1,A2,A3,A4>& slot)
             {
-                return Connection(*this, slot.clone() );
+                return Connection(*this, slot);
             }
 
             /**
@@ -755,7 +762,7 @@ class Delegate<R, A1,A2,A3,Void,Void,Void,Void,Void,Void,Void> : public Delegate
             /** Connects this object to the given slot and returns that Connection. */
             Connection connect(const BasicSlot<R,A1,A2,A3>& slot)
             {
-                return Connection(*this, slot.clone() );
+                return Connection(*this, slot);
             }
 
             /**
@@ -853,7 +860,7 @@ class Delegate<R, A1,A2,Void,Void,Void,Void,Void,Void,Void,Void> : public Delega
             /** Connects this object to the given slot and returns that Connection. */
             Connection connect(const BasicSlot<R,A1,A2>& slot)
             {
-                return Connection(*this, slot.clone() );
+                return Connection(*this, slot);
             }
 
             /**
@@ -951,7 +958,7 @@ class Delegate<R, A1,Void,Void,Void,Void,Void,Void,Void,Void,Void> : public Dele
             /** Connects this object to the given slot and returns that Connection. */
             Connection connect(const BasicSlot<R,A1>& slot)
             {
-                return Connection(*this, slot.clone() );
+                return Connection(*this, slot);
             }
 
             /**
@@ -1049,7 +1056,7 @@ class Delegate<R, Void,Void,Void,Void,Void,Void,Void,Void,Void,Void> : public De
             /** Connects this object to the given slot and returns that Connection. */
             Connection connect(const BasicSlot<R>& slot)
             {
-                return Connection(*this, slot.clone() );
+                return Connection(*this, slot);
             }
 
             /**
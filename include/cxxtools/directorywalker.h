@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_DIRECTORYWALKER_H
+#define CXXTOOLS_DIRECTORYWALKER_H
+
+#include <cxxtools/fileinfo.h>
+#include <cxxtools/callable.h>
+#include <cxxtools/noncopyable.h>
+#include <cxxtools/timespan.h>
+#include <string>
+
+namespace cxxtools
+{
+    class DirectoryWalkerImpl;
+
+    /**
+       Walks recursively through a directory tree.
+
+       The directories are read in large batches and the type of the entries
+       is taken from the directory itself, so that no stat call is needed
+       for most file systems. Subdirectories are opened relative to their
+       parent directory.
+
+       Entries are returned in pre-order, i.e. a directory is returned before
+       its contents. Symbolic links are returned but not followed.
+
+       Pull interface:
+       \code
+        cxxtools::DirectoryWalker walker("/usr");
+        cxxtools::DirectoryWalker::Entry entry;
+        while (walker.next(entry))
+            std::cout << entry.path() << std::endl;
+       \endcode
+
+       Callback interface, which may process subtrees in parallel:
+       \code
+        void onEntry(const cxxtools::DirectoryWalker::Entry& entry);
+
+        cxxtools::DirectoryWalker walker("/usr");
+        walker.walk(cxxtools::callable(onEntry), 8);
+       \endcode
+     */
+    class DirectoryWalker : private NonCopyable
+    {
+        public:
+            class Entry
+            {
+                    friend class DirectoryWalkerImpl;
+
+                public:
+                    Entry()
+                        : _nameOffset(0),
+                          _type(FileInfo::Invalid),
+                          _depth(0),
+                          _size(0)
+                    { }
+
+                    /// Returns the path of the entry including the root path.
+                    const std::string& path() const
+                    { return _path; }
+
+                    /// Returns the name of the entry without the directory.
+                    const char* name() const
+                    { return _path.c_str() + _nameOffset; }
+
+                    FileInfo::Type type() const
+                    { return _type; }
+
+                    bool isDirectory() const
+                    { return _type == FileInfo::Directory; }
+
+                    bool isFile() const
+                    { return _type == FileInfo::File; }
+
+                    /// Returns the depth of the entry; entries of the root
+                    /// directory have depth 0.
+                    unsigned depth() const
+                    { return _depth; }
+
+                    /// Returns the size of the file.
+                    /// Valid only when statEntries is enabled.
+                    std::size_t size() const
+                    { return _size; }
+
+                    /// Returns the time of the last modification since the epoch.
+                    /// Valid only when statEntries is enabled.
+                    Timespan mtime() const
+                    { return _mtime; }
+
+                private:
+                    std::string _path;
+                    std::string::size_type _nameOffset;
+                    FileInfo::Type _type;
+                    unsigned _depth;
+                    std::size_t _size;
+                    Timespan _mtime;
+            };
+
+            /// Throws a SystemError when the directory can't be opened.
+            explicit DirectoryWalker(const std::string& path);
+
+            ~DirectoryWalker();
+
+            /// Skips entries starting with a dot. Hidden directories are not entered.
+            DirectoryWalker& skipHidden(bool sw = true);
+
+            /// Calls stat for every entry, so that size and mtime are set.
+            DirectoryWalker& statEntries(bool sw = true);
+
+            /// Limits the depth of the walk; 0 returns just the entries of the root directory.
+            DirectoryWalker& maxDepth(unsigned depth);
+
+            /// Fetches the next entry. Returns false, when all entries are read.
+            bool next(Entry& entry);
+
+            /**
+               Calls the callback for all remaining entries.
+
+               When threads is greater than 1, additional threads are started
+               and subtrees are spread across them. The callback is then called
+               concurrently from different threads. The order of the entries
+               is only kept within a subtree handled by one thread.
+
+               When a callback throws, the walk is stopped and the exception
+               is rethrown. Exceptions from helper threads are rethrown as
+               std::runtime_error with the message of the original exception.
+             */
+            void walk(const Callable<void, const Entry&>& cb, unsigned threads = 1);
+
+        private:
+            DirectoryWalkerImpl* _impl;
+    };
+}
+
+#endif // CXXTOOLS_DIRECTORYWALKER_H
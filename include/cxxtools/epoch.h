@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_EPOCH_H
+#define CXXTOOLS_EPOCH_H
+
+#include <cxxtools/atomicity.h>
+#include <cxxtools/noncopyable.h>
+
+namespace cxxtools
+{
+  /** Epoch based reclamation of shared data.
+
+      Data, which is read often and changed rarely, is published through
+      a pointer. Readers access it within a read section without taking a
+      lock. Writers copy the data, modify the copy and publish it. The old
+      data must not be destroyed until all readers, which may still see it,
+      have left their read section. Epoch::synchronize waits for them;
+      Epoch::deferDelete queues the object and destroys it after a later
+      synchronization, so that the writer need not wait. A background
+      thread synchronizes and destroys queued objects in batches, at the
+      latest about 100 ms after they were queued, so writers may queue
+      objects while holding locks. Objects left on program exit are
+      destroyed, when the static objects are destroyed.
+
+      Entering and leaving a read section costs a store into a per thread
+      record, which is not shared with other threads as long as no writer
+      waits. Read sections may be nested. They must be short, must not call
+      synchronize and should not call code, which takes locks held by a
+      thread calling synchronize.
+
+      Example:
+      \code
+        cxxtools::SnapshotPtr<std::vector<int> > values(new std::vector<int>());
+        cxxtools::Mutex writeMutex;
+
+        // reader
+        {
+          cxxtools::EpochReadLock lock;
+          std::vector<int>* v = values.get();
+          ...
+        }
+
+        // writer
+        {
+          cxxtools::MutexLock lock(writeMutex);
+          std::vector<int>* v = new std::vector<int>(*values.get());
+          v->push_back(42);
+          values.update(v);
+        }
+      \endcode
+   */
+  class Epoch
+  {
+      template <typename T>
+      static void destroy(void* obj)
+      { delete static_cast<T*>(obj); }
+
+    public:
+      /// Enters a read section.
+      static void enter();
+
+      /// Leaves a read section.
+      static void leave();
+
+      /// Waits until all read sections entered before the call are left.
+      /// Objects queued by deferDelete before the call are destroyed.
+      static void synchronize();
+
+      /// Calls fn(arg) after all read sections, which are active now, are left.
+      static void defer(void (*fn)(void*), void* arg);
+
+      /// Deletes the object after all read sections, which are active now, are left.
+      template <typename T>
+      static void deferDelete(T* obj)
+      { defer(&Epoch::destroy<T>, const_cast<void*>(static_cast<const void*>(obj))); }
+
+      /// Returns the number of objects queued by defer or deferDelete.
+      static unsigned pending();
+  };
+
+  /// Enters a read section in the constructor and leaves it in the destructor.
+  class EpochReadLock : private NonCopyable
+  {
+    public:
+      EpochReadLock()
+      { Epoch::enter(); }
+
+      ~EpochReadLock()
+      { Epoch::leave(); }
+  };
+
+  /** A pointer to a snapshot of data shared between threads.
+
+      The object pointed to is treated as immutable. Readers fetch the
+      pointer with get() within a read section. Writers create a new object
+      and publish it with update(). The old object is destroyed when no
+      reader may see it any more. Writers must be serialized by the caller.
+   */
+  template <typename T>
+  class SnapshotPtr : private NonCopyable
+  {
+      void* volatile _ptr;
+
+    public:
+      explicit SnapshotPtr(T* ptr = 0)
+        : _ptr(ptr)
+      { }
+
+      /// Deletes the current object. No reader may use it any more.
+      ~SnapshotPtr()
+      { delete static_cast<T*>(_ptr); }
+
+      /// Returns the current object. It may be used until the read section is left.
+      T* get() const
+      { return static_cast<T*>(_ptr); }
+
+      T* operator->() const
+      { return get(); }
+
+      T& operator*() const
+      { return *get(); }
+
+      /// Publishes a new object and deletes the old one when no reader uses it.
+      void update(T* ptr)
+      {
+        T* old = exchange(ptr);
+        if (old)
+          Epoch::deferDelete(old);
+      }
+
+      /// Publishes a new object and returns the old one.
+      /// The caller is responsible to destroy it after Epoch::synchronize.
+      T* exchange(T* ptr)
+      { return static_cast<T*>(atomicExchange(_ptr, const_cast<void*>(static_cast<const void*>(ptr)))); }
+  };
+}
+
+#endif // CXXTOOLS_EPOCH_H
@@ -30,6 +30,8 @@
 #define cxxtools_EVENT_H
 
 #include <typeinfo>
+#include <cstddef>
+#include <new>
 
 namespace cxxtools
 {
@@ -39,7 +41,8 @@ namespace cxxtools
         Specific Event objects, subclass from Event and implement the clone()
         and typeInfo() methods. The first is used to deep copy event objects
         for example in an EventLoop and the latter one is used to dispatch
-        events by type.
+        events by type. Small events may additionally implement cloneTo(),
+        which copies the event into a given buffer without allocating memory.
      */
     class Event
     {
@@ -54,6 +57,17 @@ namespace cxxtools
             virtual void destroy() = 0;
 
             virtual const std::type_info& typeInfo() const = 0;
+
+            /** \brief Copies the event into a buffer.
+
+                The buffer is aligned for any type. Returns 0, if the event
+                does not fit into the buffer. A copy created with cloneTo is
+                released by calling its destructor instead of destroy().
+             */
+            virtual Event* cloneTo(void* /*buffer*/, std::size_t /*size*/) const
+            {
+                return 0;
+            }
     };
 
     template <typename T>
@@ -82,6 +96,13 @@ namespace cxxtools
             {
                 delete this;
             }
+
+            virtual Event* cloneTo(void* buffer, std::size_t size) const
+            {
+                if (sizeof(T) > size)
+                    return 0;
+                return new (buffer) T(*static_cast<const T*>(this));
+            }
     };
 
 } // namespace cxxtools
@@ -55,6 +55,20 @@ class FileDevice : public IODevice
 
         size_t size() const;
 
+        /** Enables or disables io_uring for asynchronous reads and writes.
+
+            When enabled and supported by the kernel, beginRead and beginWrite
+            of regular files are submitted to the io_uring of the thread and
+            the completion is signaled through inputReady and outputReady.
+            Otherwise the data is read or written, when the device is ready,
+            which is always the case for regular files. It is enabled by
+            default.
+         */
+        static void ioUring(bool sw);
+
+        /// Returns true, if io_uring is enabled and supported.
+        static bool ioUring();
+
     protected:
         size_t onBeginRead(char* buffer, size_t n, bool& eof);
 
@@ -77,12 +91,29 @@ class FileDevice : public IODevice
 
         size_t onWrite(const char* buffer, size_t count);
 
+        size_t onReadv(const struct iovec* iov, size_t iovcnt, bool& eof);
+
+        size_t onBeginWritev(const struct iovec* iov, size_t iovcnt);
+
+        size_t onWritev(const struct iovec* iov, size_t iovcnt);
+
         void onCancel();
 
         size_t onPeek(char* buffer, size_t count);
 
         void onSync() const;
 
+        bool onWait(Timespan timeout);
+
+        void onAttach(SelectorBase& sb);
+
+        void onDetach(SelectorBase& sb);
+
+    public:
+        SelectableImpl& simpl();
+
+        IODeviceImpl& ioimpl();
+
     private:
         std::string _path;
 };
@@ -67,6 +67,13 @@ class FunctionSlot : public BasicSlot<R, A1,A2,A3,A4,A5,A6,A7,A8,A9,A10>
         Slot* clone() const
         { return new FunctionSlot(*this); }
 
+        /** Creates a copy of this object in buffer, if it fits and this is not a subclass. */
+        Slot* cloneTo(void* buffer, std::size_t size) const
+        {
+            return sizeof(FunctionSlot) <= size && typeid(*this) == typeid(FunctionSlot)
+                ? new (buffer) FunctionSlot(*this) : clone();
+        }
+
         virtual void onConnect(const Connection& /*c*/)
         { }
 
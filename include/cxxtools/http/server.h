@@ -31,6 +31,7 @@
 
 #include <cxxtools/signal.h>
 #include <cxxtools/timespan.h>
+#include <cxxtools/net/socketoptions.h>
 #include <string>
 
 namespace cxxtools
@@ -83,6 +84,11 @@ class Server
         unsigned maxThreads() const;
         void maxThreads(unsigned m);
 
+        /// Sets the options for the sockets of the following listen calls
+        /// and the connections accepted there.
+        void socketOptions(const net::SocketOptions& options);
+        const net::SocketOptions& socketOptions() const;
+
         enum Runmode {
           Stopped,
           Starting,
@@ -82,6 +82,10 @@ class Service
 
         void waitIdle();
 
+        /// Keeps waitIdle from returning until release is called.
+        void acquire();
+        void release();
+
     protected:
         virtual Responder* createResponder(const Request&) = 0;
         virtual void releaseResponder(Responder*) = 0;
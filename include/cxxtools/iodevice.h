@@ -35,6 +35,7 @@
 #include <cxxtools/selectable.h>
 #include <limits>
 #include <ios>
+#include <sys/uio.h>
 
 namespace cxxtools {
 
@@ -145,6 +146,41 @@ class IODevice : public Selectable
          */
         size_t write(const char* buffer, size_t n);
 
+        //! @brief Read data from I/O device into multiple buffers
+        /**
+            Reads up to the total size of the buffers and fills them in
+            order (scatter read). Returns the number of bytes read like
+            read(). In asynchronous mode only the first non empty buffer
+            is filled.
+
+            \param iov array of buffers.
+            \param iovcnt number of buffers.
+            \return number of bytes read, which may be less than requested.
+            \throw IOError
+         */
+        size_t readv(const struct iovec* iov, size_t iovcnt);
+
+        /**
+            Starts an asynchronous write of multiple buffers (gather write).
+            The buffers and the iovec array must stay valid until endWrite
+            is called. Nothing is done, when all buffers are empty.
+         */
+        size_t beginWritev(const struct iovec* iov, size_t iovcnt);
+
+        //! @brief Write data from multiple buffers to I/O device
+        /**
+            Writes the buffers in order with a single system call, where
+            the device supports it (gather write). Returns the number of
+            bytes written, which may be less than the total size of the
+            buffers.
+
+            \param iov array of buffers.
+            \param iovcnt number of buffers.
+            \return number of bytes written.
+            \throw IOError
+         */
+        size_t writev(const struct iovec* iov, size_t iovcnt);
+
         /** @brief Cancels asynchronous reading and writing
         */
         void cancel();
@@ -233,7 +269,7 @@ class IODevice : public Selectable
         { return _rbuf != 0; }
 
         bool writing() const
-        { return _wbuf != 0; }
+        { return _wbuf != 0 || _wiov != 0; }
 
         char* rbuf() const
         { return _rbuf; }
@@ -253,6 +289,13 @@ class IODevice : public Selectable
         size_t wavail() const
         { return _wavail; }
 
+        //! @brief Returns the buffers of a pending beginWritev or null.
+        const struct iovec* wiov() const
+        { return _wiov; }
+
+        size_t wiovcnt() const
+        { return _wiovcnt; }
+
     protected:
         //! @brief Default Constructor
         IODevice();
@@ -273,6 +316,26 @@ class IODevice : public Selectable
 
         virtual void onCancel() = 0;
 
+        //! @brief Read bytes from device into multiple buffers
+        /**
+            The default implementation reads into the first non empty
+            buffer using onRead.
+         */
+        virtual size_t onReadv(const struct iovec* iov, size_t iovcnt, bool& eof);
+
+        /**
+            The default implementation writes the first non empty buffer
+            using onBeginWrite.
+         */
+        virtual size_t onBeginWritev(const struct iovec* iov, size_t iovcnt);
+
+        //! @brief Write bytes from multiple buffers to device
+        /**
+            The default implementation writes the first non empty buffer
+            using onWrite.
+         */
+        virtual size_t onWritev(const struct iovec* iov, size_t iovcnt);
+
         //! @brief Read data from I/O device without consuming them
         virtual size_t onPeek(char*, size_t)
         { return 0; }
@@ -310,6 +373,8 @@ class IODevice : public Selectable
         const char* _wbuf;
         size_t _wbuflen;
         size_t _wavail;
+        const struct iovec* _wiov;
+        size_t _wiovcnt;
         void* _reserved;
 };
 
@@ -30,6 +30,8 @@
 #define CXXTOOLS_JSON_RPCCLIENT_H
 
 #include <cxxtools/remoteclient.h>
+#include <cxxtools/decomposer.h>
+#include <cxxtools/string.h>
 #include <string>
 
 namespace cxxtools
@@ -104,6 +106,115 @@ class RpcClient : public RemoteClient
 
         void call(IComposer& r, IRemoteProcedure& method, IDecomposer** argv, unsigned argc);
 
+        /** Starts a batch request.
+
+            Calls started with RemoteProcedure::begin and notifications are
+            collected until endBatch is called and then sent to the server as
+            a single json rpc 2.0 batch. The server may execute the calls of a
+            batch in parallel.
+
+            When a selector is set, endBatch returns immediately and each
+            procedure signals its result when the reply arrives. Without a
+            selector endBatch waits for the reply and the results are
+            available through RemoteProcedure::result.
+
+            The procedures must not be destroyed before the batch is finished.
+
+            Example:
+            \code
+              cxxtools::json::RpcClient client("localhost", 7004);
+              cxxtools::RemoteProcedure<int, int, int> add1(client, "add");
+              cxxtools::RemoteProcedure<int, int, int> add2(client, "add");
+
+              client.beginBatch();
+              add1.begin(1, 2);
+              add2.begin(3, 4);
+              client.notify("log", std::string("two calls sent"));
+              client.endBatch();
+
+              std::cout << add1.result() << ' ' << add2.result() << std::endl;
+            \endcode
+         */
+        void beginBatch();
+
+        /// Sends the calls collected since beginBatch.
+        void endBatch();
+
+        /** Sends a notification.
+
+            A notification is a call without id. The server executes it but
+            does not send a reply, so the client does not wait for it.
+         */
+        void notify(const String& method, IDecomposer** argv, unsigned argc);
+
+        void notify(const std::string& method)
+        { notify(String(method), 0, 0); }
+
+        template <typename A1>
+        void notify(const std::string& method, const A1& a1)
+        {
+            Decomposer<A1> d1;
+            d1.begin(a1);
+            IDecomposer* argv[1] = { &d1 };
+            notify(String(method), argv, 1);
+        }
+
+        template <typename A1, typename A2>
+        void notify(const std::string& method, const A1& a1, const A2& a2)
+        {
+            Decomposer<A1> d1;
+            Decomposer<A2> d2;
+            d1.begin(a1);
+            d2.begin(a2);
+            IDecomposer* argv[2] = { &d1, &d2 };
+            notify(String(method), argv, 2);
+        }
+
+        template <typename A1, typename A2, typename A3>
+        void notify(const std::string& method, const A1& a1, const A2& a2, const A3& a3)
+        {
+            Decomposer<A1> d1;
+            Decomposer<A2> d2;
+            Decomposer<A3> d3;
+            d1.begin(a1);
+            d2.begin(a2);
+            d3.begin(a3);
+            IDecomposer* argv[3] = { &d1, &d2, &d3 };
+            notify(String(method), argv, 3);
+        }
+
+        template <typename A1, typename A2, typename A3, typename A4>
+        void notify(const std::string& method, const A1& a1, const A2& a2, const A3& a3, const A4& a4)
+        {
+            Decomposer<A1> d1;
+            Decomposer<A2> d2;
+            Decomposer<A3> d3;
+            Decomposer<A4> d4;
+            d1.begin(a1);
+            d2.begin(a2);
+            d3.begin(a3);
+            d4.begin(a4);
+            IDecomposer* argv[4] = { &d1, &d2, &d3, &d4 };
+            notify(String(method), argv, 4);
+        }
+
+        template <typename A1, typename A2, typename A3, typename A4, typename A5>
+        void notify(const std::string& method, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5)
+        {
+            Decomposer<A1> d1;
+            Decomposer<A2> d2;
+            Decomposer<A3> d3;
+            Decomposer<A4> d4;
+            Decomposer<A5> d5;
+            d1.begin(a1);
+            d2.begin(a2);
+            d3.begin(a3);
+            d4.begin(a4);
+            d5.begin(a5);
+            IDecomposer* argv[5] = { &d1, &d2, &d3, &d4, &d5 };
+            notify(String(method), argv, 5);
+        }
+
         Milliseconds timeout() const;
         void timeout(Milliseconds t);
 
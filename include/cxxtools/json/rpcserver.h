@@ -31,6 +31,7 @@
 
 #include <string>
 #include <cxxtools/signal.h>
+#include <cxxtools/net/socketoptions.h>
 #include <cxxtools/serviceregistry.h>
 
 namespace cxxtools
@@ -63,6 +64,11 @@ namespace cxxtools
                 unsigned maxThreads() const;
                 void maxThreads(unsigned m);
 
+                /// Sets the options for the sockets of the following listen
+                /// calls and the connections accepted there.
+                void socketOptions(const net::SocketOptions& options);
+                const net::SocketOptions& socketOptions() const;
+
                 enum Runmode {
                   Stopped,
                   Starting,
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_LIGHTMUTEX_H
+#define CXXTOOLS_LIGHTMUTEX_H
+
+#include <cxxtools/noncopyable.h>
+#include <cxxtools/timespan.h>
+#include <atomic>
+
+namespace cxxtools
+{
+    /** @brief A mutex, which needs no heap allocation.
+
+        The LightMutex has the interface of the Mutex but is implemented as
+        a single integer. Locking and unlocking without contention is a
+        single atomic operation. Threads, which have to wait, sleep in the
+        kernel using futexes on Linux. On other systems they give up their
+        time slice until the mutex is released.
+
+        The mutex is not recursive.
+
+        The class needs C++11.
+     */
+    class LightMutex : private NonCopyable
+    {
+            // 0: unlocked; 1: locked; 2: locked and there may be waiting threads
+            std::atomic<int> _state;
+
+            void lockSlow(int state);
+            void wake();
+
+        public:
+            LightMutex()
+                : _state(0)
+            { }
+
+            void lock()
+            {
+                int state = 0;
+                if (!_state.compare_exchange_strong(state, 1, std::memory_order_acquire, std::memory_order_relaxed))
+                    lockSlow(state);
+            }
+
+            bool tryLock()
+            {
+                int state = 0;
+                return _state.compare_exchange_strong(state, 1, std::memory_order_acquire, std::memory_order_relaxed);
+            }
+
+            void unlock()
+            {
+                if (_state.exchange(0, std::memory_order_release) == 2)
+                    wake();
+            }
+
+            bool unlockNoThrow()
+            {
+                unlock();
+                return true;
+            }
+    };
+
+    /// Scoped lock for the LightMutex like the MutexLock for the Mutex.
+    class LightMutexLock : private NonCopyable
+    {
+        public:
+            LightMutexLock(LightMutex& m, bool doLock = true, bool isLocked = false)
+                : _mutex(m),
+                  _isLocked(isLocked)
+            {
+                if (doLock)
+                    lock();
+            }
+
+            ~LightMutexLock()
+            {
+                if (_isLocked)
+                    _mutex.unlock();
+            }
+
+            void lock()
+            {
+                if (!_isLocked)
+                {
+                    _mutex.lock();
+                    _isLocked = true;
+                }
+            }
+
+            void unlock()
+            {
+                if (_isLocked)
+                {
+                    _mutex.unlock();
+                    _isLocked = false;
+                }
+            }
+
+            LightMutex& mutex()
+            { return _mutex; }
+
+            const LightMutex& mutex() const
+            { return _mutex; }
+
+        private:
+            LightMutex& _mutex;
+            bool _isLocked;
+    };
+
+    /** @brief A condition variable for the LightMutex, which needs no heap allocation.
+
+        The interface is the same as of the Condition. Signaling a condition,
+        which no thread waits for, does not enter the kernel.
+
+        The class needs C++11.
+     */
+    class LightCondition : private NonCopyable
+    {
+            std::atomic<unsigned> _sequence;
+            std::atomic<unsigned> _waiters;
+
+            void wake(int count);
+
+        public:
+            LightCondition()
+                : _sequence(0),
+                  _waiters(0)
+            { }
+
+            void wait(LightMutex& mtx);
+
+            void wait(LightMutexLock& m)
+            { wait(m.mutex()); }
+
+            /// Waits at most the given time. Returns false if a timeout occurred.
+            bool wait(LightMutex& mtx, const Milliseconds& ts);
+
+            bool wait(LightMutexLock& m, const Milliseconds& ts)
+            { return wait(m.mutex(), ts); }
+
+            /// Unblocks a single waiting thread.
+            void signal()
+            {
+                _sequence.fetch_add(1, std::memory_order_seq_cst);
+                if (_waiters.load(std::memory_order_seq_cst) > 0)
+                    wake(1);
+            }
+
+            /// Unblocks all waiting threads.
+            void broadcast()
+            {
+                _sequence.fetch_add(1, std::memory_order_seq_cst);
+                if (_waiters.load(std::memory_order_seq_cst) > 0)
+                    wake(-1);
+            }
+    };
+}
+
+#endif // CXXTOOLS_LIGHTMUTEX_H
@@ -29,60 +29,96 @@
 #ifndef CXXTOOLS_LRUCACHE_H
 #define CXXTOOLS_LRUCACHE_H
 
-#include <map>
-#include <limits>
+#include <cxxtools/cacheindex.h>
+#include <utility>
 
 namespace cxxtools
 {
   /**
      Implements a lru cache
+
+     The elements are linked in a list ordered by the last access, so that
+     moving and evicting the least recently used element takes constant
+     time. The elements are found using the Index, which is a std::map by
+     default (see OrderedCacheIndex), so that lookup takes logarithmic time.
+     Pass a HashedCacheIndex to find them in a hash table in constant average
+     time instead.
    */
 
-  template <typename Key, typename Value>
+  template <typename Key, typename Value, typename Index = OrderedCacheIndex<Key> >
   class LruCache
   {
       struct Data
       {
-        unsigned serial;
         Value value;
+        const Key* key;
+        Data* newer;
+        Data* older;
         Data() { }
-        Data(unsigned serial_, const Value& value_)
-          : serial(serial_),
-            value(value_)
+        explicit Data(const Value& value_)
+          : value(value_),
+            key(0),
+            newer(0),
+            older(0)
             { }
       };
 
-      typedef std::map<Key, Data> DataType;
+      typedef typename Index::template Map<Data>::type DataType;
       DataType data;
 
       typename DataType::size_type maxElements;
-      unsigned serial;
+      Data* newest;
+      Data* oldest;
       unsigned hits;
       unsigned misses;
 
-      unsigned _nextSerial()
+      void _unlink(Data* d)
       {
-        if (serial == std::numeric_limits<unsigned>::max())
-        {
-          for (typename DataType::iterator it = data.begin(); it != data.end(); ++it)
-            it->second.serial = 0;
-          serial = 1;
-        }
+        if (d->newer)
+          d->newer->older = d->older;
+        else
+          newest = d->older;
 
-        return serial++;
+        if (d->older)
+          d->older->newer = d->newer;
+        else
+          oldest = d->newer;
       }
 
-      typename DataType::iterator _getOldest()
+      void _pushNewest(Data* d)
       {
-        typename DataType::iterator foundElement = data.begin();
+        d->newer = 0;
+        d->older = newest;
+        if (newest)
+          newest->newer = d;
+        else
+          oldest = d;
+        newest = d;
+      }
 
-        typename DataType::iterator it = data.begin();
+      void _touch(Data* d)
+      {
+        if (d != newest)
+        {
+          _unlink(d);
+          _pushNewest(d);
+        }
+      }
 
-        for (++it; it != data.end(); ++it)
-          if (it->second.serial < foundElement->second.serial)
-            foundElement = it;
+      void _erase(Data* d)
+      {
+        _unlink(d);
+        data.erase(data.find(*d->key));
+      }
 
-        return foundElement;
+      void _copy(const LruCache& c)
+      {
+        for (const Data* d = c.oldest; d; d = d->newer)
+        {
+          typename DataType::iterator it = data.insert(typename DataType::value_type(*d->key, Data(d->value))).first;
+          it->second.key = &it->first;
+          _pushNewest(&it->second);
+        }
       }
 
     public:
@@ -91,11 +127,33 @@ namespace cxxtools
 
       explicit LruCache(size_type maxElements_)
         : maxElements(maxElements_),
-          serial(0),
+          newest(0),
+          oldest(0),
           hits(0),
           misses(0)
         { }
 
+      LruCache(const LruCache& c)
+        : maxElements(c.maxElements),
+          newest(0),
+          oldest(0),
+          hits(c.hits),
+          misses(c.misses)
+        { _copy(c); }
+
+      LruCache& operator= (const LruCache& c)
+      {
+        if (this != &c)
+        {
+          clear();
+          maxElements = c.maxElements;
+          hits = c.hits;
+          misses = c.misses;
+          _copy(c);
+        }
+        return *this;
+      }
+
       /// returns the number of elements currently in the cache
       size_type size() const        { return data.size(); }
 
@@ -106,7 +164,7 @@ namespace cxxtools
       {
         maxElements = maxElements_;
         while (data.size() > maxElements)
-          data.erase(_getOldest());
+          _erase(oldest);
       }
 
       /// removes a element from the cache and returns true, if found
@@ -116,6 +174,7 @@ namespace cxxtools
         if (it == data.end())
           return false;
 
+        _unlink(&it->second);
         data.erase(it);
         return true;
       }
@@ -124,6 +183,7 @@ namespace cxxtools
       void clear(bool stats = false)
       {
         data.clear();
+        newest = oldest = 0;
         if (stats)
           hits = misses = 0;
       }
@@ -136,17 +196,17 @@ namespace cxxtools
         typename DataType::iterator it = data.find(key);
         if (it == data.end())
         {
-          if (data.size() >= maxElements)
-            data.erase(_getOldest());
+          if (data.size() >= maxElements && oldest)
+            _erase(oldest);
 
-          it = data.insert(data.begin(),
-            typename DataType::value_type(key,
-              Data(_nextSerial(), value)));
+          it = data.insert(typename DataType::value_type(key, Data(value))).first;
+          it->second.key = &it->first;
+          _pushNewest(&it->second);
         }
         else
         {
           // element found
-          it->second.serial = _nextSerial();
+          _touch(&it->second);
         }
 
         return it->second.value;
@@ -161,12 +221,11 @@ namespace cxxtools
           return 0;
         }
 
-        it->second.serial = _nextSerial();
+        _touch(&it->second);
 
         ++hits;
         return &it->second.value;
       }
-
       /// returns a pair of values - a flag, if the value was found and the
       /// value if found or the passed default otherwise. If the value is
       /// found it is a cache hit and pushed to the top of the list.
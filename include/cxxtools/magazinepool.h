@@ -0,0 +1,348 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_MAGAZINEPOOL_H
+#define CXXTOOLS_MAGAZINEPOOL_H
+
+#include <cxxtools/pool.h>
+#include <cxxtools/mutex.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace cxxtools
+{
+  /** A pool of objects for many threads.
+
+      The MagazinePool has the same interface as the Pool. Instead of one
+      list of free objects guarded by a mutex it keeps small stacks of free
+      objects (magazines) per thread. A thread takes objects from and returns
+      objects into its own magazines. Only when they are empty or full, a
+      whole magazine is exchanged with a global lock free list of full
+      magazines.
+
+      Threads are mapped to a fixed number of slots; each slot holds 2
+      magazines and is guarded by a SpinMutex, which is normally used by one
+      thread only. The default number of slots is the number of hardware
+      threads.
+
+      The maximum number of spare objects is kept like in Pool. Objects are
+      created by the creator under a mutex, so that the creator need not be
+      thread safe.
+
+      The class needs C++11.
+   */
+  template <typename ObjectType,
+            typename CreatorType = DefaultCreator<ObjectType>,
+            template <class> class OwnershipPolicy = RefLinked,
+            template <class> class DestroyPolicy = DeletePolicy>
+  class MagazinePool : private NonCopyable
+  {
+    public:
+      typedef PoolPtr<MagazinePool, ObjectType, OwnershipPolicy, DestroyPolicy> Ptr;
+      friend class PoolPtr<MagazinePool, ObjectType, OwnershipPolicy, DestroyPolicy>;
+
+    private:
+      static const unsigned MagazineSize = 16;
+
+      struct Magazine
+      {
+        Magazine* next;
+        unsigned count;
+        ObjectType* objects[MagazineSize];
+
+        Magazine()
+          : next(0),
+            count(0)
+            { }
+      };
+
+      struct Slot
+      {
+        SpinMutex mutex;
+        Magazine* loaded;
+        Magazine* previous;
+        // keeps the slots in different cache lines
+        char padding[64];
+
+        Slot()
+          : loaded(0),
+            previous(0)
+            { }
+      };
+
+      Slot* slots;
+      unsigned numSlots;
+
+      // list of full magazines; only the whole list is taken at once, so
+      // that the list does not suffer from the ABA problem
+      std::atomic<Magazine*> depot;
+
+      std::atomic<unsigned> spare;
+      std::atomic<unsigned> maxSpare;
+
+      Mutex creatorMutex;
+      CreatorType creator;
+
+      static unsigned threadIndex()
+      {
+        static std::atomic<unsigned> nextIndex(0);
+        static thread_local unsigned index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+        return index;
+      }
+
+      Slot& slot()
+      { return slots[threadIndex() % numSlots]; }
+
+      void pushDepot(Magazine* first, Magazine* last)
+      {
+        last->next = depot.load(std::memory_order_relaxed);
+        while (!depot.compare_exchange_weak(last->next, first,
+                  std::memory_order_release, std::memory_order_relaxed))
+          ;
+      }
+
+      // takes one full magazine from the depot
+      Magazine* popDepot()
+      {
+        Magazine* first = depot.exchange(0, std::memory_order_acquire);
+        if (first == 0)
+          return 0;
+
+        Magazine* rest = first->next;
+        if (rest)
+        {
+          Magazine* last = rest;
+          while (last->next)
+            last = last->next;
+          pushDepot(rest, last);
+        }
+
+        first->next = 0;
+        return first;
+      }
+
+      ObjectType* take()
+      {
+        Slot& s = slot();
+        SpinLock lock(s.mutex);
+
+        if (s.loaded == 0 || s.loaded->count == 0)
+        {
+          if (s.previous && s.previous->count > 0)
+          {
+            std::swap(s.loaded, s.previous);
+          }
+          else
+          {
+            Magazine* m = popDepot();
+            if (m == 0)
+              return 0;
+
+            // keep one empty magazine for returned objects
+            if (s.previous == 0)
+              s.previous = s.loaded;
+            else
+              delete s.loaded;
+            s.loaded = m;
+          }
+        }
+
+        return s.loaded->objects[--s.loaded->count];
+      }
+
+      void give(ObjectType* object)
+      {
+        Slot& s = slot();
+        SpinLock lock(s.mutex);
+
+        if (s.loaded == 0)
+          s.loaded = new Magazine();
+
+        if (s.loaded->count == MagazineSize)
+        {
+          if (s.previous && s.previous->count < MagazineSize)
+          {
+            std::swap(s.loaded, s.previous);
+          }
+          else
+          {
+            if (s.previous)
+              pushDepot(s.previous, s.previous);
+            s.previous = s.loaded;
+            s.loaded = new Magazine();
+          }
+        }
+
+        s.loaded->objects[s.loaded->count++] = object;
+      }
+
+      bool put(Ptr& po) // returns true, if the object was put into a magazine
+      {
+        unsigned max = maxSpare.load(std::memory_order_relaxed);
+        if (spare.fetch_add(1, std::memory_order_relaxed) >= max && max != 0)
+        {
+          spare.fetch_sub(1, std::memory_order_relaxed);
+          return false;
+        }
+
+        give(po.getPointer());
+        return true;
+      }
+
+      // removes all magazines from the slots and the depot
+      void collect(std::vector<ObjectType*>& objects)
+      {
+        Magazine* m = depot.exchange(0, std::memory_order_acquire);
+        while (m)
+        {
+          Magazine* next = m->next;
+          objects.insert(objects.end(), m->objects, m->objects + m->count);
+          delete m;
+          m = next;
+        }
+
+        for (unsigned n = 0; n < numSlots; ++n)
+        {
+          Slot& s = slots[n];
+          SpinLock lock(s.mutex);
+          if (s.loaded)
+          {
+            objects.insert(objects.end(), s.loaded->objects, s.loaded->objects + s.loaded->count);
+            s.loaded->count = 0;
+          }
+          if (s.previous)
+          {
+            objects.insert(objects.end(), s.previous->objects, s.previous->objects + s.previous->count);
+            s.previous->count = 0;
+          }
+        }
+      }
+
+    public:
+      explicit MagazinePool(unsigned maxSpare_ = 0, CreatorType creator_ = CreatorType(), unsigned slots_ = 0)
+        : numSlots(slots_ > 0 ? slots_ : std::max(std::thread::hardware_concurrency(), 1u)),
+          depot(0),
+          spare(0),
+          maxSpare(maxSpare_),
+          creator(creator_)
+      {
+        slots = new Slot[numSlots];
+      }
+
+      explicit MagazinePool(CreatorType creator_)
+        : numSlots(std::max(std::thread::hardware_concurrency(), 1u)),
+          depot(0),
+          spare(0),
+          maxSpare(0),
+          creator(creator_)
+      {
+        slots = new Slot[numSlots];
+      }
+
+      ~MagazinePool()
+      {
+        drop();
+        for (unsigned n = 0; n < numSlots; ++n)
+        {
+          delete slots[n].loaded;
+          delete slots[n].previous;
+        }
+        delete[] slots;
+      }
+
+      Ptr get()
+      {
+        ObjectType* object = take();
+        if (object)
+        {
+          spare.fetch_sub(1, std::memory_order_relaxed);
+        }
+        else
+        {
+          MutexLock lock(creatorMutex);
+          object = creator();
+        }
+
+        Ptr po(object);
+        po.setPool(this);
+        return po;
+      }
+
+      /// Destroys spare objects, so that at most keep objects remain.
+      void drop(unsigned keep = 0)
+      {
+        std::vector<ObjectType*> objects;
+        collect(objects);
+
+        for (unsigned n = 0; n < objects.size(); ++n)
+        {
+          if (n < keep)
+          {
+            give(objects[n]);
+          }
+          else
+          {
+            spare.fetch_sub(1, std::memory_order_relaxed);
+            DestroyPolicy<ObjectType>::destroy(objects[n]);
+          }
+        }
+      }
+
+      unsigned getMaximumSize() const
+      { return maxSpare.load(std::memory_order_relaxed); }
+
+      /// Returns the number of spare objects.
+      unsigned size() const
+      { return spare.load(std::memory_order_relaxed); }
+
+      unsigned getCurrentSize() const
+      { return size(); }
+
+      void setMaximumSize(unsigned s)
+      {
+        maxSpare.store(s, std::memory_order_relaxed);
+        if (size() > s)
+          drop(s);
+      }
+
+      unsigned getSlots() const
+      { return numSlots; }
+
+      CreatorType& getCreator()
+      { return creator; }
+
+      const CreatorType& getCreator() const
+      { return creator; }
+
+  };
+
+}
+
+#endif // CXXTOOLS_MAGAZINEPOOL_H
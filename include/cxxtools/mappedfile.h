@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_MAPPEDFILE_H
+#define CXXTOOLS_MAPPEDFILE_H
+
+#include <cxxtools/noncopyable.h>
+#include <iostream>
+#include <string>
+
+namespace cxxtools
+{
+    /**
+       Read only view of a file, which is mapped into memory.
+
+       The kernel is told how the data is accessed, so that it reads ahead
+       for sequential access and does not for random access. Files of at
+       least hugePageThreshold bytes are mapped to an address aligned to a
+       huge page and transparent huge pages are requested for them, so that
+       scanning a large file needs less page table entries and TLB misses.
+       The mapping is file backed, so the kernel uses huge pages only if it
+       supports them for the page cache of the file system (on Linux
+       CONFIG_READ_ONLY_THP_FOR_FS or a tmpfs with huge pages enabled).
+       Otherwise the request has no effect.
+
+       Example:
+       \code
+        cxxtools::MappedFile file("data.json");
+        std::string s(file.begin(), file.end());
+       \endcode
+     */
+    class MappedFile : private NonCopyable
+    {
+        public:
+            enum Advice
+            {
+                Normal,
+                Sequential,   ///< read ahead aggressively
+                Random,       ///< do not read ahead
+                WillNeed      ///< start reading the data at once
+            };
+
+            /// Files of this size or more are mapped using huge pages if possible.
+            static const std::size_t hugePageThreshold;
+
+            MappedFile();
+
+            /// Maps the file. Throws FileNotFound or AccessFailed, if the
+            /// file cannot be opened.
+            explicit MappedFile(const std::string& fname, Advice advice = Sequential);
+
+            ~MappedFile();
+
+            void open(const std::string& fname, Advice advice = Sequential);
+
+            void close();
+
+            bool isOpen() const
+            { return _isOpen; }
+
+            /// Gives the kernel a hint how the whole file is accessed.
+            void advise(Advice advice);
+
+            /// Gives the kernel a hint how a part of the file is accessed.
+            void advise(Advice advice, std::size_t offset, std::size_t size);
+
+            /// Returns true, if the kernel accepted the request for huge
+            /// pages. It does not tell, whether the mapping is really backed
+            /// by huge pages; see /proc/self/smaps for that.
+            bool hugePages() const
+            { return _hugePages; }
+
+            const char* data() const
+            { return _data; }
+
+            std::size_t size() const
+            { return _size; }
+
+            const char* begin() const
+            { return _data; }
+
+            const char* end() const
+            { return _data + _size; }
+
+        private:
+            const char* _data;
+            std::size_t _size;
+            bool _isOpen;
+            bool _hugePages;
+    };
+
+    /**
+       Stream buffer, which reads directly from a memory region.
+
+       The whole region is the get area of the stream buffer, so the
+       characters are never copied into a buffer. Parsers, which read from
+       a std::istream, can read a MappedFile using this stream buffer.
+       Seeking is supported.
+     */
+    class MappedStreambuf : public std::streambuf
+    {
+        public:
+            MappedStreambuf(const char* data, std::size_t size);
+
+            explicit MappedStreambuf(const MappedFile& file);
+
+        protected:
+            int_type underflow();
+
+            std::streamsize showmanyc();
+
+            pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                             std::ios_base::openmode which = std::ios_base::in);
+
+            pos_type seekpos(pos_type pos,
+                             std::ios_base::openmode which = std::ios_base::in);
+    };
+
+    /**
+       Input stream, which maps a file into memory and reads it using a
+       MappedStreambuf.
+
+       Example:
+       \code
+        cxxtools::MappedIstream in("data.json");
+        cxxtools::JsonDeserializer deserializer(in);
+       \endcode
+     */
+    class MappedIstream : public std::istream
+    {
+            MappedFile _file;
+            MappedStreambuf _streambuf;
+
+        public:
+            explicit MappedIstream(const std::string& fname,
+                                   MappedFile::Advice advice = MappedFile::Sequential)
+                : std::istream(0),
+                  _file(fname, advice),
+                  _streambuf(_file)
+            {
+                init(&_streambuf);
+            }
+
+            const MappedFile& file() const
+            { return _file; }
+    };
+}
+
+#endif // CXXTOOLS_MAPPEDFILE_H
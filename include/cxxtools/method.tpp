@@ -93,6 +93,13 @@ class MethodSlot : public BasicSlot<R, A1,A2,A3,A4,A5,A6,A7,A8,A9,A10>
         Slot* clone() const
         { return new MethodSlot(*this); }
 
+        /** Creates a copy of this object in buffer, if it fits and this is not a subclass. */
+        Slot* cloneTo(void* buffer, std::size_t size) const
+        {
+            return sizeof(MethodSlot) <= size && typeid(*this) == typeid(MethodSlot)
+                ? new (buffer) MethodSlot(*this) : clone();
+        }
+
         /** Returns a pointer to this object's internal Callable. */
         virtual const void* callable() const
         { return &_method; }
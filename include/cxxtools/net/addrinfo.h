@@ -29,6 +29,7 @@
 #ifndef CXXTOOLS_NET_ADDRINFO_H
 #define CXXTOOLS_NET_ADDRINFO_H
 
+#include <cxxtools/timespan.h>
 #include <string>
 
 namespace cxxtools
@@ -39,6 +40,17 @@ namespace net
 
     class AddrInfoImpl;
 
+    /** Resolved network addresses of a host and port.
+
+        The constructor, which takes a host name, blocks until the host name
+        is resolved. Use beginResolve to resolve the host name in a
+        background thread. A TcpSocket, which is connected asynchronously
+        using such an object, waits in its selector for the resolver, so
+        that the event loop is never blocked.
+
+        Resolved addresses are kept in a cache for some time (see
+        cacheTimeout). Numeric addresses are always resolved immediately.
+     */
     class AddrInfo
     {
         public:
@@ -52,6 +64,23 @@ namespace net
 
             AddrInfo& operator= (const AddrInfo& src);
 
+            /// Starts resolving the host name and returns without waiting.
+            static AddrInfo beginResolve(const std::string& host, unsigned short port, bool listen = false);
+
+            /// Returns true, when the host name is resolved or resolving failed.
+            bool isResolved() const;
+
+            /// Waits until the host name is resolved. Throws an exception,
+            /// when the host name cannot be resolved.
+            void endResolve();
+
+            /// Sets the time, how long resolved addresses are cached. The
+            /// default is 60 seconds. A value of 0 disables the cache.
+            static void cacheTimeout(Timespan t);
+            static Timespan cacheTimeout();
+
+            static void clearCache();
+
             const std::string& host() const;
             unsigned short port() const;
 
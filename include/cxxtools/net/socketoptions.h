@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_NET_SOCKETOPTIONS_H
+#define CXXTOOLS_NET_SOCKETOPTIONS_H
+
+#include <cxxtools/timespan.h>
+
+namespace cxxtools
+{
+
+namespace net
+{
+
+    /** Options for tcp sockets.
+
+        Options, which are not set, keep the defaults of the system. The
+        getters return a negative value for them.
+
+        A TcpServer sets the buffer sizes and fast open on the listening
+        socket, so that they are inherited by the accepted sockets, and sets
+        the remaining options on each accepted socket. A TcpSocket sets all
+        options before it connects.
+
+        Options, which are not supported by the system, are ignored. When
+        setting an option fails, a warning is logged and the socket is used
+        anyway.
+
+        Example:
+        \code
+          cxxtools::net::SocketOptions options;
+          options.noDelay(true);
+          options.keepAlive(true);
+          options.keepIdle(cxxtools::Seconds(60));
+
+          cxxtools::net::TcpServer server;
+          server.socketOptions(options);
+          server.listen("", 7002);
+        \endcode
+     */
+    class SocketOptions
+    {
+        public:
+            SocketOptions();
+
+            /// Sends small segments immediately instead of collecting them (TCP_NODELAY).
+            void noDelay(bool sw)                 { _noDelay = sw; }
+            int noDelay() const                   { return _noDelay; }
+
+            /// Acknowledges received segments immediately (TCP_QUICKACK, Linux only).
+            /// The kernel may turn it off again later.
+            void quickAck(bool sw)                { _quickAck = sw; }
+            int quickAck() const                  { return _quickAck; }
+
+            /// Polls the network device in blocking reads for the given time,
+            /// before the thread sleeps (SO_BUSY_POLL, Linux only).
+            void busyPoll(Microseconds t)         { _busyPoll = t; }
+            Microseconds busyPoll() const         { return _busyPoll; }
+
+            /// Sets the size of the kernel send buffer (SO_SNDBUF).
+            void sendBufferSize(int size)         { _sendBufferSize = size; }
+            int sendBufferSize() const            { return _sendBufferSize; }
+
+            /// Sets the size of the kernel receive buffer (SO_RCVBUF).
+            void receiveBufferSize(int size)      { _receiveBufferSize = size; }
+            int receiveBufferSize() const         { return _receiveBufferSize; }
+
+            /// Enables TCP fast open (TCP_FASTOPEN). On a server the value is the
+            /// maximum number of pending fast open requests. A client uses fast
+            /// open, when the value is positive (TCP_FASTOPEN_CONNECT).
+            void fastOpen(int queueLength)        { _fastOpen = queueLength; }
+            int fastOpen() const                  { return _fastOpen; }
+
+            /// Enables keep alive probes on idle connections (SO_KEEPALIVE).
+            void keepAlive(bool sw)               { _keepAlive = sw; }
+            int keepAlive() const                 { return _keepAlive; }
+
+            /// Sets the idle time before the first keep alive probe (TCP_KEEPIDLE).
+            void keepIdle(Seconds t)              { _keepIdle = t; }
+            Seconds keepIdle() const              { return _keepIdle; }
+
+            /// Sets the time between keep alive probes (TCP_KEEPINTVL).
+            void keepInterval(Seconds t)          { _keepInterval = t; }
+            Seconds keepInterval() const          { return _keepInterval; }
+
+            /// Sets the number of unanswered probes, after which the
+            /// connection is dropped (TCP_KEEPCNT).
+            void keepCount(int n)                 { _keepCount = n; }
+            int keepCount() const                 { return _keepCount; }
+
+            /// Sets the options of a socket, which is about to listen.
+            void applyListen(int fd) const;
+
+            /// Sets the options of an accepted or connected socket.
+            void applyConnected(int fd) const;
+
+            /// Sets the options of a socket, which is about to connect.
+            void applyConnect(int fd) const;
+
+        private:
+            void applyConnection(int fd) const;
+
+            int _noDelay;
+            int _quickAck;
+            Microseconds _busyPoll;
+            int _sendBufferSize;
+            int _receiveBufferSize;
+            int _fastOpen;
+            int _keepAlive;
+            Seconds _keepIdle;
+            Seconds _keepInterval;
+            int _keepCount;
+    };
+
+} // namespace net
+
+} // namespace cxxtools
+
+#endif // CXXTOOLS_NET_SOCKETOPTIONS_H
@@ -32,6 +32,7 @@
 #include <cxxtools/selectable.h>
 #include <cxxtools/signal.h>
 #include <cxxtools/ioerror.h>
+#include <cxxtools/net/socketoptions.h>
 #include <string>
 #include <exception>
 
@@ -75,6 +76,14 @@ namespace net
 
       void listen(const std::string& ipaddr, unsigned short int port, int backlog = 5, unsigned flags = REUSEADDR);
 
+      /** @brief Sets the options for the listening and the accepted sockets
+          The options are applied to the listening sockets immediately and
+          in listen and to each accepted socket.
+       */
+      void socketOptions(const SocketOptions& options);
+
+      const SocketOptions& socketOptions() const;
+
       // inherit doc
       virtual SelectableImpl& simpl();
 
@@ -31,6 +31,7 @@
 
 #include <cxxtools/iodevice.h>
 #include <cxxtools/net/addrinfo.h>
+#include <cxxtools/net/socketoptions.h>
 #include <cxxtools/signal.h>
 #include <string>
 
@@ -70,6 +71,25 @@ class TcpSocket : public IODevice
         Milliseconds getTimeout() const
         { return timeout(); }
 
+        /** @brief Sets the socket options
+
+            The options are applied, when the socket connects. A connected
+            socket gets the options immediately. New sockets start with the
+            default options.
+         */
+        void socketOptions(const SocketOptions& options);
+
+        const SocketOptions& socketOptions() const;
+
+        /** @brief Sets the default options for new sockets
+
+            This is not thread safe and should be called at startup before
+            sockets are created.
+         */
+        static void defaultSocketOptions(const SocketOptions& options);
+
+        static const SocketOptions& defaultSocketOptions();
+
         void accept(const TcpServer& server, unsigned flags = 0);
 
         void connect(const AddrInfo& addrinfo);
@@ -80,7 +100,7 @@ class TcpSocket : public IODevice
         bool beginConnect(const AddrInfo& addrinfo);
 
         bool beginConnect(const std::string& ipaddr, unsigned short int port)
-        { return beginConnect(AddrInfo(ipaddr, port)); }
+        { return beginConnect(AddrInfo::beginResolve(ipaddr, port)); }
 
         void endConnect();
 
@@ -131,6 +151,15 @@ class TcpSocket : public IODevice
         // inherit doc
         virtual size_t onWrite(const char* buffer, size_t count);
 
+        // inherit doc
+        virtual size_t onReadv(const struct iovec* iov, size_t iovcnt, bool& eof);
+
+        // inherit doc
+        virtual size_t onBeginWritev(const struct iovec* iov, size_t iovcnt);
+
+        // inherit doc
+        virtual size_t onWritev(const struct iovec* iov, size_t iovcnt);
+
         virtual void onCancel();
 
     public:
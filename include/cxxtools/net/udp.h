@@ -33,12 +33,53 @@
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <string>
 
 namespace cxxtools
 {
 
 namespace net
 {
+  /**
+   * A single datagram for the batch functions of UdpSender and UdpReceiver.
+   *
+   * When sending, data points to the payload of size bytes. When receiving,
+   * data points to a buffer of size bytes and size is set to the length of
+   * the received datagram.
+   *
+   * The address is the destination when sending and the source after
+   * receiving. An empty address (addrlen == 0) sends the datagram to the
+   * connected or last peer of the socket.
+   */
+  struct UdpMessage
+  {
+      void* data;
+      size_t size;
+      bool truncated;
+      struct sockaddr_storage addr;
+      socklen_t addrlen;
+
+      UdpMessage()
+        : data(0),
+          size(0),
+          truncated(false),
+          addrlen(0)
+        { }
+
+      UdpMessage(const void* data_, size_t size_)
+        : data(const_cast<void*>(data_)),
+          size(size_),
+          truncated(false),
+          addrlen(0)
+        { }
+
+      /// Sets the destination address of the datagram.
+      void setAddress(const std::string& ipaddr, unsigned short int port);
+
+      /// Returns the ip address of the sender of a received datagram.
+      std::string getAddress() const;
+  };
+
   class UdpSender : public Socket
   {
       bool connected;
@@ -57,6 +98,13 @@ namespace net
 
       size_type send(const void* message, size_type length, int flags = 0) const;
       size_type send(const std::string& message, int flags = 0) const;
+
+      /// Sends multiple datagrams with as few system calls as possible.
+      /// Messages without address are sent to the connected peer.
+      /// Returns the number of datagrams sent, which is less than count
+      /// only when the timeout is 0 and the send buffer is full.
+      size_type send(const UdpMessage* messages, size_type count, int flags = 0) const;
+
       size_type recv(void* buffer, size_type length, int flags = 0) const;
       std::string recv(size_type length, int flags = 0) const;
   };
@@ -76,8 +124,19 @@ namespace net
 
       size_type recv(void* buffer, size_type length, int flags = 0);
       std::string recv(size_type length, int flags = 0);
+
+      /// Receives up to count datagrams with a single system call.
+      /// Waits for the first datagram and returns the number of datagrams
+      /// available then. The sender of the last datagram becomes the peer
+      /// used by send.
+      size_type recv(UdpMessage* messages, size_type count, int flags = 0);
+
       size_type send(const void* message, size_type length, int flags = 0) const;
       size_type send(const std::string& message, int flags = 0) const;
+
+      /// Sends multiple datagrams. Messages without address are sent to
+      /// the sender of the last received datagram.
+      size_type send(const UdpMessage* messages, size_type count, int flags = 0) const;
   };
 
 } // namespace net
@@ -36,24 +36,48 @@ namespace cxxtools
 {
   namespace net
   {
+    /**
+       Stream buffer, which sends the written data as udp datagrams.
+
+       A datagram is sent on each sync or when msgsize bytes are collected.
+       With a batchsize greater than 1 the datagrams are collected and sent
+       with a single system call, when batchsize datagrams are complete or
+       flushBatch is called.
+     */
     class UdpStreambuf : public std::streambuf
     {
         char* message;
         unsigned msgsize;
         UdpSender& sender;
         int flags;
+        unsigned batchsize;
+        unsigned batchcount;
+        UdpMessage* batch;
 
         void sendBuffer();
+        void sendBatch();
+        void resetBuffer();
 
       public:
-        explicit UdpStreambuf(UdpSender& sender_, int flags_ = 0, unsigned msgsize_ = 1024)
-          : message(new char[msgsize_]),
+        explicit UdpStreambuf(UdpSender& sender_, int flags_ = 0, unsigned msgsize_ = 1024,
+            unsigned batchsize_ = 1)
+          : message(new char[msgsize_ * (batchsize_ > 0 ? batchsize_ : 1)]),
             msgsize(msgsize_),
             sender(sender_),
-            flags(flags_)
+            flags(flags_),
+            batchsize(batchsize_ > 0 ? batchsize_ : 1),
+            batchcount(0),
+            batch(new UdpMessage[batchsize])
           { }
         ~UdpStreambuf()
-          { delete[] message; }
+        {
+          flushBatch();
+          delete[] batch;
+          delete[] message;
+        }
+
+        /// Sends all collected datagrams including the current one.
+        void flushBatch();
 
       protected:
         std::streambuf::int_type overflow(std::streambuf::int_type ch);
@@ -67,23 +91,30 @@ namespace cxxtools
         UdpStreambuf streambuf;
 
       public:
-        explicit UdpOStream(UdpSender& sender_, int flags = 0)
+        explicit UdpOStream(UdpSender& sender_, int flags = 0, unsigned batchsize = 1)
           : std::ostream(0),
             sender(0),
-            streambuf(sender_, flags)
+            streambuf(sender_, flags, 1024, batchsize)
         {
           init(&streambuf);
         }
         UdpOStream(const char* ipaddr, unsigned short int port, bool bcast = false,
-            int flags = 0)
+            int flags = 0, unsigned batchsize = 1)
           : std::ostream(0),
             sender(new UdpSender(ipaddr, port, bcast)),
-            streambuf(*sender, flags)
+            streambuf(*sender, flags, 1024, batchsize)
         {
           init(&streambuf);
         }
         ~UdpOStream()
-          { delete sender; }
+        {
+          streambuf.flushBatch();
+          delete sender;
+        }
+
+        /// Sends all datagrams collected in batch mode.
+        void flushBatch()
+          { streambuf.flushBatch(); }
     };
 
   } // namespace net
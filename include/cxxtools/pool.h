@@ -45,6 +45,84 @@ namespace cxxtools
       { return new T(); }
   };
 
+  /** Smart pointer to a object of a pool.
+
+      When the last pointer to the object is released, the object is put back
+      into the pool or destroyed if the pool does not take it.
+   */
+  template <typename PoolType,
+            typename ObjectType,
+            template <class> class OwnershipPolicy,
+            template <class> class DestroyPolicy>
+  class PoolPtr : public OwnershipPolicy<ObjectType>,
+                  public DestroyPolicy<ObjectType>
+  {
+      ObjectType* object;
+      PoolType* pool;
+      typedef OwnershipPolicy<ObjectType> OwnershipPolicyType;
+      typedef DestroyPolicy<ObjectType> DestroyPolicyType;
+
+      void doUnlink()
+      {
+        if (OwnershipPolicyType::unlink(object))
+        {
+          if (pool == 0 || !pool->put(*this))
+            DestroyPolicyType::destroy(object);
+        }
+      }
+
+    public:
+      PoolPtr()
+        : object(0),
+          pool(0)
+        {}
+      PoolPtr(ObjectType* ptr)
+        : object(ptr),
+          pool(0)
+        { OwnershipPolicyType::link(*this, ptr); }
+      PoolPtr(const PoolPtr& ptr)
+        : object(ptr.object),
+          pool(ptr.pool)
+        { OwnershipPolicyType::link(ptr, ptr.object); }
+      ~PoolPtr()
+        { doUnlink(); }
+
+      PoolPtr& operator= (const PoolPtr& ptr)
+      {
+        if (object != ptr.object)
+        {
+          doUnlink();
+          object = ptr.object;
+          pool = ptr.pool;
+          OwnershipPolicyType::link(ptr, object);
+        }
+        return *this;
+      }
+
+      /// The object can be dereferenced like the held object
+      ObjectType* operator->() const              { return object; }
+      /// The object can be dereferenced like the held object
+      ObjectType& operator*() const               { return *object; }
+
+      bool operator== (const ObjectType* p) const { return object == p; }
+      bool operator!= (const ObjectType* p) const { return object != p; }
+      bool operator< (const ObjectType* p) const  { return object < p; }
+      bool operator! () const { return object == 0; }
+      operator bool () const  { return object != 0; }
+
+      ObjectType* getPointer()              { return object; }
+      const ObjectType* getPointer() const  { return object; }
+      operator ObjectType* ()               { return object; }
+      operator const ObjectType* () const   { return object; }
+
+      void setPool(PoolType* p)
+      { pool = p; }
+
+      // don't put the object back to the pool
+      void release()
+      { pool = 0; }
+  };
+
   /** A Pool is a container for pooled objects
 
       It maintains a list of object instances which are not in use. If a
@@ -60,74 +138,8 @@ namespace cxxtools
   class Pool : private NonCopyable
   {
     public:
-      class Ptr : public OwnershipPolicy<ObjectType>,
-                  public DestroyPolicy<ObjectType>
-      {
-          ObjectType* object;
-          Pool* pool;
-          typedef OwnershipPolicy<ObjectType> OwnershipPolicyType;
-          typedef DestroyPolicy<ObjectType> DestroyPolicyType;
-
-          void doUnlink()
-          {
-            if (OwnershipPolicyType::unlink(object))
-            {
-              if (pool == 0 || !pool->put(*this))
-                DestroyPolicyType::destroy(object);
-            }
-          }
-
-        public:
-          Ptr()
-            : object(0),
-              pool(0)
-            {}
-          Ptr(ObjectType* ptr)
-            : object(ptr),
-              pool(0)
-            { OwnershipPolicyType::link(*this, ptr); }
-          Ptr(const Ptr& ptr)
-            : object(ptr.object),
-              pool(ptr.pool)
-            { OwnershipPolicyType::link(ptr, ptr.object); }
-          ~Ptr()
-            { doUnlink(); }
-
-          Ptr& operator= (const Ptr& ptr)
-          {
-            if (object != ptr.object)
-            {
-              doUnlink();
-              object = ptr.object;
-              pool = ptr.pool;
-              OwnershipPolicyType::link(ptr, object);
-            }
-            return *this;
-          }
-
-          /// The object can be dereferenced like the held object
-          ObjectType* operator->() const              { return object; }
-          /// The object can be dereferenced like the held object
-          ObjectType& operator*() const               { return *object; }
-
-          bool operator== (const ObjectType* p) const { return object == p; }
-          bool operator!= (const ObjectType* p) const { return object != p; }
-          bool operator< (const ObjectType* p) const  { return object < p; }
-          bool operator! () const { return object == 0; }
-          operator bool () const  { return object != 0; }
-
-          ObjectType* getPointer()              { return object; }
-          const ObjectType* getPointer() const  { return object; }
-          operator ObjectType* ()               { return object; }
-          operator const ObjectType* () const   { return object; }
-
-          void setPool(Pool* p)
-          { pool = p; }
-
-          // don't put the object back to the pool
-          void release()
-          { pool = 0; }
-      };
+      typedef PoolPtr<Pool, ObjectType, OwnershipPolicy, DestroyPolicy> Ptr;
+      friend class PoolPtr<Pool, ObjectType, OwnershipPolicy, DestroyPolicy>;
 
     private:
       typedef std::vector<Ptr> Container;
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_POSIX_PROCESS_H
+#define CXXTOOLS_POSIX_PROCESS_H
+
+#include <cxxtools/noncopyable.h>
+#include <cxxtools/iodevice.h>
+#include <string>
+#include <sys/types.h>
+#include <signal.h>
+
+namespace cxxtools
+{
+  namespace posix
+  {
+    class ProcessImpl;
+
+    /**
+     cxxtools::posix::Process starts a child process with posix_spawn and
+     connects its standard streams to non blocking IODevices.
+
+     Unlike Fork, the page tables of the parent are not copied, so starting
+     a process is cheap even from a process with a large address space.
+
+     The devices can be attached to a selector or event loop, so that many
+     child processes are driven from a single thread. They can also be read
+     and written synchronously, e.g. through an IOStream.
+
+     By default stdin and stdout of the child are connected to the parent and
+     stderr is inherited. Note that a child blocks when it writes to a
+     captured stream, which is not read by the parent.
+
+     Example:
+     \code
+       cxxtools::posix::Process ls("ls");
+       ls.arg("-l").arg("/bin");
+       ls.start();
+       ls.stdIn().close();
+
+       ls.stdOut().inputReady += ...;
+       ls.stdOut().setSelector(&eventLoop);
+       ls.stdOut().beginRead(buffer, sizeof(buffer));
+     \endcode
+     */
+    class Process : private NonCopyable
+    {
+        ProcessImpl* _impl;
+
+      public:
+        enum Mode
+        {
+          Inherit,  ///< the child uses the stream of the parent
+          Capture,  ///< the stream is connected to the parent through a pipe
+          Discard,  ///< the stream is redirected to /dev/null
+          Combine   ///< stderr only: stderr goes to the same target as stdout
+        };
+
+        explicit Process(const std::string& cmd);
+
+        /// Closes the devices and waits for the child, if it is still running.
+        ~Process();
+
+        Process& push_back(const std::string& arg);
+
+        // nice alias of push_back
+        Process& arg(const std::string& arg)
+        { return push_back(arg); }
+
+        /// Sets an environment variable for the child.
+        /// The child inherits all other variables of the parent.
+        Process& setEnv(const std::string& name, const std::string& value);
+
+        void setStdin(Mode mode);
+        void setStdout(Mode mode);
+        void setStderr(Mode mode);
+
+        /// Starts the child process.
+        /// Throws a SystemError, when the command can't be executed.
+        void start();
+
+        pid_t pid() const;
+
+        /// Returns true when the child is started and not waited for.
+        bool running() const;
+
+        /// Device to write to the standard input of the child.
+        IODevice& stdIn();
+
+        /// Device to read the standard output of the child.
+        IODevice& stdOut();
+
+        /// Device to read the standard error of the child.
+        IODevice& stdErr();
+
+        /// Waits for the child to terminate and returns its status as
+        /// returned by waitpid.
+        int wait();
+
+        /// Checks without blocking, whether the child has terminated.
+        /// Returns true and sets status, when it has.
+        bool tryWait(int& status);
+
+        /// Sends a signal to the child.
+        void kill(int signo = SIGTERM);
+    };
+  }
+}
+
+#endif // CXXTOOLS_POSIX_PROCESS_H
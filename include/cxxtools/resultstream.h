@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_RESULTSTREAM_H
+#define CXXTOOLS_RESULTSTREAM_H
+
+#include <cxxtools/decomposer.h>
+#include <cxxtools/callable.h>
+#include <cxxtools/refcounted.h>
+#include <cxxtools/smartptr.h>
+
+namespace cxxtools
+{
+
+/// Produces the elements of a ResultStream one after another.
+template <typename T>
+class ResultGenerator : public RefCounted
+{
+    public:
+        /// Sets the next element and returns true or returns false, when
+        /// there are no more elements.
+        virtual bool next(T& value) = 0;
+};
+
+/**
+ * Result of a service procedure, which is sent to the client element by element.
+
+   Procedures of a rpc server may return a ResultStream<T> instead of a
+   container to produce large or open ended results incrementally. The bin
+   rpc server sends each element as soon as it is generated, so that the
+   whole result never needs to be held in memory. Other protocols receive
+   the elements as a normal array.
+
+   The elements are produced by a ResultGenerator<T>, which is owned by the
+   stream, or by a callable, which sets the next element and returns false
+   at the end:
+
+   @code
+   class Counter : public cxxtools::ResultGenerator<unsigned>
+   {
+        unsigned _n;
+        unsigned _count;
+      public:
+        explicit Counter(unsigned count) : _n(0), _count(count) { }
+        bool next(unsigned& value)
+        {
+            if (_n >= _count)
+                return false;
+            value = _n++;
+            return true;
+        }
+   };
+
+   cxxtools::ResultStream<unsigned> count(unsigned n)
+   {
+     return cxxtools::ResultStream<unsigned>(new Counter(n));
+   }
+   @endcode
+ */
+template <typename T>
+class ResultStream
+{
+        class CallableGenerator : public ResultGenerator<T>
+        {
+                Callable<bool, T&>* _callable;
+
+            public:
+                explicit CallableGenerator(const Callable<bool, T&>& callable)
+                    : _callable(callable.clone())
+                { }
+
+                ~CallableGenerator()
+                { delete _callable; }
+
+                bool next(T& value)
+                { return _callable->call(value); }
+        };
+
+        SmartPtr<ResultGenerator<T> > _generator;
+
+    public:
+        ResultStream()
+        { }
+
+        /// Takes ownership of the generator.
+        explicit ResultStream(ResultGenerator<T>* generator)
+            : _generator(generator)
+        { }
+
+        explicit ResultStream(const Callable<bool, T&>& callable)
+            : _generator(new CallableGenerator(callable))
+        { }
+
+        /// Sets the next element and returns true or returns false, when
+        /// the stream is exhausted.
+        bool next(T& value)
+        { return _generator && _generator->next(value); }
+};
+
+/// Interface implemented by decomposers, which can output their value
+/// element by element.
+class IStreamDecomposer
+{
+    public:
+        virtual ~IStreamDecomposer()
+        { }
+
+        /// Formats the next element and returns true or returns false, when
+        /// there are no more elements.
+        virtual bool formatNext(Formatter& formatter) = 0;
+};
+
+template <typename T>
+class Decomposer<ResultStream<T> > : public IDecomposer, public IStreamDecomposer
+{
+    public:
+        void begin(const ResultStream<T>& stream)
+        {
+            _stream = stream;
+        }
+
+        virtual void setName(const std::string& name)
+        {
+            _name = name;
+        }
+
+        virtual void format(Formatter& formatter)
+        {
+            SerializationInfo si;
+            si.setName(_name);
+            si.setCategory(SerializationInfo::Array);
+
+            T value;
+            while (_stream.next(value))
+                si.addMember() <<= value;
+
+            formatEach(si, formatter);
+        }
+
+        virtual bool formatNext(Formatter& formatter)
+        {
+            T value;
+            if (!_stream.next(value))
+            {
+                _stream = ResultStream<T>();
+                return false;
+            }
+
+            _si.clear();
+            _si <<= value;
+            formatEach(_si, formatter);
+            return true;
+        }
+
+    private:
+        ResultStream<T> _stream;
+        std::string _name;
+        SerializationInfo _si;
+};
+
+}
+
+#endif // CXXTOOLS_RESULTSTREAM_H
@@ -30,6 +30,7 @@
 #define cxxtools_SerializationInfo_h
 
 #include <cxxtools/string.h>
+#include <cxxtools/compactstring.h>
 #include <vector>
 #include <set>
 #include <map>
@@ -187,6 +188,7 @@ class SerializationInfo
         void setValue(const String& value)       { _setString(value); }
         void setValue(const std::string& value)  { _setString8(value); }
         void setValue(const char* value)         { _setString8(value); }
+        void setValue(const CompactString& value);
         void setValue(Char value)                { _setString(String(1, value)); }
         void setValue(wchar_t value)             { _setString(String(1, value)); }
         void setValue(bool value)                { _setBool(value) ; }
@@ -214,6 +216,7 @@ class SerializationInfo
         */
         void getValue(String& value) const;
         void getValue(std::string& value) const;
+        void getValue(CompactString& value) const;
         void getValue(Char& value) const               { value = _getWChar(); }
         void getValue(wchar_t& value) const            { value = _getWChar(); }
         void getValue(bool& value) const               { value = _getBool(); }
@@ -243,9 +246,9 @@ class SerializationInfo
             { value = static_cast<unsigned long long>(_getUInt("unsigned long long", std::numeric_limits<unsigned long long>::max())); }
 #endif
         void getValue(float& value) const
-            { value = static_cast<float>(_getFloat("float", static_cast<long double>(std::numeric_limits<float>::max())*1.0000000000001)); }
+            { value = static_cast<float>(_getDouble("float", std::numeric_limits<float>::max())); }
         void getValue(double& value) const
-            { value = static_cast<double>(_getFloat("double", static_cast<long double>(std::numeric_limits<double>::max())*1.0000000000001)); }
+            { value = _getDouble("double", std::numeric_limits<double>::max()); }
         void getValue(long double& value) const
             { value = static_cast<long double>(_getFloat("long double", std::numeric_limits<long double>::max())); }
 
@@ -375,6 +378,7 @@ class SerializationInfo
         int_type _getInt(const char* type, int_type min, int_type max) const;
         unsigned_type _getUInt(const char* type, unsigned_type max) const;
         long double _getFloat(const char* type, long double max) const;
+        double _getDouble(const char* type, double max) const;
         Nodes& nodes();
         const Nodes& nodes() const;
 
@@ -655,6 +659,19 @@ inline void operator <<=(SerializationInfo& si, const String& n)
 }
 
 
+inline void operator >>=(const SerializationInfo& si, CompactString& n)
+{
+    si.getValue(n);
+}
+
+
+inline void operator <<=(SerializationInfo& si, const CompactString& n)
+{
+    si.setValue(n);
+    si.setTypeName("string");
+}
+
+
 inline void operator >>=(const SerializationInfo& si, Char& n)
 {
     si.getValue(n);
@@ -31,6 +31,8 @@
 
 #include <cxxtools/serviceprocedure.h>
 #include <cxxtools/callable.h>
+#include <cxxtools/epoch.h>
+#include <cxxtools/mutex.h>
 #include <string>
 #include <vector>
 #include <map>
@@ -39,11 +41,14 @@ namespace cxxtools
 {
     class ServiceRegistry
     {
-            ServiceRegistry(const ServiceRegistry&) { }
+            ServiceRegistry(const ServiceRegistry&)
+                : _procedures(new ProcedureMap())
+            { }
             ServiceRegistry& operator=(const ServiceRegistry&) { return *this; }
 
         public:
             ServiceRegistry()
+                : _procedures(new ProcedureMap())
             { }
 
             ~ServiceRegistry();
@@ -290,7 +295,9 @@ namespace cxxtools
 
         private:
             typedef std::map<std::string, ServiceProcedure*> ProcedureMap;
-            ProcedureMap _procedures;
+            // procedures are looked up without locking; writers are serialized by _mutex
+            SnapshotPtr<ProcedureMap> _procedures;
+            Mutex _mutex;
     };
 
 }
@@ -36,8 +36,7 @@
 #include <cxxtools/method.h>
 #include <cxxtools/constmethod.h>
 #include <cxxtools/connectable.h>
-#include <list>
-#include <map>
+#include <vector>
 
 
 namespace cxxtools {
@@ -49,20 +48,46 @@ namespace cxxtools {
         public:
             struct Sentry
             {
-                Sentry(const SignalBase* signal);
+                Sentry(const SignalBase* signal)
+                    : _signal(signal),
+                      _previous(signal->_sentry)
+                {
+                    _signal->_sentry = this;
+                    _signal->_sending = true;
+                }
 
-                ~Sentry();
+                ~Sentry()
+                {
+                    if( _signal )
+                        this->detach();
+                }
 
-                void detach();
+                void detach()
+                {
+                    const SignalBase* signal = _signal;
+                    signal->_sentry = _previous;
+                    _signal = 0;
+
+                    // only the outermost send may remove targets
+                    if( _previous == 0 )
+                    {
+                        signal->_sending = false;
+                        if( signal->_dirty )
+                            const_cast<SignalBase*>(signal)->removeInvalidTargets();
+                    }
+                }
 
                 bool operator!() const
                 { return _signal == 0; }
 
                 const SignalBase* _signal;
+                Sentry* _previous;  // sentry of an outer send of the same signal
             };
 
             SignalBase();
 
+            SignalBase(const SignalBase&);
+
             ~SignalBase();
 
             SignalBase& operator=(const SignalBase& other);
@@ -73,7 +98,34 @@ namespace cxxtools {
 
             void disconnectSlot(const Slot& slot);
 
+        protected:
+            // A connection of this signal to a slot. The callable of the slot
+            // is cached, so that sending iterates over contiguous memory and
+            // touches only the connection data, which holds the slot itself.
+            struct Target
+            {
+                explicit Target(const Connection& c)
+                    : connection(c),
+                      callable(c.slot().callable())
+                { }
+
+                bool valid() const
+                { return connection.valid(); }
+
+                Connection connection;
+                const void* callable;
+            };
+
+            // The targets in the order of connection. While sending, closed
+            // connections stay in the vector until the outermost send is
+            // finished, so that indexes stay valid.
+            std::vector<Target> _targets;
+
         private:
+            void closeTargets();
+
+            void removeInvalidTargets();
+
             mutable Sentry* _sentry;
             mutable bool _sending;
             mutable bool _dirty;
@@ -93,16 +145,40 @@ class Signal<const cxxtools::Event&> : public Connectable
 {
         struct Sentry
         {
-            Sentry(const Signal* signal);
+            Sentry(const Signal* signal)
+                : _signal(signal),
+                  _previous(signal->_sentry)
+            {
+                _signal->_sentry = this;
+                _signal->_sending = true;
+            }
+
+            ~Sentry()
+            {
+                if( _signal )
+                    this->detach();
+            }
 
-            ~Sentry();
+            void detach()
+            {
+                const Signal* signal = _signal;
+                signal->_sentry = _previous;
+                _signal = 0;
 
-            void detach();
+                // only the outermost send may remove routes
+                if( _previous == 0 )
+                {
+                    signal->_sending = false;
+                    if( signal->_dirty )
+                        signal->removeInvalidRoutes();
+                }
+            }
 
             bool operator!() const
             { return _signal == 0; }
 
             const Signal* _signal;
+            Sentry* _previous;  // sentry of an outer send of the same signal
         };
 
         class IEventRoute
@@ -110,6 +186,7 @@ class Signal<const cxxtools::Event&> : public Connectable
             public:
                 IEventRoute(Connection& target)
                 : _target(target)
+                , _callable(target.slot().callable())
                 { }
 
                 virtual ~IEventRoute() {}
@@ -117,7 +194,7 @@ class Signal<const cxxtools::Event&> : public Connectable
                 virtual void route(const cxxtools::Event& ev)
                 {
                     typedef Invokable<const cxxtools::Event&> InvokableT;
-                    const InvokableT* invokable = static_cast<const InvokableT*>( _target.slot().callable() );
+                    const InvokableT* invokable = static_cast<const InvokableT*>( _callable );
                     invokable->invoke(ev);
                 }
 
@@ -127,8 +204,13 @@ class Signal<const cxxtools::Event&> : public Connectable
                 bool valid() const
                 { return _target.valid(); }
 
+            protected:
+                const void* callable() const
+                { return _callable; }
+
             private:
                 Connection _target;
+                const void* _callable;
         };
 
         template <typename EventT>
@@ -142,16 +224,28 @@ class Signal<const cxxtools::Event&> : public Connectable
                 virtual void route(const cxxtools::Event& ev)
                 {
                     typedef Invokable<const cxxtools::Event&> InvokableT;
-                    const InvokableT* invokable = static_cast<const InvokableT*>( connection().slot().callable() );
+                    const InvokableT* invokable = static_cast<const InvokableT*>( callable() );
 
                     const EventT& event = static_cast<const EventT&>(ev);
                     invokable->invoke(event);
                 }
         };
 
-        typedef std::multimap< const std::type_info*,
-                               IEventRoute*,
-                               CompareEventTypeInfo > RouteMap;
+        struct Route
+        {
+            Route(const std::type_info* type_, IEventRoute* route_)
+                : type(type_),
+                  route(route_)
+            { }
+
+            bool matches(const std::type_info& ti) const
+            { return type == &ti || *type == ti; }
+
+            const std::type_info* type;  // 0 for routes receiving all events
+            IEventRoute* route;
+        };
+
+        typedef std::vector<Route> Routes;
 
         // make non copyable
 #if __cplusplus >= 201103L
@@ -172,7 +266,7 @@ class Signal<const cxxtools::Event&> : public Connectable
         template <typename R>
         Connection connect(const BasicSlot<R, const cxxtools::Event&>& slot)
         {
-            Connection conn( *this, slot.clone() );
+            Connection conn( *this, slot );
             this->addRoute( 0, new IEventRoute(conn) );
             return conn;
         }
@@ -186,7 +280,7 @@ class Signal<const cxxtools::Event&> : public Connectable
         template <typename EventT>
         void subscribe( const BasicSlot<void, const EventT&>& slot )
         {
-            Connection conn( *this, slot.clone() );
+            Connection conn( *this, slot );
             const std::type_info& ti = typeid(EventT);
             this->addRoute( &ti, new EventRoute<EventT>(conn) );
         }
@@ -210,7 +304,20 @@ class Signal<const cxxtools::Event&> : public Connectable
         void removeRoute(const std::type_info* ti, const Slot& slot);
 
     private:
-        mutable RouteMap _routes;
+        void dispatch(const std::vector<IEventRoute*>& routes, const cxxtools::Event& ev,
+                      const Sentry& sentry) const;
+
+        void removeInvalidRoutes() const;
+
+        // all routes in the order of subscription
+        mutable Routes _routes;
+
+        // The routes receiving the last sent event type: first the routes
+        // for all events, then the ones subscribed to the type. The table is
+        // cleared when the routes change.
+        mutable const std::type_info* _dispatchType;
+        mutable std::vector<IEventRoute*> _dispatchTable;
+
         mutable Sentry* _sentry;
         mutable bool _sending;
         mutable bool _dirty;
@@ -16,6 +16,7 @@
 
             /** Deeply copies rhs. */
             Signal(const Signal& rhs)
+            : SignalBase()
             {
                 operator=(rhs);
             }
@@ -27,7 +28,7 @@
             template <typename R>
             Connection connect(const BasicSlot<R, A1,A2,A3,A4,A5,A6,A7,A8,A9,A10>& slot)
             {
-                return Connection(*this, slot.clone() );
+                return Connection(*this, slot);
             }
 
             /** The converse of connect(). */
@@ -46,18 +47,16 @@
             {
                 // The sentry will set the Signal to the sending state and
                 // reset it to not-sending upon destruction. In the sending
-                // state, removing connection will leave invalid connections
-                // in the connection list to keep the iterator valid, but mark
+                // state, removing connection will leave invalid targets
+                // in the vector to keep the indexes valid, but mark
                 // the Signal dirty. If the Signal is dirty, all invalid
-                // connections will be removed by the Sentry when it destructs..
+                // targets will be removed by the Sentry when it destructs.
                 SignalBase::Sentry sentry(this);
 
-                std::list<Connection>::const_iterator it = Connectable::connections().begin();
-                std::list<Connection>::const_iterator end = Connectable::connections().end();
-
-                for(; it != end; ++it)
+                for (std::size_t n = 0; n < _targets.size(); ++n)
                 {
-                    if( false == it->valid() || &( it->sender() ) != this  )
+                    const Target& target = _targets[n];
+                    if (!target.valid())
                         continue;
 
                     // The following scenarios must be considered when the
@@ -68,7 +67,7 @@
                     //   calling any slots immediately
                     // - A new Connection might get added to this Signal in
                     //   the slot
-                    const InvokableT* invokable = static_cast<const InvokableT*>( it->slot().callable() );
+                    const InvokableT* invokable = static_cast<const InvokableT*>(target.callable);
                     invokable->invoke(a1,a2,a3,a4,a5,a6,a7,a8,a9,a10);
 
                     // if this signal gets deleted by the slot, the Sentry
@@ -105,6 +104,13 @@
             Slot* clone() const
             { return new SignalSlot(*this); }
 
+            /** Creates a copy of this object in buffer, if it fits and this is not a subclass. */
+            Slot* cloneTo(void* buffer, std::size_t size) const
+            {
+                return sizeof(SignalSlot) <= size && typeid(*this) == typeid(SignalSlot)
+                    ? new (buffer) SignalSlot(*this) : clone();
+            }
+
             /** Returns a pointer to this object's internal Callable object. */
             virtual const void* callable() const
             {
@@ -231,6 +237,7 @@
 
             /** Deeply copies rhs. */
             Signal(const Signal& rhs)
+            : SignalBase()
             {
                 operator=(rhs);
             }
@@ -242,7 +249,7 @@
             template <typename R>
             Connection connect(const BasicSlot<R, A1,A2,A3,A4,A5,A6,A7,A8,A9,Void>& slot)
             {
-                return Connection(*this, slot.clone() );
+                return Connection(*this, slot);
             }
 
             /** The converse of connect(). */
@@ -261,18 +268,16 @@
             {
                 // The sentry will set the Signal to the sending state and
                 // reset it to not-sending upon destruction. In the sending
-                // state, removing connection will leave invalid connections
-                // in the connection list to keep the iterator valid, but mark
+                // state, removing connection will leave invalid targets
+                // in the vector to keep the indexes valid, but mark
                 // the Signal dirty. If the Signal is dirty, all invalid
-                // connections will be removed by the Sentry when it destructs..
+                // targets will be removed by the Sentry when it destructs.
                 SignalBase::Sentry sentry(this);
 
-                std::list<Connection>::const_iterator it = Connectable::connections().begin();
-                std::list<Connection>::const_iterator end = Connectable::connections().end();
-
-                for(; it != end; ++it)
+                for (std::size_t n = 0; n < _targets.size(); ++n)
                 {
-                    if( false == it->valid() || &( it->sender() ) != this  )
+                    const Target& target = _targets[n];
+                    if (!target.valid())
                         continue;
 
                     // The following scenarios must be considered when the
@@ -283,7 +288,7 @@
                     //   calling any slots immediately
                     // - A new Connection might get added to this Signal in
                     //   the slot
-                    const InvokableT* invokable = static_cast<const InvokableT*>( it->slot().callable() );
+                    const InvokableT* invokable = static_cast<const InvokableT*>(target.callable);
                     invokable->invoke(a1,a2,a3,a4,a5,a6,a7,a8,a9);
 
                     // if this signal gets deleted by the slot, the Sentry
@@ -376,6 +381,7 @@
 
             /** Deeply copies rhs. */
             Signal(const Signal& rhs)
+            : SignalBase()
             {
                 operator=(rhs);
             }
@@ -387,7 +393,7 @@
             template <typename R>
             Connection connect(const BasicSlot<R, A1,A2,A3,A4,A5,A6,A7,A8,Void,Void>& slot)
             {
-                return Connection(*this, slot.clone() );
+                return Connection(*this, slot);
             }
 
             /** The converse of connect(). */
@@ -406,18 +412,16 @@
             {
                 // The sentry will set the Signal to the sending state and
                 // reset it to not-sending upon destruction. In the sending
-                // state, removing connection will leave invalid connections
-                // in the connection list to keep the iterator valid, but mark
+                // state, removing connection will leave invalid targets
+                // in the vector to keep the indexes valid, but mark
                 // the Signal dirty. If the Signal is dirty, all invalid
-                // connections will be removed by the Sentry when it destructs..
+                // targets will be removed by the Sentry when it destructs.
                 SignalBase::Sentry sentry(this);
 
-                std::list<Connection>::const_iterator it = Connectable::connections().begin();
-                std::list<Connection>::const_iterator end = Connectable::connections().end();
-
-                for(; it != end; ++it)
+                for (std::size_t n = 0; n < _targets.size(); ++n)
                 {
-                    if( false == it->valid() || &( it->sender() ) != this  )
+                    const Target& target = _targets[n];
+                    if (!target.valid())
                         continue;
 
                     // The following scenarios must be considered when the
@@ -428,7 +432,7 @@
                     //   calling any slots immediately
                     // - A new Connection might get added to this Signal in
                     //   the slot
-                    const InvokableT* invokable = static_cast<const InvokableT*>( it->slot().callable() );
+                    const InvokableT* invokable = static_cast<const InvokableT*>(target.callable);
                     invokable->invoke(a1,a2,a3,a4,a5,a6,a7,a8);
 
                     // if this signal gets deleted by the slot, the Sentry
@@ -521,6 +525,7 @@
 
             /** Deeply copies rhs. */
             Signal(const Signal& rhs)
+            : SignalBase()
             {
                 operator=(rhs);
             }
@@ -532,7 +537,7 @@
             template <typename R>
             Connection connect(const BasicSlot<R, A1,A2,A3,A4,A5,A6,A7,Void,Void,Void>& slot)
             {
-                return Connection(*this, slot.clone() );
+                return Connection(*this, slot);
             }
 
             /** The converse of connect(). */
@@ -551,18 +556,16 @@
             {
                 // The sentry will set the Signal to the sending state and
                 // reset it to not-sending upon destruction. In the sending
-                // state, removing connection will leave invalid connections
-                // in the connection list to keep the iterator valid, but mark
+                // state, removing connection will leave invalid targets
+                // in the vector to keep the indexes valid, but mark
                 // the Signal dirty. If the Signal is dirty, all invalid
-                // connections will be removed by the Sentry when it destructs..
+                // targets will be removed by the Sentry when it destructs.
                 SignalBase::Sentry sentry(this);
 
-                std::list<Connection>::const_iterator it = Connectable::connections().begin();
-                std::list<Connection>::const_iterator end = Connectable::connections().end();
-
-                for(; it != end; ++it)
+                for (std::size_t n = 0; n < _targets.size(); ++n)
                 {
-                    if( false == it->valid() || &( it->sender() ) != this  )
+                    const Target& target = _targets[n];
+                    if (!target.valid())
                         continue;
 
                     // The following scenarios must be considered when the
@@ -573,7 +576,7 @@
                     //   calling any slots immediately
                     // - A new Connection might get added to this Signal in
                     //   the slot
-                    const InvokableT* invokable = static_cast<const InvokableT*>( it->slot().callable() );
+                    const InvokableT* invokable = static_cast<const InvokableT*>(target.callable);
                     invokable->invoke(a1,a2,a3,a4,a5,a6,a7);
 
                     // if this signal gets deleted by the slot, the Sentry
@@ -666,6 +669,7 @@
 
             /** Deeply copies rhs. */
             Signal(const Signal& rhs)
+            : SignalBase()
             {
                 operator=(rhs);
             }
@@ -677,7 +681,7 @@
             template <typename R>
             Connection connect(const BasicSlot<R, A1,A2,A3,A4,A5,A6,Void,Void,Void,Void>& slot)
             {
-                return Connection(*this, slot.clone() );
+                return Connection(*this, slot);
             }
 
             /** The converse of connect(). */
@@ -696,18 +700,16 @@
             {
                 // The sentry will set the Signal to the sending state and
                 // reset it to not-sending upon destruction. In the sending
-                // state, removing connection will leave invalid connections
-                // in the connection list to keep the iterator valid, but mark
+                // state, removing connection will leave invalid targets
+                // in the vector to keep the indexes valid, but mark
                 // the Signal dirty. If the Signal is dirty, all invalid
-                // connections will be removed by the Sentry when it destructs..
+                // targets will be removed by the Sentry when it destructs.
                 SignalBase::Sentry sentry(this);
 
-                std::list<Connection>::const_iterator it = Connectable::connections().begin();
-                std::list<Connection>::const_iterator end = Connectable::connections().end();
-
-                for(; it != end; ++it)
+                for (std::size_t n = 0; n < _targets.size(); ++n)
                 {
-                    if( false == it->valid() || &( it->sender() ) != this  )
+                    const Target& target = _targets[n];
+                    if (!target.valid())
                         continue;
 
                     // The following scenarios must be considered when the
@@ -718,7 +720,7 @@
                     //   calling any slots immediately
                     // - A new Connection might get added to this Signal in
                     //   the slot
-                    const InvokableT* invokable = static_cast<const InvokableT*>( it->slot().callable() );
+                    const InvokableT* invokable = static_cast<const InvokableT*>(target.callable);
                     invokable->invoke(a1,a2,a3,a4,a5,a6);
 
                     // if this signal gets deleted by the slot, the Sentry
@@ -811,6 +813,7 @@
 
             /** Deeply copies rhs. */
             Signal(const Signal& rhs)
+            : SignalBase()
             {
                 operator=(rhs);
             }
@@ -822,7 +825,7 @@
             template <typename R>
             Connection connect(const BasicSlot<R, A1,A2,A3,A4,A5,Void,Void,Void,Void,Void>& slot)
             {
-                return Connection(*this, slot.clone() );
+                return Connection(*this, slot);
             }
 
             /** The converse of connect(). */
@@ -841,18 +844,16 @@
             {
                 // The sentry will set the Signal to the sending state and
                 // reset it to not-sending upon destruction. In the sending
-                // state, removing connection will leave invalid connections
-                // in the connection list to keep the iterator valid, but mark
+                // state, removing connection will leave invalid targets
+                // in the vector to keep the indexes valid, but mark
                 // the Signal dirty. If the Signal is dirty, all invalid
-                // connections will be removed by the Sentry when it destructs..
+                // targets will be removed by the Sentry when it destructs.
                 SignalBase::Sentry sentry(this);
 
-                std::list<Connection>::const_iterator it = Connectable::connections().begin();
-                std::list<Connection>::const_iterator end = Connectable::connections().end();
-
-                for(; it != end; ++it)
+                for (std::size_t n = 0; n < _targets.size(); ++n)
                 {
-                    if( false == it->valid() || &( it->sender() ) != this  )
+                    const Target& target = _targets[n];
+                    if (!target.valid())
                         continue;
 
                     // The following scenarios must be considered when the
@@ -863,7 +864,7 @@
                     //   calling any slots immediately
                     // - A new Connection might get added to this Signal in
                     //   the slot
-                    const InvokableT* invokable = static_cast<const InvokableT*>( it->slot().callable() );
+                    const InvokableT* invokable = static_cast<const InvokableT*>(target.callable);
                     invokable->invoke(a1,a2,a3,a4,a5);
 
                     // if this signal gets deleted by the slot, the Sentry
@@ -956,6 +957,7 @@
 
             /** Deeply copies rhs. */
             Signal(const Signal& rhs)
+            : SignalBase()
             {
                 operator=(rhs);
             }
@@ -967,7 +969,7 @@
             template <typename R>
             Connection connect(const BasicSlot<R, A1,A2,A3,A4,Void,Void,Void,Void,Void,Void>& slot)
             {
-                return Connection(*this, slot.clone() );
+                return Connection(*this, slot);
             }
 
             /** The converse of connect(). */
@@ -986,18 +988,16 @@
             {
                 // The sentry will set the Signal to the sending state and
                 // reset it to not-sending upon destruction. In the sending
-                // state, removing connection will leave invalid connections
-                // in the connection list to keep the iterator valid, but mark
+                // state, removing connection will leave invalid targets
+                // in the vector to keep the indexes valid, but mark
                 // the Signal dirty. If the Signal is dirty, all invalid
-                // connections will be removed by the Sentry when it destructs..
+                // targets will be removed by the Sentry when it destructs.
                 SignalBase::Sentry sentry(this);
 
-                std::list<Connection>::const_iterator it = Connectable::connections().begin();
-                std::list<Connection>::const_iterator end = Connectable::connections().end();
-
-                for(; it != end; ++it)
+                for (std::size_t n = 0; n < _targets.size(); ++n)
                 {
-                    if( false == it->valid() || &( it->sender() ) != this  )
+                    const Target& target = _targets[n];
+                    if (!target.valid())
                         continue;
 
                     // The following scenarios must be considered when the
@@ -1008,7 +1008,7 @@
                     //   calling any slots immediately
                     // - A new Connection might get added to this Signal in
                     //   the slot
-                    const InvokableT* invokable = static_cast<const InvokableT*>( it->slot().callable() );
+                    const InvokableT* invokable = static_cast<const InvokableT*>(target.callable);
                     invokable->invoke(a1,a2,a3,a4);
 
                     // if this signal gets deleted by the slot, the Sentry
@@ -1101,6 +1101,7 @@
 
             /** Deeply copies rhs. */
             Signal(const Signal& rhs)
+            : SignalBase()
             {
                 operator=(rhs);
             }
@@ -1112,7 +1113,7 @@
             template <typename R>
             Connection connect(const BasicSlot<R, A1,A2,A3,Void,Void,Void,Void,Void,Void,Void>& slot)
             {
-                return Connection(*this, slot.clone() );
+                return Connection(*this, slot);
             }
 
             /** The converse of connect(). */
@@ -1131,18 +1132,16 @@
             {
                 // The sentry will set the Signal to the sending state and
                 // reset it to not-sending upon destruction. In the sending
-                // state, removing connection will leave invalid connections
-                // in the connection list to keep the iterator valid, but mark
+                // state, removing connection will leave invalid targets
+                // in the vector to keep the indexes valid, but mark
                 // the Signal dirty. If the Signal is dirty, all invalid
-                // connections will be removed by the Sentry when it destructs..
+                // targets will be removed by the Sentry when it destructs.
                 SignalBase::Sentry sentry(this);
 
-                std::list<Connection>::const_iterator it = Connectable::connections().begin();
-                std::list<Connection>::const_iterator end = Connectable::connections().end();
-
-                for(; it != end; ++it)
+                for (std::size_t n = 0; n < _targets.size(); ++n)
                 {
-                    if( false == it->valid() || &( it->sender() ) != this  )
+                    const Target& target = _targets[n];
+                    if (!target.valid())
                         continue;
 
                     // The following scenarios must be considered when the
@@ -1153,7 +1152,7 @@
                     //   calling any slots immediately
                     // - A new Connection might get added to this Signal in
                     //   the slot
-                    const InvokableT* invokable = static_cast<const InvokableT*>( it->slot().callable() );
+                    const InvokableT* invokable = static_cast<const InvokableT*>(target.callable);
                     invokable->invoke(a1,a2,a3);
 
                     // if this signal gets deleted by the slot, the Sentry
@@ -1246,6 +1245,7 @@
 
             /** Deeply copies rhs. */
             Signal(const Signal& rhs)
+            : SignalBase()
             {
                 operator=(rhs);
             }
@@ -1257,7 +1257,7 @@
             template <typename R>
             Connection connect(const BasicSlot<R, A1,A2,Void,Void,Void,Void,Void,Void,Void,Void>& slot)
             {
-                return Connection(*this, slot.clone() );
+                return Connection(*this, slot);
             }
 
             /** The converse of connect(). */
@@ -1276,18 +1276,16 @@
             {
                 // The sentry will set the Signal to the sending state and
                 // reset it to not-sending upon destruction. In the sending
-                // state, removing connection will leave invalid connections
-                // in the connection list to keep the iterator valid, but mark
+                // state, removing connection will leave invalid targets
+                // in the vector to keep the indexes valid, but mark
                 // the Signal dirty. If the Signal is dirty, all invalid
-                // connections will be removed by the Sentry when it destructs..
+                // targets will be removed by the Sentry when it destructs.
                 SignalBase::Sentry sentry(this);
 
-                std::list<Connection>::const_iterator it = Connectable::connections().begin();
-                std::list<Connection>::const_iterator end = Connectable::connections().end();
-
-                for(; it != end; ++it)
+                for (std::size_t n = 0; n < _targets.size(); ++n)
                 {
-                    if( false == it->valid() || &( it->sender() ) != this  )
+                    const Target& target = _targets[n];
+                    if (!target.valid())
                         continue;
 
                     // The following scenarios must be considered when the
@@ -1298,7 +1296,7 @@
                     //   calling any slots immediately
                     // - A new Connection might get added to this Signal in
                     //   the slot
-                    const InvokableT* invokable = static_cast<const InvokableT*>( it->slot().callable() );
+                    const InvokableT* invokable = static_cast<const InvokableT*>(target.callable);
                     invokable->invoke(a1,a2);
 
                     // if this signal gets deleted by the slot, the Sentry
@@ -1391,6 +1389,7 @@
 
             /** Deeply copies rhs. */
             Signal(const Signal& rhs)
+            : SignalBase()
             {
                 operator=(rhs);
             }
@@ -1402,7 +1401,7 @@
             template <typename R>
             Connection connect(const BasicSlot<R, A1,Void,Void,Void,Void,Void,Void,Void,Void,Void>& slot)
             {
-                return Connection(*this, slot.clone() );
+                return Connection(*this, slot);
             }
 
             /** The converse of connect(). */
@@ -1421,18 +1420,16 @@
             {
                 // The sentry will set the Signal to the sending state and
                 // reset it to not-sending upon destruction. In the sending
-                // state, removing connection will leave invalid connections
-                // in the connection list to keep the iterator valid, but mark
+                // state, removing connection will leave invalid targets
+                // in the vector to keep the indexes valid, but mark
                 // the Signal dirty. If the Signal is dirty, all invalid
-                // connections will be removed by the Sentry when it destructs..
+                // targets will be removed by the Sentry when it destructs.
                 SignalBase::Sentry sentry(this);
 
-                std::list<Connection>::const_iterator it = Connectable::connections().begin();
-                std::list<Connection>::const_iterator end = Connectable::connections().end();
-
-                for(; it != end; ++it)
+                for (std::size_t n = 0; n < _targets.size(); ++n)
                 {
-                    if( false == it->valid() || &( it->sender() ) != this  )
+                    const Target& target = _targets[n];
+                    if (!target.valid())
                         continue;
 
                     // The following scenarios must be considered when the
@@ -1443,7 +1440,7 @@
                     //   calling any slots immediately
                     // - A new Connection might get added to this Signal in
                     //   the slot
-                    const InvokableT* invokable = static_cast<const InvokableT*>( it->slot().callable() );
+                    const InvokableT* invokable = static_cast<const InvokableT*>(target.callable);
                     invokable->invoke(a1);
 
                     // if this signal gets deleted by the slot, the Sentry
@@ -1536,6 +1533,7 @@
 
             /** Deeply copies rhs. */
             Signal(const Signal& rhs)
+            : SignalBase()
             {
                 operator=(rhs);
             }
@@ -1547,7 +1545,7 @@
             template <typename R>
             Connection connect(const BasicSlot<R, Void,Void,Void,Void,Void,Void,Void,Void,Void,Void>& slot)
             {
-                return Connection(*this, slot.clone() );
+                return Connection(*this, slot);
             }
 
             /** The converse of connect(). */
@@ -1566,18 +1564,16 @@
             {
                 // The sentry will set the Signal to the sending state and
                 // reset it to not-sending upon destruction. In the sending
-                // state, removing connection will leave invalid connections
-                // in the connection list to keep the iterator valid, but mark
+                // state, removing connection will leave invalid targets
+                // in the vector to keep the indexes valid, but mark
                 // the Signal dirty. If the Signal is dirty, all invalid
-                // connections will be removed by the Sentry when it destructs..
+                // targets will be removed by the Sentry when it destructs.
                 SignalBase::Sentry sentry(this);
 
-                std::list<Connection>::const_iterator it = Connectable::connections().begin();
-                std::list<Connection>::const_iterator end = Connectable::connections().end();
-
-                for(; it != end; ++it)
+                for (std::size_t n = 0; n < _targets.size(); ++n)
                 {
-                    if( false == it->valid() || &( it->sender() ) != this  )
+                    const Target& target = _targets[n];
+                    if (!target.valid())
                         continue;
 
                     // The following scenarios must be considered when the
@@ -1588,7 +1584,7 @@
                     //   calling any slots immediately
                     // - A new Connection might get added to this Signal in
                     //   the slot
-                    const InvokableT* invokable = static_cast<const InvokableT*>( it->slot().callable() );
+                    const InvokableT* invokable = static_cast<const InvokableT*>(target.callable);
                     invokable->invoke();
 
                     // if this signal gets deleted by the slot, the Sentry
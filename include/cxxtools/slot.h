@@ -29,6 +29,9 @@
 #define cxxtools_Slot_h
 
 #include <cxxtools/void.h>
+#include <cstddef>
+#include <new>
+#include <typeinfo>
 
 namespace cxxtools {
 
@@ -40,6 +43,15 @@ namespace cxxtools {
 
             virtual Slot* clone() const = 0;
 
+            /** Creates a copy of this object in the given buffer, if it fits
+                into it, or on the heap otherwise. The caller can tell the
+                cases apart by comparing the returned pointer with buffer.
+                Implementations copy into the buffer only if the dynamic type
+                is their own class, so that subclasses are not sliced.
+            */
+            virtual Slot* cloneTo(void* /*buffer*/, std::size_t /*size*/) const
+            { return clone(); }
+
             virtual const void* callable() const = 0;
 
             virtual void onConnect(const Connection& c) = 0;
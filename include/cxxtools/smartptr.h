@@ -30,6 +30,10 @@
 #define CXXTOOLS_SMARTPTR_H
 
 #include <cxxtools/atomicity.h>
+#include <new>
+#if __cplusplus >= 201103L
+#include <utility>
+#endif
 
 namespace cxxtools
 {
@@ -192,7 +196,7 @@ namespace cxxtools
 
       bool unlink(ObjectType* object)
       {
-        if (object && atomicDecrement(*rc) <= 0)
+        if (object && atomicRefDecrement(*rc) <= 0)
         {
           delete rc;
           rc = 0;
@@ -211,7 +215,7 @@ namespace cxxtools
           else
           {
             rc = ptr.rc;
-            atomicIncrement(*rc);
+            atomicRefIncrement(*rc);
           }
         }
         else
@@ -223,6 +227,193 @@ namespace cxxtools
         { return rc ? atomicGet(*rc) : 0; }
   };
 
+  /** \brief Storage of an object together with its reference count.
+
+      The count is placed in front of the object in the same memory block, so
+      that only one allocation is needed and the count is near to the object.
+      Objects are created with SmartPtr::create, which uses the method
+      construct of the ownership policy.
+  */
+  template <typename ObjectType, typename CountType>
+  class CoAllocated
+  {
+      union Header
+      {
+        CountType rc;
+        long double align1;
+        void* align2;
+        long align3;
+      };
+
+      static void* allocate()
+      {
+        void* block = ::operator new(sizeof(Header) + sizeof(ObjectType));
+        static_cast<Header*>(block)->rc = 0;
+        return static_cast<char*>(block) + sizeof(Header);
+      }
+
+      static void deallocate(void* mem)
+      { ::operator delete(static_cast<char*>(mem) - sizeof(Header)); }
+
+    protected:
+      static CountType& count(const ObjectType* object)
+      {
+        return reinterpret_cast<Header*>(const_cast<char*>(
+            reinterpret_cast<const char*>(object)) - sizeof(Header))->rc;
+      }
+
+      static void destroyObject(ObjectType* object)
+      {
+        object->~ObjectType();
+        deallocate(object);
+      }
+
+#if __cplusplus >= 201103L
+      /// Creates a new object with the given constructor arguments.
+      template <typename... Args>
+      static ObjectType* construct(Args&&... args)
+      {
+        void* mem = allocate();
+        try
+        {
+          return new (mem) ObjectType(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+          deallocate(mem);
+          throw;
+        }
+      }
+#else
+      static ObjectType* construct()
+      {
+        void* mem = allocate();
+        try { return new (mem) ObjectType(); }
+        catch (...) { deallocate(mem); throw; }
+      }
+
+      template <typename A1>
+      static ObjectType* construct(const A1& a1)
+      {
+        void* mem = allocate();
+        try { return new (mem) ObjectType(a1); }
+        catch (...) { deallocate(mem); throw; }
+      }
+
+      template <typename A1, typename A2>
+      static ObjectType* construct(const A1& a1, const A2& a2)
+      {
+        void* mem = allocate();
+        try { return new (mem) ObjectType(a1, a2); }
+        catch (...) { deallocate(mem); throw; }
+      }
+
+      template <typename A1, typename A2, typename A3>
+      static ObjectType* construct(const A1& a1, const A2& a2, const A3& a3)
+      {
+        void* mem = allocate();
+        try { return new (mem) ObjectType(a1, a2, a3); }
+        catch (...) { deallocate(mem); throw; }
+      }
+#endif
+
+    public:
+      /// Returns the number of references to an object created by create.
+      static CountType refs(const ObjectType* object)
+        { return object ? count(object) : 0; }
+  };
+
+  /** \brief Tells, whether a ownership policy allocates the objects itself.
+
+      A SmartPtr with such a policy must not take objects created with new.
+  */
+  template <typename OwnershipPolicyType>
+  class IsCoAllocated
+  {
+      template <typename ObjectType, typename CountType>
+      static char test(const CoAllocated<ObjectType, CountType>*);
+      static long test(...);
+
+    public:
+      enum { value = sizeof(test(static_cast<const OwnershipPolicyType*>(0))) == sizeof(char) };
+  };
+
+  // only defined for policies, which accept objects created with new
+  template <bool coAllocated>
+  struct UseCreateForCoAllocatedObjects;
+
+  template <>
+  struct UseCreateForCoAllocatedObjects<false> { };
+
+  /**
+      \param ObjectType The managed object type
+  */
+  template <typename ObjectType>
+  /** \brief Thread safe reference counting with the count allocated together with the object.
+
+      Like ExternalAtomicRefCounted the managed object need not be prepared
+      for reference counting. The objects must be created with the static
+      method create of the SmartPtr, which allocates the count and the object
+      in one memory block. Passing a pointer to a object created with new
+      to the SmartPtr does not compile:
+
+      \code
+        typedef cxxtools::SmartPtr<MyObject, cxxtools::CoAllocatedRefCounted> Ptr;
+        Ptr p = Ptr::create(arg1, arg2);
+      \endcode
+
+      The object is destroyed by the policy, so the destroy policy of the
+      SmartPtr is not used. Pointers to base classes are not supported.
+  */
+  class CoAllocatedRefCounted : public CoAllocated<ObjectType, atomic_t>
+  {
+      typedef CoAllocated<ObjectType, atomic_t> CoAllocatedType;
+
+    protected:
+      bool unlink(ObjectType* object)
+      {
+        if (object && atomicRefDecrement(CoAllocatedType::count(object)) == 0)
+          CoAllocatedType::destroyObject(object);
+        return false;
+      }
+
+      void link(const CoAllocatedRefCounted& /*ptr*/, ObjectType* object)
+      {
+        if (object)
+          atomicRefIncrement(CoAllocatedType::count(object));
+      }
+  };
+
+  /**
+      \param ObjectType The managed object type
+  */
+  template <typename ObjectType>
+  /** \brief Reference counting for objects, which are used by one thread only.
+
+      The policy works like CoAllocatedRefCounted but the count is not
+      changed atomically. It is meant for objects, which are owned by a
+      single thread like an event loop, where the cost of atomic operations
+      is not needed.
+  */
+  class LocalRefCounted : public CoAllocated<ObjectType, unsigned>
+  {
+      typedef CoAllocated<ObjectType, unsigned> CoAllocatedType;
+
+    protected:
+      bool unlink(ObjectType* object)
+      {
+        if (object && --CoAllocatedType::count(object) == 0)
+          CoAllocatedType::destroyObject(object);
+        return false;
+      }
+
+      void link(const LocalRefCounted& /*ptr*/, ObjectType* object)
+      {
+        if (object)
+          ++CoAllocatedType::count(object);
+      }
+  };
+
   /**
       \param ObjectType The managed object type
   */
@@ -275,7 +466,7 @@ namespace cxxtools
    *
    * This class works like a pointer, but the destructor deletes the held
    * object if this is the last reference. The policy specifies, how the class
-   * counts the references. There are 4 policies:
+   * counts the references. There are 6 policies:
    *
    *   ExternalRefCounted: allocates a reference-count
    *
@@ -287,6 +478,12 @@ namespace cxxtools
    *
    *   RefLinked: all pointers to a object are linked
    *
+   *   CoAllocatedRefCounted: like ExternalAtomicRefCounted, but the count is
+   *     allocated together with the object, which is created by create()
+   *     and not with new
+   *
+   *   LocalRefCounted: like CoAllocatedRefCounted, but not thread safe
+   *
    * The default policy is InternalRefCounted. Another class
    * cxxtools::RefCounted implements proper methods for the pointer, which
    * makes it straight-forward to use.
@@ -302,13 +499,22 @@ namespace cxxtools
       typedef OwnershipPolicy<ObjectType> OwnershipPolicyType;
       typedef DestroyPolicy<ObjectType> DestroyPolicyType;
 
+      struct CreateTag { };
+
+      SmartPtr(ObjectType* ptr, CreateTag)
+        : object(ptr)
+        { OwnershipPolicyType::link(*this, ptr); }
+
+      static void checkRawPointer()
+        { (void)sizeof(UseCreateForCoAllocatedObjects<IsCoAllocated<OwnershipPolicyType>::value>); }
+
     public:
       SmartPtr()
         : object(0)
         {}
       SmartPtr(ObjectType* ptr)
         : object(ptr)
-        { OwnershipPolicyType::link(*this, ptr); }
+        { checkRawPointer(); OwnershipPolicyType::link(*this, ptr); }
       SmartPtr(const SmartPtr& ptr)
         : object(ptr.object)
         { OwnershipPolicyType::link(ptr, ptr.object); }
@@ -351,6 +557,7 @@ namespace cxxtools
 
       SmartPtr& operator= (ObjectType* ptr)
       {
+        checkRawPointer();
         if (object != ptr)
         {
           if (OwnershipPolicyType::unlink(object))
@@ -372,6 +579,29 @@ namespace cxxtools
       operator bool () const  { return object != 0; }
 
       ObjectType* getPointer() const        { return object; }
+
+      /// Creates a new object with a policy like CoAllocatedRefCounted,
+      /// which allocates the objects itself.
+#if __cplusplus >= 201103L
+      template <typename... Args>
+      static SmartPtr create(Args&&... args)
+        { return SmartPtr(OwnershipPolicyType::construct(std::forward<Args>(args)...), CreateTag()); }
+#else
+      static SmartPtr create()
+        { return SmartPtr(OwnershipPolicyType::construct(), CreateTag()); }
+
+      template <typename A1>
+      static SmartPtr create(const A1& a1)
+        { return SmartPtr(OwnershipPolicyType::construct(a1), CreateTag()); }
+
+      template <typename A1, typename A2>
+      static SmartPtr create(const A1& a1, const A2& a2)
+        { return SmartPtr(OwnershipPolicyType::construct(a1, a2), CreateTag()); }
+
+      template <typename A1, typename A2, typename A3>
+      static SmartPtr create(const A1& a1, const A2& a2, const A3& a3)
+        { return SmartPtr(OwnershipPolicyType::construct(a1, a2, a3), CreateTag()); }
+#endif
   };
 
   template <typename T1, typename T2>
@@ -30,6 +30,8 @@
 
 #include <ios>
 #include <streambuf>
+#include <deque>
+#include <vector>
 #include <cxxtools/iodevice.h>
 
 namespace cxxtools
@@ -143,6 +145,35 @@ class StreamBuffer : public BasicStreamBuffer<char>,
          */
         void discard();
 
+        /** Appends a caller owned buffer to the output without copying it.
+         *
+         *  The data written to the stream buffer before is sent first. The
+         *  buffer and the data written afterwards are sent together with a
+         *  single vectored write. The buffer must stay valid until it is
+         *  written, i.e. until pendingOutput returns 0.
+         */
+        void borrow(const char* data, size_t size);
+
+        /** Enables or disables queueing of full output buffers.
+         *
+         *  When enabled, a full output buffer is queued and writing continues
+         *  in a new buffer instead of sending the data immediately. The queued
+         *  buffers are sent with a single vectored write on beginWrite or sync.
+         */
+        void segmented(bool sw)
+            { _osegmented = sw; }
+
+        bool segmented() const
+            { return _osegmented; }
+
+        /** Returns the number of bytes in the output buffers and borrowed
+         *  buffers, which are not written yet.
+         *
+         *  Unlike out_avail it counts the queued segments too.
+         */
+        std::streamsize pendingOutput() const
+            { return _osegmentsSize + (pptr() ? pptr() - pbase() : 0); }
+
         /** Signals, that the underlying I/O device has data to read.
          */
         Signal<StreamBuffer&> inputReady;
@@ -177,6 +208,18 @@ class StreamBuffer : public BasicStreamBuffer<char>,
 
         void onWrite(IODevice& dev);
 
+        char* allocOutputBuffer();
+
+        void releaseOutputBuffer(char* buffer);
+
+        void queuePutArea();
+
+        size_t fillIov();
+
+        void consumeOutput(size_t n);
+
+        void writeOutput();
+
     private:
         IODevice* _ioDevice;
         size_t _ibufferSize;
@@ -185,6 +228,20 @@ class StreamBuffer : public BasicStreamBuffer<char>,
         char* _obuffer;
         const size_t _pbmax;
         bool _oextend;
+        bool _osegmented;
+
+        // output, which is sent before the put area
+        struct Segment
+        {
+            const char* data;
+            size_t size;
+            char* buffer;  // output buffer to release or null if borrowed
+        };
+
+        std::deque<Segment> _osegments;
+        size_t _osegmentsSize;
+        std::vector<char*> _ofree;
+        std::vector<struct iovec> _oiov;
 };
 
 } // namespace cxxtools
@@ -384,7 +384,7 @@ std::basic_string<typename CodecType::InternT> decode(const typename CodecType::
         if (r == CodecType::partial && from_next == from)
             throw ConversionError("character conversion failed - unexpected end of input sequence");
 
-        ret.append(to, to_next);
+        ret.append(to, to_next - to);
 
         size -= (from_next - from);
         from = from_next;
@@ -434,7 +434,7 @@ std::basic_string<typename CodecType::ExternT> encode(const typename CodecType::
         if (r == CodecType::error)
             throw ConversionError("character conversion failed");
 
-        ret.append(to, to_next);
+        ret.append(to, to_next - to);
 
         size -= (from_next - from);
         from = from_next;
@@ -446,7 +446,7 @@ std::basic_string<typename CodecType::ExternT> encode(const typename CodecType::
     if (r == CodecType::error)
         throw ConversionError("character conversion failed");
 
-    ret.append(to, to_next);
+    ret.append(to, to_next - to);
 
     return ret;
 }
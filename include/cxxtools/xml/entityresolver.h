@@ -77,6 +77,9 @@ class EntityResolver
         /**
          * @brief Returns the resolved entity value (token) for the given entity.
          *
+         * The HTML4 entities are looked up in a perfect hash table generated by
+         * utils/entityhash.pl. Entities added with addEntity() are searched after that.
+         *
          * If the entity is not in the list or an dec or hex entity is invalid an exception is thrown.
          *
          * @param entity The resolved entity value for this entity is returned.
@@ -104,6 +107,14 @@ class EntityResolver
          */
         void getEntity(std::basic_ostream<Char>& os, Char ch) const;
 
+        /**
+         * @brief Outputs the given string with characters replaced by entities.
+         *
+         * The result is the same as calling getEntity() for each character but
+         * runs of characters, which need no replacement are written in one block.
+         */
+        void getEntities(std::basic_ostream<Char>& os, const String& str) const;
+
     private:
         //! Entity map containing entities which are associated to their resolved entity value.
         typedef std::map<String, String> EntityMap;
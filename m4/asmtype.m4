@@ -49,13 +49,22 @@ AC_DEFUN([AC_CXXTOOLS_ATOMICTYPE],
     [atomictype],
     AS_HELP_STRING([--with-atomictype],
                    [force atomic type. Accepted arguments:
-                    sun, windows, att_x86, att_x86_64, att_arm, att_mips, att_ppc, att_sparc32, att_sparc64, pthread,
+                    stdcxx, sun, windows, att_x86, att_x86_64, att_arm, att_mips, att_ppc, att_sparc32, att_sparc64, pthread,
                     generic, probe]),
     [ ac_cxxtools_atomicity=$withval ],
     [ ac_cxxtools_atomicity=probe ])
 
   dnl check, if atomictype is valid
 
+  dnl std::atomic of C++11
+  AC_CHECKATOMICTYPE([stdcxx], [CXXTOOLS_ATOMICITY_STDCXX],
+      [ #include <atomic>
+        #include <unistd.h>
+        #if __cplusplus < 201103L
+        #error C++11 needed
+        #endif
+        int main() { std::atomic<ssize_t> value(0); value.fetch_add(1, std::memory_order_relaxed); } ])
+
   dnl sun
   AC_CHECKATOMICTYPE([sun], [CXXTOOLS_ATOMICITY_SUN],
       [ #include <sys/atomic.h>
@@ -30,6 +30,7 @@
 #include <cxxtools/log.h>
 #include <string.h>
 #include "addrinfoimpl.h"
+#include "resolver.h"
 
 log_define("cxxtools.net.addrinfo")
 
@@ -47,21 +48,64 @@ AddrInfo::AddrInfo(AddrInfoImpl* impl)
 }
 
 
+namespace
+{
+    struct addrinfo makeHints(bool listen)
+    {
+        struct addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_socktype = SOCK_STREAM;
+        if (listen)
+            hints.ai_flags |= AI_PASSIVE;
+        return hints;
+    }
+}
+
 AddrInfo::AddrInfo(const std::string& host, unsigned short port, bool listen)
     : _impl(0)
 {
     log_debug("host=" << host << " port=" << port);
 
-    struct addrinfo hints;
-    memset(&hints, 0, sizeof(hints));
-    hints.ai_socktype = SOCK_STREAM;
-    if (listen)
-        hints.ai_flags |= AI_PASSIVE;
-    _impl = new AddrInfoImpl(host, port, hints);
+    _impl = new AddrInfoImpl(host, port, makeHints(listen));
 
     _impl->addRef();
 }
 
+AddrInfo AddrInfo::beginResolve(const std::string& host, unsigned short port, bool listen)
+{
+    log_debug("begin resolve host=" << host << " port=" << port);
+
+    AddrInfo ret(new AddrInfoImpl());
+    ret._impl->beginResolve(host, port, makeHints(listen));
+    return ret;
+}
+
+bool AddrInfo::isResolved() const
+{
+    return _impl == 0 || _impl->isResolved();
+}
+
+void AddrInfo::endResolve()
+{
+    if (_impl)
+        _impl->endResolve();
+}
+
+void AddrInfo::cacheTimeout(Timespan t)
+{
+    Resolver::cacheTimeout(t);
+}
+
+Timespan AddrInfo::cacheTimeout()
+{
+    return Resolver::cacheTimeout();
+}
+
+void AddrInfo::clearCache()
+{
+    Resolver::clearCache();
+}
+
 AddrInfo::AddrInfo(const AddrInfo& src)
     : _impl(src._impl)
 {
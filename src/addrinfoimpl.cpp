@@ -52,31 +52,45 @@ namespace net
   void AddrInfoImpl::init(const std::string& host, unsigned short port,
     const addrinfo& hints)
   {
-    if (_ai)
-    {
-      freeaddrinfo(_ai);
-      _ai = 0;
-    }
+    beginResolve(host, port, hints);
+    endResolve();
+  }
 
+  void AddrInfoImpl::beginResolve(const std::string& host, unsigned short port,
+    const addrinfo& hints)
+  {
     _host = host;
     _port = port;
+    _ai = 0;
+    _list = 0;
+    _job = 0;
 
     std::ostringstream p;
     p << port;
 
-    // TODO: exception type
-    if (0 != ::getaddrinfo(host.empty() ? 0 : host.c_str(), p.str().c_str(), &hints, &_ai))
-      throw SystemError(0, ("invalid ipaddress \"" + host + '"').c_str());
-
-    // TODO: exception type
-    if (_ai == 0)
-      throw SystemError("getaddrinfo");
+    _list = Resolver::lookup(host, p.str(), hints);
+    if (_list)
+      _ai = _list->get();
+    else
+      _job = Resolver::beginResolve(host, p.str(), hints);
   }
 
-  AddrInfoImpl::~AddrInfoImpl()
+  void AddrInfoImpl::endResolve()
   {
-    if (_ai)
-      freeaddrinfo(_ai);
+    if (!_job)
+      return;
+
+    _job->wait();
+
+    SmartPtr<ResolveJob> job = _job;
+    _job = 0;
+
+    // TODO: exception type
+    if (job->error() != 0)
+      throw SystemError(0, ("invalid ipaddress \"" + _host + '"').c_str());
+
+    _list = job->result();
+    _ai = _list->get();
   }
 
   const std::string& AddrInfoImpl::host() const
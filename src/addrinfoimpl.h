@@ -30,6 +30,8 @@
 #define CXXTOOLS_ADDRINFO_H
 
 #include <cxxtools/refcounted.h>
+#include <cxxtools/smartptr.h>
+#include "resolver.h"
 #include <string>
 #include <iterator>
 #include <sys/types.h>
@@ -44,6 +46,8 @@ namespace net {
   {
       std::string _host;
       unsigned short _port;
+      SmartPtr<AddrInfoList> _list;
+      SmartPtr<ResolveJob> _job;
       struct addrinfo* _ai;
 
     public:
@@ -52,7 +56,8 @@ namespace net {
                 const addrinfo& hints);
 
       AddrInfoImpl()
-        : _ai(0)
+        : _port(0),
+          _ai(0)
         { }
       AddrInfoImpl(const std::string& host, unsigned short port)
         : _ai(0)
@@ -61,7 +66,23 @@ namespace net {
                const addrinfo& hints)
         : _ai(0)
         { init(host, port, hints); }
-      ~AddrInfoImpl();
+
+      /// Starts resolving the host. The result is taken from the cache or
+      /// from a numeric address at once if possible.
+      void beginResolve(const std::string& host, unsigned short port,
+                const addrinfo& hints);
+
+      /// Returns true, when no lookup is running.
+      bool isResolved() const
+      { return !_job || _job->done(); }
+
+      /// Waits for the lookup and throws an exception, when it failed.
+      void endResolve();
+
+      /// Returns a file descriptor, which becomes readable when the lookup
+      /// is finished or -1 if no lookup is running.
+      int resolveFd() const
+      { return _job ? _job->fd() : -1; }
 
       class const_iterator : public std::iterator<std::forward_iterator_tag, addrinfo>
       {
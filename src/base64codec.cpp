@@ -28,6 +28,16 @@
 
 #include <cxxtools/base64codec.h>
 #include <cctype>
+#include <cstring>
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace cxxtools
 {
@@ -64,7 +74,7 @@ inline uint8_t fromBase64(char b64)
             255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
             255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255 };
 
-    return b64dec[(int)b64];
+    return b64dec[static_cast<unsigned char>(b64)];
 }
 
 // returns number of available non space bytes up to N
@@ -95,6 +105,228 @@ char readByte(MBState& s, const char*& fromNext)
     }
 }
 
+////////////////////////////////////////////////////////////////////////
+// block kernels
+//
+// The kernels convert complete groups of 3 bytes and 4 base64 characters
+// without line breaks, white space or padding. The vector versions are
+// used when the compiler targets the instruction set: decoding uses SSE2
+// and AVX2, encoding needs the byte shuffles of SSSE3 or AVX2.
+//
+
+#if defined(__SSE2__)
+inline __m128i load16(const void* p)
+{ return _mm_loadu_si128(static_cast<const __m128i*>(p)); }
+
+// translates 16 base64 characters to their values
+inline bool decodeValues(__m128i c, __m128i& v)
+{
+    __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('Z' + 1)));
+    __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('z' + 1)));
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+    __m128i plus  = _mm_cmpeq_epi8(c, _mm_set1_epi8('+'));
+    __m128i slash = _mm_cmpeq_epi8(c, _mm_set1_epi8('/'));
+
+    __m128i valid = _mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, plus)), slash);
+    if (_mm_movemask_epi8(valid) != 0xffff)
+        return false;
+
+    __m128i shift = _mm_or_si128(
+        _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+                     _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+        _mm_or_si128(_mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+                                  _mm_and_si128(plus, _mm_set1_epi8(62 - '+'))),
+                     _mm_and_si128(slash, _mm_set1_epi8(63 - '/'))));
+
+    v = _mm_add_epi8(c, shift);
+    return true;
+}
+
+// decodes 16 characters to 12 bytes
+inline bool decode16(const char* in, char* out)
+{
+    __m128i v;
+    if (!decodeValues(load16(in), v))
+        return false;
+
+    // merge the 6 bit values to 24 bit values in each 32 bit lane
+#if defined(__SSSE3__)
+    v = _mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+#else
+    v = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(v, _mm_set1_epi16(0xff)), 6), _mm_srli_epi16(v, 8));
+#endif
+    v = _mm_madd_epi16(v, _mm_set1_epi32(0x00011000));
+
+#if defined(__SSSE3__)
+    v = _mm_shuffle_epi8(v, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out), v);
+    uint32_t last = _mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+    std::memcpy(out + 8, &last, 4);
+#else
+    uint32_t lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), v);
+    for (unsigned n = 0; n < 4; ++n)
+    {
+        out[3 * n]     = static_cast<char>(lanes[n] >> 16);
+        out[3 * n + 1] = static_cast<char>(lanes[n] >> 8);
+        out[3 * n + 2] = static_cast<char>(lanes[n]);
+    }
+#endif
+
+    return true;
+}
+#endif
+
+#if defined(__SSSE3__)
+// encodes 12 bytes from the 16 bytes of in to 16 characters
+// (Wojciech Mula, Daniel Lemire: Faster Base64 Encoding and Decoding
+// Using AVX2 Instructions, 2018)
+inline __m128i encode12(__m128i in)
+{
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+    __m128i t1 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+    __m128i indices = _mm_or_si128(t0, t1);
+
+    // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+    __m128i result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+
+    const __m128i shift = _mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0);
+
+    return _mm_add_epi8(_mm_shuffle_epi8(shift, result), indices);
+}
+#endif
+
+#if defined(__AVX2__)
+inline bool decode32(const char* in, char* out)
+{
+    __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+
+    __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), c));
+    __m256i lower = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), c));
+    __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+    __m256i plus  = _mm256_cmpeq_epi8(c, _mm256_set1_epi8('+'));
+    __m256i slash = _mm256_cmpeq_epi8(c, _mm256_set1_epi8('/'));
+
+    __m256i valid = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(digit, plus)), slash);
+    if (_mm256_movemask_epi8(valid) != -1)
+        return false;
+
+    __m256i shift = _mm256_or_si256(
+        _mm256_or_si256(_mm256_and_si256(upper, _mm256_set1_epi8(-'A')),
+                        _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a'))),
+        _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')),
+                                        _mm256_and_si256(plus, _mm256_set1_epi8(62 - '+'))),
+                        _mm256_and_si256(slash, _mm256_set1_epi8(63 - '/'))));
+
+    __m256i v = _mm256_add_epi8(c, shift);
+    v = _mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140));
+    v = _mm256_madd_epi16(v, _mm256_set1_epi32(0x00011000));
+    v = _mm256_shuffle_epi8(v, _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    v = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(v));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 16), _mm256_extracti128_si256(v, 1));
+    return true;
+}
+
+inline __m256i encode24(__m256i in)
+{
+    in = _mm256_shuffle_epi8(in, _mm256_set_epi8(
+        10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+        10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    __m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+    __m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+    __m256i indices = _mm256_or_si256(t0, t1);
+
+    __m256i result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+    result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+
+    const __m256i shift = _mm256_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0,
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0);
+
+    return _mm256_add_epi8(_mm256_shuffle_epi8(shift, result), indices);
+}
+#endif
+
+// decodes up to n groups of 4 characters and returns the number of
+// decoded groups; stops at the first group with other characters than
+// the base64 alphabet
+std::size_t decodeGroups(const char* in, std::size_t n, char* out)
+{
+    std::size_t done = 0;
+
+#if defined(__AVX2__)
+    for ( ; n - done >= 8 && decode32(in + 4 * done, out + 3 * done); done += 8)
+        ;
+#endif
+
+#if defined(__SSE2__)
+    for ( ; n - done >= 4 && decode16(in + 4 * done, out + 3 * done); done += 4)
+        ;
+#endif
+
+    for ( ; done < n; ++done)
+    {
+        const char* i = in + 4 * done;
+        uint8_t first  = fromBase64(i[0]);
+        uint8_t second = fromBase64(i[1]);
+        uint8_t third  = fromBase64(i[2]);
+        uint8_t fourth = fromBase64(i[3]);
+        if ((first | second | third | fourth) >= 64)
+            break;
+
+        char* o = out + 3 * done;
+        o[0] = (first << 2) + (second >> 4);
+        o[1] = (second << 4) + (third >> 2);
+        o[2] = (third << 6) + fourth;
+    }
+
+    return done;
+}
+
+// encodes n groups of 3 bytes
+void encodeGroups(const char* in, std::size_t n, char* out)
+{
+    // the vector loads read 4 bytes more than they encode
+#if defined(__AVX2__)
+    for ( ; n >= 10; n -= 8, in += 24, out += 32)
+    {
+        __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(load16(in)), load16(in + 12), 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), encode24(v));
+    }
+#endif
+
+#if defined(__SSSE3__)
+    for ( ; n >= 6; n -= 4, in += 12, out += 16)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), encode12(load16(in)));
+#endif
+
+    for ( ; n > 0; --n, in += 3, out += 4)
+    {
+        unsigned char a = static_cast<unsigned char>(in[0]);
+        unsigned char b = static_cast<unsigned char>(in[1]);
+        unsigned char c = static_cast<unsigned char>(in[2]);
+        out[0] = toBase64(a >> 2);
+        out[1] = toBase64(((a << 4) | (b >> 4)) & 0x3f);
+        out[2] = toBase64(((b << 2) | (c >> 6)) & 0x3f);
+        out[3] = toBase64(c & 0x3f);
+    }
+}
+
 }
 
 
@@ -110,8 +342,30 @@ Base64Codec::result Base64Codec::do_in(MBState& s,
     fromNext = fromBegin;
     toNext = toBegin;
 
-    while ( numBytesN(4, s, fromNext, fromEnd) >= 4 && (toEnd - toNext) >= 3 )
+    while (true)
     {
+        // Complete groups are decoded in blocks. White space between
+        // groups, usually line breaks, is skipped here.
+        while (s.n == 0)
+        {
+            std::size_t groups = std::min<std::size_t>((fromEnd - fromNext) / 4, (toEnd - toNext) / 3);
+            std::size_t count = decodeGroups(fromNext, groups, toNext);
+            fromNext += 4 * count;
+            toNext += 3 * count;
+
+            const char* p = fromNext;
+            while (p < fromEnd && std::isspace(*p))
+                ++p;
+
+            if (p == fromNext)
+                break;
+
+            fromNext = p;
+        }
+
+        if (numBytesN(4, s, fromNext, fromEnd) < 4 || (toEnd - toNext) < 3)
+            break;
+
         uint8_t first  = fromBase64(readByte(s, fromNext));
         uint8_t second = fromBase64(readByte(s, fromNext));
         uint8_t third  = fromBase64(readByte(s, fromNext));
@@ -161,6 +415,31 @@ Base64Codec::result Base64Codec::do_out(cxxtools::MBState& state,
 
     while (fromEnd - fromNext > 0)
     {
+        // Complete groups are encoded in blocks up to the end of the line.
+        // Like below the last bytes are kept in the state until more input
+        // or the unshift arrives.
+        while (state.n == 1 && fromEnd - fromNext > 3)
+        {
+            if (col + 4 > maxcol)
+            {
+                if (toEnd - toNext < 6)
+                    break;
+                *toNext++ = '\r';
+                *toNext++ = '\n';
+                col = 0;
+            }
+
+            std::size_t groups = std::min<std::size_t>(std::min<std::size_t>(
+                (fromEnd - fromNext - 1) / 3, (toEnd - toNext) / 4), (maxcol - col) / 4);
+            if (groups == 0)
+                break;
+
+            encodeGroups(fromNext, groups, toNext);
+            fromNext += 3 * groups;
+            toNext += 4 * groups;
+            col += 4 * groups;
+        }
+
         if (state.n == 4)
         {
             if (toEnd - toNext < 4)
@@ -257,4 +536,48 @@ Base64Codec::result Base64Codec::do_unshift(MBState& state,
     return std::codecvt_base::ok;
 }
 
+
+std::string Base64Codec::decode(const char* data, unsigned size)
+{
+    // the result is decoded in one call into a buffer large enough for
+    // data without white space
+    Base64Codec codec;
+    MBState state;
+    std::string ret(size / 4 * 3 + 3, '\0');
+
+    const char* fromNext;
+    char* toNext;
+    result r = codec.in(state, data, data + size, fromNext, &ret[0], &ret[0] + ret.size(), toNext);
+
+    if (r == std::codecvt_base::error)
+        throw ConversionError("character conversion failed");
+
+    if (r == std::codecvt_base::partial)
+        throw ConversionError("character conversion failed - unexpected end of input sequence");
+
+    ret.resize(toNext - &ret[0]);
+    return ret;
+}
+
+
+std::string Base64Codec::encode(const char* data, unsigned size)
+{
+    // 4 characters for each started group of 3 bytes and a line break
+    // after 19 groups
+    std::size_t groups = (size + 2) / 3;
+    Base64Codec codec;
+    MBState state;
+    std::string ret(groups * 4 + groups / 19 * 2 + 8, '\0');
+
+    const char* fromNext;
+    char* toNext;
+    codec.out(state, data, data + size, fromNext, &ret[0], &ret[0] + ret.size(), toNext);
+
+    char* unshiftBegin = toNext;
+    codec.unshift(state, unshiftBegin, &ret[0] + ret.size(), toNext);
+
+    ret.resize(toNext - &ret[0]);
+    return ret;
+}
+
 }
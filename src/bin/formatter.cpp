@@ -32,6 +32,7 @@
 #include <cxxtools/convert.h>
 #include <cxxtools/log.h>
 #include <limits>
+#include <cstring>
 #include <stdint.h>
 #include <math.h>
 
@@ -390,15 +391,29 @@ void Formatter::addValueFloat(const std::string& name, const std::string& type,
     {
         bool isNeg = value < 0;
         int exp;
-        long double s = frexp(isNeg ? -value : value, &exp);
-        uint64_t m = static_cast<uint64_t>((std::numeric_limits<uint64_t>::max() + 1.0l) * (s * 2.0l - 1.0l));
-        if (m < 5 && s > .9)
+        uint64_t m;
+
+        double d = static_cast<double>(isNeg ? -value : value);
+        if (d == (isNeg ? -value : value) && d >= std::numeric_limits<double>::min())
+        {
+            // normalized double; take mantissa and exponent from the bits
+            uint64_t bits;
+            std::memcpy(&bits, &d, sizeof(bits));
+            m = bits << 12;
+            exp = static_cast<int>((bits >> 52) & 0x7ff) - 1022;
+        }
+        else
         {
-            // this must be an overflow, which may happen when long double has a very high resolution
-            m = std::numeric_limits<uint64_t>::max();
+            long double s = frexp(isNeg ? -value : value, &exp);
+            m = static_cast<uint64_t>((std::numeric_limits<uint64_t>::max() + 1.0l) * (s * 2.0l - 1.0l));
+            if (m < 5 && s > .9)
+            {
+                // this must be an overflow, which may happen when long double has a very high resolution
+                m = std::numeric_limits<uint64_t>::max();
+            }
         }
 
-        log_debug("value=" << value << " s=" << s << " man=" << std::hex << m << std::dec << " exp=" << exp << " neg=" << isNeg);
+        log_debug("value=" << value << " man=" << std::hex << m << std::dec << " exp=" << exp << " neg=" << isNeg);
 
         if (areLowerBitsSet(m, 32) || exp > 63 || exp < -63)
         {
@@ -30,6 +30,8 @@
 #include "rpcserverimpl.h"
 #include <cxxtools/bin/parser.h>
 #include <cxxtools/serviceprocedure.h>
+#include <cxxtools/resultstream.h>
+#include <cxxtools/ioerror.h>
 #include <cxxtools/remoteexception.h>
 #include <cxxtools/log.h>
 
@@ -56,6 +58,57 @@ void Responder::reply(IOStream& out)
     out << '\xff';
 }
 
+void Responder::replyStream(IOStream& out, IStreamDecomposer& result)
+{
+    log_info("send streamed reply");
+
+    // The elements are flushed to the client, whenever a few kilobytes are
+    // collected. Writing blocks, when the client does not read fast enough,
+    // so that the generator is not run ahead of the consumer. The write
+    // timeout of the socket limits the time the worker thread is blocked.
+    static const std::streamsize flushSize = 8192;
+
+    out << '\xc3';
+    _formatter.begin(out);
+
+    try
+    {
+        while (result.formatNext(_formatter))
+        {
+            if (out.buffer().pendingOutput() >= flushSize)
+            {
+                out.flush();
+                if (!out)
+                    break;
+            }
+        }
+    }
+    catch (const RemoteException& e)
+    {
+        _formatter.finish();
+        replyError(out, e.what(), e.rc());
+        return;
+    }
+    catch (const std::exception& e)
+    {
+        _formatter.finish();
+        replyError(out, e.what(), 0);
+        return;
+    }
+
+    _formatter.finish();
+
+    if (!out)
+    {
+        // the client did not receive the data in time or is gone; the
+        // exception closes the connection
+        log_warn("sending streamed reply failed");
+        throw IOError("sending streamed reply failed");
+    }
+
+    out << '\xff';
+}
+
 void Responder::replyError(IOStream& out, const char* msg, int rc)
 {
     log_info("send error \"" << msg << '"');
@@ -75,16 +128,43 @@ bool Responder::onInput(IOStream& ios)
     {
         if (advance(ios.buffer().sbumpc()))
         {
-            if (_failed)
+            bool replied = !_oneway;
+
+            if (_oneway)
+            {
+                if (_failed)
+                {
+                    log_warn("one way call failed: " << _errorMessage);
+                }
+                else
+                {
+                    try
+                    {
+                        _proc->endCall();
+                    }
+                    catch (const std::exception& e)
+                    {
+                        log_warn("one way call failed: " << e.what());
+                    }
+                }
+            }
+            else if (_failed)
             {
                 replyError(ios, _errorMessage.c_str(), 0);
             }
             else
             {
+                IStreamDecomposer* stream = 0;
+
                 try
                 {
                     _result = _proc->endCall();
-                    reply(ios);
+
+                    if (_acceptStream)
+                        stream = dynamic_cast<IStreamDecomposer*>(_result);
+
+                    if (stream == 0)
+                        reply(ios);
                 }
                 catch (const RemoteException& e)
                 {
@@ -96,6 +176,11 @@ bool Responder::onInput(IOStream& ios)
                     ios.buffer().discard();
                     replyError(ios, e.what(), 0);
                 }
+
+                // errors of the generator are sent to the client; a failure
+                // to send is passed to the socket, which closes the connection
+                if (stream)
+                    replyStream(ios, *stream);
             }
 
             _serviceRegistry.releaseProcedure(_proc);
@@ -103,10 +188,13 @@ bool Responder::onInput(IOStream& ios)
             _args = 0;
             _result = 0;
             _state = state_0;
+            _oneway = false;
+            _acceptStream = false;
             _failed = false;
             _errorMessage.clear();
 
-            return true;
+            if (replied)
+                return true;
         }
     }
 
@@ -118,12 +206,18 @@ bool Responder::advance(char ch)
     switch (_state)
     {
         case state_0:
-            if (ch == '\xc0')
+            // \xc0 and \xc3 start a call without and with domain, \xc4 and
+            // \xc5 a one way call, which is not answered and \xc6 and \xc7 a
+            // call, which accepts a streamed result
+            if (ch == '\xc0' || ch == '\xc4' || ch == '\xc6')
                 _state = state_method;
-            else if (ch == '\xc3')
+            else if (ch == '\xc3' || ch == '\xc5' || ch == '\xc7')
                 _state = state_domain;
             else
                 throw std::runtime_error("domain or method name expected");
+
+            _oneway = (ch == '\xc4' || ch == '\xc5');
+            _acceptStream = (ch == '\xc6' || ch == '\xc7');
             break;
 
         case state_domain:
@@ -40,6 +40,7 @@ namespace cxxtools
 class ServiceProcedure;
 class IComposer;
 class IDecomposer;
+class IStreamDecomposer;
 
 namespace bin
 {
@@ -68,6 +69,8 @@ class Responder
               _proc(0),
               _args(0),
               _result(0),
+              _oneway(false),
+              _acceptStream(false),
               _failed(false)
         { }
 
@@ -77,6 +80,7 @@ class Responder
         bool onInput(IOStream& ios);
         bool advance(char ch);
         void reply(IOStream& out);
+        void replyStream(IOStream& out, IStreamDecomposer& result);
         void replyError(IOStream& out, const char* msg, int rc);
 
     private:
@@ -91,6 +95,8 @@ class Responder
         IDecomposer* _result;
         Formatter _formatter;
 
+        bool _oneway;
+        bool _acceptStream;
         bool _failed;
         std::string _errorMessage;
 };
@@ -123,7 +123,7 @@ void RpcClient::prepareConnect(const net::AddrInfo& addrinfo, const std::string&
 
 void RpcClient::prepareConnect(const std::string& host, unsigned short int port, const std::string& domain_)
 {
-    prepareConnect(net::AddrInfo(host, port));
+    prepareConnect(net::AddrInfo::beginResolve(host, port));
     domain(domain_);
 }
 
@@ -131,7 +131,7 @@ void RpcClient::prepareConnect(const net::Uri& uri, const std::string& domain_)
 {
     if (uri.protocol() != "http")
         throw std::runtime_error("only http is supported by http client");
-    prepareConnect(net::AddrInfo(uri.host(), uri.port()));
+    prepareConnect(net::AddrInfo::beginResolve(uri.host(), uri.port()));
     domain(domain_);
 }
 
@@ -166,6 +166,27 @@ void RpcClient::call(IComposer& r, IRemoteProcedure& method, IDecomposer** argv,
     _impl->call(r, method, argv, argc);
 }
 
+void RpcClient::beginStream(IComposer& element, IRemoteStream& stream, IDecomposer** argv, unsigned argc)
+{
+    _impl->beginStream(element, stream, argv, argc);
+}
+
+void RpcClient::callStream(IComposer& element, IRemoteStream& stream, IDecomposer** argv, unsigned argc)
+{
+    _impl->callStream(element, stream, argv, argc);
+}
+
+void RpcClient::resumeStream()
+{
+    if (_impl)
+        _impl->resumeStream();
+}
+
+void RpcClient::notify(const String& method, IDecomposer** argv, unsigned argc)
+{
+    getImpl()->notify(method, argv, argc);
+}
+
 Milliseconds RpcClient::timeout() const
 {
     return getImpl()->timeout();
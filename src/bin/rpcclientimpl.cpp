@@ -30,6 +30,7 @@
 #include <cxxtools/log.h>
 #include <cxxtools/remoteprocedure.h>
 #include <cxxtools/bin/rpcclient.h>
+#include <cxxtools/bin/remotestream.h>
 #include <cxxtools/selector.h>
 #include <cxxtools/clock.h>
 #include <stdexcept>
@@ -45,6 +46,8 @@ RpcClientImpl::RpcClientImpl()
     : _stream(_socket, 8192, true),
       _exceptionPending(false),
       _proc(0),
+      _remoteStream(0),
+      _streamPaused(false),
       _timeout(Selectable::WaitInfinite),
       _connectTimeoutSet(false),
       _connectTimeout(Selectable::WaitInfinite)
@@ -77,7 +80,31 @@ void RpcClientImpl::beginCall(IComposer& r, IRemoteProcedure& method, IDecompose
     _proc = &method;
 
     prepareRequest(method.name(), argv, argc);
+    sendRequest();
 
+    _scanner.begin(_deserializer, r);
+}
+
+void RpcClientImpl::beginStream(IComposer& element, IRemoteStream& stream, IDecomposer** argv, unsigned argc)
+{
+    if (_socket.selector() == 0)
+        throw std::logic_error("cannot run async rpc request without a selector");
+
+    if (_proc)
+        throw std::logic_error("asyncronous request already running");
+
+    _proc = &stream;
+    _remoteStream = &stream;
+    _streamPaused = false;
+
+    prepareRequest(stream.name(), argv, argc, request_stream);
+    sendRequest();
+
+    _scanner.begin(_deserializer, element, &stream);
+}
+
+void RpcClientImpl::sendRequest()
+{
     try
     {
         if (_socket.isConnected())
@@ -109,8 +136,6 @@ void RpcClientImpl::beginCall(IComposer& r, IRemoteProcedure& method, IDecompose
         if (_exceptionPending)
             throw;
     }
-
-    _scanner.begin(_deserializer, r);
 }
 
 void RpcClientImpl::endCall()
@@ -126,10 +151,22 @@ void RpcClientImpl::endCall()
 }
 
 void RpcClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer** argv, unsigned argc)
+{
+    _remoteStream = 0;
+    execute(r, method, argv, argc, request_call);
+}
+
+void RpcClientImpl::callStream(IComposer& element, IRemoteStream& stream, IDecomposer** argv, unsigned argc)
+{
+    _remoteStream = &stream;
+    execute(element, stream, argv, argc, request_stream);
+}
+
+void RpcClientImpl::execute(IComposer& r, IRemoteProcedure& method, IDecomposer** argv, unsigned argc, RequestType type)
 {
     _proc = &method;
 
-    prepareRequest(_proc->name(), argv, argc);
+    prepareRequest(_proc->name(), argv, argc, type);
 
     if (!_socket.isConnected())
     {
@@ -143,7 +180,7 @@ void RpcClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer** a
     {
         _stream.flush();
 
-        _scanner.begin(_deserializer, r);
+        _scanner.begin(_deserializer, r, _remoteStream);
 
         StreamBuffer& sb = _stream.buffer();
 
@@ -160,6 +197,7 @@ void RpcClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer** a
             if ( _scanner.advance( StreamBuffer::traits_type::to_char_type(ch) ) )
             {
                 _proc = 0;
+                _remoteStream = 0;
                 _scanner.finish();
                 break;
             }
@@ -176,12 +214,66 @@ void RpcClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer** a
     }
 }
 
+void RpcClientImpl::notify(const String& name, IDecomposer** argv, unsigned argc)
+{
+    if (_proc)
+        throw std::logic_error("asyncronous request already running");
+
+    prepareRequest(name, argv, argc, request_oneway);
+    _formatter.finish();
+
+    if (!_socket.isConnected())
+    {
+        _socket.setTimeout(_connectTimeout);
+        _socket.connect(_addrInfo);
+    }
+
+    _socket.setTimeout(timeout());
+
+    _stream.flush();
+
+    if (!_stream)
+    {
+        cancel();
+        throw IOError("sending request failed");
+    }
+}
+
+void RpcClientImpl::resumeStream()
+{
+    if (!_streamPaused)
+        return;
+
+    try
+    {
+        _exceptionPending = false;
+        _streamPaused = false;
+        processInput();
+    }
+    catch (const std::exception&)
+    {
+        IRemoteProcedure* proc = _proc;
+        cancel();
+
+        if (!proc)
+            throw;
+
+        _exceptionPending = true;
+        proc->onFinished();
+
+        if (_exceptionPending)
+            throw;
+    }
+}
+
 void RpcClientImpl::cancel()
 {
     _socket.close();
     _stream.clear();
     _stream.buffer().discard();
     _proc = 0;
+    _remoteStream = 0;
+    _streamPaused = false;
 }
 
 void RpcClientImpl::wait(Timespan timeout)
@@ -209,13 +301,22 @@ void RpcClientImpl::wait(Timespan timeout)
     }
 }
 
-void RpcClientImpl::prepareRequest(const String& name, IDecomposer** argv, unsigned argc)
+void RpcClientImpl::prepareRequest(const String& name, IDecomposer** argv, unsigned argc,
+                                   RequestType type)
 {
+    // the markers for requests without domain are \xc0, \xc4 and \xc6 and
+    // for requests with domain \xc3, \xc5 and \xc7
+    static const char markers[3][2] = {
+        { '\xc0', '\xc3' },
+        { '\xc4', '\xc5' },
+        { '\xc6', '\xc7' }
+    };
+
     _formatter.begin(_stream);
     if (_domain.empty())
-        _stream << '\xc0' << name << '\0';
+        _stream << markers[type][0] << name << '\0';
     else
-        _stream << '\xc3' << _domain << '\0' << name << '\0';
+        _stream << markers[type][1] << _domain << '\0' << name << '\0';
 
     for(unsigned n = 0; n < argc; ++n)
     {
@@ -258,7 +359,7 @@ void RpcClientImpl::onOutput(StreamBuffer& sb)
     {
         _exceptionPending = false;
         sb.endWrite();
-        if (sb.out_avail() > 0)
+        if (sb.pendingOutput() > 0)
             sb.beginWrite();
         else
             sb.beginRead();
@@ -289,26 +390,7 @@ void RpcClientImpl::onInput(StreamBuffer& sb)
         if (sb.device()->eof())
             throw IOError("end of input");
 
-        while (_stream.buffer().in_avail())
-        {
-            char ch = StreamBuffer::traits_type::to_char_type(_stream.buffer().sbumpc());
-            if (_scanner.advance(ch))
-            {
-                _scanner.finish();
-                IRemoteProcedure* proc = _proc;
-                _proc = 0;
-                proc->onFinished();
-                return;
-            }
-        }
-
-        if (!_stream)
-        {
-            close();
-            throw std::runtime_error("reading result failed");
-        }
-
-        sb.beginRead();
+        processInput();
     }
     catch (const std::exception&)
     {
@@ -326,5 +408,41 @@ void RpcClientImpl::onInput(StreamBuffer& sb)
     }
 }
 
+void RpcClientImpl::processInput()
+{
+    StreamBuffer& sb = _stream.buffer();
+
+    while (sb.in_avail())
+    {
+        char ch = StreamBuffer::traits_type::to_char_type(sb.sbumpc());
+        if (_scanner.advance(ch))
+        {
+            _scanner.finish();
+            IRemoteProcedure* proc = _proc;
+            _proc = 0;
+            _remoteStream = 0;
+            proc->onFinished();
+            return;
+        }
+
+        if (_remoteStream && _remoteStream->paused())
+        {
+            // no more input is read until the stream is resumed, so that the
+            // server is blocked, when the socket buffers are full
+            log_debug("stream paused");
+            _streamPaused = true;
+            return;
+        }
+    }
+
+    if (!_stream)
+    {
+        close();
+        throw std::runtime_error("reading result failed");
+    }
+
+    sb.beginRead();
+}
+
 }
 }
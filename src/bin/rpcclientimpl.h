@@ -49,6 +49,8 @@ class SelectorBase;
 namespace bin
 {
 
+class IRemoteStream;
+
 class RpcClientImpl : public RefCounted, public Connectable
 {
         RpcClientImpl(RpcClientImpl&);
@@ -76,6 +78,14 @@ class RpcClientImpl : public RefCounted, public Connectable
 
         void call(IComposer& r, IRemoteProcedure& method, IDecomposer** argv, unsigned argc);
 
+        void beginStream(IComposer& element, IRemoteStream& stream, IDecomposer** argv, unsigned argc);
+
+        void callStream(IComposer& element, IRemoteStream& stream, IDecomposer** argv, unsigned argc);
+
+        void resumeStream();
+
+        void notify(const String& name, IDecomposer** argv, unsigned argc);
+
         Timespan timeout() const  { return _timeout; }
         void timeout(Timespan t)  { _timeout = t; if (!_connectTimeoutSet) _connectTimeout = t; }
 
@@ -96,10 +106,22 @@ class RpcClientImpl : public RefCounted, public Connectable
         { _domain = p; }
 
     private:
-        void prepareRequest(const String& name, IDecomposer** argv, unsigned argc);
+        enum RequestType
+        {
+            request_call,
+            request_oneway,
+            request_stream
+        };
+
+        void prepareRequest(const String& name, IDecomposer** argv, unsigned argc,
+                            RequestType type = request_call);
         void onConnect(net::TcpSocket& socket);
         void onOutput(StreamBuffer& sb);
         void onInput(StreamBuffer& sb);
+        void processInput();
+        void sendRequest();
+        void execute(IComposer& r, IRemoteProcedure& method, IDecomposer** argv, unsigned argc,
+                     RequestType type);
 
         // connection state
         net::TcpSocket _socket;
@@ -115,6 +137,8 @@ class RpcClientImpl : public RefCounted, public Connectable
 
         bool _exceptionPending;
         IRemoteProcedure* _proc;
+        IRemoteStream* _remoteStream;
+        bool _streamPaused;       // input processing stopped by a paused stream
 
         Timespan _timeout;
         bool _connectTimeoutSet;  // indicates if connectTimeout is explicitely set
@@ -104,5 +104,25 @@ void RpcServer::maxThreads(unsigned m)
     _impl->maxThreads(m);
 }
 
+void RpcServer::socketOptions(const net::SocketOptions& options)
+{
+    _impl->socketOptions(options);
+}
+
+const net::SocketOptions& RpcServer::socketOptions() const
+{
+    return _impl->socketOptions();
+}
+
+Milliseconds RpcServer::writeTimeout() const
+{
+    return _impl->writeTimeout();
+}
+
+void RpcServer::writeTimeout(Milliseconds ms)
+{
+    _impl->writeTimeout(ms);
+}
+
 }
 }
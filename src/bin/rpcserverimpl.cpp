@@ -101,7 +101,8 @@ RpcServerImpl::RpcServerImpl(EventLoopBase& eventLoop, Signal<RpcServer::Runmode
       inputSlot(slot(*this, &RpcServerImpl::onInput)),
       _serviceRegistry(serviceRegistry),
       _minThreads(5),
-      _maxThreads(200)
+      _maxThreads(200),
+      _writeTimeout(Seconds(20))
 {
     _eventLoop.event.subscribe(slot(*this, &RpcServerImpl::onIdleSocket));
     _eventLoop.event.subscribe(slot(*this, &RpcServerImpl::onNoWaitingThreads));
@@ -132,11 +133,13 @@ RpcServerImpl::~RpcServerImpl()
 void RpcServerImpl::listen(const std::string& ip, unsigned short int port, int backlog)
 {
     log_info("listen on " << ip << " port " << port);
-    net::TcpServer* listener = new net::TcpServer(ip, port, backlog,
-        net::TcpServer::DEFER_ACCEPT|net::TcpServer::REUSEADDR);
+    net::TcpServer* listener = new net::TcpServer();
 
     try
     {
+        listener->socketOptions(_socketOptions);
+        listener->listen(ip, port, backlog,
+            net::TcpServer::DEFER_ACCEPT|net::TcpServer::REUSEADDR);
         _listener.push_back(listener);
         _queue.put(new Socket(*this, _serviceRegistry, *listener));
     }
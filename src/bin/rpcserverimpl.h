@@ -83,6 +83,18 @@ namespace cxxtools
                 void maxThreads(unsigned m)
                 { _maxThreads = m; }
 
+                const net::SocketOptions& socketOptions() const
+                { return _socketOptions; }
+
+                void socketOptions(const net::SocketOptions& options)
+                { _socketOptions = options; }
+
+                Milliseconds writeTimeout() const
+                { return _writeTimeout; }
+
+                void writeTimeout(Milliseconds ms)
+                { _writeTimeout = ms; }
+
                 void terminate();
 
                 RpcServer::Runmode runmode() const
@@ -120,6 +132,8 @@ namespace cxxtools
                 ServiceRegistry& _serviceRegistry;
                 unsigned _minThreads;
                 unsigned _maxThreads;
+                net::SocketOptions _socketOptions;
+                Milliseconds _writeTimeout;
 
                 std::vector<net::TcpServer*> _listener;
                 Queue<Socket*> _queue;
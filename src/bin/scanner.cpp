@@ -30,6 +30,7 @@
 #include <cxxtools/log.h>
 #include <cxxtools/remoteexception.h>
 #include <cxxtools/bin/deserializer.h>
+#include <cxxtools/bin/remotestream.h>
 
 log_define("cxxtools.bin.scanner")
 
@@ -38,11 +39,12 @@ namespace cxxtools
 namespace bin
 {
 
-void Scanner::begin(Deserializer& handler, IComposer& composer)
+void Scanner::begin(Deserializer& handler, IComposer& composer, IRemoteStream* remoteStream)
 {
     _vp.begin(handler);
     _deserializer = &handler;
     _composer = &composer;
+    _remoteStream = remoteStream;
     _deserializer->begin();
     _state = state_0;
     _failed = false;
@@ -66,6 +68,11 @@ bool Scanner::advance(char ch)
                 _state = state_errorcode;
                 _count = 4;
             }
+            else if (ch == '\xc3' && _remoteStream)
+            {
+                _failed = false;
+                _state = state_stream;
+            }
             else
                 throw std::runtime_error("response expected");
             break;
@@ -74,12 +81,60 @@ bool Scanner::advance(char ch)
             if (_vp.advance(ch))
             {
                 log_debug(_deserializer->si());
-                _composer->fixup(_deserializer->si());
+                if (_remoteStream)
+                {
+                    // the server sent the whole result at once
+                    const SerializationInfo& si = _deserializer->si();
+                    if (si.category() == SerializationInfo::Array)
+                    {
+                        for (SerializationInfo::ConstIterator it = si.begin(); it != si.end(); ++it)
+                            element(*it);
+                    }
+                    else
+                        element(si);
+                }
+                else
+                    _composer->fixup(_deserializer->si());
                 _deserializer->clear();
                 _state = state_end;
             }
             break;
 
+        case state_stream:
+            if (ch == '\xff')
+            {
+                log_debug("streamed reply finished");
+                return true;
+            }
+            else if (ch == '\xc2')
+            {
+                _failed = true;
+                _state = state_errorcode;
+                _count = 4;
+            }
+            else
+            {
+                _deserializer->begin();
+                _vp.begin(*_deserializer);
+                _state = state_element;
+                if (_vp.advance(ch))
+                {
+                    element(_deserializer->si());
+                    _deserializer->clear();
+                    _state = state_stream;
+                }
+            }
+            break;
+
+        case state_element:
+            if (_vp.advance(ch))
+            {
+                element(_deserializer->si());
+                _deserializer->clear();
+                _state = state_stream;
+            }
+            break;
+
         case state_errorcode:
             _errorCode = (_errorCode << 8) | ch;
             if (--_count == 0)
@@ -107,6 +162,13 @@ bool Scanner::advance(char ch)
     return false;
 }
 
+void Scanner::element(const SerializationInfo& si)
+{
+    log_debug("stream element " << si);
+    _composer->fixup(si);
+    _remoteStream->onElement();
+}
+
 void Scanner::finish()
 {
     _vp.finish();
@@ -38,6 +38,7 @@ namespace cxxtools
     namespace bin
     {
         class Deserializer;
+        class IRemoteStream;
 
         class Scanner
         {
@@ -46,22 +47,30 @@ namespace cxxtools
                     : _state(state_0),
                       _deserializer(0),
                       _composer(0),
+                      _remoteStream(0),
                       _count(0),
                       _failed(false),
                       _errorCode(0)
                 { }
 
-                void begin(Deserializer& handler, IComposer& composer);
+                // When a stream is passed, the reply may be a streamed
+                // result. Each element is passed to the composer and
+                // signaled to the stream.
+                void begin(Deserializer& handler, IComposer& composer, IRemoteStream* remoteStream = 0);
 
                 bool advance(char ch);
 
                 void finish();
 
             private:
+                void element(const SerializationInfo& si);
+
                 enum
                 {
                     state_0,
                     state_value,
+                    state_stream,
+                    state_element,
                     state_errorcode,
                     state_errormessage,
                     state_end
@@ -70,6 +79,7 @@ namespace cxxtools
                 Parser _vp;
                 Deserializer* _deserializer;
                 IComposer* _composer;
+                IRemoteStream* _remoteStream;
 
                 unsigned short _count;
 
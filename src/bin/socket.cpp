@@ -45,6 +45,7 @@ Socket::Socket(RpcServerImpl& server, ServiceRegistry& serviceRegistry, net::Tcp
       _accepted(false)
 {
     _stream.attachDevice(*this);
+    _stream.buffer().segmented(true);
     cxxtools::connect(IODevice::inputReady, *this, &Socket::onIODeviceInput);
     cxxtools::connect(_stream.buffer().outputReady, *this, &Socket::onOutput);
 }
@@ -59,6 +60,7 @@ Socket::Socket(Socket& socket)
       _accepted(false)
 {
     _stream.attachDevice(*this);
+    _stream.buffer().segmented(true);
     cxxtools::connect(IODevice::inputReady, *this, &Socket::onIODeviceInput);
     cxxtools::connect(_stream.buffer().outputReady, *this, &Socket::onOutput);
 }
@@ -67,6 +69,10 @@ void Socket::accept()
 {
     net::TcpSocket::accept(_tcpServer);
 
+    // blocking writes of streamed results must not wait forever for a
+    // client, which does not read
+    setTimeout(_server.writeTimeout());
+
     _accepted = true;
 
     _stream.buffer().beginRead();
@@ -121,7 +127,7 @@ bool Socket::onOutput(StreamBuffer& sb)
     {
         sb.endWrite();
 
-        if ( sb.out_avail() )
+        if ( sb.pendingOutput() )
         {
             sb.beginWrite();
         }
@@ -0,0 +1,373 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "charconv.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <stdint.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace cxxtools
+{
+namespace charconv
+{
+    namespace
+    {
+#if defined(__SSE2__)
+        inline __m128i load16(const void* p)
+        { return _mm_loadu_si128(static_cast<const __m128i*>(p)); }
+
+        inline void store16(void* p, __m128i v)
+        { _mm_storeu_si128(static_cast<__m128i*>(p), v); }
+
+        // widens 16 bytes to 16 characters; sign is 0 or the sign mask of v
+        inline void widen16(__m128i v, __m128i sign, Char* d)
+        {
+            __m128i lo = _mm_unpacklo_epi8(v, sign);
+            __m128i hi = _mm_unpackhi_epi8(v, sign);
+            __m128i loSign = _mm_srai_epi16(lo, 15);
+            __m128i hiSign = _mm_srai_epi16(hi, 15);
+            store16(d, _mm_unpacklo_epi16(lo, loSign));
+            store16(d + 4, _mm_unpackhi_epi16(lo, loSign));
+            store16(d + 8, _mm_unpacklo_epi16(hi, hiSign));
+            store16(d + 12, _mm_unpackhi_epi16(hi, hiSign));
+        }
+
+        // narrows 16 characters, if none of them has a bit of outOfRange set
+        inline bool narrow16(const Char* s, char* d, __m128i outOfRange)
+        {
+            __m128i a = load16(s);
+            __m128i b = load16(s + 4);
+            __m128i c = load16(s + 8);
+            __m128i e = load16(s + 12);
+            __m128i any = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, e)), outOfRange);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(any, _mm_setzero_si128())) != 0xffff)
+                return false;
+            store16(d, _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, e)));
+            return true;
+        }
+#endif
+
+#if defined(__AVX2__)
+        inline __m256i load32(const void* p)
+        { return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+
+        inline void store32(void* p, __m256i v)
+        { _mm256_storeu_si256(static_cast<__m256i*>(p), v); }
+
+        // narrows 32 characters, if none of them has a bit of outOfRange set
+        inline bool narrow32(const Char* s, char* d, __m256i outOfRange)
+        {
+            __m256i a = load32(s);
+            __m256i b = load32(s + 8);
+            __m256i c = load32(s + 16);
+            __m256i e = load32(s + 24);
+            __m256i any = _mm256_and_si256(_mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, e)), outOfRange);
+            if (!_mm256_testz_si256(any, any))
+                return false;
+            // the packs work on 128 bit lanes, so the result needs a final permutation
+            __m256i v = _mm256_packus_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, e));
+            store32(d, _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7)));
+            return true;
+        }
+#endif
+
+        inline bool hasHighBit(const char* s)
+        {
+            uint64_t v;
+            std::memcpy(&v, s, sizeof(v));
+            return (v & 0x8080808080808080ull) != 0;
+        }
+    }
+
+    std::size_t asciiLength(const char* s, std::size_t n)
+    {
+        std::size_t i = 0;
+
+#if defined(__AVX2__)
+        for ( ; i + 32 <= n; i += 32)
+        {
+            unsigned mask = _mm256_movemask_epi8(load32(s + i));
+            if (mask)
+                return i + __builtin_ctz(mask);
+        }
+#endif
+
+#if defined(__SSE2__)
+        for ( ; i + 16 <= n; i += 16)
+        {
+            unsigned mask = _mm_movemask_epi8(load16(s + i));
+            if (mask)
+                return i + __builtin_ctz(mask);
+        }
+#endif
+
+        for ( ; i + 8 <= n && !hasHighBit(s + i); i += 8)
+            ;
+
+        while (i < n && static_cast<unsigned char>(s[i]) < 0x80)
+            ++i;
+
+        return i;
+    }
+
+    std::size_t widenAscii(const char* s, std::size_t n, Char* d)
+    {
+        std::size_t i = 0;
+
+#if defined(__AVX2__)
+        for ( ; i + 32 <= n; i += 32)
+        {
+            __m256i v = load32(s + i);
+            if (_mm256_movemask_epi8(v))
+                break;
+
+            __m128i lo = _mm256_castsi256_si128(v);
+            __m128i hi = _mm256_extracti128_si256(v, 1);
+            store32(d + i, _mm256_cvtepu8_epi32(lo));
+            store32(d + i + 8, _mm256_cvtepu8_epi32(_mm_srli_si128(lo, 8)));
+            store32(d + i + 16, _mm256_cvtepu8_epi32(hi));
+            store32(d + i + 24, _mm256_cvtepu8_epi32(_mm_srli_si128(hi, 8)));
+        }
+#endif
+
+#if defined(__SSE2__)
+        for ( ; i + 16 <= n; i += 16)
+        {
+            __m128i v = load16(s + i);
+            if (_mm_movemask_epi8(v))
+                break;
+            widen16(v, _mm_setzero_si128(), d + i);
+        }
+#else
+        for ( ; i + 8 <= n && !hasHighBit(s + i); i += 8)
+            for (unsigned k = 0; k < 8; ++k)
+                d[i + k] = Char(static_cast<Char::value_type>(s[i + k]));
+#endif
+
+        for ( ; i < n && static_cast<unsigned char>(s[i]) < 0x80; ++i)
+            d[i] = Char(static_cast<Char::value_type>(s[i]));
+
+        return i;
+    }
+
+    std::size_t narrowAscii(const Char* s, std::size_t n, char* d)
+    {
+        std::size_t i = 0;
+
+#if defined(__AVX2__)
+        for ( ; i + 32 <= n && narrow32(s + i, d + i, _mm256_set1_epi32(~0x7f)); i += 32)
+            ;
+#endif
+
+#if defined(__SSE2__)
+        for ( ; i + 16 <= n && narrow16(s + i, d + i, _mm_set1_epi32(~0x7f)); i += 16)
+            ;
+#endif
+
+        for ( ; i < n && static_cast<uint32_t>(s[i].value()) < 0x80; ++i)
+            d[i] = static_cast<char>(s[i].value());
+
+        return i;
+    }
+
+    void widen(const char* s, std::size_t n, Char* d)
+    {
+        std::size_t i = 0;
+
+#if defined(__AVX2__)
+        for ( ; i + 32 <= n; i += 32)
+        {
+            __m256i v = load32(s + i);
+            __m128i lo = _mm256_castsi256_si128(v);
+            __m128i hi = _mm256_extracti128_si256(v, 1);
+#if CHAR_MIN < 0
+            store32(d + i, _mm256_cvtepi8_epi32(lo));
+            store32(d + i + 8, _mm256_cvtepi8_epi32(_mm_srli_si128(lo, 8)));
+            store32(d + i + 16, _mm256_cvtepi8_epi32(hi));
+            store32(d + i + 24, _mm256_cvtepi8_epi32(_mm_srli_si128(hi, 8)));
+#else
+            store32(d + i, _mm256_cvtepu8_epi32(lo));
+            store32(d + i + 8, _mm256_cvtepu8_epi32(_mm_srli_si128(lo, 8)));
+            store32(d + i + 16, _mm256_cvtepu8_epi32(hi));
+            store32(d + i + 24, _mm256_cvtepu8_epi32(_mm_srli_si128(hi, 8)));
+#endif
+        }
+#endif
+
+#if defined(__SSE2__)
+        for ( ; i + 16 <= n; i += 16)
+        {
+            __m128i v = load16(s + i);
+#if CHAR_MIN < 0
+            widen16(v, _mm_cmpgt_epi8(_mm_setzero_si128(), v), d + i);
+#else
+            widen16(v, _mm_setzero_si128(), d + i);
+#endif
+        }
+#endif
+
+        for ( ; i < n; ++i)
+            d[i] = Char(static_cast<Char::value_type>(s[i]));
+    }
+
+    void widenLatin1(const char* s, std::size_t n, Char* d)
+    {
+        std::size_t i = 0;
+
+#if defined(__AVX2__)
+        for ( ; i + 32 <= n; i += 32)
+        {
+            __m256i v = load32(s + i);
+            __m128i lo = _mm256_castsi256_si128(v);
+            __m128i hi = _mm256_extracti128_si256(v, 1);
+            store32(d + i, _mm256_cvtepu8_epi32(lo));
+            store32(d + i + 8, _mm256_cvtepu8_epi32(_mm_srli_si128(lo, 8)));
+            store32(d + i + 16, _mm256_cvtepu8_epi32(hi));
+            store32(d + i + 24, _mm256_cvtepu8_epi32(_mm_srli_si128(hi, 8)));
+        }
+#endif
+
+#if defined(__SSE2__)
+        for ( ; i + 16 <= n; i += 16)
+            widen16(load16(s + i), _mm_setzero_si128(), d + i);
+#endif
+
+        for ( ; i < n; ++i)
+            d[i] = Char(static_cast<Char::value_type>(static_cast<unsigned char>(s[i])));
+    }
+
+    void narrow(const Char* s, std::size_t n, char* d, char dfault)
+    {
+        std::size_t i = 0;
+
+        // blocks with characters in the range [0, 0xff] are narrowed in bulk
+        // and other blocks character by character
+#if defined(__AVX2__)
+        for ( ; i + 32 <= n; i += 32)
+        {
+            if (!narrow32(s + i, d + i, _mm256_set1_epi32(~0xff)))
+                for (unsigned k = 0; k < 32; ++k)
+                    d[i + k] = s[i + k].narrow(dfault);
+        }
+#endif
+
+#if defined(__SSE2__)
+        for ( ; i + 16 <= n; i += 16)
+        {
+            if (!narrow16(s + i, d + i, _mm_set1_epi32(~0xff)))
+                for (unsigned k = 0; k < 16; ++k)
+                    d[i + k] = s[i + k].narrow(dfault);
+        }
+#endif
+
+        for ( ; i < n; ++i)
+            d[i] = s[i].narrow(dfault);
+    }
+
+    bool utf8Length(const char* s, std::size_t n, std::size_t& length, Char::value_type& maxValue)
+    {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(s);
+        const unsigned char* e = p + n;
+        length = 0;
+        maxValue = 0;
+
+        while (p < e)
+        {
+            std::size_t ascii = asciiLength(reinterpret_cast<const char*>(p), e - p);
+            if (ascii > 0)
+            {
+                if (maxValue < 0x7f)
+                    maxValue = std::max<Char::value_type>(maxValue, *std::max_element(p, p + ascii));
+                p += ascii;
+                length += ascii;
+                continue;
+            }
+
+            // the checks follow RFC 3629: no overlong sequences, no
+            // surrogates and no values above U+10FFFF
+            unsigned char c = *p;
+            Char::value_type value;
+            std::size_t count;
+            unsigned char lo = 0x80;
+            unsigned char hi = 0xbf;
+
+            if (c >= 0xc2 && c <= 0xdf)
+            {
+                value = c & 0x1f;
+                count = 1;
+            }
+            else if (c >= 0xe0 && c <= 0xef)
+            {
+                value = c & 0x0f;
+                count = 2;
+                if (c == 0xe0)
+                    lo = 0xa0;
+                else if (c == 0xed)
+                    hi = 0x9f;
+            }
+            else if (c >= 0xf0 && c <= 0xf4)
+            {
+                value = c & 0x07;
+                count = 3;
+                if (c == 0xf0)
+                    lo = 0x90;
+                else if (c == 0xf4)
+                    hi = 0x8f;
+            }
+            else
+                return false;
+
+            if (static_cast<std::size_t>(e - p) <= count)
+                return false;
+
+            ++p;
+            for (std::size_t k = 0; k < count; ++k, ++p)
+            {
+                if (*p < lo || *p > hi)
+                    return false;
+                value = (value << 6) | (*p & 0x3f);
+                lo = 0x80;
+                hi = 0xbf;
+            }
+
+            if (value > maxValue)
+                maxValue = value;
+            ++length;
+        }
+
+        return true;
+    }
+}
+}
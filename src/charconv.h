@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_CHARCONV_H
+#define CXXTOOLS_CHARCONV_H
+
+#include <cxxtools/char.h>
+#include <cstddef>
+
+namespace cxxtools
+{
+    /*
+     * Block conversions between bytes and unicode characters used by the
+     * Utf8Codec and by String::widen and String::narrow.
+     *
+     * The functions process 32 bytes at a time with AVX2, 16 bytes with SSE2
+     * and 8 bytes otherwise, whatever the compiler targets.
+     */
+    namespace charconv
+    {
+        /// Returns the number of leading bytes < 0x80 in s.
+        std::size_t asciiLength(const char* s, std::size_t n);
+
+        /// Copies the leading bytes < 0x80 from s to d and returns the number of copied bytes.
+        std::size_t widenAscii(const char* s, std::size_t n, Char* d);
+
+        /// Copies the leading characters < 0x80 from s to d and returns the number of copied characters.
+        std::size_t narrowAscii(const Char* s, std::size_t n, char* d);
+
+        /// Converts n bytes from s to d like Char(char) does.
+        void widen(const char* s, std::size_t n, Char* d);
+
+        /// Converts n latin-1 bytes from s to d.
+        void widenLatin1(const char* s, std::size_t n, Char* d);
+
+        /// Converts n characters from s to d like Char::narrow(dfault) does.
+        void narrow(const Char* s, std::size_t n, char* d, char dfault);
+
+        /**
+         * Counts the characters in n bytes of utf-8 encoded data and
+         * determines the largest character value. Returns false, if the
+         * data is not legal utf-8.
+         */
+        bool utf8Length(const char* s, std::size_t n, std::size_t& length, Char::value_type& maxValue);
+    }
+}
+
+#endif // CXXTOOLS_CHARCONV_H
@@ -0,0 +1,543 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/compactstring.h>
+#include <cxxtools/conversionerror.h>
+#include "charconv.h"
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+
+namespace cxxtools
+{
+    namespace
+    {
+        const Char::value_type ReplacementChar = 0xfffd;
+
+        inline Char::value_type checked(Char::value_type v)
+        {
+            return v < 0 || v > 0x10ffff || (v >= 0xd800 && v <= 0xdfff) ? ReplacementChar : v;
+        }
+
+        inline std::size_t utf8Size(Char::value_type v)
+        {
+            return v < 0x80 ? 1 : v < 0x800 ? 2 : v < 0x10000 ? 3 : 4;
+        }
+
+        inline char* utf8Out(char* p, Char::value_type v)
+        {
+            if (v < 0x80)
+            {
+                *p++ = static_cast<char>(v);
+            }
+            else if (v < 0x800)
+            {
+                *p++ = static_cast<char>(0xc0 | (v >> 6));
+                *p++ = static_cast<char>(0x80 | (v & 0x3f));
+            }
+            else if (v < 0x10000)
+            {
+                *p++ = static_cast<char>(0xe0 | (v >> 12));
+                *p++ = static_cast<char>(0x80 | ((v >> 6) & 0x3f));
+                *p++ = static_cast<char>(0x80 | (v & 0x3f));
+            }
+            else
+            {
+                *p++ = static_cast<char>(0xf0 | (v >> 18));
+                *p++ = static_cast<char>(0x80 | ((v >> 12) & 0x3f));
+                *p++ = static_cast<char>(0x80 | ((v >> 6) & 0x3f));
+                *p++ = static_cast<char>(0x80 | (v & 0x3f));
+            }
+
+            return p;
+        }
+
+        // decodes one character of legal utf-8
+        inline Char::value_type utf8In(const char*& p)
+        {
+            unsigned char c = static_cast<unsigned char>(*p++);
+            if (c < 0x80)
+                return c;
+
+            unsigned count = c >= 0xf0 ? 3 : c >= 0xe0 ? 2 : 1;
+            Char::value_type v = c & (0x3f >> count);
+            for (unsigned n = 0; n < count; ++n)
+                v = (v << 6) | (static_cast<unsigned char>(*p++) & 0x3f);
+            return v;
+        }
+
+        // counts the bytes >= 0x80, which need 2 bytes in utf-8
+        inline std::size_t highBytes(const char* data, std::size_t n)
+        {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < n; )
+            {
+                i += charconv::asciiLength(data + i, n - i);
+                for ( ; i < n && static_cast<unsigned char>(data[i]) >= 0x80; ++i)
+                    ++count;
+            }
+            return count;
+        }
+
+        template <typename Other>
+        int compareChars(CompactString::const_iterator it, CompactString::const_iterator end, Other oit, Other oend)
+        {
+            for ( ; it != end && oit != oend; ++it, ++oit)
+            {
+                Char::value_type a = (*it).value();
+                Char::value_type b = Char(*oit).value();
+                if (a != b)
+                    return a < b ? -1 : 1;
+            }
+
+            return it != end ? 1 : oit != oend ? -1 : 0;
+        }
+    }
+
+    const uint32_t CompactString::LongFlag;
+    const CompactString::size_type CompactString::ShortCapacity;
+
+    Char CompactString::const_iterator::operator*() const
+    {
+        if (_latin1)
+            return Char(static_cast<Char::value_type>(static_cast<unsigned char>(*_p)));
+
+        const char* p = _p;
+        return Char(utf8In(p));
+    }
+
+    CompactString::const_iterator& CompactString::const_iterator::operator++()
+    {
+        if (_latin1)
+        {
+            ++_p;
+        }
+        else
+        {
+            unsigned char c = static_cast<unsigned char>(*_p);
+            _p += c < 0x80 ? 1 : c >= 0xf0 ? 4 : c >= 0xe0 ? 3 : 2;
+        }
+
+        return *this;
+    }
+
+    CompactString::CompactString(const CompactString& s)
+        : _size(0),
+          _length(0)
+    {
+        _u._short[0] = '\0';
+        appendBytes(s.data(), s.byteSize());
+        _length = s._length;
+    }
+
+#if __cplusplus >= 201103L
+    CompactString::CompactString(CompactString&& s) noexcept
+        : _u(s._u),
+          _size(s._size),
+          _length(s._length)
+    {
+        s._size = 0;
+        s._length = 0;
+        s._u._short[0] = '\0';
+    }
+#endif
+
+    CompactString::CompactString(const String& s)
+        : _size(0),
+          _length(0)
+    {
+        _u._short[0] = '\0';
+        assign(s.data(), s.size());
+    }
+
+    CompactString::CompactString(const Char* s, size_type n)
+        : _size(0),
+          _length(0)
+    {
+        _u._short[0] = '\0';
+        assign(s, n);
+    }
+
+    CompactString& CompactString::operator= (const CompactString& s)
+    {
+        if (this != &s)
+        {
+            clear();
+            appendBytes(s.data(), s.byteSize());
+            _length = s._length;
+        }
+
+        return *this;
+    }
+
+#if __cplusplus >= 201103L
+    CompactString& CompactString::operator= (CompactString&& s) noexcept
+    {
+        swap(s);
+        s.clear();
+        return *this;
+    }
+#endif
+
+    CompactString CompactString::fromUtf8(const char* data, size_type size)
+    {
+        std::size_t length;
+        Char::value_type maxValue;
+        if (!charconv::utf8Length(data, size, length, maxValue))
+            throw ConversionError("invalid utf-8 sequence");
+
+        CompactString ret;
+        if (maxValue <= 0xff)
+        {
+            // latin-1 characters need at most 2 bytes in utf-8
+            ret.reserve(length);
+            char* p = ret.buffer();
+            for (const char* it = data; it != data + size; )
+            {
+                std::size_t ascii = charconv::asciiLength(it, data + size - it);
+                std::memcpy(p, it, ascii);
+                p += ascii;
+                it += ascii;
+                if (it != data + size)
+                    *p++ = static_cast<char>(utf8In(it));
+            }
+
+            ret.setSize(length);
+        }
+        else
+        {
+            ret.appendBytes(data, size);
+        }
+
+        ret._length = static_cast<uint32_t>(length);
+        return ret;
+    }
+
+    CompactString CompactString::fromLatin1(const char* data, size_type size)
+    {
+        CompactString ret;
+        ret.appendBytes(data, size);
+        ret._length = static_cast<uint32_t>(size);
+        return ret;
+    }
+
+    bool CompactString::isAscii() const
+    {
+        return charconv::asciiLength(data(), byteSize()) == byteSize();
+    }
+
+    void CompactString::reserve(size_type n)
+    {
+        if (n <= capacity())
+            return;
+
+        if (n >= LongFlag)
+            throw std::length_error("CompactString too long");
+
+        size_type c = std::max(n, std::min<size_type>(capacity() * 2, LongFlag - 1));
+        char* p = new char[c + 1];
+        std::memcpy(p, data(), byteSize() + 1);
+
+        if (isLong())
+            delete[] _u._long._ptr;
+
+        _u._long._ptr = p;
+        _u._long._capacity = c;
+        _size |= LongFlag;
+    }
+
+    Char CompactString::operator[](size_type n) const
+    {
+        if (isLatin1())
+            return Char(static_cast<Char::value_type>(static_cast<unsigned char>(data()[n])));
+
+        const_iterator it = begin();
+        for ( ; n > 0; --n)
+            ++it;
+        return *it;
+    }
+
+    Char CompactString::at(size_type n) const
+    {
+        if (n >= _length)
+            throw std::out_of_range("CompactString::at");
+        return (*this)[n];
+    }
+
+    CompactString& CompactString::assign(const Char* s, size_type n)
+    {
+        clear();
+        return append(s, n);
+    }
+
+    CompactString& CompactString::append(Char ch)
+    {
+        Char::value_type v = checked(ch.value());
+
+        if (isLatin1() && v <= 0xff)
+        {
+            char c = static_cast<char>(v);
+            appendBytes(&c, 1);
+        }
+        else
+        {
+            if (isLatin1())
+                toUtf8Encoding();
+
+            char buffer[4];
+            appendBytes(buffer, utf8Out(buffer, v) - buffer);
+        }
+
+        ++_length;
+        return *this;
+    }
+
+    CompactString& CompactString::append(const CompactString& s)
+    {
+        if (this == &s)
+        {
+            CompactString copy(s);
+            return append(copy);
+        }
+
+        if (s.isLatin1() && !isLatin1())
+        {
+            appendLatin1AsUtf8(s.data(), s.byteSize());
+        }
+        else
+        {
+            if (!s.isLatin1() && isLatin1())
+                toUtf8Encoding();
+            appendBytes(s.data(), s.byteSize());
+        }
+
+        _length += s._length;
+        return *this;
+    }
+
+    CompactString& CompactString::append(const Char* s, size_type n)
+    {
+        if (_length + n >= LongFlag)
+            throw std::length_error("CompactString too long");
+
+        bool latin1 = isLatin1();
+        size_type bytes = 0;
+        for (size_type i = 0; i < n; ++i)
+        {
+            Char::value_type v = checked(s[i].value());
+            if (v > 0xff)
+                latin1 = false;
+            bytes += utf8Size(v);
+        }
+
+        if (latin1)
+        {
+            reserve(byteSize() + n);
+            charconv::narrow(s, n, buffer() + byteSize(), '?');
+            setSize(byteSize() + n);
+        }
+        else
+        {
+            if (isLatin1())
+                toUtf8Encoding();
+
+            reserve(byteSize() + bytes);
+            char* p = buffer() + byteSize();
+            size_type i = 0;
+            while (i < n)
+            {
+                size_type ascii = charconv::narrowAscii(s + i, n - i, p);
+                p += ascii;
+                i += ascii;
+                if (i < n)
+                    p = utf8Out(p, checked(s[i++].value()));
+            }
+
+            setSize(p - buffer());
+        }
+
+        _length += static_cast<uint32_t>(n);
+        return *this;
+    }
+
+    String CompactString::toString() const
+    {
+        String ret;
+        if (_length == 0)
+            return ret;
+
+        ret.resize(_length);
+        Char* d = &ret[0];
+
+        if (isLatin1())
+        {
+            charconv::widenLatin1(data(), byteSize(), d);
+        }
+        else
+        {
+            const char* p = data();
+            const char* e = p + byteSize();
+            while (p < e)
+            {
+                std::size_t ascii = charconv::widenAscii(p, e - p, d);
+                p += ascii;
+                d += ascii;
+                if (p < e)
+                    *d++ = Char(utf8In(p));
+            }
+        }
+
+        return ret;
+    }
+
+    std::string CompactString::toUtf8() const
+    {
+        if (!isLatin1())
+            return std::string(data(), byteSize());
+
+        std::string ret;
+        ret.resize(byteSize() + highBytes(data(), byteSize()));
+
+        const char* p = data();
+        const char* e = p + byteSize();
+        char* d = &ret[0];
+        while (p < e)
+        {
+            std::size_t ascii = charconv::asciiLength(p, e - p);
+            std::memcpy(d, p, ascii);
+            p += ascii;
+            d += ascii;
+            if (p < e)
+                d = utf8Out(d, static_cast<unsigned char>(*p++));
+        }
+
+        return ret;
+    }
+
+    std::string CompactString::narrow(char dfault) const
+    {
+        if (isLatin1())
+            return std::string(data(), byteSize());
+
+        std::string ret;
+        ret.reserve(_length);
+        for (const_iterator it = begin(); it != end(); ++it)
+            ret += (*it).narrow(dfault);
+        return ret;
+    }
+
+    int CompactString::compare(const CompactString& s) const
+    {
+        // both latin-1 and utf-8 sort bytewise in code point order
+        if (isLatin1() == s.isLatin1())
+        {
+            size_type n = std::min(byteSize(), s.byteSize());
+            int c = std::memcmp(data(), s.data(), n);
+            if (c != 0)
+                return c < 0 ? -1 : 1;
+            return byteSize() < s.byteSize() ? -1 : byteSize() > s.byteSize() ? 1 : 0;
+        }
+
+        return compareChars(begin(), end(), s.begin(), s.end());
+    }
+
+    int CompactString::compare(const String& s) const
+    {
+        return compareChars(begin(), end(), s.begin(), s.end());
+    }
+
+    void CompactString::swap(CompactString& s)
+    {
+        std::swap(_u, s._u);
+        std::swap(_size, s._size);
+        std::swap(_length, s._length);
+    }
+
+    void CompactString::appendBytes(const char* data, size_type n)
+    {
+        reserve(byteSize() + n);
+        std::memcpy(buffer() + byteSize(), data, n);
+        setSize(byteSize() + n);
+    }
+
+    void CompactString::appendLatin1AsUtf8(const char* data, size_type n)
+    {
+        reserve(byteSize() + n + highBytes(data, n));
+
+        char* p = buffer() + byteSize();
+        for (const char* e = data + n; data < e; )
+        {
+            std::size_t ascii = charconv::asciiLength(data, e - data);
+            std::memcpy(p, data, ascii);
+            p += ascii;
+            data += ascii;
+            if (data < e)
+                p = utf8Out(p, static_cast<unsigned char>(*data++));
+        }
+
+        setSize(p - buffer());
+    }
+
+    void CompactString::toUtf8Encoding()
+    {
+        size_type size = byteSize();
+        size_type high = highBytes(data(), size);
+        if (high == 0)
+            return;
+
+        // expand the data in place from the end
+        reserve(size + high);
+        char* b = buffer();
+        char* d = b + size + high;
+        for (char* s = b + size; s != b; )
+        {
+            unsigned char c = static_cast<unsigned char>(*--s);
+            if (c < 0x80)
+            {
+                *--d = static_cast<char>(c);
+            }
+            else
+            {
+                *--d = static_cast<char>(0x80 | (c & 0x3f));
+                *--d = static_cast<char>(0xc0 | (c >> 6));
+            }
+        }
+
+        setSize(size + high);
+    }
+
+    std::ostream& operator<< (std::ostream& out, const CompactString& s)
+    {
+        if (s.isAscii() || !s.isLatin1())
+            out.write(s.data(), s.byteSize());
+        else
+            out << s.toUtf8();
+        return out;
+    }
+}
@@ -39,18 +39,34 @@ Connection::Connection()
 Connection::Connection(Connectable& sender, Slot* slot)
 {
     _data = new ConnectionData(sender, slot);
+    open(sender);
+}
+
 
+Connection::Connection(Connectable& sender, const Slot& slot)
+{
+    _data = new ConnectionData(sender, slot);
+    open(sender);
+}
+
+
+void Connection::open(Connectable& sender)
+{
     try
     {
         _data->setValid(false);
 
         sender.onConnectionOpen(*this);
-        slot->onConnect(*this);
+        _data->slot().onConnect(*this);
        _data->setValid(true);
     }
     catch (...)
     {
-        delete _data;
+        // the sender may still hold a reference
+        sender.onConnectionClose(*this);
+        if (_data->release() == 0)
+            delete _data;
+        _data = 0;
         throw;
     }
 }
@@ -0,0 +1,655 @@
+/*
+ * Copyright (C) 2016 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/csvreader.h>
+#include <cxxtools/serializationerror.h>
+#include <cxxtools/conversionerror.h>
+#include <cxxtools/thread.h>
+#include <cxxtools/utf8codec.h>
+#include <cxxtools/log.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include <unistd.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+log_define("cxxtools.csv.reader")
+
+namespace cxxtools
+{
+
+namespace
+{
+    // inputs smaller than this are not split into chunks
+    const std::size_t minChunkSize = 1024 * 1024;
+
+    // returns the position of the first occurrence of a or b or end if not found
+    const char* findAny(const char* p, const char* end, char a, char b)
+    {
+#ifdef __SSE2__
+        const __m128i va = _mm_set1_epi8(a);
+        const __m128i vb = _mm_set1_epi8(b);
+        while (end - p >= 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)));
+            if (mask != 0)
+                return p + __builtin_ctz(mask);
+            p += 16;
+        }
+#endif
+        while (p != end && *p != a && *p != b)
+            ++p;
+        return p;
+    }
+
+    std::size_t countChar(const char* p, const char* end, char ch)
+    {
+        std::size_t count = 0;
+#ifdef __SSE2__
+        const __m128i vc = _mm_set1_epi8(ch);
+        while (end - p >= 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            count += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(v, vc)));
+            p += 16;
+        }
+#endif
+        return count + std::count(p, end, ch);
+    }
+
+    const char* findChar(const char* p, const char* end, char ch)
+    {
+        const char* r = static_cast<const char*>(::memchr(p, ch, end - p));
+        return r ? r : end;
+    }
+
+    // parses the data in [begin, end) into columns
+    class ChunkParser
+    {
+            const char* _data;
+            const char* _begin;
+            const char* _end;
+            char _delimiter;
+            char _quote;
+
+        public:
+            ChunkParser(const char* data, const char* begin, const char* end, char delimiter, char quote)
+                : _data(data),
+                  _begin(begin),
+                  _end(end),
+                  _delimiter(delimiter),
+                  _quote(quote),
+                  rows(0)
+            { }
+
+            // parses a single record at p and returns the position after it
+            const char* parseRecord(const char* p, std::vector<CsvReader::FieldPos>& fields) const;
+
+            void run();
+
+            std::vector<CsvReader::FieldPosVector> columns;
+            std::size_t rows;
+            std::string errorMessage;
+    };
+
+    const char* ChunkParser::parseRecord(const char* p, std::vector<CsvReader::FieldPos>& fields) const
+    {
+        fields.clear();
+
+        while (true)
+        {
+            CsvReader::FieldPos f;
+            const char* e;
+
+            if (p != _end && *p == _quote)
+            {
+                const char* b = ++p;
+                while (true)
+                {
+                    p = findChar(p, _end, _quote);
+                    if (p == _end)
+                        SerializationError::doThrow("unterminated quoted value in csv");
+
+                    if (p + 1 != _end && p[1] == _quote)
+                        p += 2;  // doubled quote
+                    else
+                        break;
+                }
+
+                f.offset = b - _data;
+                f.size = p - b;
+                f.quote = _quote;
+                e = ++p;
+
+                if (e != _end && *e == '\r')
+                    ++e;
+
+                if (e != _end && *e != _delimiter && *e != '\n')
+                {
+                    std::ostringstream msg;
+                    msg << "unexpected character '" << *e << "' after quoted value in csv";
+                    SerializationError::doThrow(msg.str());
+                }
+            }
+            else
+            {
+                e = findAny(p, _end, _delimiter, '\n');
+                const char* fe = e;
+                if ((e == _end || *e == '\n') && fe != p && fe[-1] == '\r')
+                    --fe;
+
+                f.offset = p - _data;
+                f.size = fe - p;
+                f.quote = 0;
+            }
+
+            fields.push_back(f);
+
+            if (e == _end)
+                return e;
+
+            p = e + 1;
+            if (*e == '\n')
+                return p;
+        }
+    }
+
+    void ChunkParser::run()
+    {
+        try
+        {
+            std::vector<CsvReader::FieldPos> fields;
+            const char* p = _begin;
+            while (p != _end)
+            {
+                if (*p == '\n')
+                {
+                    ++p;  // skip empty line
+                    continue;
+                }
+
+                if (*p == '\r' && p + 1 != _end && p[1] == '\n')
+                {
+                    p += 2;
+                    continue;
+                }
+
+                p = parseRecord(p, fields);
+
+                if (fields.size() != columns.size())
+                {
+                    std::ostringstream msg;
+                    msg << "number of columns " << fields.size() << " in row " << (rows + 1)
+                        << " does not match expected number of columns " << columns.size() << " in csv";
+                    errorMessage = msg.str();
+                    return;
+                }
+
+                for (unsigned n = 0; n < fields.size(); ++n)
+                    columns[n].push_back(fields[n]);
+
+                ++rows;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            errorMessage = e.what();
+        }
+    }
+
+    class QuoteCounter
+    {
+            const char* _begin;
+            const char* _end;
+            char _quote;
+
+        public:
+            QuoteCounter(const char* begin, const char* end, char quote)
+                : _begin(begin),
+                  _end(end),
+                  _quote(quote),
+                  count(0)
+            { }
+
+            void run()
+            { count = countChar(_begin, _end, _quote); }
+
+            std::size_t count;
+    };
+
+    // executes run() of all jobs, each in its own thread
+    template <typename Job>
+    void runParallel(std::vector<Job*>& jobs)
+    {
+        if (jobs.size() == 1)
+        {
+            jobs[0]->run();
+            return;
+        }
+
+        std::vector<AttachedThread*> threads;
+        try
+        {
+            for (unsigned n = 0; n < jobs.size(); ++n)
+            {
+                threads.push_back(new AttachedThread(callable(*jobs[n], &Job::run)));
+                threads.back()->start();
+            }
+        }
+        catch (...)
+        {
+            for (unsigned n = 0; n < threads.size(); ++n)
+                delete threads[n];
+            throw;
+        }
+
+        for (unsigned n = 0; n < threads.size(); ++n)
+        {
+            threads[n]->join();
+            delete threads[n];
+        }
+    }
+
+    std::string unescape(const char* b, const char* e, char quote)
+    {
+        std::string ret;
+        ret.reserve(e - b);
+        while (b != e)
+        {
+            const char* q = findChar(b, e, quote);
+            ret.append(b, q);
+            if (q == e)
+                break;
+            ret += quote;
+            b = q + 1;
+            if (b != e && *b == quote)
+                ++b;
+        }
+        return ret;
+    }
+
+    template <typename T>
+    void convertInt(T& n, const CsvField& field, const char* typeto)
+    {
+        if (field.quoted())
+        {
+            convert(n, field.str());
+            return;
+        }
+
+        bool ok = false;
+        const char* r = getInt(field.begin(), field.end(), ok, n);
+        while (ok && r != field.end() && std::isspace(*r))
+            ++r;
+
+        if (r != field.end() || !ok)
+            ConversionError::doThrow(typeto, "csv field", field.str().c_str());
+    }
+
+    template <typename T>
+    void convertFloat(T& n, const CsvField& field, const char* typeto)
+    {
+        if (field.quoted())
+        {
+            convert(n, field.str());
+            return;
+        }
+
+        bool ok = false;
+        const char* r = getFloat(field.begin(), field.end(), ok, n);
+        while (ok && r != field.end() && std::isspace(*r))
+            ++r;
+
+        if (r != field.end() || !ok)
+            ConversionError::doThrow(typeto, "csv field", field.str().c_str());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////
+// CsvField
+//
+std::string CsvField::str() const
+{
+    if (_quote)
+        return unescape(_begin, _end, _quote);
+    return std::string(_begin, _end);
+}
+
+String CsvField::toString() const
+{
+    return Utf8Codec::decode(str());
+}
+
+void CsvField::get(bool& value) const
+{
+    convert(value, str());
+}
+
+void CsvField::get(short& value) const
+{
+    convertInt(value, *this, "short");
+}
+
+void CsvField::get(unsigned short& value) const
+{
+    convertInt(value, *this, "unsigned short");
+}
+
+void CsvField::get(int& value) const
+{
+    convertInt(value, *this, "int");
+}
+
+void CsvField::get(unsigned int& value) const
+{
+    convertInt(value, *this, "unsigned int");
+}
+
+void CsvField::get(long& value) const
+{
+    convertInt(value, *this, "long");
+}
+
+void CsvField::get(unsigned long& value) const
+{
+    convertInt(value, *this, "unsigned long");
+}
+
+#ifdef HAVE_LONG_LONG
+void CsvField::get(long long& value) const
+{
+    convertInt(value, *this, "long long");
+}
+#endif
+
+#ifdef HAVE_UNSIGNED_LONG_LONG
+void CsvField::get(unsigned long long& value) const
+{
+    convertInt(value, *this, "unsigned long long");
+}
+#endif
+
+void CsvField::get(float& value) const
+{
+    convertFloat(value, *this, "float");
+}
+
+void CsvField::get(double& value) const
+{
+    convertFloat(value, *this, "double");
+}
+
+void CsvField::get(long double& value) const
+{
+    convertFloat(value, *this, "long double");
+}
+
+////////////////////////////////////////////////////////////////////////
+// CsvReader
+//
+const char CsvReader::autoDelimiter = '\0';
+
+const std::string& CsvReader::Column::title() const
+{
+    static const std::string empty;
+    return _column < _reader->_titles.size() ? _reader->_titles[_column] : empty;
+}
+
+CsvReader::CsvReader(const char* data, std::size_t size)
+    : _data(data),
+      _size(size),
+      _delimiter(autoDelimiter),
+      _quote('"'),
+      _readTitle(true),
+      _threads(0)
+{ }
+
+CsvReader::CsvReader(const std::string& fname)
+    : _data(0),
+      _size(0),
+      _file(fname, MappedFile::Sequential),
+      _delimiter(autoDelimiter),
+      _quote('"'),
+      _readTitle(true),
+      _threads(0)
+{
+    _data = _file.data();
+    _size = _file.size();
+}
+
+CsvReader::~CsvReader()
+{
+}
+
+void CsvReader::parse()
+{
+    const char* begin = _data;
+    const char* end = _data + _size;
+
+    _titles.clear();
+    _columns.clear();
+
+    if (begin == end)
+        return;
+
+    if (_readTitle)
+    {
+        if (_delimiter == autoDelimiter)
+        {
+            // the first character in the title line, which is not part of a
+            // title is the delimiter
+            char q = 0;
+            for (const char* p = begin; p != end && *p != '\n' && *p != '\r'; ++p)
+            {
+                if (q)
+                {
+                    if (*p == q)
+                        q = 0;
+                }
+                else if (*p == '"' || *p == '\'')
+                    q = *p;
+                else if (!std::isalnum(static_cast<unsigned char>(*p)) && *p != '_' && *p != ' ')
+                {
+                    _delimiter = *p;
+                    break;
+                }
+            }
+
+            if (_delimiter == autoDelimiter)
+                _delimiter = ',';
+
+            log_debug("delimiter=" << _delimiter);
+        }
+    }
+    else if (_delimiter == autoDelimiter)
+        throw std::logic_error("can't read csv data with auto delimiter but without title");
+
+    // the first record determines the number of columns
+    std::vector<FieldPos> fields;
+    ChunkParser first(_data, begin, end, _delimiter, _quote);
+    const char* p = first.parseRecord(begin, fields);
+
+    if (_readTitle)
+    {
+        for (unsigned n = 0; n < fields.size(); ++n)
+        {
+            CsvField f(_data + fields[n].offset, _data + fields[n].offset + fields[n].size, fields[n].quote);
+            _titles.push_back(f.str());
+            log_debug("title=\"" << _titles.back() << '"');
+        }
+        begin = p;
+    }
+
+    unsigned noColumns = fields.size();
+
+    // split the data into chunks
+    unsigned threads = _threads;
+    if (threads == 0)
+    {
+        long n = ::sysconf(_SC_NPROCESSORS_ONLN);
+        threads = n > 0 ? n : 1;
+    }
+
+    std::size_t size = end - begin;
+    if (size / threads < minChunkSize)
+        threads = size / minChunkSize > 0 ? size / minChunkSize : 1;
+
+    log_debug("parse " << size << " bytes in " << threads << " chunks");
+
+    std::vector<const char*> bounds(threads + 1);
+    bounds[0] = begin;
+    bounds[threads] = end;
+    for (unsigned n = 1; n < threads; ++n)
+        bounds[n] = begin + size / threads * n;
+
+    if (threads > 1)
+    {
+        // The parity of the number of quotes before a nominal chunk start
+        // tells, whether it is within a quoted value. The start is moved to
+        // the begin of the next record outside of quotes.
+        std::vector<QuoteCounter*> counters;
+        for (unsigned n = 0; n < threads; ++n)
+            counters.push_back(new QuoteCounter(bounds[n], bounds[n + 1], _quote));
+
+        runParallel(counters);
+
+        bool inQuote = false;
+        for (unsigned n = 1; n < threads; ++n)
+        {
+            if (counters[n - 1]->count & 1)
+                inQuote = !inQuote;
+
+            const char* s = bounds[n];
+            bool q = inQuote;
+            while (s != end)
+            {
+                s = findAny(s, end, _quote, '\n');
+                if (s == end)
+                    break;
+                if (*s == _quote)
+                    q = !q;
+                else if (!q)
+                    break;
+                ++s;
+            }
+
+            if (s != end)
+                ++s;
+
+            bounds[n] = std::max(s, bounds[n - 1]);
+        }
+
+        for (unsigned n = 0; n < threads; ++n)
+            delete counters[n];
+
+        for (unsigned n = threads - 1; n > 0; --n)
+            bounds[n] = std::min(bounds[n], bounds[n + 1]);
+    }
+
+    std::vector<ChunkParser*> parsers;
+    try
+    {
+        for (unsigned n = 0; n < threads; ++n)
+        {
+            parsers.push_back(new ChunkParser(_data, bounds[n], bounds[n + 1], _delimiter, _quote));
+            parsers.back()->columns.resize(noColumns);
+            for (unsigned c = 0; c < noColumns; ++c)
+                parsers.back()->columns[c].reserve((bounds[n + 1] - bounds[n]) / (noColumns * 8) + 1);
+        }
+
+        runParallel(parsers);
+
+        std::size_t rows = 0;
+        for (unsigned n = 0; n < threads; ++n)
+        {
+            if (!parsers[n]->errorMessage.empty())
+            {
+                std::ostringstream msg;
+                msg << parsers[n]->errorMessage << " (chunk starting at row " << (rows + 1) << ')';
+                SerializationError::doThrow(msg.str());
+            }
+            rows += parsers[n]->rows;
+        }
+
+        log_debug(rows << " rows read");
+
+        _columns.resize(noColumns);
+        for (unsigned c = 0; c < noColumns; ++c)
+        {
+            if (threads == 1)
+            {
+                _columns[c].swap(parsers[0]->columns[c]);
+                continue;
+            }
+
+            _columns[c].reserve(rows);
+            for (unsigned n = 0; n < threads; ++n)
+            {
+                FieldPosVector& v = parsers[n]->columns[c];
+                _columns[c].insert(_columns[c].end(), v.begin(), v.end());
+                FieldPosVector().swap(v);
+            }
+        }
+    }
+    catch (...)
+    {
+        for (unsigned n = 0; n < parsers.size(); ++n)
+            delete parsers[n];
+        _columns.clear();
+        throw;
+    }
+
+    for (unsigned n = 0; n < parsers.size(); ++n)
+        delete parsers[n];
+}
+
+CsvReader::Column CsvReader::column(unsigned n) const
+{
+    if (n >= _columns.size())
+        throw std::out_of_range("csv column index out of range");
+    return Column(*this, n);
+}
+
+CsvReader::Column CsvReader::column(const std::string& title) const
+{
+    for (unsigned n = 0; n < _titles.size(); ++n)
+        if (_titles[n] == title)
+            return Column(*this, n);
+
+    throw std::out_of_range("csv column \"" + title + "\" not found");
+}
+
+}
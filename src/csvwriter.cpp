@@ -0,0 +1,425 @@
+/*
+ * Copyright (C) 2016 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/csvwriter.h>
+#include <cxxtools/convert.h>
+#include <cxxtools/serializationerror.h>
+#include <cxxtools/log.h>
+#include <iterator>
+#include <ostream>
+#include <cstring>
+#include <stdint.h>
+
+log_define("cxxtools.csv.writer")
+
+namespace cxxtools
+{
+    namespace
+    {
+        inline void put(std::streambuf* sb, const char* data, std::size_t size)
+        { sb->sputn(data, size); }
+
+        inline void put(std::streambuf* sb, char ch)
+        { sb->sputc(ch); }
+
+        inline void put(std::string& s, const char* data, std::size_t size)
+        { s.append(data, size); }
+
+        inline void put(std::string& s, char ch)
+        { s += ch; }
+
+        inline bool matches(const char* p, const char* end, const std::string& s)
+        {
+            return !s.empty() && *p == s[0]
+                && static_cast<std::size_t>(end - p) >= s.size()
+                && s.compare(0, s.size(), p, s.size()) == 0;
+        }
+
+        bool needsQuote(const char* data, std::size_t size, const std::string& delimiter,
+                        char quote, const std::string& lineEnding)
+        {
+            const char* end = data + size;
+            for (const char* p = data; p != end; ++p)
+            {
+                if (*p == quote || *p == '\n' || *p == '\r'
+                    || matches(p, end, delimiter)
+                    || matches(p, end, lineEnding))
+                    return true;
+            }
+
+            return false;
+        }
+
+        template <typename Out>
+        void csvDataOut(Out& out, const char* data, std::size_t size, const std::string& delimiter,
+                        char quote, const std::string& lineEnding)
+        {
+            if (!needsQuote(data, size, delimiter, quote, lineEnding))
+            {
+                put(out, data, size);
+                return;
+            }
+
+            put(out, quote);
+
+            const char* end = data + size;
+            while (data != end)
+            {
+                const char* q = static_cast<const char*>(::memchr(data, quote, end - data));
+                if (q == 0)
+                {
+                    put(out, data, end - data);
+                    break;
+                }
+
+                put(out, data, q - data + 1);
+                put(out, quote);
+                data = q + 1;
+            }
+
+            put(out, quote);
+        }
+
+        void utf8Out(std::string& out, uint32_t ch)
+        {
+            if (ch < 0x80)
+            {
+                out += static_cast<char>(ch);
+            }
+            else if (ch < 0x800)
+            {
+                out += static_cast<char>(0xc0 | (ch >> 6));
+                out += static_cast<char>(0x80 | (ch & 0x3f));
+            }
+            else if (ch < 0x10000)
+            {
+                out += static_cast<char>(0xe0 | (ch >> 12));
+                out += static_cast<char>(0x80 | ((ch >> 6) & 0x3f));
+                out += static_cast<char>(0x80 | (ch & 0x3f));
+            }
+            else
+            {
+                out += static_cast<char>(0xf0 | ((ch >> 18) & 0x07));
+                out += static_cast<char>(0x80 | ((ch >> 12) & 0x3f));
+                out += static_cast<char>(0x80 | ((ch >> 6) & 0x3f));
+                out += static_cast<char>(0x80 | (ch & 0x3f));
+            }
+        }
+    }
+
+    CsvWriter::CsvWriter(std::ostream& os)
+        : _sb(os.rdbuf()),
+          _firstline(true),
+          _collectTitles(true),
+          _level(0),
+          _delimiter(","),
+          _quote('"'),
+          _lineEnding("\n"),
+          _memberNo(0),
+          _memberDepth(0),
+          _outColumn(0),
+          _plainColumn(0)
+    { }
+
+    void CsvWriter::selectColumn(const std::string& title)
+    {
+        selectColumn(title, title);
+    }
+
+    void CsvWriter::selectColumn(const std::string& memberName, const std::string& title)
+    {
+        _titles.resize(_titles.size() + 1);
+        _titles.back()._memberName = memberName;
+        _titles.back()._title = title;
+        _collectTitles = false;
+    }
+
+    int CsvWriter::columnIndex()
+    {
+        if (_memberDepth == 0)
+            return _plainColumn++;
+
+        // usually the members arrive in the same order as in the first object
+        if (_memberNo < _memberColumns.size()
+            && _memberColumns[_memberNo]._memberName == _memberName)
+            return _memberColumns[_memberNo]._column;
+
+        int column = -1;
+        for (unsigned n = 0; n < _titles.size(); ++n)
+        {
+            if (_titles[n]._memberName == _memberName)
+            {
+                column = n;
+                break;
+            }
+        }
+
+        log_debug("member \"" << _memberName << "\" no " << _memberNo << " column " << column);
+
+        if (_memberColumns.size() <= _memberNo)
+            _memberColumns.resize(_memberNo + 1);
+
+        _memberColumns[_memberNo]._memberName = _memberName;
+        _memberColumns[_memberNo]._column = column;
+
+        return column;
+    }
+
+    void CsvWriter::valueOut(const char* data, std::size_t size)
+    {
+        int column = columnIndex();
+        if (column < 0)
+            return;
+
+        unsigned c = static_cast<unsigned>(column);
+
+        // a column, which is already written or waiting for output, gets a
+        // second value, when a member is repeated in a object
+        if (c < _outColumn || (c < _pendingSet.size() && _pendingSet[c]))
+            throw SerializationError("duplicate value for csv column \"" + _memberName + '"');
+
+        if (!_firstline && c == _outColumn)
+        {
+            if (c > 0)
+                put(_sb, _delimiter.data(), _delimiter.size());
+
+            csvDataOut(_sb, data, size, _delimiter, _quote, _lineEnding);
+            ++_outColumn;
+
+            // output values, which arrived earlier
+            while (_outColumn < _pendingSet.size() && _pendingSet[_outColumn])
+            {
+                put(_sb, _delimiter.data(), _delimiter.size());
+                put(_sb, _pending[_outColumn].data(), _pending[_outColumn].size());
+                _pendingSet[_outColumn] = false;
+                ++_outColumn;
+            }
+        }
+        else
+        {
+            if (_pending.size() <= c)
+            {
+                _pending.resize(c + 1);
+                _pendingSet.resize(c + 1);
+            }
+
+            _pending[c].clear();
+            csvDataOut(_pending[c], data, size, _delimiter, _quote, _lineEnding);
+            _pendingSet[c] = true;
+        }
+    }
+
+    void CsvWriter::titlesOut()
+    {
+        log_debug("print " << _titles.size() << " titles");
+        for (unsigned n = 0; n < _titles.size(); ++n)
+        {
+            if (n > 0)
+                put(_sb, _delimiter.data(), _delimiter.size());
+            csvDataOut(_sb, _titles[n]._title.data(), _titles[n]._title.size(), _delimiter, _quote, _lineEnding);
+        }
+
+        put(_sb, _lineEnding.data(), _lineEnding.size());
+    }
+
+    void CsvWriter::dataOut()
+    {
+        if (_firstline)
+        {
+            if (!_titles.empty())
+                titlesOut();
+
+            _firstline = false;
+            _collectTitles = false;
+        }
+
+        unsigned columns = _titles.size();
+        if (columns < _plainColumn)
+            columns = _plainColumn;
+        for (unsigned n = _pendingSet.size(); n > columns; --n)
+        {
+            if (_pendingSet[n - 1])
+            {
+                columns = n;
+                break;
+            }
+        }
+
+        for ( ; _outColumn < columns; ++_outColumn)
+        {
+            if (_outColumn > 0)
+                put(_sb, _delimiter.data(), _delimiter.size());
+
+            if (_outColumn < _pendingSet.size() && _pendingSet[_outColumn])
+            {
+                put(_sb, _pending[_outColumn].data(), _pending[_outColumn].size());
+                _pendingSet[_outColumn] = false;
+            }
+        }
+
+        put(_sb, _lineEnding.data(), _lineEnding.size());
+
+        _outColumn = 0;
+        _plainColumn = 0;
+        _memberNo = 0;
+    }
+
+    void CsvWriter::addValueString(const std::string& /*name*/, const std::string& /*type*/,
+                          const String& value)
+    {
+        _buffer.clear();
+        for (String::const_iterator it = value.begin(); it != value.end(); ++it)
+            utf8Out(_buffer, static_cast<uint32_t>(it->value()));
+        valueOut(_buffer.data(), _buffer.size());
+    }
+
+    void CsvWriter::addValueStdString(const std::string& /*name*/, const std::string& /*type*/,
+                          const std::string& value)
+    {
+        // std::string values are latin1 like in String::widen
+        std::string::const_iterator it;
+        for (it = value.begin(); it != value.end(); ++it)
+            if (static_cast<unsigned char>(*it) >= 0x80)
+                break;
+
+        if (it == value.end())
+        {
+            valueOut(value.data(), value.size());
+        }
+        else
+        {
+            _buffer.assign(value.begin(), it);
+            for ( ; it != value.end(); ++it)
+                utf8Out(_buffer, static_cast<unsigned char>(*it));
+            valueOut(_buffer.data(), _buffer.size());
+        }
+    }
+
+    void CsvWriter::addValueBool(const std::string& /*name*/, const std::string& /*type*/,
+                          bool value)
+    {
+        if (value)
+            valueOut("true", 4);
+        else
+            valueOut("false", 5);
+    }
+
+    void CsvWriter::addValueInt(const std::string& /*name*/, const std::string& /*type*/,
+                          int_type value)
+    {
+        char buffer[sizeof(int_type) * 3 + 2];
+        char* e = putInt(buffer, value);
+        valueOut(buffer, e - buffer);
+    }
+
+    void CsvWriter::addValueUnsigned(const std::string& /*name*/, const std::string& /*type*/,
+                          unsigned_type value)
+    {
+        char buffer[sizeof(unsigned_type) * 3 + 2];
+        char* e = putInt(buffer, value);
+        valueOut(buffer, e - buffer);
+    }
+
+    void CsvWriter::addValueFloat(const std::string& /*name*/, const std::string& /*type*/,
+                          long double value)
+    {
+        _buffer.clear();
+        putFloat(std::back_inserter(_buffer), value);
+        valueOut(_buffer.data(), _buffer.size());
+    }
+
+    void CsvWriter::addNull(const std::string& /*name*/, const std::string& /*type*/)
+    {
+        valueOut("", 0);
+    }
+
+    void CsvWriter::beginArray(const std::string& /*name*/, const std::string& /*type*/)
+    {
+        ++_level;
+        log_debug("beginArray, level=" << _level);
+    }
+
+    void CsvWriter::finishArray()
+    {
+        --_level;
+
+        log_debug("finishArray, level=" << _level);
+
+        if (_level == 1)
+            dataOut();
+    }
+
+    void CsvWriter::beginObject(const std::string& /*name*/, const std::string& /*type*/)
+    {
+        ++_level;
+        log_debug("beginObject, level=" << _level);
+    }
+
+    void CsvWriter::beginMember(const std::string& name)
+    {
+        log_debug("beginMember " << name);
+        if (_collectTitles && _firstline && _level == 2)
+        {
+            log_debug("add title " << name);
+            _titles.resize(_titles.size() + 1);
+            _titles.back()._title = name;
+            _titles.back()._memberName = name;
+        }
+
+        _memberName = name;
+        ++_memberDepth;
+    }
+
+    void CsvWriter::finishMember()
+    {
+        log_debug("finishMember");
+        --_memberDepth;
+        if (_level == 2)
+            ++_memberNo;
+    }
+
+    void CsvWriter::finishObject()
+    {
+        --_level;
+
+        log_debug("finishObject, level=" << _level);
+
+        if (_level == 1)
+            dataOut();
+    }
+
+    void CsvWriter::finish()
+    {
+        log_debug("finish");
+
+        if (_firstline && !_titles.empty())
+            titlesOut();
+
+        _sb->pubsync();
+    }
+}
@@ -0,0 +1,577 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/directorywalker.h>
+#include <cxxtools/systemerror.h>
+#include <cxxtools/threadpool.h>
+#include <cxxtools/mutex.h>
+#include <cxxtools/condition.h>
+#include <cxxtools/atomicity.h>
+#include <cxxtools/log.h>
+#include "error.h"
+#include <deque>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+log_define("cxxtools.directorywalker")
+
+namespace cxxtools
+{
+    namespace
+    {
+        FileInfo::Type typeFromMode(mode_t mode)
+        {
+            if (S_ISDIR(mode))
+                return FileInfo::Directory;
+            else if (S_ISCHR(mode))
+                return FileInfo::Chardev;
+            else if (S_ISBLK(mode))
+                return FileInfo::Blockdev;
+            else if (S_ISFIFO(mode))
+                return FileInfo::Fifo;
+            else if (S_ISLNK(mode))
+                return FileInfo::Symlink;
+            else if (S_ISSOCK(mode))
+                return FileInfo::Socket;
+
+            return FileInfo::File;
+        }
+
+        // Returns Invalid, when the file system does not tell the type.
+        FileInfo::Type typeFromDirent(unsigned char type)
+        {
+            switch (type)
+            {
+                case DT_DIR:  return FileInfo::Directory;
+                case DT_REG:  return FileInfo::File;
+                case DT_LNK:  return FileInfo::Symlink;
+                case DT_CHR:  return FileInfo::Chardev;
+                case DT_BLK:  return FileInfo::Blockdev;
+                case DT_FIFO: return FileInfo::Fifo;
+                case DT_SOCK: return FileInfo::Socket;
+                default:      return FileInfo::Invalid;
+            }
+        }
+
+        inline bool isDotOrDotDot(const char* name)
+        {
+            return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+        }
+
+#ifdef SYS_getdents64
+        struct Dirent64
+        {
+            uint64_t d_ino;
+            int64_t d_off;
+            unsigned short d_reclen;
+            unsigned char d_type;
+            char d_name[1];
+        };
+#endif
+
+        // An open directory. On Linux the entries are fetched with getdents64
+        // in large batches, which needs fewer system calls than readdir.
+        class DirReader : private NonCopyable
+        {
+                int _fd;
+#ifdef SYS_getdents64
+                std::vector<char> _buffer;
+                std::size_t _pos;
+                std::size_t _len;
+#else
+                DIR* _dir;
+#endif
+
+            public:
+                static const std::size_t BatchSize = 65536;
+
+                DirReader()
+                    : _fd(-1)
+#ifdef SYS_getdents64
+                    , _pos(0),
+                      _len(0)
+#else
+                    , _dir(0)
+#endif
+                { }
+
+                ~DirReader()
+                { close(); }
+
+                // Opens the directory relative to the directory dirfd.
+                // Returns 0 or the errno value, when the directory can't be opened.
+                int open(int dirfd, const char* path, bool follow)
+                {
+                    int flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+                    if (!follow)
+                        flags |= O_NOFOLLOW;
+
+                    _fd = ::openat(dirfd, path, flags);
+                    if (_fd < 0)
+                        return errno;
+
+#ifdef SYS_getdents64
+                    if (_buffer.empty())
+                        _buffer.resize(BatchSize);
+                    _pos = _len = 0;
+#else
+                    _dir = ::fdopendir(_fd);
+                    if (_dir == 0)
+                    {
+                        int err = errno;
+                        ::close(_fd);
+                        _fd = -1;
+                        return err;
+                    }
+#endif
+                    return 0;
+                }
+
+                void close()
+                {
+#ifdef SYS_getdents64
+                    if (_fd >= 0)
+                        ::close(_fd);
+#else
+                    if (_dir)
+                        ::closedir(_dir);
+                    _dir = 0;
+#endif
+                    _fd = -1;
+                }
+
+                int fd() const
+                { return _fd; }
+
+                bool next(const char*& name, unsigned char& type)
+                {
+#ifdef SYS_getdents64
+                    if (_pos >= _len)
+                    {
+                        long ret;
+                        do
+                        {
+                            ret = ::syscall(SYS_getdents64, _fd, &_buffer[0], _buffer.size());
+                        } while (ret < 0 && errno == EINTR);
+
+                        if (ret < 0)
+                            throw SystemError("getdents64");
+
+                        if (ret == 0)
+                            return false;
+
+                        _pos = 0;
+                        _len = ret;
+                    }
+
+                    const Dirent64* d = reinterpret_cast<const Dirent64*>(&_buffer[_pos]);
+                    _pos += d->d_reclen;
+                    name = d->d_name;
+                    type = d->d_type;
+                    return true;
+#else
+                    errno = 0;
+                    struct dirent* d = ::readdir(_dir);
+                    if (d == 0)
+                    {
+                        if (errno != 0)
+                            throw SystemError("readdir");
+                        return false;
+                    }
+
+                    name = d->d_name;
+#ifdef _DIRENT_HAVE_D_TYPE
+                    type = d->d_type;
+#else
+                    type = DT_UNKNOWN;
+#endif
+                    return true;
+#endif
+                }
+        };
+
+        // Subtrees, which are waiting for a thread in a parallel walk.
+        struct WorkQueue
+        {
+            Mutex mutex;
+            Condition available;
+            std::deque<std::pair<std::string, unsigned> > queue;
+            unsigned threads;
+            unsigned idle;
+            volatile atomic_t stopped;
+            std::string error;
+
+            explicit WorkQueue(unsigned threads_)
+                : threads(threads_),
+                  idle(0),
+                  stopped(0)
+            { }
+
+            // Hands a directory over to an idle thread. Returns false, when
+            // all threads are busy, so that the caller walks it itself.
+            bool offer(const std::string& path, unsigned depth)
+            {
+                MutexLock lock(mutex);
+                if (idle <= queue.size())
+                    return false;
+
+                queue.push_back(std::make_pair(path, depth));
+                available.signal();
+                return true;
+            }
+
+            void stop(const char* what)
+            {
+                MutexLock lock(mutex);
+                if (error.empty())
+                    error = what;
+                atomicSet(stopped, 1);
+                available.broadcast();
+            }
+        };
+    }
+
+    class DirectoryWalkerImpl : private NonCopyable
+    {
+        public:
+            struct Options
+            {
+                bool skipHidden;
+                bool statEntries;
+                unsigned maxDepth;
+
+                Options()
+                    : skipHidden(false),
+                      statEntries(false),
+                      maxDepth(std::numeric_limits<unsigned>::max())
+                { }
+            };
+
+        private:
+            struct Level
+            {
+                DirReader reader;
+                std::string path;    // path of the directory with trailing slash
+                unsigned depth;      // depth of the entries
+            };
+
+            Options _options;
+            WorkQueue* _workQueue;
+            std::vector<Level*> _levels;
+            unsigned _open;
+
+            int enter(int dirfd, const char* name, const std::string& path, unsigned depth, bool root);
+
+        public:
+            DirectoryWalkerImpl(const Options& options, WorkQueue* workQueue = 0)
+                : _options(options),
+                  _workQueue(workQueue),
+                  _open(0)
+            { }
+
+            ~DirectoryWalkerImpl();
+
+            Options& options()
+            { return _options; }
+
+            void setWorkQueue(WorkQueue* workQueue)
+            { _workQueue = workQueue; }
+
+            void open(const std::string& path)
+            {
+                int err = enter(AT_FDCWD, path.c_str(), path, 0, true);
+                if (err != 0)
+                    throw SystemError(err, ("opendir(\"" + path + "\")").c_str());
+            }
+
+            bool next(DirectoryWalker::Entry& entry);
+
+            void work(const Callable<void, const DirectoryWalker::Entry&>& cb);
+    };
+
+    DirectoryWalkerImpl::~DirectoryWalkerImpl()
+    {
+        for (unsigned n = 0; n < _levels.size(); ++n)
+            delete _levels[n];
+    }
+
+    int DirectoryWalkerImpl::enter(int dirfd, const char* name, const std::string& path, unsigned depth, bool root)
+    {
+        if (_open == _levels.size())
+            _levels.push_back(new Level());
+
+        Level& level = *_levels[_open];
+
+        int err = level.reader.open(dirfd, name, root);
+        if (err != 0)
+        {
+            // directories may be removed or may not be readable while walking
+            if (!root)
+                log_warn("skip directory \"" << path << "\": " << getErrnoString(err));
+            return err;
+        }
+
+        level.path = path;
+        if (level.path.empty() || level.path[level.path.size() - 1] != '/')
+            level.path += '/';
+        level.depth = depth;
+
+        ++_open;
+        return 0;
+    }
+
+    bool DirectoryWalkerImpl::next(DirectoryWalker::Entry& entry)
+    {
+        while (_open > 0)
+        {
+            Level& level = *_levels[_open - 1];
+
+            const char* name;
+            unsigned char type;
+            if (!level.reader.next(name, type))
+            {
+                level.reader.close();
+                --_open;
+                continue;
+            }
+
+            if (isDotOrDotDot(name) || (_options.skipHidden && name[0] == '.'))
+                continue;
+
+            entry._path = level.path;
+            entry._nameOffset = level.path.size();
+            entry._path += name;
+            entry._depth = level.depth;
+            entry._type = typeFromDirent(type);
+            entry._size = 0;
+            entry._mtime = Timespan(0);
+
+            if (_options.statEntries || entry._type == FileInfo::Invalid)
+            {
+                struct stat st;
+                if (::fstatat(level.reader.fd(), name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+                {
+                    if (errno == ENOENT)
+                        continue;  // removed in the meantime
+                    throw SystemError("fstatat", "Could not stat '" + entry._path + '\'');
+                }
+
+                entry._type = typeFromMode(st.st_mode);
+                entry._size = st.st_size;
+                entry._mtime = Timespan(st.st_mtim.tv_sec, st.st_mtim.tv_nsec / 1000);
+            }
+
+            if (entry._type == FileInfo::Directory && level.depth < _options.maxDepth)
+            {
+                if (_workQueue == 0 || !_workQueue->offer(entry._path, level.depth + 1))
+                    enter(level.reader.fd(), name, entry._path, level.depth + 1, false);
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    void DirectoryWalkerImpl::work(const Callable<void, const DirectoryWalker::Entry&>& cb)
+    {
+        DirectoryWalker::Entry entry;
+
+        while (true)
+        {
+            while (!atomicGet(_workQueue->stopped) && next(entry))
+                cb(entry);
+
+            MutexLock lock(_workQueue->mutex);
+
+            ++_workQueue->idle;
+            while (_workQueue->queue.empty()
+                && _workQueue->idle < _workQueue->threads
+                && !atomicGet(_workQueue->stopped))
+                _workQueue->available.wait(lock);
+
+            if (_workQueue->queue.empty() || atomicGet(_workQueue->stopped))
+            {
+                // all threads are idle, so the walk is finished
+                _workQueue->available.broadcast();
+                return;
+            }
+
+            --_workQueue->idle;
+
+            std::pair<std::string, unsigned> dir = _workQueue->queue.front();
+            _workQueue->queue.pop_front();
+
+            lock.unlock();
+
+            enter(AT_FDCWD, dir.first.c_str(), dir.first, dir.second, false);
+        }
+    }
+
+    namespace
+    {
+        class WalkTask : public Callable<void>
+        {
+                const DirectoryWalkerImpl::Options& _options;
+                WorkQueue& _workQueue;
+                const Callable<void, const DirectoryWalker::Entry&>& _cb;
+
+            public:
+                WalkTask(const DirectoryWalkerImpl::Options& options, WorkQueue& workQueue,
+                         const Callable<void, const DirectoryWalker::Entry&>& cb)
+                    : _options(options),
+                      _workQueue(workQueue),
+                      _cb(cb)
+                { }
+
+                Callable<void>* clone() const
+                { return new WalkTask(*this); }
+
+                void operator()() const
+                {
+                    try
+                    {
+                        DirectoryWalkerImpl walker(_options, &_workQueue);
+                        walker.work(_cb);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        log_warn("directory walk failed: " << e.what());
+                        _workQueue.stop(e.what());
+                    }
+                    catch (...)
+                    {
+                        _workQueue.stop("directory walk failed");
+                    }
+                }
+        };
+    }
+
+    ////////////////////////////////////////////////////////////////////////
+    // DirectoryWalker
+    //
+    DirectoryWalker::DirectoryWalker(const std::string& path)
+        : _impl(new DirectoryWalkerImpl(DirectoryWalkerImpl::Options()))
+    {
+        try
+        {
+            _impl->open(path);
+        }
+        catch (...)
+        {
+            delete _impl;
+            throw;
+        }
+    }
+
+    DirectoryWalker::~DirectoryWalker()
+    {
+        delete _impl;
+    }
+
+    DirectoryWalker& DirectoryWalker::skipHidden(bool sw)
+    {
+        _impl->options().skipHidden = sw;
+        return *this;
+    }
+
+    DirectoryWalker& DirectoryWalker::statEntries(bool sw)
+    {
+        _impl->options().statEntries = sw;
+        return *this;
+    }
+
+    DirectoryWalker& DirectoryWalker::maxDepth(unsigned depth)
+    {
+        _impl->options().maxDepth = depth;
+        return *this;
+    }
+
+    bool DirectoryWalker::next(Entry& entry)
+    {
+        return _impl->next(entry);
+    }
+
+    void DirectoryWalker::walk(const Callable<void, const Entry&>& cb, unsigned threads)
+    {
+        if (threads <= 1)
+        {
+            Entry entry;
+            while (_impl->next(entry))
+                cb(entry);
+            return;
+        }
+
+        WorkQueue workQueue(threads);
+        _impl->setWorkQueue(&workQueue);
+
+        try
+        {
+            // the pool is destroyed and all helpers are finished before
+            // the work queue goes out of scope
+            ThreadPool pool(threads - 1);
+            for (unsigned n = 0; n < threads - 1; ++n)
+                pool.schedule(WalkTask(_impl->options(), workQueue, cb));
+
+            try
+            {
+                _impl->work(cb);
+            }
+            catch (const std::exception& e)
+            {
+                workQueue.stop(e.what());
+                throw;
+            }
+            catch (...)
+            {
+                workQueue.stop("directory walk failed");
+                throw;
+            }
+        }
+        catch (...)
+        {
+            _impl->setWorkQueue(0);
+            throw;
+        }
+
+        _impl->setWorkQueue(0);
+
+        if (!workQueue.error.empty())
+            throw std::runtime_error(workQueue.error);
+    }
+}
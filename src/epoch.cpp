@@ -0,0 +1,407 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/epoch.h>
+#include <cxxtools/mutex.h>
+#include <cxxtools/condition.h>
+#include <cxxtools/thread.h>
+#include <cxxtools/timespan.h>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 201103L
+#include <atomic>
+#include <stdint.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#endif
+
+namespace cxxtools
+{
+  namespace
+  {
+    typedef std::vector<std::pair<void (*)(void*), void*> > Callbacks;
+
+    // objects are destroyed in batches to amortize the synchronization, but
+    // not later than reclaimInterval after they were queued
+    const unsigned maxPending = 64;
+    const Milliseconds reclaimInterval(100);
+
+    struct Pending
+    {
+      Mutex mutex;
+      Callbacks callbacks;
+      Condition queued;
+      bool stop;
+      // Serializes synchronize, so that it does not return before the
+      // objects taken by a concurrent call, e.g. of the reclaimer thread,
+      // are destroyed.
+      Mutex synchronizeMutex;
+
+      Pending()
+        : stop(false)
+      { }
+    };
+
+    // never destroyed, so that it may be used while other static objects are destroyed
+    Pending& pendingCallbacks()
+    {
+      static Pending* p = new Pending();
+      return *p;
+    }
+
+    void takePending(Callbacks& callbacks)
+    {
+      Pending& p = pendingCallbacks();
+      MutexLock lock(p.mutex);
+      callbacks.swap(p.callbacks);
+    }
+
+    void runCallbacks(const Callbacks& callbacks)
+    {
+      for (Callbacks::const_iterator it = callbacks.begin(); it != callbacks.end(); ++it)
+        it->first(it->second);
+    }
+  }
+
+#if __cplusplus >= 201103L
+
+  namespace
+  {
+    // A reader announces the epoch, in which it entered its outermost read
+    // section. Outside of read sections the epoch is 0. Records are
+    // allocated once per thread and reused after the thread has terminated.
+    struct ThreadRecord
+    {
+      std::atomic<uint64_t> epoch;
+      unsigned nesting;
+      bool inUse;
+      char padding[64];  // keep records of different threads in different cache lines
+
+      ThreadRecord()
+        : epoch(0),
+          nesting(0),
+          inUse(true)
+      { }
+    };
+
+    std::atomic<uint64_t> globalEpoch(1);
+
+    thread_local ThreadRecord* threadRecord = 0;
+    thread_local bool threadReleased = false;
+
+    // With membarrier(2) a writer forces a memory barrier on all running
+    // threads of the process, so that readers need only a compiler barrier.
+    bool useMembarrier = false;
+
+#if defined(__linux__) && defined(SYS_membarrier)
+    const int membarrierPrivateExpedited = 1 << 3;
+    const int membarrierRegisterPrivateExpedited = 1 << 4;
+
+    bool registerMembarrier()
+    {
+      return ::syscall(SYS_membarrier, membarrierRegisterPrivateExpedited, 0) == 0;
+    }
+
+    void heavyBarrier()
+    {
+      if (!useMembarrier
+        || ::syscall(SYS_membarrier, membarrierPrivateExpedited, 0) != 0)
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+#else
+    bool registerMembarrier()
+    {
+      return false;
+    }
+
+    void heavyBarrier()
+    {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+#endif
+
+    struct Registry
+    {
+      Mutex mutex;
+      std::vector<ThreadRecord*> records;
+
+      Registry()
+      { useMembarrier = registerMembarrier(); }
+    };
+
+    Registry& registry()
+    {
+      static Registry* r = new Registry();
+      return *r;
+    }
+
+    void releaseRecord();
+
+    struct RecordRelease
+    {
+      ~RecordRelease()
+      { releaseRecord(); }
+    };
+
+    ThreadRecord* acquireRecord()
+    {
+      Registry& r = registry();
+      MutexLock lock(r.mutex);
+
+      ThreadRecord* record = 0;
+      for (std::vector<ThreadRecord*>::iterator it = r.records.begin(); it != r.records.end(); ++it)
+      {
+        if (!(*it)->inUse)
+        {
+          record = *it;
+          record->inUse = true;
+          break;
+        }
+      }
+
+      if (record == 0)
+      {
+        record = new ThreadRecord();
+        r.records.push_back(record);
+      }
+
+      threadRecord = record;
+      lock.unlock();
+
+      // A thread, which enters a read section while its thread local
+      // objects are destroyed, keeps its record.
+      if (!threadReleased)
+      {
+        static thread_local RecordRelease recordRelease;
+      }
+
+      return record;
+    }
+
+    void releaseRecord()
+    {
+      Registry& r = registry();
+      MutexLock lock(r.mutex);
+      threadRecord->epoch.store(0, std::memory_order_relaxed);
+      threadRecord->nesting = 0;
+      threadRecord->inUse = false;
+      threadRecord = 0;
+      threadReleased = true;
+    }
+  }
+
+  void Epoch::enter()
+  {
+    ThreadRecord* record = threadRecord;
+    if (record == 0)
+      record = acquireRecord();
+
+    if (record->nesting++ == 0)
+    {
+      record->epoch.store(globalEpoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+      if (useMembarrier)
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+      else
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+  }
+
+  void Epoch::leave()
+  {
+    ThreadRecord* record = threadRecord;
+    if (--record->nesting == 0)
+      record->epoch.store(0, std::memory_order_release);
+  }
+
+  void Epoch::synchronize()
+  {
+    if (threadRecord && threadRecord->nesting > 0)
+      throw std::logic_error("Epoch::synchronize called within a read section");
+
+    MutexLock serial(pendingCallbacks().synchronizeMutex);
+
+    Callbacks callbacks;
+    takePending(callbacks);
+
+    // Records are never freed, so the readers are waited for without
+    // holding the registry lock and new threads may register meanwhile.
+    // Threads, which register later, see the new epoch.
+    std::vector<ThreadRecord*> records;
+    uint64_t epoch;
+
+    {
+      Registry& r = registry();
+      MutexLock lock(r.mutex);
+
+      heavyBarrier();
+
+      epoch = globalEpoch.fetch_add(1) + 1;
+      records = r.records;
+    }
+
+    for (std::vector<ThreadRecord*>::const_iterator it = records.begin(); it != records.end(); ++it)
+    {
+      for (unsigned count = 0; ; ++count)
+      {
+        uint64_t e = (*it)->epoch.load(std::memory_order_acquire);
+        if (e == 0 || e >= epoch)
+          break;
+
+        if (count < 100)
+          Thread::yield();
+        else
+          Thread::sleep(Milliseconds(1));
+      }
+    }
+
+    heavyBarrier();
+
+    runCallbacks(callbacks);
+  }
+
+#else
+
+  // Without C++11 read sections are implemented with a read write mutex.
+  namespace
+  {
+    ReadWriteMutex& epochMutex()
+    {
+      static ReadWriteMutex* m = new ReadWriteMutex();
+      return *m;
+    }
+  }
+
+  void Epoch::enter()
+  {
+    epochMutex().readLock();
+  }
+
+  void Epoch::leave()
+  {
+    epochMutex().unlock();
+  }
+
+  void Epoch::synchronize()
+  {
+    MutexLock serial(pendingCallbacks().synchronizeMutex);
+
+    Callbacks callbacks;
+    takePending(callbacks);
+
+    {
+      WriteLock lock(epochMutex());
+    }
+
+    runCallbacks(callbacks);
+  }
+
+#endif
+
+  namespace
+  {
+    // Queued objects are destroyed by a background thread. The writer must
+    // not wait for the readers itself, since it may hold a lock, which a
+    // reader needs before it can leave its read section. The thread is
+    // stopped on program exit and the remaining objects are destroyed then.
+    class Reclaimer
+    {
+        AttachedThread _thread;
+
+        void run()
+        {
+          Pending& p = pendingCallbacks();
+          while (true)
+          {
+            {
+              MutexLock lock(p.mutex);
+              while (!p.stop && p.callbacks.empty())
+                p.queued.wait(lock);
+
+              // give the writers the chance to queue more objects
+              if (!p.stop && p.callbacks.size() < maxPending)
+                p.queued.wait(lock, reclaimInterval);
+
+              if (p.stop)
+                return;
+            }
+
+            Epoch::synchronize();
+          }
+        }
+
+      public:
+        Reclaimer()
+          : _thread(callable(*this, &Reclaimer::run))
+        { _thread.start(); }
+
+        ~Reclaimer()
+        {
+          Pending& p = pendingCallbacks();
+
+          {
+            MutexLock lock(p.mutex);
+            p.stop = true;
+            p.queued.signal();
+          }
+
+          try
+          {
+            _thread.join();
+            Epoch::synchronize();
+          }
+          catch (const std::exception&)
+          {
+          }
+        }
+    };
+  }
+
+  void Epoch::defer(void (*fn)(void*), void* arg)
+  {
+    static Reclaimer reclaimer;
+
+    Pending& p = pendingCallbacks();
+    MutexLock lock(p.mutex);
+    p.callbacks.push_back(Callbacks::value_type(fn, arg));
+
+    // the reclaimer waits for the first object and for a full batch
+    if (p.callbacks.size() == 1 || p.callbacks.size() >= maxPending)
+      p.queued.signal();
+  }
+
+  unsigned Epoch::pending()
+  {
+    Pending& p = pendingCallbacks();
+    MutexLock lock(p.mutex);
+    return p.callbacks.size();
+  }
+}
@@ -27,9 +27,9 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 #include "selectorimpl.h"
+#include "eventqueue.h"
 #include "cxxtools/eventloop.h"
-#include "cxxtools/mutex.h"
-#include <deque>
+#include "cxxtools/atomicity.h"
 
 namespace cxxtools
 {
@@ -38,61 +38,24 @@ class EventLoop::Impl
 {
 public:
     Impl()
-        : _exitLoop(false),
+        : _exitLoop(0),
           _selector(new SelectorImpl())
         { }
-    ~Impl();
+    ~Impl()
+    { delete _selector; }
 
-    bool eventQueueEmpty()
+    bool eventQueueEmpty() const
     { return _eventQueue.empty() && _priorityEventQueue.empty(); }
 
-    Event* front()
-    {
-        if (_priorityEventQueue.empty())
-            return _eventQueue.front();
-        else
-            return _priorityEventQueue.front();
-    }
-
-    void pop_front()
-    {
-        if (_priorityEventQueue.empty())
-            _eventQueue.pop_front();
-        else
-            _priorityEventQueue.pop_front();
-    }
+    bool exitLoop()
+    { return atomicGet(_exitLoop) != 0; }
 
-    bool _exitLoop;
+    volatile atomic_t _exitLoop;
     SelectorImpl* _selector;
-    std::deque<Event* > _eventQueue;
-    std::deque<Event* > _priorityEventQueue;
-    RecursiveMutex _queueMutex;
+    EventQueue _eventQueue;
+    EventQueue _priorityEventQueue;
 };
 
-EventLoop::Impl::~Impl()
-{
-    try
-    {
-        while ( ! _eventQueue.empty() )
-        {
-            Event* ev = _eventQueue.front();
-            _eventQueue.pop_front();
-            ev->destroy();
-        }
-
-        while ( ! _priorityEventQueue.empty() )
-        {
-            Event* ev = _priorityEventQueue.front();
-            _priorityEventQueue.pop_front();
-            ev->destroy();
-        }
-    }
-    catch(...)
-    {}
-
-    delete _selector;
-}
-
 EventLoop::EventLoop()
 : _impl(new Impl())
 {
@@ -132,21 +95,11 @@ void EventLoop::onRun()
 {
     while (true)
     {
-        RecursiveLock lock(_impl->_queueMutex);
-
-        if (_impl->_exitLoop)
-        {
-            _impl->_exitLoop = false;
+        if (atomicExchange(_impl->_exitLoop, 0) != 0)
             break;
-        }
 
         if (!_impl->eventQueueEmpty())
-        {
-            lock.unlock();
             this->processEvents();
-        }
-
-        lock.unlock();
 
         bool active = this->wait( this->idleTimeout() );
         if( ! active )
@@ -161,13 +114,8 @@ bool EventLoop::onWaitUntil(Timespan timeout)
 {
     if (_impl->_selector->waitUntil(timeout))
     {
-        RecursiveLock lock(_impl->_queueMutex);
-
         if (!_impl->eventQueueEmpty())
-        {
-            lock.unlock();
             this->processEvents();
-        }
 
         return true;
     }
@@ -184,32 +132,17 @@ void EventLoop::onWake()
 
 void EventLoop::onExit()
 {
-    RecursiveLock lock(_impl->_queueMutex);
-    _impl->_exitLoop = true;
-    lock.unlock();
-
+    atomicSet(_impl->_exitLoop, 1);
     this->wake();
 }
 
 
 void EventLoop::onQueueEvent(const Event& ev, bool priority)
 {
-    RecursiveLock lock( _impl->_queueMutex );
-
-    Event* clonedEvent = ev.clone();
-
-    try
-    {
-        if (priority)
-            _impl->_priorityEventQueue.push_back(clonedEvent);
-        else
-            _impl->_eventQueue.push_back(clonedEvent);
-    }
-    catch(...)
-    {
-        clonedEvent->destroy();
-        throw;
-    }
+    if (priority)
+        _impl->_priorityEventQueue.push(ev);
+    else
+        _impl->_eventQueue.push(ev);
 }
 
 
@@ -222,28 +155,29 @@ void EventLoop::onCommitEvent(const Event& ev, bool priority)
 
 void EventLoop::onProcessEvents()
 {
-    while (!_impl->_exitLoop)
+    while (!_impl->exitLoop())
     {
-        RecursiveLock lock(_impl->_queueMutex);
-
-        if (_impl->eventQueueEmpty() || _impl->_exitLoop)
-            break;
-
-        Event* ev = _impl->front();
-        _impl->pop_front();
+        EventQueue* queue = &_impl->_priorityEventQueue;
+        EventQueue::Node* node = queue->pop();
+        if (node == 0)
+        {
+            queue = &_impl->_eventQueue;
+            node = queue->pop();
+            if (node == 0)
+                break;
+        }
 
         try
         {
-            lock.unlock();
-            event.send(*ev);
+            event.send(EventQueue::event(node));
         }
         catch(...)
         {
-            ev->destroy();
+            queue->release(node);
             throw;
         }
 
-        ev->destroy();
+        queue->release(node);
     }
 }
 
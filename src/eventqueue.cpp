@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "eventqueue.h"
+
+namespace cxxtools
+{
+
+namespace
+{
+    // unused nodes, which are kept for reuse
+    const unsigned maxFreeNodes = 1024;
+}
+
+class EventQueue::Node
+{
+    public:
+        // events, which fit into this buffer, are not cloned
+        static const std::size_t BufferSize = 64;
+
+#if __cplusplus >= 201103L
+        std::atomic<Node*> next;
+#endif
+        Node* nextFree;
+        Event* event;
+        bool inplace;
+
+        union
+        {
+            char buffer[BufferSize];
+            long double align1;
+            void* align2;
+            long align3;
+        };
+
+        Node()
+            : nextFree(0),
+              event(0),
+              inplace(false)
+        {
+#if __cplusplus >= 201103L
+            next.store(0, std::memory_order_relaxed);
+#endif
+        }
+
+        void set(const Event& ev)
+        {
+            event = ev.cloneTo(buffer, BufferSize);
+            inplace = event != 0;
+            if (!inplace)
+                event = ev.clone();
+        }
+
+        void clear()
+        {
+            if (inplace)
+                event->~Event();
+            else if (event)
+                event->destroy();
+            event = 0;
+        }
+};
+
+Event& EventQueue::event(Node* node)
+{
+    return *node->event;
+}
+
+#if __cplusplus >= 201103L
+
+// The queue is the intrusive multiple producer single consumer queue of
+// Dmitry Vyukov. A stub node makes sure, that the queue is never empty.
+
+EventQueue::EventQueue()
+    : _stub(new Node()),
+      _free(0),
+      _freeCount(0)
+{
+    _head.store(_stub, std::memory_order_relaxed);
+    _tail = _stub;
+}
+
+EventQueue::~EventQueue()
+{
+    Node* node;
+    while ((node = pop()) != 0)
+        release(node);
+
+    while (_free)
+    {
+        node = _free;
+        _free = node->nextFree;
+        delete node;
+    }
+
+    delete _stub;
+}
+
+EventQueue::Node* EventQueue::allocate()
+{
+    SpinLock lock(_freeMutex);
+    Node* node = _free;
+    if (node)
+    {
+        _free = node->nextFree;
+        --_freeCount;
+        lock.unlock();
+        node->next.store(0, std::memory_order_relaxed);
+        return node;
+    }
+
+    lock.unlock();
+    return new Node();
+}
+
+void EventQueue::append(Node* node)
+{
+    node->next.store(0, std::memory_order_relaxed);
+    Node* prev = _head.exchange(node, std::memory_order_acq_rel);
+    // until next is set, the consumer does not see the node
+    prev->next.store(node, std::memory_order_release);
+}
+
+void EventQueue::push(const Event& ev)
+{
+    Node* node = allocate();
+
+    try
+    {
+        node->set(ev);
+    }
+    catch (...)
+    {
+        release(node);
+        throw;
+    }
+
+    append(node);
+}
+
+EventQueue::Node* EventQueue::pop()
+{
+    Node* tail = _tail;
+    Node* next = tail->next.load(std::memory_order_acquire);
+
+    if (tail == _stub)
+    {
+        if (next == 0)
+            return 0;
+
+        _tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next)
+    {
+        _tail = next;
+        return tail;
+    }
+
+    // a producer has taken the place of the last node but not linked it yet
+    if (tail != _head.load(std::memory_order_acquire))
+        return 0;
+
+    append(_stub);
+
+    next = tail->next.load(std::memory_order_acquire);
+    if (next)
+    {
+        _tail = next;
+        return tail;
+    }
+
+    return 0;
+}
+
+bool EventQueue::empty() const
+{
+    // the stub is appended again only when the last node is removed
+    return _head.load(std::memory_order_acquire) == _stub;
+}
+
+void EventQueue::release(Node* node)
+{
+    node->clear();
+
+    SpinLock lock(_freeMutex);
+    if (_freeCount < maxFreeNodes)
+    {
+        node->nextFree = _free;
+        _free = node;
+        ++_freeCount;
+    }
+    else
+    {
+        lock.unlock();
+        delete node;
+    }
+}
+
+#else
+
+EventQueue::EventQueue()
+{
+}
+
+EventQueue::~EventQueue()
+{
+    while (!_queue.empty())
+    {
+        release(_queue.front());
+        _queue.pop_front();
+    }
+}
+
+EventQueue::Node* EventQueue::allocate()
+{
+    return new Node();
+}
+
+void EventQueue::push(const Event& ev)
+{
+    Node* node = allocate();
+
+    try
+    {
+        node->set(ev);
+        MutexLock lock(_mutex);
+        _queue.push_back(node);
+    }
+    catch (...)
+    {
+        release(node);
+        throw;
+    }
+}
+
+EventQueue::Node* EventQueue::pop()
+{
+    MutexLock lock(_mutex);
+    if (_queue.empty())
+        return 0;
+
+    Node* node = _queue.front();
+    _queue.pop_front();
+    return node;
+}
+
+bool EventQueue::empty() const
+{
+    MutexLock lock(_mutex);
+    return _queue.empty();
+}
+
+void EventQueue::release(Node* node)
+{
+    node->clear();
+    delete node;
+}
+
+#endif
+
+}
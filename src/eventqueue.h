@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_EVENTQUEUE_H
+#define CXXTOOLS_EVENTQUEUE_H
+
+#include <cxxtools/event.h>
+#include <cxxtools/mutex.h>
+#include <cxxtools/noncopyable.h>
+
+#if __cplusplus >= 201103L
+#include <atomic>
+#else
+#include <deque>
+#endif
+
+namespace cxxtools
+{
+
+/** Queue of events with many producers and one consumer.
+
+    Events are copied into the nodes of the queue using Event::cloneTo, so
+    that posting a small event does not allocate memory. Larger events are
+    cloned. Nodes are recycled.
+
+    With C++11 events are appended without locking. The consumer removes
+    them without locking. Only the list of unused nodes is guarded by a
+    spin lock.
+ */
+class EventQueue : private NonCopyable
+{
+    public:
+        class Node;
+
+        EventQueue();
+        ~EventQueue();
+
+        /// Appends a copy of the event. May be called by any thread.
+        void push(const Event& ev);
+
+        /// Removes the oldest event. Returns 0 if the queue is empty.
+        /// Must be called by the consumer thread only.
+        Node* pop();
+
+        /// Returns true, if there are no events in the queue.
+        bool empty() const;
+
+        /// Returns the event of a node returned by pop.
+        static Event& event(Node* node);
+
+        /// Destroys the event and recycles the node.
+        void release(Node* node);
+
+    private:
+        Node* allocate();
+
+#if __cplusplus >= 201103L
+        void append(Node* node);
+
+        std::atomic<Node*> _head;  // last appended node
+        Node* _tail;               // next node to be removed
+        Node* _stub;
+
+        SpinMutex _freeMutex;
+        Node* _free;
+        unsigned _freeCount;
+#else
+        std::deque<Node*> _queue;
+        mutable Mutex _mutex;
+#endif
+};
+
+}
+
+#endif // CXXTOOLS_EVENTQUEUE_H
@@ -28,6 +28,7 @@
  */
 #include <cxxtools/filedevice.h>
 #include "filedeviceimpl.h"
+#include "iouring.h"
 
 namespace cxxtools
 {
@@ -64,6 +65,9 @@ void FileDevice::open( const std::string& path, IODevice::OpenMode mode, bool in
     close();
     _impl->open(path, mode, inherit);
     _path = path;
+    this->setEnabled(true);
+    this->setAsync((mode & IODevice::Async) != 0);
+    this->setEof(false);
 }
 
 
@@ -109,6 +113,18 @@ size_t FileDevice::size() const
 }
 
 
+void FileDevice::ioUring(bool sw)
+{
+    IoUring::enable(sw);
+}
+
+
+bool FileDevice::ioUring()
+{
+    return IoUring::current() != 0;
+}
+
+
 FileDevice::pos_type FileDevice::onSeek(off_type offset, std::ios::seekdir sd)
 {
     return _impl->seek(offset, sd);
@@ -131,6 +147,24 @@ size_t FileDevice::onWrite(const char* buffer, size_t count)
 }
 
 
+size_t FileDevice::onReadv(const struct iovec* iov, size_t iovcnt, bool& eof)
+{
+    return _impl->readv(iov, iovcnt, eof);
+}
+
+
+size_t FileDevice::onBeginWritev(const struct iovec* iov, size_t iovcnt)
+{
+    return _impl->beginWritev(iov, iovcnt);
+}
+
+
+size_t FileDevice::onWritev(const struct iovec* iov, size_t iovcnt)
+{
+    return _impl->writev(iov, iovcnt);
+}
+
+
 void FileDevice::onCancel()
 {
     _impl->cancel();
@@ -149,4 +183,34 @@ void FileDevice::onSync() const
 }
 
 
+bool FileDevice::onWait(Timespan timeout)
+{
+    return _impl->wait(timeout);
+}
+
+
+void FileDevice::onAttach(SelectorBase& sb)
+{
+    _impl->attach(sb);
+}
+
+
+void FileDevice::onDetach(SelectorBase& sb)
+{
+    _impl->detach(sb);
+}
+
+
+SelectableImpl& FileDevice::simpl()
+{
+    return *_impl;
+}
+
+
+IODeviceImpl& FileDevice::ioimpl()
+{
+    return *_impl;
+}
+
+
 } // namespace cxxtools
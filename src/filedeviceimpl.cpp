@@ -28,23 +28,41 @@
 #include "filedeviceimpl.h"
 #include "cxxtools/iodevice.h"
 #include "error.h"
+#include <cxxtools/log.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <limits.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <errno.h>
+#include <sys/poll.h>
+#include <stdexcept>
+
+log_define("cxxtools.filedevice.impl")
 
 namespace cxxtools
 {
 
 FileDeviceImpl::FileDeviceImpl(FileDevice& device)
 : IODeviceImpl(device)
+, _regular(false)
+, _ring(0)
+, _readOp(this)
+, _writeOp(this)
 { }
 
 
 FileDeviceImpl::~FileDeviceImpl()
-{ }
+{
+    try
+    {
+        cancelRing();
+    }
+    catch (const std::exception& e)
+    {
+        log_error("failed to cancel io_uring request: " << e.what());
+    }
+}
 
 
 bool FileDeviceImpl::seekable() const
@@ -123,4 +141,267 @@ size_t FileDeviceImpl::peek(char* buffer, size_t count)
     return ret;
 }
 
+
+void FileDeviceImpl::open(const std::string& path, IODevice::OpenMode mode, bool inherit)
+{
+    IODeviceImpl::open(path, mode, inherit);
+    _regular = seekable();
+}
+
+
+void FileDeviceImpl::close()
+{
+    cancelRing();
+    _regular = false;
+    IODeviceImpl::close();
+}
+
+
+IoUring* FileDeviceImpl::ring()
+{
+    if (_ring)
+    {
+        checkThread();
+        return _ring;
+    }
+
+    // pipes and terminals are ready for poll, when data is available, so
+    // only regular files benefit from io_uring; do not mix with requests
+    // pending in the poll based path
+    if (!_regular || _device.reading() || _device.writing())
+        return 0;
+
+    return IoUring::current();
+}
+
+
+void FileDeviceImpl::startRing(IoUring* ring)
+{
+    if (_ring == 0)
+    {
+        ring->addRef();
+        _ring = ring;
+    }
+
+    updatePoll();
+}
+
+
+void FileDeviceImpl::updatePoll()
+{
+    bool pending = _readOp.pending || _writeOp.pending;
+
+    if (_pfd)
+    {
+        if (_readOp.done || _writeOp.done)
+        {
+            // the completion may be reaped by another device of this thread;
+            // the file itself is always ready, so poll returns at once
+            _pfd->fd = _fd;
+            _pfd->events = POLLIN;
+        }
+        else if (pending)
+        {
+            // the file is always ready; wait for the completion instead
+            _pfd->fd = _ring->eventFd();
+            _pfd->events = POLLIN;
+        }
+        else
+        {
+            _pfd->fd = _fd;
+            _pfd->events = 0;
+        }
+    }
+
+    if (!pending && _ring)
+    {
+        if (_ring->release() == 0)
+            delete _ring;
+        _ring = 0;
+    }
+}
+
+
+void FileDeviceImpl::checkThread() const
+{
+    // the ring and the pending requests belong to the thread, which
+    // started them
+    if (!_ring->isCurrent())
+        throw std::logic_error("io_uring request of a file device used in another thread");
+}
+
+
+void FileDeviceImpl::onCompleted(IoUring::Operation& /*op*/)
+{
+    updatePoll();
+}
+
+
+void FileDeviceImpl::cancelRing()
+{
+    if (_ring)
+    {
+        checkThread();
+        _ring->cancel(_readOp);
+        _ring->cancel(_writeOp);
+        updatePoll();
+    }
+}
+
+
+size_t FileDeviceImpl::beginRead(char* buffer, size_t n, bool& eof)
+{
+    IoUring* ring = this->ring();
+    if (ring == 0)
+        return IODeviceImpl::beginRead(buffer, n, eof);
+
+    log_debug("io_uring read(" << _fd << ", " << n << ')');
+    ring->read(_readOp, _fd, buffer, n);
+    startRing(ring);
+
+    return 0;
+}
+
+
+size_t FileDeviceImpl::endRead(bool& eof)
+{
+    if (!_readOp.pending)
+        return IODeviceImpl::endRead(eof);
+
+    checkThread();
+    _ring->wait(_readOp);
+    int ret = _readOp.result;
+    _ring->consume(_readOp);
+    updatePoll();
+
+    log_debug("io_uring read(" << _fd << ") returned " << ret);
+
+    if (ret == -EAGAIN || ret == -EINTR)
+        return IODeviceImpl::read(_device.rbuf(), _device.rbuflen(), eof);
+
+    if (ret < 0)
+        throw IOError(getErrnoString(-ret, "read failed"));
+
+    if (ret == 0)
+        eof = true;
+
+    return static_cast<size_t>(ret);
+}
+
+
+size_t FileDeviceImpl::beginWrite(const char* buffer, size_t n)
+{
+    IoUring* ring = this->ring();
+    if (ring == 0)
+        return IODeviceImpl::beginWrite(buffer, n);
+
+    log_debug("io_uring write(" << _fd << ", " << n << ')');
+    ring->write(_writeOp, _fd, buffer, n);
+    startRing(ring);
+
+    return 0;
+}
+
+
+size_t FileDeviceImpl::beginWritev(const struct iovec* iov, size_t iovcnt)
+{
+    IoUring* ring = this->ring();
+    if (ring == 0)
+        return IODeviceImpl::beginWritev(iov, iovcnt);
+
+    if (iovcnt > IOVCNT_MAX)
+        iovcnt = IOVCNT_MAX;
+
+    log_debug("io_uring writev(" << _fd << ", " << iovcnt << ')');
+    ring->writev(_writeOp, _fd, iov, iovcnt);
+    startRing(ring);
+
+    return 0;
+}
+
+
+size_t FileDeviceImpl::endWrite()
+{
+    if (!_writeOp.pending)
+        return IODeviceImpl::endWrite();
+
+    checkThread();
+    _ring->wait(_writeOp);
+    int ret = _writeOp.result;
+    _ring->consume(_writeOp);
+    updatePoll();
+
+    log_debug("io_uring write(" << _fd << ") returned " << ret);
+
+    if (ret == -EAGAIN || ret == -EINTR)
+        return IODeviceImpl::endWrite();
+
+    if (ret < 0)
+        throw IOError(getErrnoString(-ret, "write failed"));
+
+    return static_cast<size_t>(ret);
+}
+
+
+void FileDeviceImpl::cancel()
+{
+    cancelRing();
+    IODeviceImpl::cancel();
+}
+
+
+void FileDeviceImpl::initWait(pollfd& pfd)
+{
+    if (_readOp.done || _writeOp.done)
+    {
+        pfd.fd = _fd;
+        pfd.revents = 0;
+        pfd.events = POLLIN;
+    }
+    else if (_readOp.pending || _writeOp.pending)
+    {
+        _ring->submit();
+
+        pfd.fd = _ring->eventFd();
+        pfd.revents = 0;
+        pfd.events = POLLIN;
+    }
+    else
+        IODeviceImpl::initWait(pfd);
+}
+
+
+bool FileDeviceImpl::checkPollEvent(pollfd& pfd)
+{
+    if (!_readOp.pending && !_writeOp.pending)
+        return IODeviceImpl::checkPollEvent(pfd);
+
+    // completions may already be reaped by another device of this thread
+    if (pfd.fd == _ring->eventFd() && (pfd.revents & POLLIN_MASK))
+        _ring->reap();
+
+    bool avail = false;
+
+    DestructionSentry sentry(_sentry);
+
+    if (_writeOp.done)
+    {
+        log_debug("send signal outputReady");
+        _device.outputReady(_device);
+        avail = true;
+    }
+
+    if( ! _sentry )
+        return avail;
+
+    if (_readOp.done)
+    {
+        log_debug("send signal inputReady");
+        _device.inputReady(_device);
+        avail = true;
+    }
+
+    return avail;
+}
+
 } //namespace cxxtools
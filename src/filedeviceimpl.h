@@ -31,11 +31,12 @@
 #include "cxxtools/filedevice.h"
 #include "cxxtools/iodevice.h"
 #include "iodeviceimpl.h"
+#include "iouring.h"
 
 namespace cxxtools
 {
 
-class FileDeviceImpl : public IODeviceImpl
+class FileDeviceImpl : public IODeviceImpl, private IoUring::Listener
 {
     public:
         typedef FileDevice::pos_type pos_type;
@@ -55,6 +56,43 @@ class FileDeviceImpl : public IODeviceImpl
         size_t size() const;
 
         size_t peek(char* buffer, size_t count);
+
+        void open(const std::string& path, IODevice::OpenMode mode, bool inherit);
+
+        void close();
+
+        size_t beginRead(char* buffer, size_t n, bool& eof);
+
+        size_t endRead(bool& eof);
+
+        size_t beginWrite(const char* buffer, size_t n);
+
+        size_t beginWritev(const struct iovec* iov, size_t iovcnt);
+
+        size_t endWrite();
+
+        void cancel();
+
+        void initWait(pollfd& pfd);
+
+        bool checkPollEvent(pollfd& pfd);
+
+    private:
+        IoUring* ring();
+        void startRing(IoUring* ring);
+        void updatePoll();
+        void cancelRing();
+        void checkThread() const;
+
+        void onCompleted(IoUring::Operation& op);
+
+        // regular files and block devices are read and written through io_uring
+        bool _regular;
+
+        // ring of the pending requests
+        IoUring* _ring;
+        IoUring::Operation _readOp;
+        IoUring::Operation _writeOp;
 };
 
 } //namespace cxxtools
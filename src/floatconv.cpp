@@ -0,0 +1,717 @@
+/*
+ * Copyright (C) 2016 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+   The shortest representation of doubles and floats is calculated using the
+   Ryu algorithm by Ulf Adams ("Ryu: Fast Float-to-String Conversion", PLDI
+   2018). Decimal numbers are converted to doubles and floats using the
+   algorithm by Daniel Lemire and Michael Eisel ("Number Parsing at a
+   Gigabyte per Second", 2021). The rare cases, which can't be decided with
+   128 bit precision, are passed to strtod.
+
+   The tables in floattables.h are generated by utils/floattables.pl.
+ */
+
+#include <cxxtools/convert.h>
+#include <cfloat>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace cxxtools
+{
+namespace
+{
+#include "floattables.h"
+
+#ifdef __SIZEOF_INT128__
+    __extension__ typedef unsigned __int128 uint128_t;
+
+    // returns the low 64 bits of the product and passes the high bits in high
+    inline uint64_t umul128(uint64_t a, uint64_t b, uint64_t& high)
+    {
+        const uint128_t p = static_cast<uint128_t>(a) * b;
+        high = static_cast<uint64_t>(p >> 64);
+        return static_cast<uint64_t>(p);
+    }
+#else
+    inline uint64_t umul128(uint64_t a, uint64_t b, uint64_t& high)
+    {
+        const uint64_t aLo = a & 0xffffffff;
+        const uint64_t aHi = a >> 32;
+        const uint64_t bLo = b & 0xffffffff;
+        const uint64_t bHi = b >> 32;
+
+        const uint64_t b00 = aLo * bLo;
+        const uint64_t b01 = aLo * bHi;
+        const uint64_t b10 = aHi * bLo;
+        const uint64_t b11 = aHi * bHi;
+
+        const uint64_t mid1 = b10 + (b00 >> 32);
+        const uint64_t mid2 = b01 + (mid1 & 0xffffffff);
+
+        high = b11 + (mid1 >> 32) + (mid2 >> 32);
+        return (mid2 << 32) | (b00 & 0xffffffff);
+    }
+#endif
+
+    inline int leadingZeros(uint64_t v)
+    {
+#ifdef __GNUC__
+        return __builtin_clzll(v);
+#else
+        int n = 0;
+        for (uint64_t mask = uint64_t(1) << 63; (v & mask) == 0; mask >>= 1)
+            ++n;
+        return n;
+#endif
+    }
+
+    ////////////////////////////////////////////////////////////////////////
+    // shortest representation (Ryu)
+    //
+
+    const int doubleMantissaBits = 52;
+    const int doubleBias = 1023;
+    const int doublePow5InvBitcount = 125;
+    const int doublePow5Bitcount = 125;
+
+    const int floatMantissaBits = 23;
+    const int floatBias = 127;
+    const int floatPow5InvBitcount = 59;
+    const int floatPow5Bitcount = 61;
+
+    // ceil(log2(5^e)) for e > 0
+    inline int32_t pow5bits(int32_t e)
+    { return ((e * 1217359) >> 19) + 1; }
+
+    // floor(log10(2^e))
+    inline uint32_t log10Pow2(int32_t e)
+    { return static_cast<uint32_t>((e * 78913) >> 18); }
+
+    // floor(log10(5^e))
+    inline uint32_t log10Pow5(int32_t e)
+    { return static_cast<uint32_t>((e * 732923) >> 20); }
+
+    inline uint32_t pow5Factor(uint64_t value)
+    {
+        uint32_t count = 0;
+        while (value % 5 == 0)
+        {
+            value /= 5;
+            ++count;
+        }
+        return count;
+    }
+
+    inline bool multipleOfPowerOf5(uint64_t value, uint32_t p)
+    { return pow5Factor(value) >= p; }
+
+    inline bool multipleOfPowerOf2(uint64_t value, uint32_t p)
+    { return (value & ((uint64_t(1) << p) - 1)) == 0; }
+
+    inline uint64_t mulShift64(uint64_t m, const uint64_t* mul, int32_t j)
+    {
+        uint64_t high1;
+        const uint64_t low1 = umul128(m, mul[1], high1);
+        uint64_t high0;
+        umul128(m, mul[0], high0);
+        const uint64_t sum = high0 + low1;
+        if (sum < high0)
+            ++high1;
+
+        // 64 < j < 128
+        const int32_t dist = j - 64;
+        return (high1 << (64 - dist)) | (sum >> dist);
+    }
+
+    inline uint32_t mulShift32(uint32_t m, uint64_t factor, int32_t shift)
+    {
+        const uint64_t bits0 = static_cast<uint64_t>(m) * static_cast<uint32_t>(factor);
+        const uint64_t bits1 = static_cast<uint64_t>(m) * static_cast<uint32_t>(factor >> 32);
+        const uint64_t sum = (bits0 >> 32) + bits1;
+        return static_cast<uint32_t>(sum >> (shift - 32));
+    }
+
+    // Calculates the shortest decimal output * 10^e10 within the rounding
+    // interval of the double given by its ieee mantissa and exponent.
+    void d2d(uint64_t ieeeMantissa, uint32_t ieeeExponent, uint64_t& output, int32_t& e10)
+    {
+        int32_t e2;
+        uint64_t m2;
+        if (ieeeExponent == 0)
+        {
+            e2 = 1 - doubleBias - doubleMantissaBits - 2;
+            m2 = ieeeMantissa;
+        }
+        else
+        {
+            e2 = static_cast<int32_t>(ieeeExponent) - doubleBias - doubleMantissaBits - 2;
+            m2 = (uint64_t(1) << doubleMantissaBits) | ieeeMantissa;
+        }
+
+        const bool acceptBounds = (m2 & 1) == 0;
+
+        // the interval of valid representations is [mm, mp] scaled by 4
+        const uint64_t mv = 4 * m2;
+        const uint32_t mmShift = ieeeMantissa != 0 || ieeeExponent <= 1;
+
+        uint64_t vr, vp, vm;
+        bool vmIsTrailingZeros = false;
+        bool vrIsTrailingZeros = false;
+
+        if (e2 >= 0)
+        {
+            const uint32_t q = log10Pow2(e2) - (e2 > 3);
+            e10 = static_cast<int32_t>(q);
+            const int32_t k = doublePow5InvBitcount + pow5bits(static_cast<int32_t>(q)) - 1;
+            const int32_t i = -e2 + static_cast<int32_t>(q) + k;
+            const uint64_t* mul = doublePow5InvSplit[q];
+            vr = mulShift64(4 * m2, mul, i);
+            vp = mulShift64(4 * m2 + 2, mul, i);
+            vm = mulShift64(4 * m2 - 1 - mmShift, mul, i);
+            if (q <= 21)
+            {
+                // only one of mp, mv and mm can be a multiple of 5
+                if (mv % 5 == 0)
+                    vrIsTrailingZeros = multipleOfPowerOf5(mv, q);
+                else if (acceptBounds)
+                    vmIsTrailingZeros = multipleOfPowerOf5(mv - 1 - mmShift, q);
+                else
+                    vp -= multipleOfPowerOf5(mv + 2, q);
+            }
+        }
+        else
+        {
+            const uint32_t q = log10Pow5(-e2) - (-e2 > 1);
+            e10 = static_cast<int32_t>(q) + e2;
+            const int32_t i = -e2 - static_cast<int32_t>(q);
+            const int32_t k = pow5bits(i) - doublePow5Bitcount;
+            const int32_t j = static_cast<int32_t>(q) - k;
+            const uint64_t* mul = doublePow5Split[i];
+            vr = mulShift64(4 * m2, mul, j);
+            vp = mulShift64(4 * m2 + 2, mul, j);
+            vm = mulShift64(4 * m2 - 1 - mmShift, mul, j);
+            if (q <= 1)
+            {
+                // mv = 4 * m2 has at least 2 trailing 0 bits
+                vrIsTrailingZeros = true;
+                if (acceptBounds)
+                    vmIsTrailingZeros = mmShift == 1;
+                else
+                    --vp;
+            }
+            else if (q < 63)
+            {
+                vrIsTrailingZeros = multipleOfPowerOf2(mv, q);
+            }
+        }
+
+        // remove digits as long as the interval allows
+        int32_t removed = 0;
+        uint8_t lastRemovedDigit = 0;
+        if (vmIsTrailingZeros || vrIsTrailingZeros)
+        {
+            // general case, which happens rarely
+            while (vp / 10 > vm / 10)
+            {
+                vmIsTrailingZeros &= vm % 10 == 0;
+                vrIsTrailingZeros &= lastRemovedDigit == 0;
+                lastRemovedDigit = static_cast<uint8_t>(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                ++removed;
+            }
+
+            if (vmIsTrailingZeros)
+            {
+                while (vm % 10 == 0)
+                {
+                    vrIsTrailingZeros &= lastRemovedDigit == 0;
+                    lastRemovedDigit = static_cast<uint8_t>(vr % 10);
+                    vr /= 10;
+                    vp /= 10;
+                    vm /= 10;
+                    ++removed;
+                }
+            }
+
+            // round even if the exact number is .....50..0
+            if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0)
+                lastRemovedDigit = 4;
+
+            output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) || lastRemovedDigit >= 5);
+        }
+        else
+        {
+            bool roundUp = false;
+            if (vp / 100 > vm / 100)
+            {
+                // remove two digits at a time
+                roundUp = vr % 100 >= 50;
+                vr /= 100;
+                vp /= 100;
+                vm /= 100;
+                removed += 2;
+            }
+
+            while (vp / 10 > vm / 10)
+            {
+                roundUp = vr % 10 >= 5;
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                ++removed;
+            }
+
+            output = vr + (vr == vm || roundUp);
+        }
+
+        e10 += removed;
+    }
+
+    // Float variant of d2d.
+    void f2d(uint32_t ieeeMantissa, uint32_t ieeeExponent, uint32_t& output, int32_t& e10)
+    {
+        int32_t e2;
+        uint32_t m2;
+        if (ieeeExponent == 0)
+        {
+            e2 = 1 - floatBias - floatMantissaBits - 2;
+            m2 = ieeeMantissa;
+        }
+        else
+        {
+            e2 = static_cast<int32_t>(ieeeExponent) - floatBias - floatMantissaBits - 2;
+            m2 = (uint32_t(1) << floatMantissaBits) | ieeeMantissa;
+        }
+
+        const bool acceptBounds = (m2 & 1) == 0;
+
+        const uint32_t mv = 4 * m2;
+        const uint32_t mp = 4 * m2 + 2;
+        const uint32_t mmShift = ieeeMantissa != 0 || ieeeExponent <= 1;
+        const uint32_t mm = 4 * m2 - 1 - mmShift;
+
+        uint32_t vr, vp, vm;
+        bool vmIsTrailingZeros = false;
+        bool vrIsTrailingZeros = false;
+        uint8_t lastRemovedDigit = 0;
+
+        if (e2 >= 0)
+        {
+            const uint32_t q = log10Pow2(e2);
+            e10 = static_cast<int32_t>(q);
+            const int32_t k = floatPow5InvBitcount + pow5bits(static_cast<int32_t>(q)) - 1;
+            const int32_t i = -e2 + static_cast<int32_t>(q) + k;
+            vr = mulShift32(mv, floatPow5InvSplit[q], i);
+            vp = mulShift32(mp, floatPow5InvSplit[q], i);
+            vm = mulShift32(mm, floatPow5InvSplit[q], i);
+            if (q != 0 && (vp - 1) / 10 <= vm / 10)
+            {
+                // we need to know one removed digit even if we don't loop below
+                const int32_t l = floatPow5InvBitcount + pow5bits(static_cast<int32_t>(q - 1)) - 1;
+                lastRemovedDigit = static_cast<uint8_t>(mulShift32(mv, floatPow5InvSplit[q - 1],
+                    -e2 + static_cast<int32_t>(q) - 1 + l) % 10);
+            }
+
+            if (q <= 9)
+            {
+                // only one of mp, mv and mm can be a multiple of 5
+                if (mv % 5 == 0)
+                    vrIsTrailingZeros = multipleOfPowerOf5(mv, q);
+                else if (acceptBounds)
+                    vmIsTrailingZeros = multipleOfPowerOf5(mm, q);
+                else
+                    vp -= multipleOfPowerOf5(mp, q);
+            }
+        }
+        else
+        {
+            const uint32_t q = log10Pow5(-e2);
+            e10 = static_cast<int32_t>(q) + e2;
+            const int32_t i = -e2 - static_cast<int32_t>(q);
+            const int32_t k = pow5bits(i) - floatPow5Bitcount;
+            int32_t j = static_cast<int32_t>(q) - k;
+            vr = mulShift32(mv, floatPow5Split[i], j);
+            vp = mulShift32(mp, floatPow5Split[i], j);
+            vm = mulShift32(mm, floatPow5Split[i], j);
+            if (q != 0 && (vp - 1) / 10 <= vm / 10)
+            {
+                j = static_cast<int32_t>(q) - 1 - (pow5bits(i + 1) - floatPow5Bitcount);
+                lastRemovedDigit = static_cast<uint8_t>(mulShift32(mv, floatPow5Split[i + 1], j) % 10);
+            }
+
+            if (q <= 1)
+            {
+                vrIsTrailingZeros = true;
+                if (acceptBounds)
+                    vmIsTrailingZeros = mmShift == 1;
+                else
+                    --vp;
+            }
+            else if (q < 31)
+            {
+                vrIsTrailingZeros = multipleOfPowerOf2(mv, q - 1);
+            }
+        }
+
+        int32_t removed = 0;
+        if (vmIsTrailingZeros || vrIsTrailingZeros)
+        {
+            while (vp / 10 > vm / 10)
+            {
+                vmIsTrailingZeros &= vm % 10 == 0;
+                vrIsTrailingZeros &= lastRemovedDigit == 0;
+                lastRemovedDigit = static_cast<uint8_t>(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                ++removed;
+            }
+
+            if (vmIsTrailingZeros)
+            {
+                while (vm % 10 == 0)
+                {
+                    vrIsTrailingZeros &= lastRemovedDigit == 0;
+                    lastRemovedDigit = static_cast<uint8_t>(vr % 10);
+                    vr /= 10;
+                    vp /= 10;
+                    vm /= 10;
+                    ++removed;
+                }
+            }
+
+            if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0)
+                lastRemovedDigit = 4;
+
+            output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) || lastRemovedDigit >= 5);
+        }
+        else
+        {
+            while (vp / 10 > vm / 10)
+            {
+                lastRemovedDigit = static_cast<uint8_t>(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                ++removed;
+            }
+
+            output = vr + (vr == vm || lastRemovedDigit >= 5);
+        }
+
+        e10 += removed;
+    }
+
+    unsigned putDigits(uint64_t output, int32_t e10, char* digits, int& exp)
+    {
+        while (output % 10 == 0)
+        {
+            output /= 10;
+            ++e10;
+        }
+
+        unsigned count = 1;
+        for (uint64_t v = output; v >= 10; v /= 10)
+            ++count;
+
+        for (unsigned n = count; n > 0; --n)
+        {
+            digits[n - 1] = static_cast<char>('0' + output % 10);
+            output /= 10;
+        }
+
+        exp = e10 + static_cast<int>(count);
+        return count;
+    }
+
+    ////////////////////////////////////////////////////////////////////////
+    // decimal to binary (Eisel-Lemire)
+    //
+
+    struct BinaryFormat
+    {
+        int mantissaBits;
+        int minimumExponent;
+        int infinitePower;
+        int smallestPowerOfTen;
+        int largestPowerOfTen;
+        int minExponentRoundToEven;
+        int maxExponentRoundToEven;
+    };
+
+    const BinaryFormat binary64 = { 52, -1023, 0x7ff, -342, 308, -4, 23 };
+    const BinaryFormat binary32 = { 23, -127, 0xff, -65, 38, -17, 10 };
+
+    // Calculates the ieee mantissa and biased exponent of w * 10^q. Returns
+    // false, if the result can't be decided using 128 bit precision.
+    bool computeFloat(const BinaryFormat& b, long q, uint64_t w, uint64_t& mantissa, int& power2)
+    {
+        if (w == 0 || q < b.smallestPowerOfTen)
+        {
+            mantissa = 0;
+            power2 = 0;
+            return true;
+        }
+
+        if (q > b.largestPowerOfTen)
+        {
+            mantissa = 0;
+            power2 = b.infinitePower;
+            return true;
+        }
+
+        const int lz = leadingZeros(w);
+        w <<= lz;
+
+        // we need the mantissa bits plus the implicit bit, a rounding bit
+        // and one bit, which may get lost when the product is too small
+        const uint64_t* p = pow5_128[q + 342];
+        uint64_t high;
+        uint64_t low = umul128(w, p[1], high);
+        const uint64_t precisionMask = ~uint64_t(0) >> (b.mantissaBits + 3);
+        if ((high & precisionMask) == precisionMask)
+        {
+            uint64_t high2;
+            umul128(w, p[0], high2);
+            low += high2;
+            if (high2 > low)
+                ++high;
+        }
+
+        // 5^q is exact for q in [0, 55] and the reciprocal for q in [-27, 0]
+        if (low == ~uint64_t(0) && (q < -27 || q > 55))
+            return false;
+
+        const int upperbit = static_cast<int>(high >> 63);
+        const int shift = upperbit + 64 - b.mantissaBits - 3;
+
+        mantissa = high >> shift;
+        power2 = ((static_cast<int>(q) * (152170 + 65536)) >> 16) + 63 + upperbit - lz - b.minimumExponent;
+
+        if (power2 <= 0)
+        {
+            // subnormal
+            if (-power2 + 1 >= 64)
+            {
+                mantissa = 0;
+                power2 = 0;
+                return true;
+            }
+
+            mantissa >>= -power2 + 1;
+            mantissa += (mantissa & 1);
+            mantissa >>= 1;
+
+            // rounding may result in the smallest normal number
+            power2 = mantissa < (uint64_t(1) << b.mantissaBits) ? 0 : 1;
+            return true;
+        }
+
+        // round to even, if we are exactly between two values
+        if (low <= 1 && q >= b.minExponentRoundToEven && q <= b.maxExponentRoundToEven
+            && (mantissa & 3) == 1 && (mantissa << shift) == high)
+            mantissa &= ~uint64_t(1);
+
+        mantissa += (mantissa & 1);
+        mantissa >>= 1;
+        if (mantissa >= (uint64_t(2) << b.mantissaBits))
+        {
+            mantissa = uint64_t(1) << b.mantissaBits;
+            ++power2;
+        }
+
+        mantissa &= ~(uint64_t(1) << b.mantissaBits);
+        if (power2 >= b.infinitePower)
+        {
+            power2 = b.infinitePower;
+            mantissa = 0;
+        }
+
+        return true;
+    }
+
+    bool eiselLemire(long q, uint64_t w, double& n)
+    {
+        uint64_t mantissa;
+        int power2;
+        if (!computeFloat(binary64, q, w, mantissa, power2))
+            return false;
+
+        uint64_t bits = mantissa | (static_cast<uint64_t>(power2) << doubleMantissaBits);
+        std::memcpy(&n, &bits, sizeof(n));
+        return true;
+    }
+
+    bool eiselLemire(long q, uint64_t w, float& n)
+    {
+        uint64_t mantissa;
+        int power2;
+        if (!computeFloat(binary32, q, w, mantissa, power2))
+            return false;
+
+        uint32_t bits = static_cast<uint32_t>(mantissa) | (static_cast<uint32_t>(power2) << floatMantissaBits);
+        std::memcpy(&n, &bits, sizeof(n));
+        return true;
+    }
+
+    std::string decimalString(const DecimalFloat& d)
+    {
+        char buffer[24];
+        std::string s(buffer, putInt(buffer, d.mantissa));
+        s += d.more;
+        s += 'e';
+        char* e = putInt(buffer, d.exponent - static_cast<long>(d.more.size()));
+        s.append(buffer, e);
+        return s;
+    }
+
+    inline void parseDecimal(const std::string& s, double& n)
+    { n = std::strtod(s.c_str(), 0); }
+
+    inline void parseDecimal(const std::string& s, float& n)
+    { n = std::strtof(s.c_str(), 0); }
+
+    template <typename T>
+    void decimalToBinary(T& n, const DecimalFloat& d)
+    {
+        if (d.more.empty())
+        {
+            if (eiselLemire(d.exponent, d.mantissa, n))
+                return;
+        }
+        else
+        {
+            // the value is between mantissa and mantissa + 1
+            T n1;
+            if (eiselLemire(d.exponent, d.mantissa, n)
+                && eiselLemire(d.exponent, d.mantissa + 1, n1)
+                && n == n1)
+                return;
+        }
+
+        parseDecimal(decimalString(d), n);
+    }
+}
+
+unsigned shortestDigits(double d, char* digits, int& exp)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &d, sizeof(bits));
+
+    uint64_t output;
+    int32_t e10;
+    d2d(bits & ((uint64_t(1) << doubleMantissaBits) - 1),
+        static_cast<uint32_t>((bits >> doubleMantissaBits) & 0x7ff),
+        output, e10);
+
+    return putDigits(output, e10, digits, exp);
+}
+
+unsigned shortestDigits(float d, char* digits, int& exp)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &d, sizeof(bits));
+
+    uint32_t output;
+    int32_t e10;
+    f2d(bits & ((uint32_t(1) << floatMantissaBits) - 1),
+        (bits >> floatMantissaBits) & 0xff,
+        output, e10);
+
+    return putDigits(output, e10, digits, exp);
+}
+
+void decimalToFloat(float& n, const DecimalFloat& d)
+{
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    // mantissa and power of 10 are exact, so we need just one rounding
+    static const float powersOfTen[] = {
+        1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+
+    if (d.more.empty() && d.exponent >= -10 && d.exponent <= 10
+        && d.mantissa <= (uint64_t(1) << 24))
+    {
+        float v = static_cast<float>(d.mantissa);
+        n = d.exponent < 0 ? v / powersOfTen[-d.exponent] : v * powersOfTen[d.exponent];
+        return;
+    }
+#endif
+
+    decimalToBinary(n, d);
+}
+
+void decimalToFloat(double& n, const DecimalFloat& d)
+{
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    static const double powersOfTen[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+    if (d.more.empty() && d.exponent >= -22 && d.exponent <= 22
+        && d.mantissa <= (uint64_t(1) << 53))
+    {
+        double v = static_cast<double>(d.mantissa);
+        n = d.exponent < 0 ? v / powersOfTen[-d.exponent] : v * powersOfTen[d.exponent];
+        return;
+    }
+#endif
+
+    decimalToBinary(n, d);
+}
+
+void decimalToFloat(long double& n, const DecimalFloat& d)
+{
+    if (std::numeric_limits<long double>::digits <= std::numeric_limits<double>::digits)
+    {
+        double v;
+        decimalToFloat(v, d);
+        n = v;
+        return;
+    }
+
+    // with at least 64 bits mantissa, 10^27 and the 19 digit mantissa are exact
+    static const long double powersOfTen[] = {
+        1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L, 1e10L, 1e11L,
+        1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L, 1e20L, 1e21L,
+        1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L };
+
+    if (d.more.empty() && d.exponent >= -27 && d.exponent <= 27)
+    {
+        long double v = static_cast<long double>(d.mantissa);
+        n = d.exponent < 0 ? v / powersOfTen[-d.exponent] : v * powersOfTen[d.exponent];
+        return;
+    }
+
+    n = std::strtold(decimalString(d).c_str(), 0);
+}
+
+}
@@ -120,14 +120,14 @@ void Client::prepareConnect(const net::AddrInfo& addrinfo)
 
 void Client::prepareConnect(const std::string& host, unsigned short int port)
 {
-    prepareConnect(net::AddrInfo(host, port));
+    prepareConnect(net::AddrInfo::beginResolve(host, port));
 }
 
 void Client::prepareConnect(const net::Uri& uri)
 {
     if (uri.protocol() != "http")
         throw std::runtime_error("only http is supported by http client");
-    prepareConnect(net::AddrInfo(uri.host(), uri.port()));
+    prepareConnect(net::AddrInfo::beginResolve(uri.host(), uri.port()));
     auth(uri.user(), uri.password());
 }
 
@@ -400,7 +400,7 @@ void ClientImpl::onConnect(net::TcpSocket& socket)
 
 void ClientImpl::onOutput(StreamBuffer& sb)
 {
-    log_trace("ClientImpl::onOutput; out_avail=" << sb.out_avail());
+    log_trace("ClientImpl::onOutput; pendingOutput=" << sb.pendingOutput());
 
     try
     {
@@ -410,7 +410,7 @@ void ClientImpl::onOutput(StreamBuffer& sb)
 
             sb.endWrite();
 
-            if( sb.out_avail() > 0 )
+            if( sb.pendingOutput() > 0 )
             {
                 sb.beginWrite();
             }
@@ -42,59 +42,104 @@ void Mapper::addService(const std::string& url, Service& service)
 {
     log_debug("add service for url <" << url << '>');
 
-    WriteLock serviceLock(_serviceMutex);
-    _services.push_back(ServicesType::value_type(url, &service));
+    MutexLock serviceLock(_serviceMutex);
+    ServicesType* services = new ServicesType(*_services);
+    services->push_back(ServicesType::value_type(url, &service));
+    _services.update(services);
 }
 
 void Mapper::addService(const Regex& url, Service& service)
 {
     log_debug("add service for regex");
 
-    WriteLock serviceLock(_serviceMutex);
-    _services.push_back(ServicesType::value_type(url, &service));
+    MutexLock serviceLock(_serviceMutex);
+    ServicesType* services = new ServicesType(*_services);
+    services->push_back(ServicesType::value_type(url, &service));
+    _services.update(services);
 }
 
 void Mapper::removeService(Service& service)
 {
-    WriteLock serviceLock(_serviceMutex);
-    service.waitIdle();
+    MutexLock serviceLock(_serviceMutex);
 
-    ServicesType::size_type n = 0;
-    while (n < _services.size())
+    ServicesType* services = new ServicesType();
+    for (ServicesType::const_iterator it = _services->begin(); it != _services->end(); ++it)
     {
-        if (_services[n].second == &service)
-        {
-            _services.erase(_services.begin() + n);
-        }
-        else
-        {
-            ++n;
-        }
+        if (it->second != &service)
+            services->push_back(*it);
     }
+
+    // wait until no request uses the old list any more, so that no new
+    // responders are created by the service
+    ServicesType* old = _services.exchange(services);
+    Epoch::synchronize();
+    delete old;
+
+    service.waitIdle();
+}
+
+namespace
+{
+    // Releases the services acquired by getResponder.
+    class AcquiredServices
+    {
+            std::vector<Service*> _services;
+
+        public:
+            ~AcquiredServices()
+            {
+                for (std::vector<Service*>::size_type n = 0; n < _services.size(); ++n)
+                    _services[n]->release();
+            }
+
+            void add(Service* service)
+            {
+                service->acquire();
+                _services.push_back(service);
+            }
+
+            std::vector<Service*>::size_type size() const
+            { return _services.size(); }
+
+            Service* operator[](std::vector<Service*>::size_type n) const
+            { return _services[n]; }
+    };
 }
 
 Responder* Mapper::getResponder(const Request& request)
 {
     log_debug("get responder for url <" << request.url() << '>');
 
-    ReadLock serviceLock(_serviceMutex);
+    // The services run user code, which may take locks held by a writer
+    // waiting for readers, so they are called outside of the read section.
+    // Acquiring them keeps removeService from returning in the meantime.
+    AcquiredServices services;
 
-    for (ServicesType::const_iterator it = _services.begin();
-         it != _services.end(); ++it)
     {
-        if (it->first.match(request.url()))
+        EpochReadLock serviceLock;
+        const ServicesType* s = _services.get();
+
+        for (ServicesType::const_iterator it = s->begin(); it != s->end(); ++it)
         {
-            if (!it->second->checkAuth(request))
-            {
-                return _noAuthService.createResponder(request, it->second->realm(), it->second->authContent());
-            }
+            if (it->first.match(request.url()))
+                services.add(it->second);
+        }
+    }
 
-            Responder* resp = it->second->doCreateResponder(request);
-            if (resp)
-            {
-                log_debug("got responder");
-                return resp;
-            }
+    for (std::vector<Service*>::size_type n = 0; n < services.size(); ++n)
+    {
+        Service* service = services[n];
+
+        if (!service->checkAuth(request))
+        {
+            return _noAuthService.createResponder(request, service->realm(), service->authContent());
+        }
+
+        Responder* resp = service->doCreateResponder(request);
+        if (resp)
+        {
+            log_debug("got responder");
+            return resp;
         }
     }
 
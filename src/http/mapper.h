@@ -31,8 +31,10 @@
 
 #include "notfoundservice.h"
 #include "notauthenticatedservice.h"
-#include <map>
+#include <vector>
 #include <cxxtools/regex.h>
+#include <cxxtools/epoch.h>
+#include <cxxtools/mutex.h>
 
 namespace cxxtools
 {
@@ -42,6 +44,11 @@ namespace http
 class Mapper
 {
     public:
+        Mapper()
+            : _services(new ServicesType())
+            { }
+
+
         void addService(const std::string& url, Service& service);
         void addService(const Regex& url, Service& service);
         void removeService(Service& service);
@@ -67,8 +74,9 @@ class Mapper
                                  : regex.match(u); }
         };
         typedef std::vector<std::pair<Key, Service*> > ServicesType;
-        ReadWriteMutex _serviceMutex;
-        ServicesType _services;
+        // the services are read without locking; writers are serialized by _serviceMutex
+        Mutex _serviceMutex;
+        SnapshotPtr<ServicesType> _services;
         NotFoundService _defaultService;
         NotAuthenticatedService _noAuthService;
 };
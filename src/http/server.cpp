@@ -142,6 +142,16 @@ void Server::maxThreads(unsigned m)
     _impl->maxThreads(m);
 }
 
+void Server::socketOptions(const net::SocketOptions& options)
+{
+    _impl->socketOptions(options);
+}
+
+const net::SocketOptions& Server::socketOptions() const
+{
+    return _impl->socketOptions();
+}
+
 } // namespace http
 
 } // namespace cxxtools
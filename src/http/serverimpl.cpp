@@ -147,12 +147,14 @@ ServerImpl::~ServerImpl()
 void ServerImpl::listen(const std::string& ip, unsigned short int port, int backlog)
 {
     log_debug("listen on " << ip << " port " << port);
-    net::TcpServer* listener = new net::TcpServer(ip, port, backlog,
-        net::TcpServer::DEFER_ACCEPT|net::TcpServer::REUSEADDR);
+    net::TcpServer* listener = new net::TcpServer();
     Socket* socket = 0;
 
     try
     {
+        listener->socketOptions(socketOptions());
+        listener->listen(ip, port, backlog,
+            net::TcpServer::DEFER_ACCEPT|net::TcpServer::REUSEADDR);
         _listener.push_back(listener);
         socket = new Socket(*this, *listener);
         _queue.put(socket);
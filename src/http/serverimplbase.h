@@ -86,6 +86,9 @@ class ServerImplBase : private NonCopyable
         unsigned maxThreads() const           { return _maxThreads; }
         void maxThreads(unsigned m)           { _maxThreads = m; }
 
+        const net::SocketOptions& socketOptions() const      { return _socketOptions; }
+        void socketOptions(const net::SocketOptions& options) { _socketOptions = options; }
+
         virtual void terminate()              { }
         Server::Runmode runmode() const
         { return _runmode; }
@@ -107,6 +110,8 @@ class ServerImplBase : private NonCopyable
         unsigned _minThreads;
         unsigned _maxThreads;
 
+        net::SocketOptions _socketOptions;
+
         Signal<Server::Runmode>& _runmodeChanged;
         Server::Runmode _runmode;
 
@@ -57,6 +57,19 @@ void Service::waitIdle()
         _isIdle.wait(lock);
 }
 
+void Service::acquire()
+{
+    MutexLock lock(_mutex);
+    ++_responderCount;
+}
+
+void Service::release()
+{
+    MutexLock lock(_mutex);
+    if (--_responderCount <= 0)
+        _isIdle.signal();
+}
+
 bool Service::checkAuth(const Request& request)
 {
     for (std::vector<const Authenticator*>::const_iterator it = _authenticators.begin();
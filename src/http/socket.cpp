@@ -257,7 +257,7 @@ bool Socket::onOutput(StreamBuffer& sb)
     {
         sb.endWrite();
 
-        if ( sb.out_avail() )
+        if ( sb.pendingOutput() )
         {
             sb.beginWrite();
             _timer.start(_server.writeTimeout());
@@ -273,6 +273,7 @@ bool Socket::onOutput(StreamBuffer& sb)
                 _timer.start(_server.keepAliveTimeout());
                 _request.clear();
                 _reply.clear();
+                _replyBody.clear();
                 _parser.reset(false);
                 if (sb.in_avail())
                     onInput(sb);
@@ -352,7 +353,10 @@ void Socket::sendReply()
 
     _stream << "\r\n";
 
-    _reply.sendBody(_stream);
+    // the body is copied once out of the reply and sent together with
+    // the header without passing it through the stream buffer
+    _replyBody = _reply.body();
+    _stream.buffer().borrow(_replyBody.data(), _replyBody.size());
 
 }
 
@@ -105,6 +105,8 @@ class Socket : public net::TcpSocket, public Connectable
         HeaderParser _parser;
         Request _request;
         Reply _reply;
+        // reply body, which is borrowed to the stream buffer until it is sent
+        std::string _replyBody;
 
         Timer _timer;
         int _contentLength;
@@ -41,6 +41,8 @@ IODevice::IODevice()
 , _wbuf(0)
 , _wbuflen(0)
 , _wavail(0)
+, _wiov(0)
+, _wiovcnt(0)
 , _reserved(0)
 { }
 
@@ -93,7 +95,7 @@ size_t IODevice::endRead()
 
     if (_wavail > 0)
         this->setState(Selectable::Avail);
-    else if (_wbuf)
+    else if (writing())
         this->setState(Selectable::Busy);
     else
         this->setState(Selectable::Idle);
@@ -139,7 +141,7 @@ size_t IODevice::beginWrite(const char* buffer, size_t n)
     if (!enabled())
         throw std::logic_error("Device not enabled");
 
-    if (_wbuf)
+    if (writing())
         throw IOPending("write operation pending");
 
     size_t r = this->onBeginWrite(buffer, n);
@@ -159,7 +161,7 @@ size_t IODevice::beginWrite(const char* buffer, size_t n)
 
 size_t IODevice::endWrite()
 {
-    if ( ! _wbuf )
+    if ( ! _wbuf && ! _wiov )
         return 0;
 
     size_t n;
@@ -172,6 +174,8 @@ size_t IODevice::endWrite()
         _wbuf = 0;
         _wbuflen = 0;
         _wavail = 0;
+        _wiov = 0;
+        _wiovcnt = 0;
         throw;
     }
 
@@ -185,6 +189,8 @@ size_t IODevice::endWrite()
     _wbuf = 0;
     _wbuflen = 0;
     _wavail = 0;
+    _wiov = 0;
+    _wiovcnt = 0;
 
     return n;
 }
@@ -194,7 +200,7 @@ size_t IODevice::write(const char* buffer, size_t n)
 {
     if ( async() )
     {
-        if ( _wbuf )
+        if ( writing() )
         {
             throw IOPending("write operation pending");
         }
@@ -217,6 +223,110 @@ size_t IODevice::write(const char* buffer, size_t n)
 }
 
 
+size_t IODevice::readv(const struct iovec* iov, size_t iovcnt)
+{
+    if (async())
+    {
+        for (size_t n = 0; n < iovcnt; ++n)
+            if (iov[n].iov_len > 0)
+                return read(static_cast<char*>(iov[n].iov_base), iov[n].iov_len);
+        return 0;
+    }
+
+    return this->onReadv(iov, iovcnt, _eof);
+}
+
+
+size_t IODevice::beginWritev(const struct iovec* iov, size_t iovcnt)
+{
+    if (!async())
+        throw std::logic_error("Device not in async mode");
+
+    if (!enabled())
+        throw std::logic_error("Device not enabled");
+
+    if (writing())
+        throw IOPending("write operation pending");
+
+    // skip leading empty buffers
+    while (iovcnt > 0 && iov->iov_len == 0)
+    {
+        ++iov;
+        --iovcnt;
+    }
+
+    if (iovcnt == 0)
+        return 0;
+
+    size_t r = this->onBeginWritev(iov, iovcnt);
+
+    if (r > 0 || _ravail)
+        this->setState(Selectable::Avail);
+    else
+        this->setState(Selectable::Busy);
+
+    // devices without vectored I/O use the first buffer only
+    _wbuf = static_cast<const char*>(iov->iov_base);
+    _wbuflen = iov->iov_len;
+    _wavail = r;
+    _wiov = iov;
+    _wiovcnt = iovcnt;
+
+    return r;
+}
+
+
+size_t IODevice::writev(const struct iovec* iov, size_t iovcnt)
+{
+    if ( async() )
+    {
+        if ( writing() )
+        {
+            throw IOPending("write operation pending");
+        }
+
+        try
+        {
+            this->beginWritev(iov, iovcnt);
+            return endWrite();
+        }
+        catch(...)
+        {
+            _wbuf = 0; _wbuflen = 0; _wavail = 0;
+            _wiov = 0; _wiovcnt = 0;
+            throw;
+        }
+    }
+
+    return this->onWritev(iov, iovcnt);
+}
+
+
+size_t IODevice::onReadv(const struct iovec* iov, size_t iovcnt, bool& eof)
+{
+    for (size_t n = 0; n < iovcnt; ++n)
+        if (iov[n].iov_len > 0)
+            return onRead(static_cast<char*>(iov[n].iov_base), iov[n].iov_len, eof);
+    return 0;
+}
+
+
+size_t IODevice::onBeginWritev(const struct iovec* iov, size_t /*iovcnt*/)
+{
+    // beginWritev skips empty buffers, so the first one is not empty
+    return onBeginWrite(static_cast<const char*>(iov->iov_base), iov->iov_len);
+}
+
+
+size_t IODevice::onWritev(const struct iovec* iov, size_t iovcnt)
+{
+    for (size_t n = 0; n < iovcnt; ++n)
+        if (iov[n].iov_len > 0)
+            return onWrite(static_cast<const char*>(iov[n].iov_base), iov[n].iov_len);
+    return 0;
+}
+
+
 void IODevice::cancel()
 {
     onCancel();
@@ -230,6 +340,8 @@ void IODevice::cancel()
     _wbuf = 0;
     _wbuflen = 0;
     _wavail = 0;
+    _wiov = 0;
+    _wiovcnt = 0;
 }
 
 
@@ -35,6 +35,8 @@
 #include <string.h>
 #include <fcntl.h>
 #include <sys/poll.h>
+#include <sys/uio.h>
+#include <limits.h>
 #include <cxxtools/log.h>
 #include <cxxtools/hdstream.h>
 
@@ -46,6 +48,14 @@ const short IODeviceImpl::POLLERR_MASK= POLLERR | POLLHUP | POLLNVAL;
 const short IODeviceImpl::POLLIN_MASK= POLLIN;
 const short IODeviceImpl::POLLOUT_MASK= POLLOUT;
 
+// readv and writev fail with more than IOV_MAX buffers, so we transfer
+// only that many and report a partial read or write
+#ifdef IOV_MAX
+const size_t IODeviceImpl::IOVCNT_MAX = IOV_MAX;
+#else
+const size_t IODeviceImpl::IOVCNT_MAX = 16;
+#endif
+
 IODeviceImpl::IODeviceImpl(IODevice& device)
 : _device(device)
 , _fd(-1)
@@ -268,6 +278,9 @@ size_t IODeviceImpl::endWrite()
         return n;
     }
 
+    if (_device.wiov())
+        return this->writev( _device.wiov(), _device.wiovcnt() );
+
     return this->write( _device.wbuf(), _device.wbuflen() );
 }
 
@@ -309,6 +322,111 @@ size_t IODeviceImpl::write( const char* buffer, size_t count )
 }
 
 
+size_t IODeviceImpl::readv(const struct iovec* iov, size_t iovcnt, bool& eof)
+{
+    if (iovcnt > IOVCNT_MAX)
+        iovcnt = IOVCNT_MAX;
+
+    ssize_t ret = 0;
+
+    while(true)
+    {
+        ret = ::readv(_fd, iov, iovcnt);
+
+        log_debug("::readv(" << _fd << ", " << iovcnt << ") returned " << ret);
+
+        if(ret > 0)
+            break;
+
+        if(ret == 0 || errno == ECONNRESET)
+        {
+            eof = true;
+            return 0;
+        }
+
+        if(errno == EINTR)
+            continue;
+
+        if(errno != EAGAIN)
+            throw IOError(getErrnoString("readv failed"));
+
+        pollfd pfd;
+        pfd.fd = this->fd();
+        pfd.revents = 0;
+        pfd.events = POLLIN;
+
+        if (!this->wait(_timeout, pfd))
+        {
+            log_debug("timeout (" << _timeout << ')');
+            throw IOTimeout();
+        }
+    }
+
+    return ret;
+}
+
+
+size_t IODeviceImpl::beginWritev(const struct iovec* iov, size_t iovcnt)
+{
+    if (iovcnt > IOVCNT_MAX)
+        iovcnt = IOVCNT_MAX;
+
+    ssize_t ret = ::writev(_fd, iov, iovcnt);
+
+    log_debug("::writev(" << _fd << ", " << iovcnt << ") returned " << ret);
+    if (ret > 0)
+        return static_cast<size_t>(ret);
+
+    if (ret == 0 || errno == ECONNRESET || errno == EPIPE)
+        throw IOError("lost connection to peer");
+
+    if(_pfd)
+    {
+        _pfd->events |= POLLOUT;
+    }
+
+    return 0;
+}
+
+
+size_t IODeviceImpl::writev(const struct iovec* iov, size_t iovcnt)
+{
+    if (iovcnt > IOVCNT_MAX)
+        iovcnt = IOVCNT_MAX;
+
+    ssize_t ret = 0;
+
+    while(true)
+    {
+        ret = ::writev(_fd, iov, iovcnt);
+        log_debug("::writev(" << _fd << ", " << iovcnt << ") returned " << ret);
+        if(ret > 0)
+            break;
+
+        if(ret == 0 || errno == ECONNRESET || errno == EPIPE)
+            throw IOError("lost connection to peer");
+
+        if(errno == EINTR)
+            continue;
+
+        if(errno != EAGAIN)
+            throw IOError(getErrnoString("Could not write to file handle"));
+
+        pollfd pfd;
+        pfd.fd = this->fd();
+        pfd.revents = 0;
+        pfd.events = POLLOUT;
+
+        if (!this->wait(_timeout, pfd))
+        {
+            throw IOTimeout();
+        }
+    }
+
+    return static_cast<size_t>(ret);
+}
+
+
 void IODeviceImpl::sigwrite(int sig)
 {
     ::write(_fd, (const void*)&sig, sizeof(sig));
@@ -423,7 +541,12 @@ bool IODeviceImpl::checkPollEvent(pollfd& pfd)
 
     DestructionSentry sentry(_sentry);
 
-    if (pfd.revents & POLLERR_MASK)
+    // A hangup of the peer, e.g. when the writer closes its end of a pipe,
+    // is no error for a pending read. The remaining data and eof are
+    // returned by endRead.
+    bool hangup = (pfd.revents & POLLERR_MASK) == POLLHUP && _device.reading();
+
+    if ((pfd.revents & POLLERR_MASK) && !hangup)
     {
         _errorPending = true;
 
@@ -476,7 +599,7 @@ bool IODeviceImpl::checkPollEvent(pollfd& pfd)
     if( ! _sentry )
         return avail;
 
-    if( pfd.revents & POLLIN_MASK )
+    if( (pfd.revents & POLLIN_MASK) || hangup )
     {
         log_debug("send signal inputReady");
         _device.inputReady(_device);
@@ -73,6 +73,7 @@ namespace cxxtools {
             static const short POLLERR_MASK;
             static const short POLLIN_MASK;
             static const short POLLOUT_MASK;
+            static const size_t IOVCNT_MAX;
 
             IODeviceImpl(IODevice&);
 
@@ -105,6 +106,12 @@ namespace cxxtools {
 
             virtual size_t write( const char* buffer, size_t count );
 
+            virtual size_t readv(const struct iovec* iov, size_t iovcnt, bool& eof);
+
+            virtual size_t beginWritev(const struct iovec* iov, size_t iovcnt);
+
+            virtual size_t writev(const struct iovec* iov, size_t iovcnt);
+
             void sigwrite(int sig);
 
             virtual void cancel();
@@ -0,0 +1,401 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "iouring.h"
+#include "config.h"
+
+#if defined(HAVE_LINUX_IO_URING_H) && __cplusplus >= 201103L
+
+#include <cxxtools/ioerror.h>
+#include <cxxtools/log.h>
+#include "error.h"
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <atomic>
+#include <cstring>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+
+log_define("cxxtools.iouring")
+
+namespace cxxtools
+{
+
+namespace
+{
+    const unsigned ringEntries = 64;
+
+    // the kernel limits the length of a single read or write
+    const std::size_t maxLength = 1 << 30;
+
+    std::atomic<bool> uringEnabled(true);
+
+    struct RingHolder
+    {
+        IoUring* ring;
+        bool failed;
+
+        RingHolder()
+            : ring(0),
+              failed(false)
+            { }
+
+        ~RingHolder()
+        {
+            if (ring && ring->release() == 0)
+                delete ring;
+        }
+    };
+
+    thread_local RingHolder ringHolder;
+
+    template <typename T>
+    T* ringPtr(void* ring, unsigned offset)
+    {
+        return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+    }
+
+    inline unsigned loadAcquire(const unsigned* p)
+    { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+
+    inline void storeRelease(unsigned* p, unsigned v)
+    { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+}
+
+IoUring::IoUring()
+    : _ringFd(-1),
+      _eventFd(-1),
+      _sqRing(MAP_FAILED),
+      _sqRingSize(0),
+      _cqRing(MAP_FAILED),
+      _cqRingSize(0),
+      _sqes(0),
+      _sqesSize(0),
+      _queued(0)
+{
+}
+
+IoUring::~IoUring()
+{
+    if (_sqes)
+        ::munmap(_sqes, _sqesSize);
+    if (_cqRing != MAP_FAILED && _cqRing != _sqRing)
+        ::munmap(_cqRing, _cqRingSize);
+    if (_sqRing != MAP_FAILED)
+        ::munmap(_sqRing, _sqRingSize);
+    if (_eventFd >= 0)
+        ::close(_eventFd);
+    if (_ringFd >= 0)
+        ::close(_ringFd);
+}
+
+bool IoUring::init(unsigned entries)
+{
+#ifdef IORING_FEAT_RW_CUR_POS
+    io_uring_params p;
+    std::memset(&p, 0, sizeof(p));
+
+    _ringFd = ::syscall(__NR_io_uring_setup, entries, &p);
+    if (_ringFd < 0)
+    {
+        log_debug(getErrnoString("io_uring_setup failed"));
+        return false;
+    }
+
+    if (!(p.features & IORING_FEAT_RW_CUR_POS))
+    {
+        log_debug("io_uring does not support the current file position");
+        return false;
+    }
+
+    _sqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    _cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (_cqRingSize > _sqRingSize)
+            _sqRingSize = _cqRingSize;
+        _cqRingSize = _sqRingSize;
+    }
+
+    _sqRing = ::mmap(0, _sqRingSize, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, _ringFd, IORING_OFF_SQ_RING);
+    if (_sqRing == MAP_FAILED)
+        return false;
+
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+        _cqRing = _sqRing;
+    else
+    {
+        _cqRing = ::mmap(0, _cqRingSize, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, _ringFd, IORING_OFF_CQ_RING);
+        if (_cqRing == MAP_FAILED)
+            return false;
+    }
+
+    _sqesSize = p.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(0, _sqesSize, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, _ringFd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+        return false;
+    _sqes = static_cast<io_uring_sqe*>(sqes);
+
+    _sqHead = ringPtr<unsigned>(_sqRing, p.sq_off.head);
+    _sqTail = ringPtr<unsigned>(_sqRing, p.sq_off.tail);
+    _sqMask = ringPtr<unsigned>(_sqRing, p.sq_off.ring_mask);
+    _sqArray = ringPtr<unsigned>(_sqRing, p.sq_off.array);
+    _sqEntries = p.sq_entries;
+
+    _cqHead = ringPtr<unsigned>(_cqRing, p.cq_off.head);
+    _cqTail = ringPtr<unsigned>(_cqRing, p.cq_off.tail);
+    _cqMask = ringPtr<unsigned>(_cqRing, p.cq_off.ring_mask);
+    _cqes = ringPtr<io_uring_cqe>(_cqRing, p.cq_off.cqes);
+
+    _eventFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_eventFd < 0)
+        return false;
+
+    if (::syscall(__NR_io_uring_register, _ringFd, IORING_REGISTER_EVENTFD, &_eventFd, 1) != 0)
+    {
+        log_debug(getErrnoString("io_uring_register failed"));
+        return false;
+    }
+
+    log_debug("io_uring with " << _sqEntries << " entries created");
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+IoUring* IoUring::current()
+{
+    if (!enabled())
+        return 0;
+
+    if (ringHolder.ring)
+        return ringHolder.ring;
+
+    if (ringHolder.failed)
+        return 0;
+
+    IoUring* ring = new IoUring();
+    if (!ring->init(ringEntries))
+    {
+        delete ring;
+        ringHolder.failed = true;
+        return 0;
+    }
+
+    ring->addRef();
+    ringHolder.ring = ring;
+    return ring;
+}
+
+void IoUring::flush()
+{
+    if (ringHolder.ring)
+        ringHolder.ring->submit();
+}
+
+void IoUring::enable(bool sw)
+{
+    uringEnabled = sw;
+}
+
+bool IoUring::enabled()
+{
+    return uringEnabled;
+}
+
+bool IoUring::isCurrent() const
+{
+    return ringHolder.ring == this;
+}
+
+void IoUring::queue(unsigned char opcode, int fd, const void* addr, unsigned len, Operation* op)
+{
+    unsigned tail = *_sqTail;
+    if (tail - loadAcquire(_sqHead) >= _sqEntries)
+    {
+        submit();
+        if (tail - loadAcquire(_sqHead) >= _sqEntries)
+            throw IOError("io_uring submission queue full");
+    }
+
+    unsigned index = tail & *_sqMask;
+    io_uring_sqe* sqe = &_sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uintptr_t>(addr);
+    sqe->len = len;
+    if (opcode != IORING_OP_ASYNC_CANCEL)
+        sqe->off = static_cast<uint64_t>(-1);   // current file position
+    sqe->user_data = reinterpret_cast<uintptr_t>(op);
+
+    _sqArray[index] = index;
+    storeRelease(_sqTail, tail + 1);
+    ++_queued;
+
+    if (op)
+    {
+        op->pending = true;
+        op->done = false;
+        op->result = 0;
+    }
+}
+
+void IoUring::read(Operation& op, int fd, char* buffer, std::size_t n)
+{
+    queue(IORING_OP_READ, fd, buffer, n > maxLength ? maxLength : n, &op);
+}
+
+void IoUring::write(Operation& op, int fd, const char* buffer, std::size_t n)
+{
+    queue(IORING_OP_WRITE, fd, buffer, n > maxLength ? maxLength : n, &op);
+}
+
+void IoUring::writev(Operation& op, int fd, const struct iovec* iov, std::size_t iovcnt)
+{
+    queue(IORING_OP_WRITEV, fd, iov, iovcnt, &op);
+}
+
+void IoUring::enter(unsigned toSubmit, unsigned minComplete)
+{
+    while (true)
+    {
+        int ret = ::syscall(__NR_io_uring_enter, _ringFd, toSubmit, minComplete,
+                            minComplete > 0 ? IORING_ENTER_GETEVENTS : 0, 0, 0);
+        if (ret >= 0)
+        {
+            log_debug("io_uring_enter submitted " << ret << " of " << toSubmit);
+            _queued -= ret < static_cast<int>(_queued) ? ret : _queued;
+            return;
+        }
+
+        if (errno != EINTR)
+            throw IOError(getErrnoString("io_uring_enter failed"));
+    }
+}
+
+void IoUring::submit()
+{
+    if (_queued > 0)
+        enter(_queued, 0);
+}
+
+void IoUring::reap()
+{
+    // reset the eventfd first; completions, which arrive later, signal it
+    // again
+    uint64_t value;
+    ::read(_eventFd, &value, sizeof(value));
+
+    unsigned head = *_cqHead;
+    unsigned tail = loadAcquire(_cqTail);
+
+    for ( ; head != tail; ++head)
+    {
+        const io_uring_cqe& cqe = _cqes[head & *_cqMask];
+        Operation* op = reinterpret_cast<Operation*>(static_cast<uintptr_t>(cqe.user_data));
+        if (op)
+        {
+            op->result = cqe.res;
+            op->done = true;
+            if (op->listener)
+                op->listener->onCompleted(*op);
+        }
+    }
+
+    storeRelease(_cqHead, head);
+}
+
+void IoUring::consume(Operation& op)
+{
+    op.pending = false;
+    op.done = false;
+}
+
+void IoUring::wait(Operation& op)
+{
+    submit();
+    reap();
+
+    while (op.pending && !op.done)
+    {
+        enter(0, 1);
+        reap();
+    }
+}
+
+void IoUring::cancel(Operation& op)
+{
+    if (!op.pending)
+        return;
+
+    if (!op.done)
+    {
+        log_debug("cancel io_uring request");
+        queue(IORING_OP_ASYNC_CANCEL, -1, &op, 0, 0);
+        wait(op);
+    }
+
+    consume(op);
+}
+
+}
+
+#else
+
+namespace cxxtools
+{
+
+IoUring::IoUring()           { }
+IoUring::~IoUring()          { }
+IoUring* IoUring::current()  { return 0; }
+void IoUring::flush()        { }
+void IoUring::enable(bool)   { }
+bool IoUring::enabled()      { return false; }
+bool IoUring::isCurrent() const  { return false; }
+void IoUring::read(Operation&, int, char*, std::size_t)                       { }
+void IoUring::write(Operation&, int, const char*, std::size_t)                { }
+void IoUring::writev(Operation&, int, const struct iovec*, std::size_t)       { }
+void IoUring::submit()       { }
+void IoUring::reap()         { }
+void IoUring::consume(Operation&)  { }
+void IoUring::wait(Operation&)     { }
+void IoUring::cancel(Operation&)   { }
+
+}
+
+#endif
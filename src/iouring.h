@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_IOURING_H
+#define CXXTOOLS_IOURING_H
+
+#include <cxxtools/refcounted.h>
+#include <cxxtools/noncopyable.h>
+#include <cstddef>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct iovec;
+
+namespace cxxtools
+{
+
+/** Minimal io_uring submission and completion queue.
+
+    Each thread has its own ring, which is created on first use. Requests
+    are queued in the submission queue and submitted together, when the
+    thread is about to wait in poll (see flush) or when the queue is full.
+    The eventfd of the ring becomes readable when requests are completed.
+    reap resets it and passes each completion to the listener of its
+    request, so that the owner of the request is notified, even when the
+    completion is reaped while waiting for a different request.
+
+    A ring must only be used by the thread, which created it.
+
+    The ring is not used, if the kernel does not support io_uring or does
+    not support reading at the current file position (Linux 5.6).
+ */
+class IoUring : public RefCounted, private NonCopyable
+{
+    public:
+        struct Operation;
+
+        /// Receives the completions of requests.
+        class Listener
+        {
+            public:
+                /// Called by reap, when the request is completed.
+                virtual void onCompleted(Operation& op) = 0;
+
+            protected:
+                ~Listener() { }
+        };
+
+        /// State of one read or write request.
+        struct Operation
+        {
+            bool pending;
+            bool done;
+            int result;
+            Listener* listener;
+
+            explicit Operation(Listener* listener_ = 0)
+                : pending(false),
+                  done(false),
+                  result(0),
+                  listener(listener_)
+                { }
+        };
+
+        ~IoUring();
+
+        /// Returns the ring of the current thread or 0, if io_uring can't be used.
+        static IoUring* current();
+
+        /// Enables or disables the use of io_uring for new requests.
+        static void enable(bool sw);
+        static bool enabled();
+
+        /// Submits the queued requests of the current thread.
+        static void flush();
+
+        int eventFd() const
+        { return _eventFd; }
+
+        /// Returns true, if this is the ring of the current thread.
+        bool isCurrent() const;
+
+        /// Queues a read at the current file position.
+        void read(Operation& op, int fd, char* buffer, std::size_t n);
+
+        /// Queues a write at the current file position.
+        void write(Operation& op, int fd, const char* buffer, std::size_t n);
+
+        /// Queues a writev at the current file position. The vector must
+        /// stay valid until the request is completed.
+        void writev(Operation& op, int fd, const struct iovec* iov, std::size_t iovcnt);
+
+        /// Submits the queued requests.
+        void submit();
+
+        /// Resets the eventfd and processes the completed requests.
+        void reap();
+
+        /// Marks a completed request as processed.
+        void consume(Operation& op);
+
+        /// Waits until the request is completed.
+        void wait(Operation& op);
+
+        /// Cancels the request and waits until the kernel has released it.
+        void cancel(Operation& op);
+
+    private:
+        IoUring();
+        bool init(unsigned entries);
+
+        void queue(unsigned char opcode, int fd, const void* addr, unsigned len, Operation* op);
+        void enter(unsigned toSubmit, unsigned minComplete);
+
+        int _ringFd;
+        int _eventFd;
+
+        void* _sqRing;
+        std::size_t _sqRingSize;
+        void* _cqRing;
+        std::size_t _cqRingSize;
+        io_uring_sqe* _sqes;
+        std::size_t _sqesSize;
+
+        unsigned* _sqHead;
+        unsigned* _sqTail;
+        unsigned* _sqMask;
+        unsigned* _sqArray;
+        unsigned _sqEntries;
+
+        unsigned* _cqHead;
+        unsigned* _cqTail;
+        unsigned* _cqMask;
+        io_uring_cqe* _cqes;
+
+        // queued but not submitted requests
+        unsigned _queued;
+};
+
+}
+
+#endif // CXXTOOLS_IOURING_H
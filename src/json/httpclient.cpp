@@ -53,7 +53,7 @@ HttpClient::HttpClient(SelectorBase& selector, const std::string& server,
                        unsigned short port, const std::string& url)
 : _impl(0)
 {
-    prepareConnect(net::AddrInfo(server, port), url);
+    prepareConnect(net::AddrInfo::beginResolve(server, port), url);
     setSelector(selector);
 }
 
@@ -71,7 +71,7 @@ HttpClient::HttpClient(SelectorBase& selector, const net::Uri& uri)
 : _impl(0)
 {
     setSelector(selector);
-    prepareConnect(net::AddrInfo(uri.host(), uri.port()), uri.path());
+    prepareConnect(net::AddrInfo::beginResolve(uri.host(), uri.port()), uri.path());
     auth(uri.user(), uri.password());
 }
 
@@ -79,7 +79,7 @@ HttpClient::HttpClient(SelectorBase& selector, const net::Uri& uri)
 HttpClient::HttpClient(const std::string& server, unsigned short port, const std::string& url)
 : _impl(0)
 {
-    prepareConnect(net::AddrInfo(server, port), url);
+    prepareConnect(net::AddrInfo::beginResolve(server, port), url);
 }
 
 
@@ -93,7 +93,7 @@ HttpClient::HttpClient(const net::AddrInfo& addrinfo, const std::string& url)
 HttpClient::HttpClient(const net::Uri& uri)
 : _impl(0)
 {
-    prepareConnect(net::AddrInfo(uri.host(), uri.port()), uri.path());
+    prepareConnect(net::AddrInfo::beginResolve(uri.host(), uri.port()), uri.path());
     auth(uri.user(), uri.password());
 }
 
@@ -136,13 +136,13 @@ void HttpClient::prepareConnect(const net::Uri& uri)
 {
     if (uri.protocol() != "http")
         throw std::runtime_error("only http is supported by http client");
-    prepareConnect(net::AddrInfo(uri.host(), uri.port()), uri.path());
+    prepareConnect(net::AddrInfo::beginResolve(uri.host(), uri.port()), uri.path());
     auth(uri.user(), uri.password());
 }
 
 void HttpClient::prepareConnect(const std::string& addr, unsigned short port, const std::string& url)
 {
-    prepareConnect(net::AddrInfo(addr, port), url);
+    prepareConnect(net::AddrInfo::beginResolve(addr, port), url);
 }
 
 void HttpClient::connect()
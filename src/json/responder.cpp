@@ -33,7 +33,15 @@
 #include <cxxtools/remoteexception.h>
 #include <cxxtools/textstream.h>
 #include <cxxtools/utf8codec.h>
+#include <cxxtools/threadpool.h>
+#include <cxxtools/refcounted.h>
+#include <cxxtools/smartptr.h>
+#include <cxxtools/mutex.h>
+#include <cxxtools/condition.h>
 #include <cxxtools/log.h>
+#include <sstream>
+#include <vector>
+#include <unistd.h>
 
 log_define("cxxtools.json.responder")
 
@@ -41,6 +49,117 @@ namespace cxxtools
 {
 namespace json
 {
+namespace
+{
+    unsigned batchThreads()
+    {
+        long n = ::sysconf(_SC_NPROCESSORS_ONLN);
+        return n > 0 ? static_cast<unsigned>(n) : 1;
+    }
+
+    // Helper threads for executing the elements of batch requests in parallel.
+    // The pool runs until the process ends, so it is never destroyed.
+    ThreadPool& batchPool()
+    {
+        static ThreadPool* pool = new ThreadPool(batchThreads());
+        return *pool;
+    }
+
+    // The elements of a batch request. The elements are fetched one by one
+    // by the thread, which received the request and the helper threads.
+    // Helper threads, which start late, may still hold a reference after
+    // the batch is finished, hence the reference counting.
+    class Batch : public AtomicRefCounted
+    {
+        public:
+            Batch(const Responder& responder, const SerializationInfo& requests)
+                : _responder(responder),
+                  _next(0),
+                  _done(0)
+            {
+                for (SerializationInfo::ConstIterator it = requests.begin(); it != requests.end(); ++it)
+                    _requests.push_back(&*it);
+                _responses.resize(_requests.size());
+            }
+
+            unsigned size() const
+            { return _requests.size(); }
+
+            // response to the n-th element; empty for notifications
+            const std::string& response(unsigned n) const
+            { return _responses[n]; }
+
+            // executes elements until no element is left
+            void run();
+
+            // waits until all elements are executed
+            void wait();
+
+        private:
+            const Responder& _responder;
+            std::vector<const SerializationInfo*> _requests;
+            std::vector<std::string> _responses;
+
+            Mutex _mutex;
+            Condition _finished;
+            unsigned _next;
+            unsigned _done;
+    };
+
+    void Batch::run()
+    {
+        while (true)
+        {
+            unsigned n;
+
+            {
+                MutexLock lock(_mutex);
+                if (_next >= _requests.size())
+                    return;
+                n = _next++;
+            }
+
+            std::ostringstream out;
+            try
+            {
+                if (_responder.execute(*_requests[n], out))
+                    _responses[n] = out.str();
+            }
+            catch (const std::exception& e)
+            {
+                log_error("failed to execute element " << n << " of batch request: " << e.what());
+            }
+
+            MutexLock lock(_mutex);
+            if (++_done == _requests.size())
+                _finished.broadcast();
+        }
+    }
+
+    void Batch::wait()
+    {
+        MutexLock lock(_mutex);
+        while (_done < _requests.size())
+            _finished.wait(lock);
+    }
+
+    class BatchTask : public Callable<void>
+    {
+            SmartPtr<Batch> _batch;
+
+        public:
+            explicit BatchTask(Batch* batch)
+                : _batch(batch)
+            { }
+
+            Callable<void>* clone() const
+            { return new BatchTask(*this); }
+
+            void operator()() const
+            { _batch->run(); }
+    };
+}
+
 const int Responder::ParseError;
 const int Responder::InvalidRequest;
 const int Responder::MethodNotFound;
@@ -67,106 +186,200 @@ void Responder::finalize(std::ostream& out)
 {
     log_trace("finalize");
 
-    std::string methodName;
-    ServiceProcedure* proc = 0;
+    if (_failed)
+        formatError(out, 0, _errorCode, _errorMessage);
+    else if (_deserializer.si().category() == SerializationInfo::Array)
+        executeBatch(_deserializer.si(), out);
+    else
+        execute(_deserializer.si(), out);
+}
 
-    TextOStream ts(out, new Utf8Codec());
-    JsonFormatter formatter;
+bool Responder::execute(const SerializationInfo& request, std::ostream& out) const
+{
+    if (request.category() != SerializationInfo::Object)
+    {
+        formatError(out, 0, InvalidRequest, "request is not an object");
+        return true;
+    }
 
-    formatter.begin(ts);
+    // requests without id are notifications, which get no response
+    const SerializationInfo* id = request.findMember("id");
 
-    formatter.beginObject(std::string(), std::string());
-    formatter.addValueString("jsonrpc", "string", L"2.0");
+    std::string methodName;
+    ServiceProcedure* proc = 0;
+    IDecomposer* result = 0;
+    int errorCode = 0;
+    std::string errorMessage;
 
-    if (_failed)
+    try
     {
-        formatter.beginObject("error", std::string());
-        formatter.addValueInt("code", "int", _errorCode);
-        formatter.addValueStdString("error", std::string(), _errorMessage);
+        result = call(request, methodName, proc);
     }
-    else
+    catch (const RemoteException& e)
+    {
+        log_debug("method \"" << methodName << "\" exited with RemoteException: " << e.what());
+        errorCode = e.rc();
+        errorMessage = e.what();
+    }
+    catch (const SerializationError& e)
+    {
+        log_debug("serialization error");
+        errorCode = InvalidRequest;
+        errorMessage = e.what();
+    }
+    catch (const std::exception& e)
     {
+        log_debug("method \"" << methodName << "\" exited with exception: " << e.what());
+        errorCode = ApplicationError;
+        errorMessage = e.what();
+    }
 
-        try
+    try
+    {
+        if (id == 0)
         {
-            _deserializer.si().getMember("method") >>= methodName;
+            log_debug("notification \"" << methodName << "\" processed");
+        }
+        else if (result == 0)
+        {
+            formatError(out, id, errorCode, errorMessage);
+        }
+        else
+        {
+            TextOStream ts(out, new Utf8Codec());
+            JsonFormatter formatter;
 
-            log_debug("method = " << methodName);
-            proc = _serviceRegistry.getProcedure(methodName);
-            if( ! proc )
-                throw RemoteException("Method \"" + methodName + "\" not found", MethodNotFound);
+            formatter.begin(ts);
 
-            // compose arguments
-            IComposer** args = proc->beginCall();
+            formatter.beginObject(std::string(), std::string());
+            formatter.addValueString("jsonrpc", "string", L"2.0");
+            IDecomposer::formatEach(*id, formatter);
 
-            // process args
-            const SerializationInfo* paramsPtr = _deserializer.si().findMember("params");
+            formatter.beginValue("result");
+            result->format(formatter);
+            formatter.finishValue();
 
-            // params may be ommited in request
-            SerializationInfo emptyParams;
+            formatter.finishObject();
 
-            const SerializationInfo& params = paramsPtr ? *paramsPtr : emptyParams;
+            ts.flush();
+        }
+    }
+    catch (...)
+    {
+        if (proc)
+            _serviceRegistry.releaseProcedure(proc);
+        throw;
+    }
 
-            SerializationInfo::ConstIterator it = params.begin();
-            if (args)
-            {
-                for (int a = 0; args[a]; ++a)
-                {
-                    if (it == params.end())
-                        throw RemoteException("missing parameters", InvalidParams);
-                    args[a]->fixup(*it);
-                    ++it;
-                }
-            }
+    if (proc)
+        _serviceRegistry.releaseProcedure(proc);
 
-            if (it != params.end())
-                throw RemoteException("too many parameters", InvalidParams);
+    return id != 0;
+}
 
-            IDecomposer::formatEach(_deserializer.si().getMember("id"), formatter);
+IDecomposer* Responder::call(const SerializationInfo& request, std::string& methodName, ServiceProcedure*& proc) const
+{
+    request.getMember("method") >>= methodName;
 
-            IDecomposer* result;
-            result = proc->endCall();
+    log_debug("method = " << methodName);
+    proc = _serviceRegistry.getProcedure(methodName);
+    if( ! proc )
+        throw RemoteException("Method \"" + methodName + "\" not found", MethodNotFound);
 
-            formatter.beginValue("result");
-            result->format(formatter);
-            formatter.finishValue();
-        }
-        catch (const RemoteException& e)
-        {
-            log_debug("method \"" << methodName << "\" exited with RemoteException: " << e.what());
+    // compose arguments
+    IComposer** args = proc->beginCall();
 
-            formatter.beginObject("error", std::string());
+    // process args
+    const SerializationInfo* paramsPtr = request.findMember("params");
 
-            formatter.addValueInt("code", "int", static_cast<Formatter::int_type>(e.rc()));
-            formatter.addValueStdString("message", std::string(), e.what());
-            formatter.finishObject();
-        }
-        catch (const SerializationError& e)
-        {
-            log_debug("serialization error");
+    // params may be ommited in request
+    SerializationInfo emptyParams;
 
-            formatter.beginObject("error", std::string());
+    const SerializationInfo& params = paramsPtr ? *paramsPtr : emptyParams;
 
-            formatter.addValueInt("code", "int", InvalidRequest);
-            formatter.addValueStdString("message", std::string(), e.what());
-            formatter.finishObject();
-        }
-        catch (const std::exception& e)
+    SerializationInfo::ConstIterator it = params.begin();
+    if (args)
+    {
+        for (int a = 0; args[a]; ++a)
         {
-            log_debug("method \"" << methodName << "\" exited with exception: " << e.what());
+            if (it == params.end())
+                throw RemoteException("missing parameters", InvalidParams);
+            args[a]->fixup(*it);
+            ++it;
+        }
+    }
 
-            formatter.beginObject("error", std::string());
+    if (it != params.end())
+        throw RemoteException("too many parameters", InvalidParams);
 
-            formatter.addValueInt("code", "int", ApplicationError);
-            formatter.addValueStdString("message", std::string(), e.what());
-            formatter.finishObject();
-        }
+    return proc->endCall();
+}
+
+void Responder::executeBatch(const SerializationInfo& requests, std::ostream& out) const
+{
+    if (requests.memberCount() == 0)
+    {
+        formatError(out, 0, InvalidRequest, "empty batch request");
+        return;
+    }
+
+    log_debug("batch request with " << requests.memberCount() << " elements");
+
+    SmartPtr<Batch> batch(new Batch(*this, requests));
+
+    if (batch->size() > 1)
+    {
+        static const unsigned threads = batchThreads();
+        unsigned helpers = batch->size() - 1;
+        if (helpers > threads)
+            helpers = threads;
+
+        for (unsigned n = 0; n < helpers; ++n)
+            batchPool().schedule(BatchTask(batch.getPointer()));
+    }
+
+    batch->run();
+    batch->wait();
+
+    // the response to a batch of notifications is empty
+    bool first = true;
+    for (unsigned n = 0; n < batch->size(); ++n)
+    {
+        const std::string& response = batch->response(n);
+        if (response.empty())
+            continue;
+
+        out << (first ? '[' : ',') << response;
+        first = false;
     }
 
+    if (!first)
+        out << ']';
+}
+
+void Responder::formatError(std::ostream& out, const SerializationInfo* id, int code, const std::string& message)
+{
+    TextOStream ts(out, new Utf8Codec());
+    JsonFormatter formatter;
+
+    formatter.begin(ts);
+
+    formatter.beginObject(std::string(), std::string());
+    formatter.addValueString("jsonrpc", "string", L"2.0");
+
+    if (id)
+        IDecomposer::formatEach(*id, formatter);
+    else
+        formatter.addNull("id", std::string());
+
+    formatter.beginObject("error", std::string());
+    formatter.addValueInt("code", "int", static_cast<Formatter::int_type>(code));
+    formatter.addValueStdString("message", std::string(), message);
     formatter.finishObject();
 
-    if (proc)
-        _serviceRegistry.releaseProcedure(proc);
+    formatter.finishObject();
+
+    ts.flush();
 }
 
 bool Responder::advance(char ch)
@@ -34,11 +34,13 @@
 #include <cxxtools/iostream.h>
 #include <cxxtools/jsonparser.h>
 #include <cxxtools/jsonformatter.h>
+#include <string>
 
 namespace cxxtools
 {
 
 class ServiceRegistry;
+class ServiceProcedure;
 
 namespace json
 {
@@ -65,7 +67,17 @@ class Responder
         bool failed() const
         { return _failed; }
 
+        /// Executes a single request object and writes the response into out.
+        /// Returns false, when the request is a notification and nothing was written.
+        bool execute(const SerializationInfo& request, std::ostream& out) const;
+
     private:
+        IDecomposer* call(const SerializationInfo& request, std::string& methodName,
+                          ServiceProcedure*& proc) const;
+        void executeBatch(const SerializationInfo& requests, std::ostream& out) const;
+        static void formatError(std::ostream& out, const SerializationInfo* id,
+                                int code, const std::string& message);
+
         ServiceRegistry& _serviceRegistry;
         JsonDeserializer _deserializer;
 
@@ -122,14 +122,14 @@ void RpcClient::prepareConnect(const net::AddrInfo& addrinfo)
 
 void RpcClient::prepareConnect(const std::string& host, unsigned short int port)
 {
-    prepareConnect(net::AddrInfo(host, port));
+    prepareConnect(net::AddrInfo::beginResolve(host, port));
 }
 
 void RpcClient::prepareConnect(const net::Uri& uri)
 {
     if (uri.protocol() != "http")
         throw std::runtime_error("only http is supported by http client");
-    prepareConnect(net::AddrInfo(uri.host(), uri.port()));
+    prepareConnect(net::AddrInfo::beginResolve(uri.host(), uri.port()));
 }
 
 void RpcClient::connect()
@@ -163,6 +163,21 @@ void RpcClient::call(IComposer& r, IRemoteProcedure& method, IDecomposer** argv,
     _impl->call(r, method, argv, argc);
 }
 
+void RpcClient::beginBatch()
+{
+    getImpl()->beginBatch();
+}
+
+void RpcClient::endBatch()
+{
+    getImpl()->endBatch();
+}
+
+void RpcClient::notify(const String& method, IDecomposer** argv, unsigned argc)
+{
+    getImpl()->notify(method, argv, argc);
+}
+
 Milliseconds RpcClient::timeout() const
 {
     return getImpl()->timeout();
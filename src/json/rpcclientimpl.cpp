@@ -33,7 +33,9 @@
 #include <cxxtools/jsonformatter.h>
 #include <cxxtools/ioerror.h>
 #include <cxxtools/clock.h>
+#include <cxxtools/remoteexception.h>
 #include <stdexcept>
+#include <vector>
 
 log_define("cxxtools.json.rpcclient.impl")
 
@@ -47,6 +49,8 @@ RpcClientImpl::RpcClientImpl()
       _exceptionPending(false),
       _proc(0),
       _count(0),
+      _batchOpen(false),
+      _batchSize(0),
       _timeout(Selectable::WaitInfinite),
       _connectTimeoutSet(false),
       _connectTimeout(Selectable::WaitInfinite)
@@ -70,6 +74,18 @@ void RpcClientImpl::close()
 
 void RpcClientImpl::beginCall(IComposer& r, IRemoteProcedure& method, IDecomposer** argv, unsigned argc)
 {
+    if (_batchOpen)
+    {
+        prepareRequest(method.name(), argv, argc);
+
+        BatchCall c;
+        c.proc = &method;
+        c.composer = &r;
+        c.finished = false;
+        _batchCalls[_count] = c;
+        return;
+    }
+
     if (_socket.selector() == 0)
         throw std::logic_error("cannot run async rpc request without a selector");
 
@@ -82,23 +98,7 @@ void RpcClientImpl::beginCall(IComposer& r, IRemoteProcedure& method, IDecompose
 
     try
     {
-        if (_socket.isConnected())
-        {
-            try
-            {
-                _stream.buffer().beginWrite();
-            }
-            catch (const IOError&)
-            {
-                log_debug("write failed, connection is not active any more");
-                _socket.beginConnect(_addrInfo);
-            }
-        }
-        else
-        {
-            log_debug("not yet connected - do it now");
-            _socket.beginConnect(_addrInfo);
-        }
+        beginWrite();
     }
     catch (const std::exception& )
     {
@@ -117,7 +117,8 @@ void RpcClientImpl::beginCall(IComposer& r, IRemoteProcedure& method, IDecompose
 
 void RpcClientImpl::endCall()
 {
-    _proc = 0;
+    if (_batchCalls.empty())
+        _proc = 0;
 
     if (_exceptionPending)
     {
@@ -128,6 +129,9 @@ void RpcClientImpl::endCall()
 
 void RpcClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer** argv, unsigned argc)
 {
+    if (_batchOpen)
+        throw std::logic_error("synchronous call not possible in batch request");
+
     _proc = &method;
 
     prepareRequest(_proc->name(), argv, argc);
@@ -177,12 +181,109 @@ void RpcClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer** a
     }
 }
 
+void RpcClientImpl::notify(const String& name, IDecomposer** argv, unsigned argc)
+{
+    if (_batchOpen)
+    {
+        prepareRequest(name, argv, argc, true);
+        return;
+    }
+
+    if (_proc)
+        throw std::logic_error("asyncronous request already running");
+
+    prepareRequest(name, argv, argc, true);
+    flush();
+}
+
+void RpcClientImpl::beginBatch()
+{
+    if (_proc)
+        throw std::logic_error("asyncronous request already running");
+
+    if (_batchOpen)
+        throw std::logic_error("batch request already open");
+
+    _batchOpen = true;
+    _batchSize = 0;
+}
+
+void RpcClientImpl::endBatch()
+{
+    if (!_batchOpen)
+        throw std::logic_error("no batch request open");
+
+    _batchOpen = false;
+
+    if (_batchSize == 0)
+        return;
+
+    _stream << ']';
+    _batchSize = 0;
+
+    if (_batchCalls.empty())
+    {
+        // a batch of notifications is not answered
+        flush();
+        return;
+    }
+
+    if (_socket.selector() == 0)
+    {
+        try
+        {
+            flush();
+
+            _deserializer.begin();
+
+            StreamBuffer& sb = _stream.buffer();
+
+            while (true)
+            {
+                int ch = sb.sbumpc();
+                if (ch == StreamBuffer::traits_type::eof())
+                    throw std::runtime_error("reading result failed");
+
+                if (_deserializer.advance(ch))
+                    break;
+            }
+        }
+        catch (const std::exception&)
+        {
+            _batchCalls.clear();
+            cancel();
+            throw;
+        }
+
+        finalizeBatch();
+    }
+    else
+    {
+        _proc = _batchCalls.begin()->second.proc;
+
+        try
+        {
+            beginWrite();
+        }
+        catch (const std::exception& e)
+        {
+            failBatch(e.what());
+            return;
+        }
+
+        _deserializer.begin();
+    }
+}
+
 void RpcClientImpl::cancel()
 {
     _socket.close();
     _stream.clear();
     _stream.buffer().discard();
     _proc = 0;
+    _batchCalls.clear();
+    _batchOpen = false;
+    _batchSize = 0;
 }
 
 void RpcClientImpl::wait(Timespan timeout)
@@ -210,8 +311,11 @@ void RpcClientImpl::wait(Timespan timeout)
     }
 }
 
-void RpcClientImpl::prepareRequest(const String& name, IDecomposer** argv, unsigned argc)
+void RpcClientImpl::prepareRequest(const String& name, IDecomposer** argv, unsigned argc, bool notification)
 {
+    if (_batchOpen)
+        _stream << (_batchSize++ == 0 ? '[' : ',');
+
     TextOStream ts(_stream, new Utf8Codec());
     JsonFormatter formatter;
 
@@ -221,7 +325,10 @@ void RpcClientImpl::prepareRequest(const String& name, IDecomposer** argv, unsig
 
     formatter.addValueStdString("jsonrpc", std::string(), "2.0");
     formatter.addValueString("method", std::string(), String(_prefix) + name);
-    formatter.addValueInt("id", "int", ++_count);
+
+    // notifications have no id and are not answered by the server
+    if (!notification)
+        formatter.addValueInt("id", "int", ++_count);
 
     formatter.beginArray("params", std::string());
 
@@ -239,6 +346,134 @@ void RpcClientImpl::prepareRequest(const String& name, IDecomposer** argv, unsig
     ts.flush();
 }
 
+void RpcClientImpl::beginWrite()
+{
+    if (_socket.isConnected())
+    {
+        try
+        {
+            _stream.buffer().beginWrite();
+        }
+        catch (const IOError&)
+        {
+            log_debug("write failed, connection is not active any more");
+            _socket.beginConnect(_addrInfo);
+        }
+    }
+    else
+    {
+        log_debug("not yet connected - do it now");
+        _socket.beginConnect(_addrInfo);
+    }
+}
+
+void RpcClientImpl::flush()
+{
+    if (!_socket.isConnected())
+    {
+        _socket.setTimeout(_connectTimeout);
+        _socket.connect(_addrInfo);
+    }
+
+    _socket.setTimeout(timeout());
+
+    _stream.flush();
+
+    if (!_stream)
+    {
+        cancel();
+        throw IOError("sending request failed");
+    }
+}
+
+void RpcClientImpl::finalizeBatch()
+{
+    BatchCalls calls;
+    calls.swap(_batchCalls);
+    _proc = 0;
+
+    const SerializationInfo& reply = _deserializer.si();
+
+    if (reply.category() == SerializationInfo::Array)
+    {
+        for (SerializationInfo::ConstIterator it = reply.begin(); it != reply.end(); ++it)
+        {
+            const SerializationInfo* id = it->findMember("id");
+            if (id == 0 || id->isNull())
+            {
+                log_warn("reply without id in batch reply");
+                continue;
+            }
+
+            Formatter::int_type n = 0;
+            *id >>= n;
+
+            BatchCalls::iterator c = calls.find(n);
+            if (c == calls.end() || c->second.finished)
+            {
+                log_warn("unexpected id " << n << " in batch reply");
+                continue;
+            }
+
+            try
+            {
+                Scanner::finalizeReply(*it, *c->second.composer);
+            }
+            catch (const RemoteException& e)
+            {
+                c->second.proc->setFault(e.rc(), e.what());
+            }
+            catch (const std::exception& e)
+            {
+                c->second.proc->setFault(0, e.what());
+            }
+
+            c->second.finished = true;
+        }
+    }
+    else
+    {
+        // the server rejected the whole batch
+        int rc = 0;
+        std::string msg = "invalid reply to batch request";
+        try
+        {
+            Scanner::checkError(reply);
+        }
+        catch (const RemoteException& e)
+        {
+            rc = e.rc();
+            msg = e.what();
+        }
+
+        for (BatchCalls::iterator c = calls.begin(); c != calls.end(); ++c)
+        {
+            c->second.proc->setFault(rc, msg);
+            c->second.finished = true;
+        }
+    }
+
+    for (BatchCalls::iterator c = calls.begin(); c != calls.end(); ++c)
+    {
+        if (!c->second.finished)
+            c->second.proc->setFault(0, "no reply to call in batch request");
+        c->second.proc->onFinished();
+    }
+}
+
+void RpcClientImpl::failBatch(const std::string& msg)
+{
+    BatchCalls calls;
+    calls.swap(_batchCalls);
+    cancel();
+
+    for (BatchCalls::iterator c = calls.begin(); c != calls.end(); ++c)
+    {
+        c->second.proc->setFault(0, msg);
+        c->second.proc->onFinished();
+    }
+}
+
 void RpcClientImpl::onConnect(net::TcpSocket& socket)
 {
     try
@@ -250,8 +485,14 @@ void RpcClientImpl::onConnect(net::TcpSocket& socket)
 
         _stream.buffer().beginWrite();
     }
-    catch (const std::exception& )
+    catch (const std::exception& e)
     {
+        if (!_batchCalls.empty())
+        {
+            failBatch(e.what());
+            return;
+        }
+
         IRemoteProcedure* proc = _proc;
         cancel();
 
@@ -272,13 +513,19 @@ void RpcClientImpl::onOutput(StreamBuffer& sb)
     {
         _exceptionPending = false;
         sb.endWrite();
-        if (sb.out_avail() > 0)
+        if (sb.pendingOutput() > 0)
             sb.beginWrite();
         else
             sb.beginRead();
     }
-    catch (const std::exception&)
+    catch (const std::exception& e)
     {
+        if (!_batchCalls.empty())
+        {
+            failBatch(e.what());
+            return;
+        }
+
         IRemoteProcedure* proc = _proc;
         cancel();
 
@@ -308,6 +555,12 @@ void RpcClientImpl::onInput(StreamBuffer& sb)
             char ch = StreamBuffer::traits_type::to_char_type(_stream.buffer().sbumpc());
             if (_deserializer.advance(ch))
             {
+                if (!_batchCalls.empty())
+                {
+                    finalizeBatch();
+                    return;
+                }
+
                 _scanner.finalizeReply();
                 IRemoteProcedure* proc = _proc;
                 _proc = 0;
@@ -324,8 +577,14 @@ void RpcClientImpl::onInput(StreamBuffer& sb)
 
         sb.beginRead();
     }
-    catch (const std::exception&)
+    catch (const std::exception& e)
     {
+        if (!_batchCalls.empty())
+        {
+            failBatch(e.what());
+            return;
+        }
+
         IRemoteProcedure* proc = _proc;
         cancel();
 
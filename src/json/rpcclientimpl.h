@@ -39,6 +39,7 @@
 #include <cxxtools/selector.h>
 #include <cxxtools/refcounted.h>
 #include <string>
+#include <map>
 #include "scanner.h"
 
 namespace cxxtools
@@ -78,6 +79,15 @@ class RpcClientImpl : public RefCounted, public Connectable
 
         void call(IComposer& r, IRemoteProcedure& method, IDecomposer** argv, unsigned argc);
 
+        void notify(const String& name, IDecomposer** argv, unsigned argc);
+
+        void beginBatch();
+
+        void endBatch();
+
+        bool batchOpen() const
+        { return _batchOpen; }
+
         Timespan timeout() const  { return _timeout; }
         void timeout(Timespan t)  { _timeout = t; if (!_connectTimeoutSet) _connectTimeout = t; }
 
@@ -98,7 +108,11 @@ class RpcClientImpl : public RefCounted, public Connectable
         { _prefix = p; }
 
     private:
-        void prepareRequest(const String& name, IDecomposer** argv, unsigned argc);
+        void prepareRequest(const String& name, IDecomposer** argv, unsigned argc, bool notification = false);
+        void beginWrite();
+        void flush();
+        void finalizeBatch();
+        void failBatch(const std::string& msg);
         void onConnect(net::TcpSocket& socket);
         void onOutput(StreamBuffer& sb);
         void onInput(StreamBuffer& sb);
@@ -119,6 +133,19 @@ class RpcClientImpl : public RefCounted, public Connectable
         IRemoteProcedure* _proc;
         Formatter::int_type _count;
 
+        // calls of a batch request, which are not answered yet, indexed by id
+        struct BatchCall
+        {
+            IRemoteProcedure* proc;
+            IComposer* composer;
+            bool finished;
+        };
+
+        typedef std::map<Formatter::int_type, BatchCall> BatchCalls;
+        BatchCalls _batchCalls;
+        bool _batchOpen;
+        unsigned _batchSize;
+
         Timespan _timeout;
         bool _connectTimeoutSet;  // indicates if connectTimeout is explicitely set
                                   // when not, it follows the setting of _timeout
@@ -94,5 +94,15 @@ void RpcServer::maxThreads(unsigned m)
     _impl->maxThreads(m);
 }
 
+void RpcServer::socketOptions(const net::SocketOptions& options)
+{
+    _impl->socketOptions(options);
+}
+
+const net::SocketOptions& RpcServer::socketOptions() const
+{
+    return _impl->socketOptions();
+}
+
 }
 }
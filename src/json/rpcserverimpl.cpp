@@ -132,11 +132,13 @@ RpcServerImpl::~RpcServerImpl()
 void RpcServerImpl::listen(const std::string& ip, unsigned short int port, int backlog)
 {
     log_info("listen on " << ip << " port " << port);
-    net::TcpServer* listener = new net::TcpServer(ip, port, backlog,
-        net::TcpServer::DEFER_ACCEPT|net::TcpServer::REUSEADDR);
+    net::TcpServer* listener = new net::TcpServer();
 
     try
     {
+        listener->socketOptions(_socketOptions);
+        listener->listen(ip, port, backlog,
+            net::TcpServer::DEFER_ACCEPT|net::TcpServer::REUSEADDR);
         _listener.push_back(listener);
         _queue.put(new Socket(*this, _serviceRegistry, *listener));
     }
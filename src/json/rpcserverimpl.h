@@ -83,6 +83,12 @@ namespace cxxtools
                 void maxThreads(unsigned m)
                 { _maxThreads = m; }
 
+                const net::SocketOptions& socketOptions() const
+                { return _socketOptions; }
+
+                void socketOptions(const net::SocketOptions& options)
+                { _socketOptions = options; }
+
                 void terminate();
 
                 RpcServer::Runmode runmode() const
@@ -120,6 +126,7 @@ namespace cxxtools
                 ServiceRegistry& _serviceRegistry;
                 unsigned _minThreads;
                 unsigned _maxThreads;
+                net::SocketOptions _socketOptions;
 
                 std::vector<net::TcpServer*> _listener;
                 Queue<Socket*> _queue;
@@ -50,7 +50,12 @@ void Scanner::begin(JsonDeserializer& handler, IComposer& composer)
 
 void Scanner::finalizeReply()
 {
-    const SerializationInfo* s = _deserializer->si().findMember("error");
+    finalizeReply(_deserializer->si(), *_composer);
+}
+
+void Scanner::checkError(const SerializationInfo& reply)
+{
+    const SerializationInfo* s = reply.findMember("error");
 
     if (s && !s->isNull())
     {
@@ -73,9 +78,12 @@ void Scanner::finalizeReply()
             throw RemoteException(msg);
         }
     }
+}
 
-    _composer->fixup(
-        _deserializer->si().getMember("result"));
+void Scanner::finalizeReply(const SerializationInfo& reply, IComposer& composer)
+{
+    checkError(reply);
+    composer.fixup(reply.getMember("result"));
 }
 
 }
@@ -37,6 +37,7 @@ namespace cxxtools
 {
     class JsonDeserializer;
     class IComposer;
+    class SerializationInfo;
 
     namespace json
     {
@@ -55,6 +56,12 @@ namespace cxxtools
 
                 void finalizeReply();
 
+                /// Throws a RemoteException, when the reply reports an error.
+                static void checkError(const SerializationInfo& reply);
+
+                /// Passes the result of a reply to the composer or throws the error.
+                static void finalizeReply(const SerializationInfo& reply, IComposer& composer);
+
             private:
                 JsonDeserializer* _deserializer;
                 IComposer* _composer;
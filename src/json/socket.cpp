@@ -45,6 +45,7 @@ Socket::Socket(RpcServerImpl& server, ServiceRegistry& serviceRegistry, net::Tcp
       _accepted(false)
 {
     _stream.attachDevice(*this);
+    _stream.buffer().segmented(true);
     cxxtools::connect(IODevice::inputReady, *this, &Socket::onIODeviceInput);
     cxxtools::connect(_stream.buffer().outputReady, *this, &Socket::onOutput);
     _responder.begin();
@@ -60,6 +61,7 @@ Socket::Socket(Socket& socket)
       _accepted(false)
 {
     _stream.attachDevice(*this);
+    _stream.buffer().segmented(true);
     cxxtools::connect(IODevice::inputReady, *this, &Socket::onIODeviceInput);
     cxxtools::connect(_stream.buffer().outputReady, *this, &Socket::onOutput);
     _responder.begin();
@@ -107,6 +109,14 @@ void Socket::onInput(StreamBuffer& sb)
         if (_responder.advance(sb.sbumpc()))
         {
             _responder.finalize(_stream);
+
+            if (sb.pendingOutput() == 0)
+            {
+                // notifications are not answered
+                _responder.begin();
+                continue;
+            }
+
             buffer().beginWrite();
             onOutput(sb);
             return;
@@ -127,7 +137,7 @@ bool Socket::onOutput(StreamBuffer& sb)
     {
         sb.endWrite();
 
-        if ( sb.out_avail() )
+        if ( sb.pendingOutput() )
         {
             sb.beginWrite();
         }
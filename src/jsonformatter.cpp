@@ -30,6 +30,7 @@
 #include <cxxtools/jsonformatter.h>
 #include <cxxtools/convert.h>
 #include <cxxtools/log.h>
+#include <iterator>
 #include <limits>
 
 log_define("cxxtools.jsonformatter")
@@ -210,7 +211,7 @@ void JsonFormatter::addValueFloat(const std::string& name, const std::string& ty
     }
     else
     {
-        *_ts << convert<String>(value);
+        putFloat(std::ostreambuf_iterator<Char>(*_ts), value);
     }
 
     finishValue();
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/lightmutex.h>
+#include <cxxtools/thread.h>
+#include <climits>
+#include <errno.h>
+#include <time.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace cxxtools
+{
+    namespace
+    {
+        // Sleeps while the value is equal to expected. Returns false on timeout.
+        template <typename T>
+        bool futexWait(std::atomic<T>& value, T expected, const Milliseconds* timeout = 0)
+        {
+#if defined(__linux__)
+            static_assert(sizeof(std::atomic<T>) == sizeof(int), "futex needs a 32 bit value");
+
+            struct timespec ts;
+            if (timeout)
+            {
+                long ms = timeout->totalMSecs() > 0 ? static_cast<long>(timeout->totalMSecs()) : 0;
+                ts.tv_sec = ms / 1000;
+                ts.tv_nsec = (ms % 1000) * 1000000;
+            }
+
+            long ret = ::syscall(SYS_futex, reinterpret_cast<int*>(&value), FUTEX_WAIT_PRIVATE,
+                static_cast<int>(expected), timeout ? &ts : 0, 0, 0);
+            return ret == 0 || errno != ETIMEDOUT;
+#else
+            if (value.load(std::memory_order_relaxed) == expected)
+            {
+                if (timeout)
+                {
+                    Thread::sleep(*timeout > Milliseconds(1) ? Milliseconds(1) : *timeout);
+                    return false;
+                }
+
+                Thread::yield();
+            }
+            return true;
+#endif
+        }
+
+        template <typename T>
+        void futexWake(std::atomic<T>& value, int count)
+        {
+#if defined(__linux__)
+            ::syscall(SYS_futex, reinterpret_cast<int*>(&value), FUTEX_WAKE_PRIVATE,
+                count < 0 ? INT_MAX : count, 0, 0, 0);
+#endif
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // LightMutex
+    //
+    void LightMutex::lockSlow(int state)
+    {
+        // spin shortly since the mutex is usually held only for a short time
+        for (unsigned count = 0; count < 100 && state == 1; ++count)
+        {
+            state = 0;
+            if (_state.compare_exchange_weak(state, 1, std::memory_order_acquire, std::memory_order_relaxed))
+                return;
+        }
+
+        if (state != 2)
+            state = _state.exchange(2, std::memory_order_acquire);
+
+        while (state != 0)
+        {
+            futexWait(_state, 2);
+            state = _state.exchange(2, std::memory_order_acquire);
+        }
+    }
+
+    void LightMutex::wake()
+    {
+        futexWake(_state, 1);
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // LightCondition
+    //
+    void LightCondition::wait(LightMutex& mtx)
+    {
+        unsigned sequence = _sequence.load(std::memory_order_seq_cst);
+        _waiters.fetch_add(1, std::memory_order_seq_cst);
+        mtx.unlock();
+
+        futexWait(_sequence, sequence);
+
+        _waiters.fetch_sub(1, std::memory_order_relaxed);
+        mtx.lock();
+    }
+
+    bool LightCondition::wait(LightMutex& mtx, const Milliseconds& ts)
+    {
+        unsigned sequence = _sequence.load(std::memory_order_seq_cst);
+        _waiters.fetch_add(1, std::memory_order_seq_cst);
+        mtx.unlock();
+
+        bool ret = futexWait(_sequence, sequence, &ts);
+
+        _waiters.fetch_sub(1, std::memory_order_relaxed);
+        mtx.lock();
+
+        return ret;
+    }
+
+    void LightCondition::wake(int count)
+    {
+        futexWake(_sequence, count);
+    }
+}
@@ -31,6 +31,7 @@
 #include <cxxtools/smartptr.h>
 #include <cxxtools/convert.h>
 #include <cxxtools/mutex.h>
+#include <cxxtools/epoch.h>
 #include <cxxtools/atomicity.h>
 #include <cxxtools/serializationinfo.h>
 #include <cxxtools/xml/xmldeserializer.h>
@@ -66,9 +67,76 @@ namespace cxxtools
   {
     Mutex loggersMutex;
     Mutex logMutex;
+#if __cplusplus < 201103L
     Mutex poolMutex;
+#endif
     atomic_t mutexWaitCount = 0;
 
+#if __cplusplus >= 201103L
+
+    // Each thread keeps up to MaxPoolSize instances, so that no lock is needed.
+    // The thread local cache has no destructor; a separate cleanup object
+    // frees the instances, when the thread exits, and disables the cache, so
+    // that log messages in later destructors still work.
+    template <typename T, unsigned MaxPoolSize = 8>
+    class LPool
+    {
+        struct Cache
+        {
+          T* instances[MaxPoolSize];
+          unsigned count;
+          bool dead;
+        };
+
+        struct Cleanup
+        {
+          ~Cleanup()
+          {
+            Cache& c = cache();
+            while (c.count > 0)
+              delete c.instances[--c.count];
+            c.dead = true;
+          }
+        };
+
+        static Cache& cache()
+        {
+          static thread_local Cache c;
+          return c;
+        }
+
+        LPool(const LPool&);
+        LPool& operator=(const LPool&);
+
+      public:
+        LPool() { }
+
+        T* getInstance()
+        {
+          Cache& c = cache();
+          if (c.count == 0)
+            return new T();
+
+          return c.instances[--c.count];
+        }
+
+        void releaseInstance(T* inst)
+        {
+          Cache& c = cache();
+          if (c.dead || c.count >= MaxPoolSize)
+          {
+            delete inst;
+            return;
+          }
+
+          static thread_local Cleanup cleanup;
+          c.instances[c.count++] = inst;
+        }
+
+    };
+
+#else
+
     template <typename T, unsigned MaxPoolSize = 8>
     class LPool
     {
@@ -121,6 +189,8 @@ namespace cxxtools
 
     };
 
+#endif
+
     class ScopedAtomicIncrementer
     {
         atomic_t& count;
@@ -545,32 +615,68 @@ namespace cxxtools
     class UdpAppender : public LogAppender
     {
         net::UdpSender _loghost;
-        std::string _msg;
+
+        // pending messages are collected in one buffer and sent with a
+        // single system call when flushed
+        std::string _msgs;
+        std::vector<std::string::size_type> _ends;
+        std::vector<net::UdpMessage> _batch;
+
+        static const unsigned maxBatchCount = 64;
+        static const std::string::size_type maxBatchSize = 65536;
+
+        void sendBatch();
 
       public:
         UdpAppender(const std::string& host, unsigned short int port, bool broadcast = true)
           : _loghost(host, port, broadcast)
         { }
 
+        ~UdpAppender()
+        { sendBatch(); }
+
         virtual void putMessage(const std::string& msg);
         virtual void finish(bool flush);
     };
 
     void UdpAppender::putMessage(const std::string& msg)
     {
-      _msg = msg;
+      _msgs += msg;
+      _ends.push_back(_msgs.size());
     }
 
-    void UdpAppender::finish(bool /*flush*/)
+    void UdpAppender::finish(bool flush)
     {
+      if (!flush && _ends.size() < maxBatchCount && _msgs.size() < maxBatchSize)
+        return;
+
+      sendBatch();
+    }
+
+    void UdpAppender::sendBatch()
+    {
+      if (_ends.empty())
+        return;
+
+      _batch.resize(_ends.size());
+      std::string::size_type begin = 0;
+      for (unsigned n = 0; n < _ends.size(); ++n)
+      {
+        _batch[n].data = const_cast<char*>(_msgs.data()) + begin;
+        _batch[n].size = _ends[n] - begin;
+        begin = _ends[n];
+      }
+
       try
       {
-        _loghost.send(_msg);
+        _loghost.send(&_batch[0], _batch.size());
       }
       catch (const std::exception&)
       {
       }
-      _msg.clear();
+
+      _msgs.clear();
+      _ends.clear();
     }
 
     //////////////////////////////////////////////////////////////////////
@@ -1115,7 +1221,7 @@ namespace cxxtools
       SmartPtr<LogAppender> _appender;
       LogConfiguration _config;
       typedef std::map<std::string, Logger*> Loggers;  // map category => logger
-      Loggers _loggers;
+      SnapshotPtr<Loggers> _loggers;  // changed under loggersMutex
 
       Impl(const Impl&);
       Impl& operator=(const Impl&);
@@ -1140,6 +1246,7 @@ namespace cxxtools
   };
 
   LogManager::Impl::Impl(const LogConfiguration& config)
+    : _loggers(new Loggers())
   {
     if (config.impl()->fname().empty())
     {
@@ -1188,13 +1295,14 @@ namespace cxxtools
 
     _config = config;
 
-    for (Loggers::iterator it = _loggers.begin(); it != _loggers.end(); ++it)
+    MutexLock lock(loggersMutex);
+    for (Loggers::iterator it = _loggers->begin(); it != _loggers->end(); ++it)
       it->second->setLogFlags(logFlags(it->second->getCategory()));
   }
 
   LogManager::Impl::~Impl()
   {
-    for (Loggers::iterator it = _loggers.begin(); it != _loggers.end(); ++it)
+    for (Loggers::iterator it = _loggers->begin(); it != _loggers->end(); ++it)
       delete it->second;
   }
 
@@ -1331,15 +1439,25 @@ namespace cxxtools
 
   Logger* LogManager::Impl::getLogger(const std::string& category)
   {
+    // check for existing loggers
+    {
+      EpochReadLock lock;
+      const Loggers* loggers = _loggers.get();
+      Loggers::const_iterator it = loggers->find(category);
+      if (it != loggers->end())
+        return it->second;
+    }
+
     MutexLock lock(loggersMutex);
 
-    // check for existing loggers
-    Loggers::iterator it = _loggers.find(category);
-    if (it != _loggers.end())
+    Loggers::const_iterator it = _loggers->find(category);
+    if (it != _loggers->end())
       return it->second;
 
     Logger* ret = new Logger(category, logFlags(category));
-    _loggers[category] = ret;
+    Loggers* loggers = new Loggers(*_loggers);
+    (*loggers)[category] = ret;
+    _loggers.update(loggers);
 
     return ret;
   }
@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/mappedfile.h>
+#include <cxxtools/ioerror.h>
+#include <cxxtools/log.h>
+#include "error.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+log_define("cxxtools.mappedfile")
+
+namespace cxxtools
+{
+    namespace
+    {
+        // transparent huge pages on x86 and most other platforms
+        const std::size_t hugePageSize = 2 * 1024 * 1024;
+
+        int madviseFlag(MappedFile::Advice advice)
+        {
+            switch (advice)
+            {
+                case MappedFile::Sequential: return MADV_SEQUENTIAL;
+                case MappedFile::Random:     return MADV_RANDOM;
+                case MappedFile::WillNeed:   return MADV_WILLNEED;
+                default:                     return MADV_NORMAL;
+            }
+        }
+
+#ifdef MADV_HUGEPAGE
+        // Releases a part of the reserved range; it must start at a page.
+        void unmapReserved(char* p, std::size_t size)
+        {
+            if (::munmap(p, size) != 0)
+                log_warn(getErrnoString("munmap of reserved address range failed"));
+        }
+
+        // Maps the file to an address aligned to a huge page. Returns
+        // MAP_FAILED if it does not work; the caller maps it normally then.
+        void* mapAligned(int fd, std::size_t size)
+        {
+            std::size_t reserve = size + hugePageSize;
+            void* r = ::mmap(0, reserve, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (r == MAP_FAILED)
+                return MAP_FAILED;
+
+            char* begin = static_cast<char*>(r);
+            char* aligned = reinterpret_cast<char*>(
+                (reinterpret_cast<std::size_t>(begin) + hugePageSize - 1) & ~(hugePageSize - 1));
+
+            void* p = ::mmap(aligned, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+            if (p == MAP_FAILED)
+            {
+                ::munmap(r, reserve);
+                return MAP_FAILED;
+            }
+
+            // release the unused parts of the reserved range; the mapping
+            // of the file covers the last partial page
+            if (aligned > begin)
+                unmapReserved(begin, aligned - begin);
+
+            std::size_t pageSize = ::sysconf(_SC_PAGESIZE);
+            char* end = aligned + (size + pageSize - 1) / pageSize * pageSize;
+            if (end < begin + reserve)
+                unmapReserved(end, begin + reserve - end);
+
+            return p;
+        }
+#endif
+    }
+
+    const std::size_t MappedFile::hugePageThreshold = 32 * 1024 * 1024;
+
+    MappedFile::MappedFile()
+        : _data(0),
+          _size(0),
+          _isOpen(false),
+          _hugePages(false)
+    { }
+
+    MappedFile::MappedFile(const std::string& fname, Advice advice)
+        : _data(0),
+          _size(0),
+          _isOpen(false),
+          _hugePages(false)
+    {
+        open(fname, advice);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+    void MappedFile::open(const std::string& fname, Advice advice)
+    {
+        close();
+
+        int fd = ::open(fname.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            if (errno == ENOENT)
+                throw FileNotFound(fname);
+            throw AccessFailed(getErrnoString(("open file \"" + fname + "\" failed").c_str()));
+        }
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0)
+        {
+            std::string msg = getErrnoString("fstat failed");
+            ::close(fd);
+            throw IOError(msg);
+        }
+
+        std::size_t size = st.st_size;
+        void* p = MAP_FAILED;
+        bool hugePages = false;
+
+        if (size > 0)
+        {
+#ifdef MADV_HUGEPAGE
+            if (size >= hugePageThreshold)
+            {
+                p = mapAligned(fd, size);
+                hugePages = p != MAP_FAILED && ::madvise(p, size, MADV_HUGEPAGE) == 0;
+                log_debug("map file \"" << fname << "\" aligned; huge pages advice accepted " << hugePages);
+            }
+#endif
+
+            if (p == MAP_FAILED)
+                p = ::mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (p == MAP_FAILED)
+            {
+                std::string msg = getErrnoString("mmap failed");
+                ::close(fd);
+                throw IOError(msg);
+            }
+        }
+
+        ::close(fd);
+
+        _data = size > 0 ? static_cast<const char*>(p) : 0;
+        _size = size;
+        _isOpen = true;
+        _hugePages = hugePages;
+
+        log_debug("mapped file \"" << fname << "\" size " << size);
+
+        advise(advice);
+    }
+
+    void MappedFile::close()
+    {
+        if (_data)
+            ::munmap(const_cast<char*>(_data), _size);
+
+        _data = 0;
+        _size = 0;
+        _isOpen = false;
+        _hugePages = false;
+    }
+
+    void MappedFile::advise(Advice advice)
+    {
+        advise(advice, 0, _size);
+    }
+
+    void MappedFile::advise(Advice advice, std::size_t offset, std::size_t size)
+    {
+        if (_data == 0 || offset >= _size)
+            return;
+
+        if (size > _size - offset)
+            size = _size - offset;
+
+        // madvise needs an address aligned to a page
+        std::size_t pageSize = ::sysconf(_SC_PAGESIZE);
+        std::size_t skip = offset % pageSize;
+
+        if (::madvise(const_cast<char*>(_data) + offset - skip, size + skip, madviseFlag(advice)) != 0)
+            log_debug(getErrnoString("madvise failed"));
+    }
+
+    MappedStreambuf::MappedStreambuf(const char* data, std::size_t size)
+    {
+        char* p = const_cast<char*>(data);
+        setg(p, p, p + size);
+    }
+
+    MappedStreambuf::MappedStreambuf(const MappedFile& file)
+    {
+        char* p = const_cast<char*>(file.data());
+        setg(p, p, p + file.size());
+    }
+
+    MappedStreambuf::int_type MappedStreambuf::underflow()
+    {
+        return traits_type::eof();
+    }
+
+    std::streamsize MappedStreambuf::showmanyc()
+    {
+        return gptr() < egptr() ? egptr() - gptr() : -1;
+    }
+
+    MappedStreambuf::pos_type MappedStreambuf::seekoff(off_type off,
+        std::ios_base::seekdir dir, std::ios_base::openmode which)
+    {
+        if (!(which & std::ios_base::in))
+            return pos_type(off_type(-1));
+
+        off_type pos;
+        if (dir == std::ios_base::beg)
+            pos = off;
+        else if (dir == std::ios_base::cur)
+            pos = gptr() - eback() + off;
+        else
+            pos = egptr() - eback() + off;
+
+        if (pos < 0 || pos > egptr() - eback())
+            return pos_type(off_type(-1));
+
+        setg(eback(), eback() + pos, egptr());
+        return pos_type(pos);
+    }
+
+    MappedStreambuf::pos_type MappedStreambuf::seekpos(pos_type pos,
+        std::ios_base::openmode which)
+    {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+}
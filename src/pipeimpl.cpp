@@ -114,6 +114,24 @@ size_t PipeIODevice::onWrite(const char* buffer, size_t count)
 }
 
 
+size_t PipeIODevice::onReadv(const struct iovec* iov, size_t iovcnt, bool& eof)
+{
+    return _impl.readv(iov, iovcnt, eof);
+}
+
+
+size_t PipeIODevice::onBeginWritev(const struct iovec* iov, size_t iovcnt)
+{
+    return _impl.beginWritev(iov, iovcnt);
+}
+
+
+size_t PipeIODevice::onWritev(const struct iovec* iov, size_t iovcnt)
+{
+    return _impl.writev(iov, iovcnt);
+}
+
+
 void PipeIODevice::onCancel()
 {
     _impl.cancel();
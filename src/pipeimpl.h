@@ -36,9 +36,15 @@
 
 namespace cxxtools {
 
+namespace posix
+{
+    class ProcessImpl;
+}
+
 class PipeIODevice : public IODevice
 {
         friend class PipeImpl;
+        friend class posix::ProcessImpl;
 
     public:
         PipeIODevice();
@@ -70,6 +76,12 @@ class PipeIODevice : public IODevice
 
         size_t onWrite(const char* buffer, size_t count);
 
+        size_t onReadv(const struct iovec* iov, size_t iovcnt, bool& eof);
+
+        size_t onBeginWritev(const struct iovec* iov, size_t iovcnt);
+
+        size_t onWritev(const struct iovec* iov, size_t iovcnt);
+
         void onCancel();
 
         void onSync() const;
@@ -0,0 +1,467 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/posix/process.h>
+#include <cxxtools/systemerror.h>
+#include <cxxtools/log.h>
+#include "../pipeimpl.h"
+#include "config.h"
+#include <stdexcept>
+#include <vector>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+log_define("cxxtools.process")
+
+namespace cxxtools
+{
+  namespace posix
+  {
+    namespace
+    {
+      // creates a pipe, which is not inherited by child processes
+      void createPipe(int fds[2])
+      {
+#ifdef HAVE_PIPE2
+        if (::pipe2(fds, O_CLOEXEC) == 0)
+          return;
+        if (errno != ENOSYS)
+          throw SystemError("pipe2");
+#endif
+        if (::pipe(fds) != 0)
+          throw SystemError("pipe");
+
+        ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+      }
+
+      // The child end of a pipe is duplicated to 0, 1 or 2 in the child. When
+      // the parent has closed its standard streams, the pipe may already have
+      // that number. Then dup2 does not clear the close on exec flag, so the
+      // descriptor is moved out of the way.
+      int moveAboveStdio(int fd)
+      {
+        if (fd > 2)
+          return fd;
+
+        int newFd = ::fcntl(fd, F_DUPFD_CLOEXEC, 3);
+        if (newFd < 0)
+          throw SystemError("fcntl");
+
+        ::close(fd);
+        return newFd;
+      }
+
+      class SpawnFileActions
+      {
+          posix_spawn_file_actions_t _actions;
+
+        public:
+          SpawnFileActions()
+          { ::posix_spawn_file_actions_init(&_actions); }
+
+          ~SpawnFileActions()
+          { ::posix_spawn_file_actions_destroy(&_actions); }
+
+          void dup2(int fd, int newFd)
+          {
+            int ret = ::posix_spawn_file_actions_adddup2(&_actions, fd, newFd);
+            if (ret != 0)
+              throw SystemError(ret, "posix_spawn_file_actions_adddup2");
+          }
+
+          void open(int fd, const char* path, int flags)
+          {
+            int ret = ::posix_spawn_file_actions_addopen(&_actions, fd, path, flags, 0);
+            if (ret != 0)
+              throw SystemError(ret, "posix_spawn_file_actions_addopen");
+          }
+
+          const posix_spawn_file_actions_t* get() const
+          { return &_actions; }
+      };
+
+      class SpawnAttr
+      {
+          posix_spawnattr_t _attr;
+
+        public:
+          SpawnAttr()
+          {
+            ::posix_spawnattr_init(&_attr);
+
+            // the child starts with no blocked signals and the default
+            // handling of SIGPIPE, regardless of what the parent has set
+            sigset_t mask;
+            sigemptyset(&mask);
+            ::posix_spawnattr_setsigmask(&_attr, &mask);
+
+            sigset_t def;
+            sigemptyset(&def);
+            sigaddset(&def, SIGPIPE);
+            ::posix_spawnattr_setsigdefault(&_attr, &def);
+
+            ::posix_spawnattr_setflags(&_attr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+          }
+
+          ~SpawnAttr()
+          { ::posix_spawnattr_destroy(&_attr); }
+
+          const posix_spawnattr_t* get() const
+          { return &_attr; }
+      };
+    }
+
+    class ProcessImpl
+    {
+        std::vector<std::string> _args;
+        std::vector<std::string> _env;
+        Process::Mode _mode[3];
+        PipeIODevice _device[3];
+        int _childFd[3];
+        pid_t _pid;
+
+        void closeChildFds();
+
+      public:
+        explicit ProcessImpl(const std::string& cmd)
+          : _pid(0)
+        {
+          _args.push_back(cmd);
+          _mode[0] = Process::Capture;
+          _mode[1] = Process::Capture;
+          _mode[2] = Process::Inherit;
+          _childFd[0] = _childFd[1] = _childFd[2] = -1;
+        }
+
+        ~ProcessImpl();
+
+        void push_back(const std::string& arg)
+        { _args.push_back(arg); }
+
+        void setEnv(const std::string& name, const std::string& value);
+
+        void setMode(int fd, Process::Mode mode)
+        { _mode[fd] = mode; }
+
+        void start();
+
+        pid_t pid() const
+        { return _pid; }
+
+        IODevice& device(int fd)
+        { return _device[fd]; }
+
+        int wait();
+
+        bool tryWait(int& status);
+
+        void kill(int signo);
+    };
+
+    ProcessImpl::~ProcessImpl()
+    {
+      closeChildFds();
+
+      // let the child see eof on its stdin before waiting for it
+      for (unsigned n = 0; n < 3; ++n)
+      {
+        try
+        {
+          _device[n].close();
+        }
+        catch (const std::exception& e)
+        {
+          log_debug("ignore exception in closing pipe: " << e.what());
+        }
+      }
+
+      if (_pid)
+      {
+        int status;
+        while (::waitpid(_pid, &status, 0) < 0 && errno == EINTR)
+          ;
+      }
+    }
+
+    void ProcessImpl::closeChildFds()
+    {
+      for (unsigned n = 0; n < 3; ++n)
+      {
+        if (_childFd[n] >= 0)
+        {
+          ::close(_childFd[n]);
+          _childFd[n] = -1;
+        }
+      }
+    }
+
+    void ProcessImpl::setEnv(const std::string& name, const std::string& value)
+    {
+      std::string prefix = name + '=';
+      for (unsigned n = 0; n < _env.size(); ++n)
+      {
+        if (_env[n].compare(0, prefix.size(), prefix) == 0)
+        {
+          _env[n] = prefix + value;
+          return;
+        }
+      }
+
+      _env.push_back(prefix + value);
+    }
+
+    void ProcessImpl::start()
+    {
+      if (_pid)
+        throw std::logic_error("process " + _args[0] + " already started");
+
+      SpawnFileActions actions;
+      SpawnAttr attr;
+
+      try
+      {
+        for (int n = 0; n < 3; ++n)
+        {
+          switch (_mode[n])
+          {
+            case Process::Inherit:
+              break;
+
+            case Process::Capture:
+            {
+              int fds[2];
+              createPipe(fds);
+
+              // stdin is the read end for the child, stdout and stderr the write end
+              int parentFd = n == 0 ? fds[1] : fds[0];
+              _childFd[n] = n == 0 ? fds[0] : fds[1];
+
+              _device[n].open(parentFd, true);
+              _childFd[n] = moveAboveStdio(_childFd[n]);
+              actions.dup2(_childFd[n], n);
+              break;
+            }
+
+            case Process::Discard:
+              actions.open(n, "/dev/null", n == 0 ? O_RDONLY : O_WRONLY);
+              break;
+
+            case Process::Combine:
+              if (n != 2)
+                throw std::invalid_argument("only stderr can be combined with stdout");
+              actions.dup2(1, 2);
+              break;
+          }
+        }
+
+        std::vector<char*> argv;
+        for (unsigned n = 0; n < _args.size(); ++n)
+          argv.push_back(const_cast<char*>(_args[n].c_str()));
+        argv.push_back(0);
+
+        std::vector<char*> envp;
+        if (!_env.empty())
+        {
+          for (char** e = environ; *e; ++e)
+          {
+            const char* eq = std::strchr(*e, '=');
+            std::string::size_type len = eq ? eq - *e + 1 : std::strlen(*e);
+
+            bool overridden = false;
+            for (unsigned n = 0; !overridden && n < _env.size(); ++n)
+              overridden = _env[n].size() >= len && _env[n].compare(0, len, *e, len) == 0;
+
+            if (!overridden)
+              envp.push_back(*e);
+          }
+
+          for (unsigned n = 0; n < _env.size(); ++n)
+            envp.push_back(const_cast<char*>(_env[n].c_str()));
+          envp.push_back(0);
+        }
+
+        log_debug("spawn " << _args[0]);
+
+        pid_t pid;
+        int ret = ::posix_spawnp(&pid, argv[0], actions.get(), attr.get(),
+                                 &argv[0], envp.empty() ? environ : &envp[0]);
+        if (ret != 0)
+          throw SystemError(ret, "posix_spawnp");
+
+        log_debug("process " << _args[0] << " started with pid " << pid);
+
+        _pid = pid;
+      }
+      catch (...)
+      {
+        closeChildFds();
+        for (unsigned n = 0; n < 3; ++n)
+          _device[n].close();
+        throw;
+      }
+
+      closeChildFds();
+    }
+
+    int ProcessImpl::wait()
+    {
+      if (!_pid)
+        throw std::logic_error("process " + _args[0] + " not running");
+
+      int status;
+      while (::waitpid(_pid, &status, 0) < 0)
+      {
+        if (errno != EINTR)
+          throw SystemError("waitpid");
+      }
+
+      log_debug("process " << _pid << " terminated with status " << status);
+
+      _pid = 0;
+      return status;
+    }
+
+    bool ProcessImpl::tryWait(int& status)
+    {
+      if (!_pid)
+        throw std::logic_error("process " + _args[0] + " not running");
+
+      pid_t ret = ::waitpid(_pid, &status, WNOHANG);
+      if (ret < 0)
+        throw SystemError("waitpid");
+
+      if (ret == 0)
+        return false;
+
+      log_debug("process " << _pid << " terminated with status " << status);
+
+      _pid = 0;
+      return true;
+    }
+
+    void ProcessImpl::kill(int signo)
+    {
+      if (!_pid)
+        throw std::logic_error("process " + _args[0] + " not running");
+
+      if (::kill(_pid, signo) != 0)
+        throw SystemError("kill");
+    }
+
+    ////////////////////////////////////////////////////////////////////////
+    // Process
+    //
+    Process::Process(const std::string& cmd)
+      : _impl(new ProcessImpl(cmd))
+    { }
+
+    Process::~Process()
+    {
+      delete _impl;
+    }
+
+    Process& Process::push_back(const std::string& arg)
+    {
+      _impl->push_back(arg);
+      return *this;
+    }
+
+    Process& Process::setEnv(const std::string& name, const std::string& value)
+    {
+      _impl->setEnv(name, value);
+      return *this;
+    }
+
+    void Process::setStdin(Mode mode)
+    {
+      _impl->setMode(0, mode);
+    }
+
+    void Process::setStdout(Mode mode)
+    {
+      _impl->setMode(1, mode);
+    }
+
+    void Process::setStderr(Mode mode)
+    {
+      _impl->setMode(2, mode);
+    }
+
+    void Process::start()
+    {
+      _impl->start();
+    }
+
+    pid_t Process::pid() const
+    {
+      return _impl->pid();
+    }
+
+    bool Process::running() const
+    {
+      return _impl->pid() != 0;
+    }
+
+    IODevice& Process::stdIn()
+    {
+      return _impl->device(0);
+    }
+
+    IODevice& Process::stdOut()
+    {
+      return _impl->device(1);
+    }
+
+    IODevice& Process::stdErr()
+    {
+      return _impl->device(2);
+    }
+
+    int Process::wait()
+    {
+      return _impl->wait();
+    }
+
+    bool Process::tryWait(int& status)
+    {
+      return _impl->tryWait(status);
+    }
+
+    void Process::kill(int signo)
+    {
+      _impl->kill(signo);
+    }
+  }
+}
@@ -28,7 +28,8 @@
 
 #include <cxxtools/propertiesfile.h>
 #include <cxxtools/propertiesparser.h>
-#include <fstream>
+#include <cxxtools/mappedfile.h>
+#include <cxxtools/ioerror.h>
 
 namespace cxxtools
 {
@@ -69,10 +70,19 @@ namespace cxxtools
 
   PropertiesFile::PropertiesFile(const std::string& filename)
   {
-    PropertiesEvent ev(*this);
-    std::ifstream in(filename.c_str());
-    if (!in)
+    MappedFile file;
+    try
+    {
+      file.open(filename);
+    }
+    catch (const AccessFailed&)
+    {
       throw PropertiesParserError("could not open properties file \"" + filename + '"');
+    }
+
+    PropertiesEvent ev(*this);
+    MappedStreambuf sb(file);
+    std::istream in(&sb);
     PropertiesParser(ev).parse(in);
   }
 
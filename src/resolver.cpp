@@ -0,0 +1,335 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "resolver.h"
+#include <cxxtools/thread.h>
+#include <cxxtools/mutex.h>
+#include <cxxtools/condition.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/systemerror.h>
+#include <cxxtools/log.h>
+#include <deque>
+#include <map>
+#include <sstream>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include "config.h"
+#ifdef HAVE_SYS_EVENTFD_H
+#include <sys/eventfd.h>
+#include <stdint.h>
+#endif
+
+log_define("cxxtools.net.resolver")
+
+namespace cxxtools
+{
+
+namespace net
+{
+
+namespace
+{
+  // number of threads, which run getaddrinfo concurrently
+  const unsigned maxResolverThreads = 4;
+
+  // the cache is cleaned up, when it grows larger than this
+  const unsigned maxCacheSize = 256;
+
+  struct CacheEntry
+  {
+    SmartPtr<AddrInfoList> list;
+    Timespan expires;
+  };
+
+  typedef std::map<std::string, CacheEntry> CacheType;
+
+  struct ResolverState
+  {
+    Mutex mutex;
+    Condition jobAvailable;
+    std::deque<ResolveJob*> jobs;
+    unsigned threads;
+    unsigned idle;
+
+    Mutex cacheMutex;
+    CacheType cache;
+    Timespan cacheTimeout;
+
+    ResolverState()
+      : threads(0),
+        idle(0),
+        cacheTimeout(Seconds(60))
+      { }
+  };
+
+  // the resolver threads run until the process ends, so the state is never destroyed
+  ResolverState& resolverState()
+  {
+    static ResolverState* s = new ResolverState();
+    return *s;
+  }
+
+  std::string cacheKey(const std::string& host, const std::string& service,
+                       const struct addrinfo& hints)
+  {
+    std::ostringstream key;
+    key << host << '\0' << service << '\0'
+        << hints.ai_flags << ':' << hints.ai_family << ':'
+        << hints.ai_socktype << ':' << hints.ai_protocol;
+    return key.str();
+  }
+
+  void cachePut(const std::string& key, const SmartPtr<AddrInfoList>& list)
+  {
+    ResolverState& s = resolverState();
+    MutexLock lock(s.cacheMutex);
+
+    if (s.cacheTimeout <= Timespan(0))
+      return;
+
+    Timespan now = Clock::getSystemTicks();
+
+    if (s.cache.size() >= maxCacheSize)
+    {
+      for (CacheType::iterator it = s.cache.begin(); it != s.cache.end(); )
+      {
+        if (it->second.expires <= now)
+          s.cache.erase(it++);
+        else
+          ++it;
+      }
+
+      if (s.cache.size() >= maxCacheSize)
+        s.cache.clear();
+    }
+
+    CacheEntry& entry = s.cache[key];
+    entry.list = list;
+    entry.expires = now + s.cacheTimeout;
+  }
+
+  SmartPtr<AddrInfoList> cacheGet(const std::string& key)
+  {
+    ResolverState& s = resolverState();
+    MutexLock lock(s.cacheMutex);
+
+    CacheType::iterator it = s.cache.find(key);
+    if (it == s.cache.end())
+      return SmartPtr<AddrInfoList>();
+
+    if (it->second.expires <= Clock::getSystemTicks())
+    {
+      s.cache.erase(it);
+      return SmartPtr<AddrInfoList>();
+    }
+
+    return it->second.list;
+  }
+
+  class ResolverThread : public DetachedThread
+  {
+    protected:
+      void run()
+      {
+        ResolverState& s = resolverState();
+
+        while (true)
+        {
+          MutexLock lock(s.mutex);
+
+          ++s.idle;
+          while (s.jobs.empty())
+            s.jobAvailable.wait(lock);
+          --s.idle;
+
+          ResolveJob* job = s.jobs.front();
+          s.jobs.pop_front();
+
+          lock.unlock();
+
+          job->run();
+
+          if (job->release() == 0)
+            delete job;
+        }
+      }
+  };
+}
+
+////////////////////////////////////////////////////////////////////////
+// ResolveJob
+//
+ResolveJob::ResolveJob(const std::string& host, const std::string& service,
+                       const struct addrinfo& hints)
+  : _host(host),
+    _service(service),
+    _hints(hints),
+    _done(0),
+    _error(0)
+{
+#ifdef HAVE_SYS_EVENTFD_H
+  _fd[0] = _fd[1] = ::eventfd(0, EFD_CLOEXEC);
+  if (_fd[0] >= 0)
+    return;
+#endif
+
+  if (::pipe(_fd) != 0)
+    throw SystemError("pipe");
+
+  ::fcntl(_fd[0], F_SETFD, FD_CLOEXEC);
+  ::fcntl(_fd[1], F_SETFD, FD_CLOEXEC);
+}
+
+ResolveJob::~ResolveJob()
+{
+  ::close(_fd[0]);
+  if (_fd[1] != _fd[0])
+    ::close(_fd[1]);
+}
+
+void ResolveJob::run()
+{
+  log_debug("resolve host \"" << _host << "\" service \"" << _service << '"');
+
+  struct addrinfo* ai = 0;
+  _error = ::getaddrinfo(_host.empty() ? 0 : _host.c_str(), _service.c_str(), &_hints, &ai);
+  if (_error == 0)
+  {
+    _result = new AddrInfoList(ai);
+    cachePut(cacheKey(_host, _service, _hints), _result);
+  }
+  else
+    log_debug("resolving host \"" << _host << "\" failed: " << gai_strerror(_error));
+
+  atomicSet(_done, 1);
+
+  // the descriptor stays readable, so that every waiting selector sees it
+#ifdef HAVE_SYS_EVENTFD_H
+  if (_fd[0] == _fd[1])
+  {
+    uint64_t one = 1;
+    ::write(_fd[1], &one, sizeof(one));
+    return;
+  }
+#endif
+
+  ::write(_fd[1], "R", 1);
+}
+
+void ResolveJob::wait() const
+{
+  while (!done())
+  {
+    pollfd pfd;
+    pfd.fd = _fd[0];
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    if (::poll(&pfd, 1, -1) < 0 && errno != EINTR)
+      throw SystemError("poll");
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+// Resolver
+//
+SmartPtr<AddrInfoList> Resolver::lookup(const std::string& host,
+    const std::string& service, const struct addrinfo& hints)
+{
+  SmartPtr<AddrInfoList> list = cacheGet(cacheKey(host, service, hints));
+  if (list)
+  {
+    log_debug("host \"" << host << "\" found in cache");
+    return list;
+  }
+
+  // numeric addresses and the local host need no name service
+  struct addrinfo numericHints = hints;
+  if (!host.empty())
+    numericHints.ai_flags |= AI_NUMERICHOST;
+
+  struct addrinfo* ai = 0;
+  if (::getaddrinfo(host.empty() ? 0 : host.c_str(), service.c_str(), &numericHints, &ai) == 0)
+    list = new AddrInfoList(ai);
+
+  return list;
+}
+
+SmartPtr<ResolveJob> Resolver::beginResolve(const std::string& host,
+    const std::string& service, const struct addrinfo& hints)
+{
+  SmartPtr<ResolveJob> job(new ResolveJob(host, service, hints));
+
+  ResolverState& s = resolverState();
+  MutexLock lock(s.mutex);
+
+  // the reference of the queue is released by the resolver thread
+  job->addRef();
+  s.jobs.push_back(job.getPointer());
+
+  if (s.idle < s.jobs.size() && s.threads < maxResolverThreads)
+  {
+    log_debug("start resolver thread " << s.threads);
+    ResolverThread* thread = new ResolverThread();
+    thread->start();
+    ++s.threads;
+  }
+
+  s.jobAvailable.signal();
+
+  return job;
+}
+
+void Resolver::cacheTimeout(Timespan t)
+{
+  ResolverState& s = resolverState();
+  MutexLock lock(s.cacheMutex);
+  s.cacheTimeout = t;
+  if (t <= Timespan(0))
+    s.cache.clear();
+}
+
+Timespan Resolver::cacheTimeout()
+{
+  ResolverState& s = resolverState();
+  MutexLock lock(s.cacheMutex);
+  return s.cacheTimeout;
+}
+
+void Resolver::clearCache()
+{
+  ResolverState& s = resolverState();
+  MutexLock lock(s.cacheMutex);
+  s.cache.clear();
+}
+
+} // namespace net
+
+} // namespace cxxtools
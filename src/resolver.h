@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_NET_RESOLVER_H
+#define CXXTOOLS_NET_RESOLVER_H
+
+#include <cxxtools/refcounted.h>
+#include <cxxtools/smartptr.h>
+#include <cxxtools/timespan.h>
+#include <cxxtools/atomicity.h>
+#include <string>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netdb.h>
+
+namespace cxxtools
+{
+
+namespace net
+{
+
+  /// Result of getaddrinfo shared by the cache and the AddrInfoImpl objects.
+  class AddrInfoList : public AtomicRefCounted
+  {
+      struct addrinfo* _ai;
+
+    public:
+      explicit AddrInfoList(struct addrinfo* ai)
+        : _ai(ai)
+        { }
+      ~AddrInfoList()
+      {
+        if (_ai)
+          freeaddrinfo(_ai);
+      }
+
+      struct addrinfo* get() const  { return _ai; }
+  };
+
+  /** Host name lookup, which runs in a resolver thread.
+
+      The file descriptor becomes readable, when the lookup is finished, so
+      that a selector can wait for it.
+   */
+  class ResolveJob : public AtomicRefCounted
+  {
+      std::string _host;
+      std::string _service;
+      struct addrinfo _hints;
+
+      int _fd[2];
+      volatile atomic_t _done;
+      int _error;
+      SmartPtr<AddrInfoList> _result;
+
+    public:
+      ResolveJob(const std::string& host, const std::string& service,
+                 const struct addrinfo& hints);
+      ~ResolveJob();
+
+      /// Runs getaddrinfo and signals the file descriptor.
+      void run();
+
+      bool done() const
+      { return atomicGet(const_cast<volatile atomic_t&>(_done)) != 0; }
+
+      /// Waits until the lookup is finished.
+      void wait() const;
+
+      /// The error code of getaddrinfo or 0 on success.
+      int error() const                           { return _error; }
+      const SmartPtr<AddrInfoList>& result() const  { return _result; }
+
+      int fd() const  { return _fd[0]; }
+  };
+
+  /** Resolves host names using a small pool of threads.
+
+      Successful lookups are kept in a cache for some time.
+   */
+  class Resolver
+  {
+    public:
+      /// Returns the cached result or the result for a numeric host without
+      /// blocking. Returns a null pointer, when a lookup is needed.
+      static SmartPtr<AddrInfoList> lookup(const std::string& host,
+          const std::string& service, const struct addrinfo& hints);
+
+      /// Starts a lookup in a resolver thread.
+      static SmartPtr<ResolveJob> beginResolve(const std::string& host,
+          const std::string& service, const struct addrinfo& hints);
+
+      static void cacheTimeout(Timespan t);
+      static Timespan cacheTimeout();
+      static void clearCache();
+  };
+
+} // namespace net
+
+} // namespace cxxtools
+
+#endif // CXXTOOLS_NET_RESOLVER_H
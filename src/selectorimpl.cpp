@@ -28,6 +28,7 @@
 
 #include "selectorimpl.h"
 #include "selectableimpl.h"
+#include "iouring.h"
 #include "cxxtools/ioerror.h"
 #include "cxxtools/systemerror.h"
 #include "cxxtools/selector.h"
@@ -41,6 +42,10 @@
 #include <limits>
 #include "config.h"
 #include "poll.h"
+#ifdef HAVE_SYS_EVENTFD_H
+#include <sys/eventfd.h>
+#include <stdint.h>
+#endif
 
 log_define("cxxtools.selector.impl")
 
@@ -50,29 +55,50 @@ namespace cxxtools
 const short SelectorImpl::POLL_ERROR_MASK= POLLERR | POLLHUP | POLLNVAL;
 
 SelectorImpl::SelectorImpl()
-: _isDirty(true)
+: _wakePending(0),
+  _isDirty(true)
 {
     _current = _devices.end();
 
+#ifdef HAVE_SYS_EVENTFD_H
+    // an eventfd needs only one file descriptor and no buffer; it must not
+    // be inherited by child processes
+    int fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd >= 0)
+    {
+        _wakePipe[0] = _wakePipe[1] = fd;
+        return;
+    }
+
+    log_debug("eventfd failed; use pipe");
+#endif
+
     //Open a pipe to send wake up message.
+#ifdef HAVE_PIPE2
+    if (::pipe2(_wakePipe, O_NONBLOCK | O_CLOEXEC) == 0)
+        return;
+
+    if (errno != ENOSYS)
+        throwSystemError("pipe2");
+#endif
+
     if( ::pipe( _wakePipe ) )
         throwSystemError("pipe");
 
-    int flags = ::fcntl(_wakePipe[0], F_GETFL);
-    if(-1 == flags)
-        throwSystemError("fcntl");
-
-    int ret = ::fcntl(_wakePipe[0], F_SETFL, flags|O_NONBLOCK);
-    if(-1 == ret)
-        throwSystemError("fcntl");
+    for (unsigned n = 0; n < 2; ++n)
+    {
+        int flags = ::fcntl(_wakePipe[n], F_GETFL);
+        if(-1 == flags)
+            throwSystemError("fcntl");
 
-    flags = ::fcntl(_wakePipe[1], F_GETFL);
-    if(-1 == flags)
-        throwSystemError("fcntl");
+        int ret = ::fcntl(_wakePipe[n], F_SETFL, flags|O_NONBLOCK);
+        if(-1 == ret)
+            throwSystemError("fcntl");
 
-    ret = ::fcntl(_wakePipe[1], F_SETFL, flags|O_NONBLOCK);
-    if(-1 == ret)
-        throwSystemError("fcntl");
+        ret = ::fcntl(_wakePipe[n], F_SETFD, FD_CLOEXEC);
+        if(-1 == ret)
+            throwSystemError("fcntl");
+    }
 
 }
 
@@ -89,7 +115,8 @@ SelectorImpl::~SelectorImpl()
     if( _wakePipe[0] != -1 && _wakePipe[1] != -1 )
     {
         ::close(_wakePipe[0]);
-        ::close(_wakePipe[1]);
+        if (_wakePipe[1] != _wakePipe[0])
+            ::close(_wakePipe[1]);
     }
 }
 
@@ -186,6 +213,9 @@ bool SelectorImpl::waitUntil(Timespan until)
         _isDirty= false;
     }
 
+    // submit the io_uring requests queued by the devices since the last wait
+    IoUring::flush();
+
 #ifdef HAVE_PPOLL
     struct timespec pollTimeout = { 0, 0 };
     struct timespec* pollTimeoutP = 0;
@@ -271,6 +301,9 @@ bool SelectorImpl::waitUntil(Timespan until)
 
                 throw IOError("Could not read from pipe");
             }
+
+            // the pipe is empty now, so the next wake must write again
+            atomicSet(_wakePending, 0);
         }
 
         for( _current = _devices.begin(); _current != _devices.end(); )
@@ -303,6 +336,19 @@ bool SelectorImpl::waitUntil(Timespan until)
 
 void SelectorImpl::wake()
 {
+    // coalesce wakes until the selector has read the pipe
+    if (atomicExchange(_wakePending, 1) != 0)
+        return;
+
+#ifdef HAVE_SYS_EVENTFD_H
+    if (_wakePipe[0] == _wakePipe[1])
+    {
+        uint64_t one = 1;
+        ::write(_wakePipe[1], &one, sizeof(one));
+        return;
+    }
+#endif
+
     ::write( _wakePipe[1], "W", 1);
     ::fsync( _wakePipe[1] );
 }
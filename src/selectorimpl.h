@@ -32,6 +32,7 @@
 #include <cxxtools/selectable.h>
 #include <cxxtools/timespan.h>
 #include <cxxtools/clock.h>
+#include <cxxtools/atomicity.h>
 #include <sys/poll.h>
 #include <vector>
 #include <set>
@@ -57,7 +58,10 @@ class SelectorImpl
 
     private:
         static const short POLL_ERROR_MASK;
+        // pipe or eventfd (in both elements) to wake up poll
         int _wakePipe[2];
+        // set when a wake is pending; further wakes need no system call
+        volatile atomic_t _wakePending;
         bool _isDirty;
         std::vector<pollfd> _pollfds;
         std::set<Selectable*>::iterator _current;
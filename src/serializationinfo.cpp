@@ -476,6 +476,30 @@ void SerializationInfo::_setString8(const char* value)
     _category = Value;
 }
 
+void SerializationInfo::setValue(const CompactString& value)
+{
+    // other characters are kept unicode since String widens bytes >= 0x80 like Char(char)
+    if (value.isAscii())
+    {
+        if (_t != t_string8)
+        {
+            _releaseValue();
+            new (_String8Ptr()) std::string(value.data(), value.byteSize());
+            _t = t_string8;
+        }
+        else
+        {
+            _String8().assign(value.data(), value.byteSize());
+        }
+
+        _category = Value;
+    }
+    else
+    {
+        _setString(value.toString());
+    }
+}
+
 void SerializationInfo::_setChar(char value)
 {
     if (_t != t_char)
@@ -572,6 +596,22 @@ void SerializationInfo::getValue(std::string& value) const
     }
 }
 
+void SerializationInfo::getValue(CompactString& value) const
+{
+    switch (_t)
+    {
+        case t_string:  value.assign(_String()); break;
+        case t_string8: value = CompactString::fromLatin1(_String8()); break;
+        case t_char:    value = CompactString::fromLatin1(&_u._c, 1); break;
+        default:
+        {
+            String s;
+            getValue(s);
+            value.assign(s);
+        }
+    }
+}
+
 namespace
 {
     inline bool isFalse(char c)
@@ -785,6 +825,56 @@ long double SerializationInfo::_getFloat(const char* type, long double max) cons
     return ret;
 }
 
+double SerializationInfo::_getDouble(const char* type, double max) const
+{
+    if (_t != t_string && _t != t_string8)
+        return static_cast<double>(_getFloat(type, static_cast<long double>(max) * 1.0000000000001));
+
+    // strings are parsed as double directly, so that they are rounded just once
+    double ret = 0;
+    bool isInf = false;
+
+    if (_t == t_string)
+    {
+        try
+        {
+            ret = convert<double>(_String());
+        }
+        catch (const ConversionError&)
+        {
+            ConversionError::doThrow(type, "String", _String().narrow().c_str());
+        }
+
+        isInf = _String().find(L'i') != String::npos || _String().find(L'I') != String::npos;
+    }
+    else
+    {
+        try
+        {
+            ret = convert<double>(_String8());
+        }
+        catch (const ConversionError&)
+        {
+            ConversionError::doThrow(type, "string", _String8().c_str());
+        }
+
+        isInf = _String8().find_first_of("iI") != std::string::npos;
+    }
+
+    // values too large for double are parsed as infinity
+    if ((ret == std::numeric_limits<double>::infinity()
+            || ret == -std::numeric_limits<double>::infinity())
+        ? !isInf
+        : (ret < -max * 1.0000000000001 || ret > max * 1.0000000000001))
+    {
+        std::ostringstream msg;
+        msg << "value " << ret << " does not fit into " << type;
+        throw std::range_error(msg.str());
+    }
+
+    return ret;
+}
+
 SerializationInfo::Nodes& SerializationInfo::nodes()
 {
     if (!_nodes)
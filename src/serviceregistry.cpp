@@ -34,7 +34,7 @@ namespace cxxtools
 ServiceRegistry::~ServiceRegistry()
 {
     ProcedureMap::iterator it;
-    for(it = _procedures.begin(); it != _procedures.end(); ++it)
+    for(it = _procedures->begin(); it != _procedures->end(); ++it)
     {
         delete it->second;
     }
@@ -42,8 +42,11 @@ ServiceRegistry::~ServiceRegistry()
 
 ServiceProcedure* ServiceRegistry::getProcedure(const std::string& name) const
 {
-    ProcedureMap::const_iterator it = _procedures.find( name );
-    if( it == _procedures.end() )
+    EpochReadLock lock;
+
+    const ProcedureMap* procedures = _procedures.get();
+    ProcedureMap::const_iterator it = procedures->find( name );
+    if( it == procedures->end() )
     {
         return 0;
     }
@@ -62,7 +65,10 @@ std::vector<std::string> ServiceRegistry::getProcedureNames() const
 {
     std::vector<std::string> procs;
 
-    for (ProcedureMap::const_iterator it = _procedures.begin(); it != _procedures.end(); ++it)
+    EpochReadLock lock;
+
+    const ProcedureMap* procedures = _procedures.get();
+    for (ProcedureMap::const_iterator it = procedures->begin(); it != procedures->end(); ++it)
     {
         procs.push_back(it->first);
     }
@@ -73,16 +79,23 @@ std::vector<std::string> ServiceRegistry::getProcedureNames() const
 
 void ServiceRegistry::registerProcedure(const std::string& name, ServiceProcedure* proc)
 {
-    ProcedureMap::iterator it = _procedures.find(name);
-    if (it == _procedures.end())
+    MutexLock lock(_mutex);
+
+    ProcedureMap* procedures = new ProcedureMap(*_procedures);
+    ProcedureMap::iterator it = procedures->find(name);
+    if (it == procedures->end())
     {
         std::pair<const std::string, ServiceProcedure*> p( name, proc );
-        _procedures.insert( p );
+        procedures->insert( p );
+        _procedures.update(procedures);
     }
     else
     {
-        delete it->second;
+        // the old procedure may still be cloned by a concurrent lookup
+        ServiceProcedure* old = it->second;
         it->second = proc;
+        _procedures.update(procedures);
+        Epoch::deferDelete(old);
     }
 }
 
@@ -30,49 +30,22 @@
 
 namespace cxxtools {
 
-SignalBase::Sentry::Sentry(const SignalBase* signal)
-: _signal(signal)
+void SignalBase::removeInvalidTargets()
 {
-    _signal->_sentry = this;
-    _signal->_sending = true;
-    _signal->_dirty = false;
-}
-
-
-SignalBase::Sentry::~Sentry()
-{
-    if( _signal )
-        this->detach();
-}
-
-
-void SignalBase::Sentry::detach()
-{
-    _signal->_sending = false;
-
-    if( _signal->_dirty == false )
+    std::vector<Target>::size_type n = 0;
+    for (std::vector<Target>::size_type i = 0; i < _targets.size(); ++i)
     {
-        _signal->_sentry = 0;
-        _signal = 0;
-        return;
-    }
-
-    std::list<Connection>::iterator it = _signal->_connections.begin();
-    while( it != _signal->_connections.end() )
-    {
-        if( it->valid() )
+        if (_targets[i].valid())
         {
-            ++it;
-        }
-        else
-        {
-            it = _signal->_connections.erase(it);
+            if (n != i)
+                _targets[n] = _targets[i];
+            ++n;
         }
     }
 
-    _signal->_dirty = false;
-    _signal->_sentry = 0;
-    _signal = 0;
+    _targets.erase(_targets.begin() + n, _targets.end());
+
+    _dirty = false;
 }
 
 
@@ -83,11 +56,36 @@ SignalBase::SignalBase()
 { }
 
 
+SignalBase::SignalBase(const SignalBase& other)
+: Connectable(other)
+, _sentry(0)
+, _sending(false)
+, _dirty(false)
+{ }
+
+
 SignalBase::~SignalBase()
 {
-    if(_sentry)
+    // let all running sends bail out
+    for (Sentry* sentry = _sentry; sentry; sentry = sentry->_previous)
+        sentry->_signal = 0;
+
+    _sentry = 0;
+    _sending = false;
+
+    closeTargets();
+}
+
+
+void SignalBase::closeTargets()
+{
+    while( !_targets.empty() )
     {
-        _sentry->detach();
+        std::vector<Target>::size_type size = _targets.size();
+        Connection c = _targets.back().connection;
+        c.close();
+        if (_targets.size() == size)
+            _targets.pop_back();
     }
 }
 
@@ -95,18 +93,13 @@ SignalBase::~SignalBase()
 SignalBase& SignalBase::operator=(const SignalBase& other)
 {
     this->clear();
+    closeTargets();
 
-    std::list<Connection>::const_iterator it = other.connections().begin();
-    std::list<Connection>::const_iterator end = other.connections().end();
-
-    for( ; it != end; ++it)
+    for (std::vector<Target>::size_type n = 0; n < other._targets.size(); ++n)
     {
-        const Connectable& signal = it->sender();
-        if( &signal == &other)
-        {
-            const Slot& slot = it->slot();
-            Connection connection( *this, slot.clone()  );
-        }
+        const Target& target = other._targets[n];
+        if (target.valid())
+            Connection connection( *this, target.connection.slot() );
     }
 
     return *this;
@@ -115,12 +108,21 @@ SignalBase& SignalBase::operator=(const SignalBase& other)
 
 void SignalBase::onConnectionOpen(const Connection& c)
 {
-    Connectable::onConnectionOpen(c);
+    if (&c.sender() == this)
+        _targets.push_back(Target(c));
+    else
+        Connectable::onConnectionOpen(c);
 }
 
 
 void SignalBase::onConnectionClose(const Connection& c)
 {
+    if (&c.sender() != this)
+    {
+        Connectable::onConnectionClose(c);
+        return;
+    }
+
     // if the signal is currently calling its slots, do not
     // remove the connection now, but only set the cleanup flag
     // Any invalid connection objects will be removed after
@@ -128,24 +130,28 @@ void SignalBase::onConnectionClose(const Connection& c)
     if( _sending )
     {
         _dirty = true;
+        return;
     }
-    else
+
+    for (std::vector<Target>::iterator it = _targets.begin(); it != _targets.end(); ++it)
     {
-        Connectable::onConnectionClose(c);
+        if (it->connection == c)
+        {
+            _targets.erase(it);
+            return;
+        }
     }
 }
 
 
 void SignalBase::disconnectSlot(const Slot& slot)
 {
-    std::list<Connection>::iterator it = Connectable::connections().begin();
-    std::list<Connection>::iterator end = Connectable::connections().end();
-
-    for(; it != end; ++it)
+    for (std::vector<Target>::size_type n = 0; n < _targets.size(); ++n)
     {
-        if( it->slot().equals(slot) )
+        if( _targets[n].valid() && _targets[n].connection.slot().equals(slot) )
         {
-            it->close();
+            Connection c = _targets[n].connection;
+            c.close();
             return;
         }
     }
@@ -165,55 +171,27 @@ bool CompareEventTypeInfo::operator()(const std::type_info* t1,
 }
 
 
-Signal<const Event&, Void, Void, Void, Void, Void, Void, Void, Void, Void>::Sentry::Sentry(const Signal* signal)
-: _signal(signal)
-{
-    _signal->_sentry = this;
-    _signal->_sending = true;
-    _signal->_dirty = false;
-}
-
-
-Signal<const Event&, Void, Void, Void, Void, Void, Void, Void, Void, Void>::Sentry::~Sentry()
-{
-    if( _signal )
-        this->detach();
-}
-
-
-void Signal<const Event&, Void, Void, Void, Void, Void, Void, Void, Void, Void>::Sentry::detach()
+void Signal<const Event&, Void, Void, Void, Void, Void, Void, Void, Void, Void>::removeInvalidRoutes() const
 {
-    _signal->_sending = false;
-
-    if( _signal->_dirty == false )
-    {
-        _signal->_sentry = 0;
-        _signal = 0;
-        return;
-    }
-
-    Signal::RouteMap::iterator it = _signal->_routes.begin();
-    while( it != _signal->_routes.end() )
+    Routes::size_type n = 0;
+    for (Routes::size_type i = 0; i < _routes.size(); ++i)
     {
-        if( it->second->valid() )
-        {
-            ++it;
-        }
+        if (_routes[i].route->valid())
+            _routes[n++] = _routes[i];
         else
-        {
-            delete it->second;
-            _signal->_routes.erase(it++);
-        }
+            delete _routes[i].route;
     }
 
-    _signal->_dirty = false;
-    _signal->_sentry = 0;
-    _signal = 0;
+    _routes.erase(_routes.begin() + n, _routes.end());
+
+    _dispatchType = 0;
+    _dirty = false;
 }
 
 
 Signal<const Event&, Void, Void, Void, Void, Void, Void, Void, Void, Void>::Signal()
-: _sentry(0)
+: _dispatchType(0)
+, _sentry(0)
 , _sending(false)
 , _dirty(false)
 {}
@@ -221,36 +199,82 @@ Signal<const Event&, Void, Void, Void, Void, Void, Void, Void, Void, Void>::Sign
 
 Signal<const Event&, Void, Void, Void, Void, Void, Void, Void, Void, Void>::~Signal()
 {
-    if(_sentry)
-        _sentry->detach();
+    // let all running sends bail out
+    for (Sentry* sentry = _sentry; sentry; sentry = sentry->_previous)
+        sentry->_signal = 0;
+
+    _sentry = 0;
+    _sending = false;
 
     while( ! _routes.empty() )
     {
-        IEventRoute* route = _routes.begin()->second;
-        route->connection().close();
+        Routes::size_type size = _routes.size();
+        Connection c = _routes.back().route->connection();
+        c.close();
+        if (_routes.size() == size)
+        {
+            delete _routes.back().route;
+            _routes.pop_back();
+        }
     }
 }
 
 
 void Signal<const Event&, Void, Void, Void, Void, Void, Void, Void, Void, Void>::send(const cxxtools::Event& ev) const
 {
+    const std::type_info& ti = ev.typeInfo();
+
+    if (_sentry)
+    {
+        // A slot sends an event through this signal again. The dispatch
+        // table is in use by the outer send, so a temporary one is built.
+        std::vector<IEventRoute*> routes;
+
+        for (Routes::size_type n = 0; n < _routes.size(); ++n)
+            if (_routes[n].type == 0)
+                routes.push_back(_routes[n].route);
+
+        for (Routes::size_type n = 0; n < _routes.size(); ++n)
+            if (_routes[n].type != 0 && _routes[n].matches(ti))
+                routes.push_back(_routes[n].route);
+
+        Signal::Sentry sentry(this);
+        dispatch(routes, ev, sentry);
+        return;
+    }
+
+    if (_dispatchType != &ti)
+    {
+        _dispatchTable.clear();
+
+        for (Routes::size_type n = 0; n < _routes.size(); ++n)
+            if (_routes[n].type == 0)
+                _dispatchTable.push_back(_routes[n].route);
+
+        for (Routes::size_type n = 0; n < _routes.size(); ++n)
+            if (_routes[n].type != 0 && _routes[n].matches(ti))
+                _dispatchTable.push_back(_routes[n].route);
+
+        _dispatchType = &ti;
+    }
+
     // The sentry will set the Signal to the sending state and
     // reset it to not-sending upon destruction. In the sending
-    // state, removing connection will leave invalid connections
-    // in the connection list to keep the iterator valid, but mark
-    // the Signal dirty. If the Signal is dirty, all invalid
-    // connections will be removed by the Sentry when it destructs..
+    // state, removing connection will leave invalid routes
+    // in place, but mark the Signal dirty. If the Signal is dirty,
+    // all invalid routes will be removed by the Sentry when it destructs.
     Signal::Sentry sentry(this);
+    dispatch(_dispatchTable, ev, sentry);
+}
 
-    RouteMap::iterator it = _routes.begin();
-    while( true )
-    {
-        if( it == _routes.end() )
-            return;
-
-        if(it->first != 0)
-            break;
 
+void Signal<const Event&, Void, Void, Void, Void, Void, Void, Void, Void, Void>::dispatch(
+    const std::vector<IEventRoute*>& routes, const cxxtools::Event& ev, const Sentry& sentry) const
+{
+    // The table is not modified while sending. Routes added in a slot
+    // receive events from the next send on.
+    for (std::vector<IEventRoute*>::size_type n = 0; n < routes.size(); ++n)
+    {
         // The following scenarios must be considered when the
         // slot is called:
         // - The slot might get deleted and thus disconnected from
@@ -259,7 +283,7 @@ void Signal<const Event&, Void, Void, Void, Void, Void, Void, Void, Void, Void>:
         //   calling any slots immediately
         // - A new Connection might get added to this Signal in
         //   the slot
-        IEventRoute* route = it->second;
+        IEventRoute* route = routes[n];
         if( route->valid() )
             route->route(ev);
 
@@ -267,26 +291,6 @@ void Signal<const Event&, Void, Void, Void, Void, Void, Void, Void, Void, Void>:
         // will be detached. In this case we bail out immediately
         if( !sentry )
             return;
-
-        ++it;
-    }
-
-    const std::type_info& ti = ev.typeInfo();
-
-    it = _routes.lower_bound( &ti );
-    while(it != _routes.end() && *(it->first) == ti)
-    {
-        IEventRoute* route = it->second;
-
-        if(route)
-            route->route(ev);
-
-        ++it;
-
-        // if this signal gets deleted by the slot, the Sentry
-        // will be detached. In this case we bail out immediately
-        if( !sentry )
-            return;
     }
 }
 
@@ -303,6 +307,12 @@ void Signal<const Event&, Void, Void, Void, Void, Void, Void, Void, Void, Void>:
 
 void Signal<const Event&, Void, Void, Void, Void, Void, Void, Void, Void, Void>::onConnectionClose(const Connection& c)
 {
+    if (&c.sender() != this)
+    {
+        Connectable::onConnectionClose(c);
+        return;
+    }
+
     // if the signal is currently calling its slots, do not
     // remove the connection now, but only set the cleanup flag
     // Any invalid connection objects will be removed after
@@ -310,42 +320,38 @@ void Signal<const Event&, Void, Void, Void, Void, Void, Void, Void, Void, Void>:
     if( _sending )
     {
         _dirty = true;
+        return;
     }
-    else
+
+    for (Routes::iterator it = _routes.begin(); it != _routes.end(); ++it)
     {
-        RouteMap::iterator it;
-        for(it = _routes.begin(); it != _routes.end(); ++it )
+        if (it->route->connection() == c)
         {
-            IEventRoute* route = it->second;
-            if(route->connection() == c )
-            {
-                delete route;
-                _routes.erase(it++);
-                return;
-            }
+            delete it->route;
+            _routes.erase(it);
+            _dispatchType = 0;
+            return;
         }
-
-        Connectable::onConnectionClose(c);
     }
 }
 
 
 void Signal<const Event&, Void, Void, Void, Void, Void, Void, Void, Void, Void>::addRoute(const std::type_info* ti, IEventRoute* route)
 {
-    RouteMap::value_type elem(ti, route);
-    _routes.insert( elem );
+    _routes.push_back(Route(ti, route));
+    _dispatchType = 0;
 }
 
 
 void Signal<const Event&, Void, Void, Void, Void, Void, Void, Void, Void, Void>::removeRoute(const Slot& slot)
 {
-    RouteMap::iterator it = _routes.begin();
-    while( it != _routes.end() && it->first == 0 )
+    for (Routes::size_type n = 0; n < _routes.size(); ++n)
     {
-        IEventRoute* route = it->second;
-        if(route->connection().slot().equals(slot) )
+        IEventRoute* route = _routes[n].route;
+        if (_routes[n].type == 0 && route->valid() && route->connection().slot().equals(slot))
         {
-            route->connection().close();
+            Connection c = route->connection();
+            c.close();
             break;
         }
     }
@@ -354,13 +360,14 @@ void Signal<const Event&, Void, Void, Void, Void, Void, Void, Void, Void, Void>:
 
 void Signal<const Event&, Void, Void, Void, Void, Void, Void, Void, Void, Void>::removeRoute(const std::type_info* ti, const Slot& slot)
 {
-    RouteMap::iterator it = _routes.lower_bound( ti );
-    while(it != _routes.end() && *(it->first) == *ti)
+    for (Routes::size_type n = 0; n < _routes.size(); ++n)
     {
-        IEventRoute* route = it->second;
-        if(route->connection().slot().equals(slot) )
+        IEventRoute* route = _routes[n].route;
+        if (_routes[n].type != 0 && _routes[n].matches(*ti)
+            && route->valid() && route->connection().slot().equals(slot))
         {
-            route->connection().close();
+            Connection c = route->connection();
+            c.close();
             break;
         }
     }
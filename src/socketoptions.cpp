@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/net/socketoptions.h>
+#include <cxxtools/log.h>
+#include "error.h"
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+log_define("cxxtools.net.socketoptions")
+
+namespace cxxtools
+{
+
+namespace net
+{
+
+namespace
+{
+    void setOption(int fd, int level, int option, int value, const char* name)
+    {
+        log_debug("setsockopt(" << fd << ", " << name << ", " << value << ')');
+        if (::setsockopt(fd, level, option, &value, sizeof(value)) != 0)
+            log_warn("failed to set socket option " << name << " to " << value << ": " << getErrnoString());
+    }
+}
+
+SocketOptions::SocketOptions()
+    : _noDelay(-1),
+      _quickAck(-1),
+      _busyPoll(-1),
+      _sendBufferSize(-1),
+      _receiveBufferSize(-1),
+      _fastOpen(-1),
+      _keepAlive(-1),
+      _keepIdle(-1),
+      _keepInterval(-1),
+      _keepCount(-1)
+{
+}
+
+void SocketOptions::applyListen(int fd) const
+{
+    if (_sendBufferSize >= 0)
+        setOption(fd, SOL_SOCKET, SO_SNDBUF, _sendBufferSize, "SO_SNDBUF");
+
+    if (_receiveBufferSize >= 0)
+        setOption(fd, SOL_SOCKET, SO_RCVBUF, _receiveBufferSize, "SO_RCVBUF");
+
+#ifdef TCP_FASTOPEN
+    if (_fastOpen >= 0)
+        setOption(fd, IPPROTO_TCP, TCP_FASTOPEN, _fastOpen, "TCP_FASTOPEN");
+#endif
+}
+
+void SocketOptions::applyConnected(int fd) const
+{
+    applyConnection(fd);
+}
+
+void SocketOptions::applyConnect(int fd) const
+{
+    if (_sendBufferSize >= 0)
+        setOption(fd, SOL_SOCKET, SO_SNDBUF, _sendBufferSize, "SO_SNDBUF");
+
+    if (_receiveBufferSize >= 0)
+        setOption(fd, SOL_SOCKET, SO_RCVBUF, _receiveBufferSize, "SO_RCVBUF");
+
+#ifdef TCP_FASTOPEN_CONNECT
+    if (_fastOpen >= 0)
+        setOption(fd, IPPROTO_TCP, TCP_FASTOPEN_CONNECT, _fastOpen > 0, "TCP_FASTOPEN_CONNECT");
+#endif
+
+    applyConnection(fd);
+}
+
+void SocketOptions::applyConnection(int fd) const
+{
+    if (_noDelay >= 0)
+        setOption(fd, IPPROTO_TCP, TCP_NODELAY, _noDelay, "TCP_NODELAY");
+
+#ifdef TCP_QUICKACK
+    if (_quickAck >= 0)
+        setOption(fd, IPPROTO_TCP, TCP_QUICKACK, _quickAck, "TCP_QUICKACK");
+#endif
+
+#ifdef SO_BUSY_POLL
+    if (_busyPoll >= Timespan(0))
+        setOption(fd, SOL_SOCKET, SO_BUSY_POLL, static_cast<int>(_busyPoll.totalUSecs()), "SO_BUSY_POLL");
+#endif
+
+    if (_keepAlive >= 0)
+        setOption(fd, SOL_SOCKET, SO_KEEPALIVE, _keepAlive, "SO_KEEPALIVE");
+
+#ifdef TCP_KEEPIDLE
+    if (_keepIdle >= Timespan(0))
+        setOption(fd, IPPROTO_TCP, TCP_KEEPIDLE, static_cast<int>(_keepIdle.totalSeconds()), "TCP_KEEPIDLE");
+#endif
+
+#ifdef TCP_KEEPINTVL
+    if (_keepInterval >= Timespan(0))
+        setOption(fd, IPPROTO_TCP, TCP_KEEPINTVL, static_cast<int>(_keepInterval.totalSeconds()), "TCP_KEEPINTVL");
+#endif
+
+#ifdef TCP_KEEPCNT
+    if (_keepCount >= 0)
+        setOption(fd, IPPROTO_TCP, TCP_KEEPCNT, _keepCount, "TCP_KEEPCNT");
+#endif
+}
+
+} // namespace net
+
+} // namespace cxxtools
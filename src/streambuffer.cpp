@@ -43,7 +43,9 @@ StreamBuffer::StreamBuffer(IODevice& ioDevice, size_t bufferSize, bool extend)
   _obufferSize(bufferSize),
   _obuffer(0),
   _pbmax(4),
-  _oextend(extend)
+  _oextend(extend),
+  _osegmented(false),
+  _osegmentsSize(0)
 {
     setg(0, 0, 0);
     setp(0, 0);
@@ -59,7 +61,9 @@ StreamBuffer::StreamBuffer(size_t bufferSize, bool extend)
   _obufferSize(bufferSize),
   _obuffer(0),
   _pbmax(4),
-  _oextend(extend)
+  _oextend(extend),
+  _osegmented(false),
+  _osegmentsSize(0)
 {
     setg(0, 0, 0);
     setp(0, 0);
@@ -70,6 +74,12 @@ StreamBuffer::~StreamBuffer()
 {
     delete[] _ibuffer;
     delete[] _obuffer;
+
+    for (std::deque<Segment>::iterator it = _osegments.begin(); it != _osegments.end(); ++it)
+        delete[] it->buffer;
+
+    for (std::vector<char*>::iterator it = _ofree.begin(); it != _ofree.end(); ++it)
+        delete[] *it;
 }
 
 
@@ -198,7 +208,7 @@ std::streamsize StreamBuffer::showfull()
 
 size_t StreamBuffer::beginWrite()
 {
-    log_trace("beginWrite; out_avail=" << out_avail());
+    log_trace("beginWrite; pendingOutput=" << pendingOutput());
 
     if (_ioDevice == 0)
         return 0;
@@ -209,6 +219,12 @@ size_t StreamBuffer::beginWrite()
         return 0;
     }
 
+    if (!_osegments.empty())
+    {
+        fillIov();
+        return _ioDevice->beginWritev(&_oiov[0], _oiov.size());
+    }
+
     if (pptr())
     {
         size_t avail = pptr() - pbase();
@@ -232,39 +248,170 @@ void StreamBuffer::discard()
 
     if (pptr())
         setp(_obuffer, _obuffer + _obufferSize);
+
+    for (std::deque<Segment>::iterator it = _osegments.begin(); it != _osegments.end(); ++it)
+        releaseOutputBuffer(it->buffer);
+
+    _osegments.clear();
+    _osegmentsSize = 0;
 }
 
 
-void StreamBuffer::onWrite(IODevice& /*dev*/)
+void StreamBuffer::borrow(const char* data, size_t size)
 {
-    outputReady.send(*this);
+    if (size == 0)
+        return;
+
+    queuePutArea();
+
+    Segment segment;
+    segment.data = data;
+    segment.size = size;
+    segment.buffer = 0;
+    _osegments.push_back(segment);
+    _osegmentsSize += size;
 }
 
 
-size_t StreamBuffer::endWrite()
+char* StreamBuffer::allocOutputBuffer()
+{
+    if (_ofree.empty())
+        return new char[_obufferSize];
+
+    char* buffer = _ofree.back();
+    _ofree.pop_back();
+    return buffer;
+}
+
+
+void StreamBuffer::releaseOutputBuffer(char* buffer)
+{
+    // buffers of an extensible stream buffer may have different sizes
+    if (buffer && !_oextend && _ofree.size() < 8)
+        _ofree.push_back(buffer);
+    else
+        delete[] buffer;
+}
+
+
+void StreamBuffer::queuePutArea()
+{
+    if (!pptr() || pptr() == pbase())
+        return;
+
+    Segment segment;
+    segment.data = pbase();
+    segment.size = pptr() - pbase();
+    segment.buffer = _obuffer;
+    _osegments.push_back(segment);
+    _osegmentsSize += segment.size;
+
+    if (_ofree.empty())
+    {
+        _obuffer = 0;
+        setp(0, 0);
+    }
+    else
+    {
+        _obuffer = allocOutputBuffer();
+        setp(_obuffer, _obuffer + _obufferSize);
+    }
+}
+
+
+size_t StreamBuffer::fillIov()
+{
+    _oiov.clear();
+
+    for (std::deque<Segment>::const_iterator it = _osegments.begin(); it != _osegments.end(); ++it)
+    {
+        struct iovec iov;
+        iov.iov_base = const_cast<char*>(it->data);
+        iov.iov_len = it->size;
+        _oiov.push_back(iov);
+    }
+
+    if (pptr() && pptr() > pbase())
+    {
+        struct iovec iov;
+        iov.iov_base = pbase();
+        iov.iov_len = pptr() - pbase();
+        _oiov.push_back(iov);
+    }
+
+    return _oiov.size();
+}
+
+
+void StreamBuffer::consumeOutput(size_t n)
 {
-    log_trace("endWrite; out_avail=" << out_avail());
+    while (n > 0 && !_osegments.empty())
+    {
+        Segment& segment = _osegments.front();
+        if (n < segment.size)
+        {
+            segment.data += n;
+            segment.size -= n;
+            _osegmentsSize -= n;
+            return;
+        }
+
+        n -= segment.size;
+        _osegmentsSize -= segment.size;
+        releaseOutputBuffer(segment.buffer);
+        _osegments.pop_front();
+    }
+
+    if (!_obuffer)
+        return;
 
     size_t leftover = 0;
-    size_t written = 0;
 
     if (pptr())
     {
         size_t avail = pptr() - pbase();
-        written = _ioDevice->endWrite();
-
-        leftover = avail - written;
-
-        log_debug(written << " bytes written; " << leftover << " left in buffer");
+        leftover = avail - n;
 
-        if (leftover > 0)
+        if (leftover > 0 && n > 0)
         {
-            traits_type::move(_obuffer, _obuffer + written, leftover);
+            traits_type::move(_obuffer, _obuffer + n, leftover);
         }
     }
 
     setp(_obuffer, _obuffer + _obufferSize);
     pbump( leftover );
+}
+
+
+void StreamBuffer::writeOutput()
+{
+    fillIov();
+    size_t written = _ioDevice->writev(&_oiov[0], _oiov.size());
+    log_debug(written << " bytes written; " << (pendingOutput() - written) << " left");
+    consumeOutput(written);
+}
+
+
+void StreamBuffer::onWrite(IODevice& /*dev*/)
+{
+    outputReady.send(*this);
+}
+
+
+size_t StreamBuffer::endWrite()
+{
+    log_trace("endWrite; pendingOutput=" << pendingOutput());
+
+    size_t written = 0;
+
+    if (pptr() || !_osegments.empty())
+    {
+        written = _ioDevice->endWrite();
+
+        log_debug(written << " bytes written; " << (pendingOutput() - written) << " left in buffer");
+    }
+
+    consumeOutput(written);
 
     return written;
 }
@@ -279,9 +426,19 @@ StreamBuffer::int_type StreamBuffer::overflow(int_type ch)
 
     if (!_obuffer)
     {
-        _obuffer = new char[_obufferSize];
+        _obuffer = allocOutputBuffer();
         setp(_obuffer, _obuffer + _obufferSize);
     }
+    else if (_osegmented && !traits_type::eq_int_type( ch, traits_type::eof() ))
+    {
+        // queue the full buffer and continue in a new one
+        queuePutArea();
+        if (!_obuffer)
+        {
+            _obuffer = allocOutputBuffer();
+            setp(_obuffer, _obuffer + _obufferSize);
+        }
+    }
     else if (_oextend && !traits_type::eq_int_type( ch, traits_type::eof() ))
     {
         // if the buffer area is extensible and overflow is not called by
@@ -299,6 +456,14 @@ StreamBuffer::int_type StreamBuffer::overflow(int_type ch)
     {
         endWrite();
     }
+    else if (!_osegments.empty())
+    {
+        // write queued segments together with the buffer
+        do
+        {
+            writeOutput();
+        } while (pptr() == epptr());
+    }
     else
     {
         // normal blocking overflow case
@@ -339,6 +504,16 @@ int StreamBuffer::sync()
     if (! _ioDevice)
         return 0;
 
+    while (!_osegments.empty())
+    {
+        if (_ioDevice->writing())
+            endWrite();
+        else
+            writeOutput();
+
+        _ioDevice->sync();
+    }
+
     if (pptr())
     {
         while (pptr() > pbase())
@@ -29,6 +29,7 @@
 
 #include <cxxtools/string.h>
 #include <cxxtools/utf8codec.h>
+#include "charconv.h"
 #include <iostream>
 #include <algorithm>
 
@@ -193,9 +194,7 @@ basic_string<cxxtools::Char>& basic_string<cxxtools::Char>::assign(const std::st
     size_type len = str.length();
     privreserve(len);
 
-    cxxtools::Char* p = privdata_rw();
-    for (size_type n = 0; n < len; ++n)
-        p[n] = cxxtools::Char( str[n] );
+    cxxtools::charconv::widen(str.data(), len, privdata_rw());
 
     setLength(len);
 
@@ -207,9 +206,7 @@ basic_string<cxxtools::Char>& basic_string<cxxtools::Char>::assign(const std::st
 {
     privreserve(len);
 
-    cxxtools::Char* p = privdata_rw();
-    for (size_type n = 0; n < len; ++n)
-        p[n] = cxxtools::Char( str[pos + n] );
+    cxxtools::charconv::widen(str.data() + pos, len, privdata_rw());
 
     setLength(len);
 
@@ -257,11 +254,7 @@ basic_string<cxxtools::Char>& basic_string<cxxtools::Char>::assign(const char* s
 basic_string<cxxtools::Char>& basic_string<cxxtools::Char>::assign(const char* str, size_type length)
 {
     privreserve(length);
-    cxxtools::Char* d = privdata_rw();
-    for (unsigned n = 0; n < length; ++n)
-    {
-        d[n] = cxxtools::Char(str[n]);
-    }
+    cxxtools::charconv::widen(str, length, privdata_rw());
 
     setLength(length);
 
@@ -714,10 +707,9 @@ std::string basic_string<cxxtools::Char>::narrow(char dfault) const
     size_type len = this->length();
     const cxxtools::Char* s = privdata_ro();
 
-    ret.reserve(len);
-
-    for (size_type n = 0; n < len; ++n)
-        ret.append( 1, s[n].narrow(dfault) );
+    ret.resize(len);
+    if (len > 0)
+        cxxtools::charconv::narrow(s, len, &ret[0], dfault);
 
     return ret;
 }
@@ -729,9 +721,8 @@ basic_string<cxxtools::Char> basic_string<cxxtools::Char>::widen(const char* str
 
     size_type len = std::char_traits<char>::length(str);
     ret.privreserve(len);
-
-    for (size_type n = 0; n < len; ++n)
-        ret += cxxtools::Char( str[n] );
+    cxxtools::charconv::widen(str, len, ret.privdata_rw());
+    ret.setLength(len);
 
     return ret;
 }
@@ -743,9 +734,8 @@ basic_string<cxxtools::Char> basic_string<cxxtools::Char>::widen(const std::stri
 
     size_type len = str.length();
     ret.privreserve(len);
-
-    for (size_type n = 0; n < len; ++n)
-        ret += cxxtools::Char( str[n] );
+    cxxtools::charconv::widen(str.data(), len, ret.privdata_rw());
+    ret.setLength(len);
 
     return ret;
 }
@@ -94,6 +94,18 @@ void TcpServer::listen(const std::string& ipaddr, unsigned short int port, int b
 }
 
 
+void TcpServer::socketOptions(const SocketOptions& options)
+{
+    _impl->socketOptions(options);
+}
+
+
+const SocketOptions& TcpServer::socketOptions() const
+{
+    return _impl->socketOptions();
+}
+
+
 void TcpServer::terminateAccept()
 {
     _impl->terminateAccept();
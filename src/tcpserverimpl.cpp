@@ -191,6 +191,8 @@ void TcpServerImpl::listen(const std::string& ipaddr, unsigned short int port, i
             }
 #endif
 
+            _options.applyListen(fd);
+
             log_debug("bind " << formatIp(*reinterpret_cast<const Sockaddr*>(it->ai_addr)));
             if (::bind(fd, it->ai_addr, it->ai_addrlen) != 0)
             {
@@ -239,6 +241,14 @@ void TcpServerImpl::listen(const std::string& ipaddr, unsigned short int port, i
     }
 }
 
+void TcpServerImpl::socketOptions(const SocketOptions& options)
+{
+    _options = options;
+
+    for (Listeners::const_iterator it = _listeners.begin(); it != _listeners.end(); ++it)
+        _options.applyListen(it->_fd);
+}
+
 void TcpServerImpl::terminateAccept()
 {
     char ch = 'A';
@@ -523,6 +533,8 @@ int TcpServerImpl::accept(int flags, struct sockaddr* sa, socklen_t& sa_len)
             throw cxxtools::SystemError("setsockopt(SO_NOSIGPIPE)");
 #endif
 
+    _options.applyConnected(clientFd);
+
     log_debug( "accepted on " << listenerFd << " => " << clientFd);
 
     return clientFd;
@@ -31,6 +31,7 @@
 
 #include "selectableimpl.h"
 #include <cxxtools/signal.h>
+#include <cxxtools/net/socketoptions.h>
 #include <string>
 #include <vector>
 #include <sys/types.h>
@@ -68,6 +69,8 @@ class TcpServerImpl : public SelectableImpl
 
         int _wakePipe[2];
 
+        SocketOptions _options;
+
 #ifdef HAVE_TCP_DEFER_ACCEPT
         bool _deferAccept;
 #endif
@@ -85,6 +88,11 @@ class TcpServerImpl : public SelectableImpl
 
         void terminateAccept();
 
+        void socketOptions(const SocketOptions& options);
+
+        const SocketOptions& socketOptions() const
+        { return _options; }
+
 #ifdef HAVE_TCP_DEFER_ACCEPT
         void deferAccept(bool sw);
 #endif
@@ -168,6 +168,30 @@ void TcpSocket::endConnect()
 }
 
 
+void TcpSocket::socketOptions(const SocketOptions& options)
+{
+    _impl->socketOptions(options);
+}
+
+
+const SocketOptions& TcpSocket::socketOptions() const
+{
+    return _impl->socketOptions();
+}
+
+
+void TcpSocket::defaultSocketOptions(const SocketOptions& options)
+{
+    TcpSocketImpl::defaultSocketOptions() = options;
+}
+
+
+const SocketOptions& TcpSocket::defaultSocketOptions()
+{
+    return TcpSocketImpl::defaultSocketOptions();
+}
+
+
 bool TcpSocket::isConnected() const
 {
     return _impl->isConnected();
@@ -263,6 +287,27 @@ size_t TcpSocket::onWrite(const char* buffer, size_t count)
 }
 
 
+size_t TcpSocket::onReadv(const struct iovec* iov, size_t iovcnt, bool& eof)
+{
+    return _impl->readv(iov, iovcnt, eof);
+}
+
+
+size_t TcpSocket::onBeginWritev(const struct iovec* iov, size_t iovcnt)
+{
+    if (!_impl->isConnected())
+        throw IOPending("connect operation pending");
+
+    return _impl->beginWritev(iov, iovcnt);
+}
+
+
+size_t TcpSocket::onWritev(const struct iovec* iov, size_t iovcnt)
+{
+    return _impl->writev(iov, iovcnt);
+}
+
+
 void TcpSocket::onCancel()
 {
     if (_impl->isConnected())
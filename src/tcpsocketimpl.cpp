@@ -150,6 +150,8 @@ TcpSocketImpl::TcpSocketImpl(TcpSocket& socket)
 : IODeviceImpl(socket)
 , _socket(socket)
 , _isConnected(false)
+, _resolving(false)
+, _options(defaultSocketOptions())
 {
 }
 
@@ -163,6 +165,13 @@ TcpSocketImpl::~TcpSocketImpl()
 void TcpSocketImpl::close()
 {
     log_debug("close socket " << _fd);
+    if (_resolving)
+    {
+        // the selector polls the descriptor of the resolver
+        _resolving = false;
+        _pfd = 0;
+    }
+
     IODeviceImpl::close();
     _isConnected = false;
 }
@@ -264,6 +273,8 @@ std::string TcpSocketImpl::tryConnect()
             throw cxxtools::SystemError("setsockopt(SO_NOSIGPIPE)");
 #endif
 
+        _options.applyConnect(fd);
+
         IODeviceImpl::open(fd, true, false);
 
         std::memmove(&_peeraddr, _addrInfoPtr->ai_addr, _addrInfoPtr->ai_addrlen);
@@ -294,6 +305,24 @@ std::string TcpSocketImpl::tryConnect()
 }
 
 
+std::string TcpSocketImpl::endResolve()
+{
+    _resolving = false;
+
+    try
+    {
+        _addrInfo.impl()->endResolve();
+    }
+    catch (const std::exception& e)
+    {
+        return e.what();
+    }
+
+    _addrInfoPtr = _addrInfo.impl()->begin();
+    return tryConnect();
+}
+
+
 bool TcpSocketImpl::beginConnect(const AddrInfo& addrInfo)
 {
     log_trace("begin connect");
@@ -301,9 +330,18 @@ bool TcpSocketImpl::beginConnect(const AddrInfo& addrInfo)
     assert(!_isConnected);
 
     _connectFailedMessages.clear();
+    _connectResult.clear();
     _addrInfo = addrInfo;
-    _addrInfoPtr = _addrInfo.impl()->begin();
-    _connectResult = tryConnect();
+
+    if (!_addrInfo.impl()->isResolved())
+    {
+        // connect, when the resolver has finished
+        log_debug("wait for resolver");
+        _resolving = true;
+        return false;
+    }
+
+    _connectResult = endResolve();
     checkPendingError();
     return _isConnected;
 }
@@ -313,6 +351,12 @@ void TcpSocketImpl::endConnect()
 {
     log_trace("ending connect");
 
+    if (_resolving)
+    {
+        _pfd = 0;
+        _connectResult = endResolve();
+    }
+
     if(_pfd && ! _socket.wbuf())
     {
         _pfd->events &= ~POLLOUT;
@@ -380,6 +424,21 @@ void TcpSocketImpl::endConnect()
 }
 
 
+SocketOptions& TcpSocketImpl::defaultSocketOptions()
+{
+    static SocketOptions options;
+    return options;
+}
+
+
+void TcpSocketImpl::socketOptions(const SocketOptions& options)
+{
+    _options = options;
+    if (_fd >= 0)
+        _options.applyConnected(_fd);
+}
+
+
 void TcpSocketImpl::accept(const TcpServer& server, unsigned flags)
 {
     socklen_t peeraddr_len = sizeof(_peeraddr);
@@ -404,6 +463,14 @@ void TcpSocketImpl::accept(const TcpServer& server, unsigned flags)
 
 void TcpSocketImpl::initWait(pollfd& pfd)
 {
+    if (_resolving)
+    {
+        pfd.fd = _addrInfo.impl()->resolveFd();
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        return;
+    }
+
     IODeviceImpl::initWait(pfd);
 
     if( ! _isConnected )
@@ -418,6 +485,26 @@ bool TcpSocketImpl::checkPollEvent(pollfd& pfd)
 {
     log_debug("checkPollEvent " << pfd.revents);
 
+    if (_resolving)
+    {
+        if (!_addrInfo.impl()->isResolved())
+            return false;
+
+        log_debug("resolver finished");
+        _pfd = 0;
+        _connectResult = endResolve();
+
+        // wait for the new socket instead of the resolver
+        if (_fd >= 0)
+            initializePoll(&pfd, 1);
+
+        // immediate success or error
+        if (_isConnected || !_connectResult.empty())
+            _socket.connected(_socket);
+
+        return true;
+    }
+
     if (_isConnected)
     {
         // check for error while neither reading nor writing
@@ -515,13 +602,31 @@ size_t TcpSocketImpl::beginWrite(const char* buffer, size_t n)
 {
     log_debug("::send(" << _fd << ", \"" << hexDump(buffer, n) << "\", " << n << ')');
 
+    struct iovec iov;
+    iov.iov_base = const_cast<char*>(buffer);
+    iov.iov_len = n;
+    return beginWritev(&iov, 1);
+}
+
+size_t TcpSocketImpl::beginWritev(const struct iovec* iov, size_t iovcnt)
+{
+    if (iovcnt > IOVCNT_MAX)
+        iovcnt = IOVCNT_MAX;
+
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = const_cast<struct iovec*>(iov);
+    msg.msg_iovlen = iovcnt;
+
+    log_debug("::sendmsg(" << _fd << ", " << iovcnt << " buffers)");
+
 #if defined(HAVE_MSG_NOSIGNAL)
 
-    ssize_t ret = ::send(_fd, (const void*)buffer, n, MSG_NOSIGNAL);
+    ssize_t ret = ::sendmsg(_fd, &msg, MSG_NOSIGNAL);
 
 #elif defined(HAVE_SO_NOSIGPIPE)
 
-    ssize_t ret = ::send(_fd, (const void*)buffer, n, 0);
+    ssize_t ret = ::sendmsg(_fd, &msg, 0);
 
 #else
 
@@ -532,7 +637,7 @@ size_t TcpSocketImpl::beginWrite(const char* buffer, size_t n)
     pthread_sigmask(SIG_BLOCK, &sigpipeMask, &oldSigmask);
 
     // execute send
-    ssize_t ret = ::send(_fd, (const void*)buffer, n, 0);
+    ssize_t ret = ::sendmsg(_fd, &msg, 0);
 
     // clear possible SIGPIPE
     sigset_t pending;
@@ -550,7 +655,7 @@ size_t TcpSocketImpl::beginWrite(const char* buffer, size_t n)
 
 #endif
 
-    log_debug("send returned " << ret);
+    log_debug("sendmsg returned " << ret);
     if (ret > 0)
         return static_cast<size_t>(ret);
 
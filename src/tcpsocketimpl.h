@@ -32,6 +32,7 @@
 #include "cxxtools/signal.h"
 #include "iodeviceimpl.h"
 #include "cxxtools/net/addrinfo.h"
+#include "cxxtools/net/socketoptions.h"
 #include "addrinfoimpl.h"
 #include "config.h"
 #include <string>
@@ -80,6 +81,8 @@ class TcpSocketImpl : public IODeviceImpl
     private:
         TcpSocket& _socket;
         bool _isConnected;
+        // waiting for the resolver before connecting
+        bool _resolving;
         struct sockaddr_storage _peeraddr;
         AddrInfo _addrInfo;
         AddrInfoImpl::const_iterator _addrInfoPtr;
@@ -87,8 +90,10 @@ class TcpSocketImpl : public IODeviceImpl
         int checkConnect();
         void checkPendingError();
         std::string tryConnect();
+        std::string endResolve();
         std::string _connectResult;
         std::vector<std::string> _connectFailedMessages;
+        SocketOptions _options;
 
         std::string connectFailedMessages();
 
@@ -114,6 +119,13 @@ class TcpSocketImpl : public IODeviceImpl
 
         void accept(const TcpServer& server, unsigned flags);
 
+        void socketOptions(const SocketOptions& options);
+
+        const SocketOptions& socketOptions() const
+        { return _options; }
+
+        static SocketOptions& defaultSocketOptions();
+
         void terminateAccept();
 
         // implementation using poll
@@ -124,6 +136,8 @@ class TcpSocketImpl : public IODeviceImpl
 
         // overrid beginWrite to use send(2) instead of write(2)
         virtual size_t beginWrite(const char* buffer, size_t n);
+
+        virtual size_t beginWritev(const struct iovec* iov, size_t iovcnt);
 };
 
 } // namespace net
@@ -28,12 +28,15 @@
 
 #include <cxxtools/net/addrinfo.h>
 #include "addrinfoimpl.h"
+#include "tcpsocketimpl.h"
+#include "config.h"
 #include <cxxtools/net/udp.h>
 #include <cxxtools/log.h>
 #include <cxxtools/systemerror.h>
 #include <cxxtools/net/tcpserver.h>
 #include <netdb.h>
 #include <sys/poll.h>
+#include <sys/uio.h>
 #include <vector>
 #include <errno.h>
 #include <string.h>
@@ -45,6 +48,127 @@ namespace cxxtools
 
 namespace net
 {
+  namespace
+  {
+    // number of datagrams passed to the kernel in one system call
+    const unsigned batchSize = 64;
+
+    struct sockaddr_storage* msgAddress(const UdpMessage& msg,
+      const struct sockaddr_storage* defaultAddr, socklen_t defaultAddrLen,
+      socklen_t& len)
+    {
+      if (msg.addrlen > 0)
+      {
+        len = msg.addrlen;
+        return const_cast<struct sockaddr_storage*>(&msg.addr);
+      }
+
+      len = defaultAddrLen;
+      return const_cast<struct sockaddr_storage*>(defaultAddr);
+    }
+
+    // Sends the messages using sendmmsg if available. Messages without
+    // address are sent to defaultAddr or to the connected peer when
+    // defaultAddr is null.
+    size_t sendMessages(const Socket& socket, const UdpMessage* messages,
+      size_t count, int flags, const struct sockaddr_storage* defaultAddr,
+      socklen_t defaultAddrLen)
+    {
+      size_t sent = 0;
+
+#ifdef HAVE_SENDMMSG
+      struct mmsghdr hdr[batchSize];
+      struct iovec iov[batchSize];
+
+      while (sent < count)
+      {
+        unsigned n = count - sent < batchSize ? count - sent : batchSize;
+
+        memset(hdr, 0, sizeof(struct mmsghdr) * n);
+        for (unsigned i = 0; i < n; ++i)
+        {
+          const UdpMessage& msg = messages[sent + i];
+          iov[i].iov_base = msg.data;
+          iov[i].iov_len = msg.size;
+          hdr[i].msg_hdr.msg_iov = &iov[i];
+          hdr[i].msg_hdr.msg_iovlen = 1;
+          hdr[i].msg_hdr.msg_name = msgAddress(msg, defaultAddr, defaultAddrLen,
+                                               hdr[i].msg_hdr.msg_namelen);
+        }
+
+        log_debug("sendmmsg " << n << " messages");
+        int ret = ::sendmmsg(socket.getFd(), hdr, n, flags);
+
+        if (ret < 0)
+        {
+          if (errno == EINTR)
+            continue;
+
+          if (errno != EAGAIN && errno != EWOULDBLOCK)
+            throw SystemError("sendmmsg");
+
+          if (socket.getTimeout() == 0)
+            break;
+
+          socket.poll(POLLOUT);
+          continue;
+        }
+
+        sent += ret;
+      }
+
+#else
+      for ( ; sent < count; ++sent)
+      {
+        const UdpMessage& msg = messages[sent];
+        socklen_t len;
+        struct sockaddr_storage* addr = msgAddress(msg, defaultAddr, defaultAddrLen, len);
+
+        ssize_t ret = ::sendto(socket.getFd(), msg.data, msg.size, flags,
+            reinterpret_cast<struct sockaddr*>(addr), len);
+
+        if (ret < 0)
+        {
+          if (errno != EAGAIN && errno != EWOULDBLOCK)
+            throw SystemError("sendto");
+
+          if (socket.getTimeout() == 0)
+            break;
+
+          socket.poll(POLLOUT);
+          --sent;
+        }
+      }
+#endif
+
+      return sent;
+    }
+  }
+
+  //////////////////////////////////////////////////////////////////////
+  // UdpMessage
+  //
+  void UdpMessage::setAddress(const std::string& ipaddr, unsigned short int port)
+  {
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_socktype = SOCK_DGRAM;
+
+    AddrInfo ai(new AddrInfoImpl(ipaddr, port, hints));
+
+    AddrInfoImpl::const_iterator it = ai.impl()->begin();
+    if (it == ai.impl()->end())
+      throw SystemError("getaddrinfo");
+
+    memmove(&addr, it->ai_addr, it->ai_addrlen);
+    addrlen = it->ai_addrlen;
+  }
+
+  std::string UdpMessage::getAddress() const
+  {
+    return formatIp(*reinterpret_cast<const Sockaddr*>(&addr));
+  }
+
   //////////////////////////////////////////////////////////////////////
   // UdpSender
   //
@@ -104,6 +228,12 @@ namespace net
     return send(message.data(), message.size(), flags);
   }
 
+  UdpSender::size_type UdpSender::send(const UdpMessage* messages,
+    size_type count, int flags) const
+  {
+    return sendMessages(*this, messages, count, flags, 0, 0);
+  }
+
   UdpSender::size_type UdpSender::recv(void* buffer, size_type length,
     int flags) const
   {
@@ -208,6 +338,100 @@ namespace net
     return std::string(&buffer[0], len);
   }
 
+  UdpReceiver::size_type UdpReceiver::recv(UdpMessage* messages, size_type count, int flags)
+  {
+    if (count == 0)
+      return 0;
+
+    if (count > batchSize)
+      count = batchSize;
+
+#ifdef HAVE_RECVMMSG
+    struct mmsghdr hdr[batchSize];
+    struct iovec iov[batchSize];
+
+    memset(hdr, 0, sizeof(struct mmsghdr) * count);
+    for (unsigned i = 0; i < count; ++i)
+    {
+      iov[i].iov_base = messages[i].data;
+      iov[i].iov_len = messages[i].size;
+      hdr[i].msg_hdr.msg_iov = &iov[i];
+      hdr[i].msg_hdr.msg_iovlen = 1;
+      hdr[i].msg_hdr.msg_name = &messages[i].addr;
+      hdr[i].msg_hdr.msg_namelen = sizeof(messages[i].addr);
+    }
+
+    log_debug("recvmmsg " << count << " messages");
+
+    int ret = ::recvmmsg(getFd(), hdr, count, flags | MSG_WAITFORONE, 0);
+
+    if (ret < 0 && errno == EAGAIN)
+    {
+      if (getTimeout() == 0)
+        throw IOTimeout();
+
+      poll(POLLIN);
+
+      ret = ::recvmmsg(getFd(), hdr, count, flags | MSG_WAITFORONE, 0);
+    }
+
+    if (ret < 0)
+      throw SystemError("recvmmsg");
+
+    for (int i = 0; i < ret; ++i)
+    {
+      messages[i].size = hdr[i].msg_len;
+      messages[i].truncated = (hdr[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+      messages[i].addrlen = hdr[i].msg_hdr.msg_namelen;
+    }
+
+    size_type received = static_cast<size_type>(ret);
+
+#else
+    // the first datagram is received blocking and the remaining ones
+    // as long as they are available without waiting
+    size_type received = 0;
+    for ( ; received < count; ++received)
+    {
+      UdpMessage& msg = messages[received];
+      msg.addrlen = sizeof(msg.addr);
+      int f = received == 0 ? flags : (flags | MSG_DONTWAIT);
+      ssize_t ret = ::recvfrom(getFd(), msg.data, msg.size, f | MSG_TRUNC,
+          reinterpret_cast<struct sockaddr*>(&msg.addr), &msg.addrlen);
+
+      if (ret < 0 && errno == EAGAIN)
+      {
+        if (received > 0)
+          break;
+
+        if (getTimeout() == 0)
+          throw IOTimeout();
+
+        poll(POLLIN);
+
+        ret = ::recvfrom(getFd(), msg.data, msg.size, f | MSG_TRUNC,
+            reinterpret_cast<struct sockaddr*>(&msg.addr), &msg.addrlen);
+      }
+
+      if (ret < 0)
+        throw SystemError("recvfrom");
+
+      msg.truncated = static_cast<size_type>(ret) > msg.size;
+      if (!msg.truncated)
+        msg.size = static_cast<size_type>(ret);
+    }
+#endif
+
+    if (received > 0)
+    {
+      const UdpMessage& last = messages[received - 1];
+      memmove(&peeraddr, &last.addr, last.addrlen);
+      peeraddrLen = last.addrlen;
+    }
+
+    return received;
+  }
+
   UdpReceiver::size_type UdpReceiver::send(const void* message, size_type length, int flags) const
   {
     ssize_t ret = ::sendto(getFd(), message, length, flags, reinterpret_cast <const struct sockaddr *> (&peeraddr), peeraddrLen);
@@ -221,6 +445,12 @@ namespace net
     return send(message.data(), message.size(), flags);
   }
 
+  UdpReceiver::size_type UdpReceiver::send(const UdpMessage* messages,
+    size_type count, int flags) const
+  {
+    return sendMessages(*this, messages, count, flags, &peeraddr, peeraddrLen);
+  }
+
 } // namespace net
 
 } // namespace cxxtools
@@ -35,20 +35,59 @@ namespace net
 {
   void UdpStreambuf::sendBuffer()
   {
+    if (batchsize <= 1)
+    {
+      try
+      {
+        sender.send(pbase(), pptr() - pbase(), flags);
+      }
+      catch (...)
+      {
+      }
+    }
+    else
+    {
+      batch[batchcount] = UdpMessage(pbase(), pptr() - pbase());
+      if (++batchcount >= batchsize)
+        sendBatch();
+    }
+  }
+
+  void UdpStreambuf::sendBatch()
+  {
+    if (batchcount == 0)
+      return;
+
     try
     {
-      sender.send(pbase(), pptr() - pbase(), flags);
+      sender.send(batch, batchcount, flags);
     }
     catch (...)
     {
     }
+
+    batchcount = 0;
+  }
+
+  void UdpStreambuf::resetBuffer()
+  {
+    char* p = message + batchcount * msgsize;
+    setp(p, p + msgsize);
+  }
+
+  void UdpStreambuf::flushBatch()
+  {
+    if (pptr() != pbase())
+      sendBuffer();
+    sendBatch();
+    resetBuffer();
   }
 
   std::streambuf::int_type UdpStreambuf::overflow(std::streambuf::int_type ch)
   {
     if (pptr() != pbase())
       sendBuffer();
-    setp(message, message + msgsize);
+    resetBuffer();
     if (ch != traits_type::eof())
     {
       *pptr() = traits_type::to_char_type(ch);
@@ -66,7 +105,7 @@ namespace net
   {
     if (pptr() != pbase())
       sendBuffer();
-    setp(message, message + msgsize);
+    resetBuffer();
     return 0;
   }
 
@@ -26,6 +26,8 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 #include "cxxtools/utf8codec.h"
+#include "charconv.h"
+#include <algorithm>
 #include <cstring>
 
 #define byteMask 0xBF
@@ -157,6 +159,87 @@ namespace
         else
             return fromBegin[n - s.n];
     }
+
+    /*
+     * Byte classes and state transitions of a deterministic automaton, which
+     * accepts exactly the sequences accepted by isLegalUTF8 (Bjoern Hoehrmann,
+     * Flexible and Economical UTF-8 Decoder). The states are multiples of 12,
+     * the number of byte classes.
+     */
+    const uint8_t utf8Class[256] = {
+        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+        1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, 9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,
+        7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7, 7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,
+        8,8,2,2,2,2,2,2,2,2,2,2,2,2,2,2, 2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,
+        10,3,3,3,3,3,3,3,3,3,3,3,3,4,3,3, 11,6,6,6,5,8,8,8,8,8,8,8,8,8,8,8
+    };
+
+    const uint8_t utf8Transition[108] = {
+        0,12,24,36,60,96,84,12,12,12,48,72,
+        12,12,12,12,12,12,12,12,12,12,12,12,
+        12, 0,12,12,12,12,12, 0,12, 0,12,12,
+        12,24,12,12,12,12,12,24,12,24,12,12,
+        12,12,12,12,12,12,12,24,12,12,12,12,
+        12,24,12,12,12,12,12,12,12,24,12,12,
+        12,12,12,12,12,12,12,36,12,36,12,12,
+        12,36,12,12,12,12,12,36,12,36,12,12,
+        12,36,12,12,12,12,12,12,12,12,12,12
+    };
+
+    enum { Utf8Accept = 0, Utf8Reject = 12 };
+
+    // Decodes complete and legal sequences. Stops at the end of the input or
+    // output or in front of an incomplete or illegal sequence.
+    void decodeLegal(const char*& fromNext, const char* fromEnd, Char*& toNext, Char* toEnd)
+    {
+        const uint8_t* f = reinterpret_cast<const uint8_t*>(fromNext);
+        const uint8_t* fe = reinterpret_cast<const uint8_t*>(fromEnd);
+        Char* t = toNext;
+
+        while (f < fe && t < toEnd)
+        {
+            if (*f < 0x80)
+            {
+                std::size_t count = charconv::widenAscii(reinterpret_cast<const char*>(f),
+                    std::min<std::size_t>(fe - f, toEnd - t), t);
+                f += count;
+                t += count;
+                continue;
+            }
+
+            const uint8_t* p = f;
+            uint32_t state = Utf8Accept;
+            uint32_t value = 0;
+            do
+            {
+                if (p >= fe || state == Utf8Reject)
+                {
+                    fromNext = reinterpret_cast<const char*>(f);
+                    toNext = t;
+                    return;
+                }
+
+                uint32_t type = utf8Class[*p];
+                value = state == Utf8Accept ? (0xff >> type) & *p
+                                            : (*p & 0x3f) | (value << 6);
+                state = utf8Transition[state + type];
+                ++p;
+            } while (state != Utf8Accept);
+
+            // U+FEFF is skipped as byte order mark wherever it occurs, like
+            // the check at the start of do_in does for sequences collected
+            // in the state
+            if (value != 0xfeff)
+                *t++ = Char(static_cast<Char::value_type>(value));
+            f = p;
+        }
+
+        fromNext = reinterpret_cast<const char*>(f);
+        toNext = t;
+    }
 }
 
 
@@ -209,6 +292,15 @@ Utf8Codec::result Utf8Codec::do_in(MBState& s, const char* fromBegin, const char
             break;
         }
 
+        // Legal sequences are decoded directly from the input. Incomplete
+        // and illegal sequences are collected byte by byte in the state.
+        if (s.n == 0)
+        {
+            decodeLegal(fromNext, fromEnd, toNext, toEnd);
+            if (fromNext >= fromEnd || toNext >= toEnd)
+                continue;
+        }
+
         if (s.n < sizeof(s.value.mbytes))
         {
             s.value.mbytes[s.n++] = *fromNext++;
@@ -274,6 +366,17 @@ Utf8Codec::result Utf8Codec::do_out(MBState& /*s*/, const Char* fromBegin, const
 
     while(fromNext < fromEnd)
     {
+        // Runs of ascii characters are copied in bulk. Like below one byte
+        // of the output is always left unused.
+        if (static_cast<uint32_t>(fromNext->value()) < 0x80 && toEnd - toNext > 1)
+        {
+            std::size_t count = charconv::narrowAscii(fromNext,
+                std::min<std::size_t>(fromEnd - fromNext, toEnd - toNext - 1), toNext);
+            fromNext += count;
+            toNext += count;
+            continue;
+        }
+
         ch = *fromNext;
         if (ch >= SurHighStart && ch <= SurLowEnd)
         {
@@ -335,6 +438,15 @@ int Utf8Codec::do_length(MBState& /*s*/, const char* fromBegin, const char* from
     size_t counter = 0;
 
     while(fromNext < fromEnd && counter <= max) {
+        std::size_t ascii = charconv::asciiLength(fromNext, fromEnd - fromNext);
+        if (ascii > 0) {
+            if (max - counter < ascii)
+                ascii = max - counter + 1;
+            fromNext += ascii;
+            counter += ascii;
+            continue;
+        }
+
         int extraBytesToRead = trailingBytesForUTF8[ (unsigned char)*fromNext ]; // NOTE: check again...
 
         if(fromNext + extraBytesToRead >= fromEnd) {
@@ -43,258 +43,288 @@ namespace
     Char::value_type charValue;
   };
 
+  // generated by utils/entityhash.pl - do not edit
   static const Ent ent[] = {
-    { L"AElig", 0x00C6 },
-    { L"Acirc", 0x00C2 },
-    { L"Agrave", 0x00C0 },
-    { L"Alpha", 0x0391 },
-    { L"Aring", 0x00C5 },
-    { L"Atilde", 0x00C3 },
-    { L"Auml", 0x00C4 },
+    { L"para", 0x00B6 },
+    { L"Euml", 0x00CB },
+    { L"Icirc", 0x00CE },
+    { L"alefsym", 0x2135 },
+    { L"yacute", 0x00FD },
+    { L"times", 0x00D7 },
+    { L"perp", 0x22A5 },
+    { L"Uuml", 0x00DC },
+    { L"quot", 0x0022 },
+    { L"ang", 0x2220 },
+    { L"eacute", 0x00E9 },
+    { L"upsilon", 0x03C5 },
+    { L"Rho", 0x03A1 },
+    { L"clubs", 0x2663 },
+    { L"le", 0x2264 },
+    { L"rsaquo", 0x203A },
     { L"Beta", 0x0392 },
-    { L"Ccedil", 0x00C7 },
-    { L"Chi", 0x03A7 },
-    { L"Dagger", 0x2021 },
+    { L"Ntilde", 0x00D1 },
+    { L"lsquo", 0x2018 },
+    { L"lceil", 0x2308 },
+    { L"cup", 0x222A },
+    { L"icirc", 0x00EE },
+    { L"oacute", 0x00F3 },
+    { L"lfloor", 0x230A },
+    { L"part", 0x2202 },
+    { L"AElig", 0x00C6 },
+    { L"otimes", 0x2297 },
     { L"Delta", 0x0394 },
+    { L"otilde", 0x00F5 },
+    { L"Kappa", 0x039A },
     { L"ETH", 0x00D0 },
+    { L"macr", 0x00AF },
+    { L"uml", 0x00A8 },
     { L"Eacute", 0x00C9 },
-    { L"Ecirc", 0x00CA },
-    { L"Egrave", 0x00C8 },
-    { L"Epsilon", 0x0395 },
-    { L"Eta", 0x0397 },
-    { L"Euml", 0x00CB },
-    { L"Gamma", 0x0393 },
-    { L"Iacute", 0x00CD },
-    { L"Icirc", 0x00CE },
-    { L"Igrave", 0x00CC },
-    { L"Iota", 0x0399 },
+    { L"tau", 0x03C4 },
+    { L"infin", 0x221E },
+    { L"szlig", 0x00DF },
+    { L"hellip", 0x2026 },
+    { L"Oslash", 0x00D8 },
+    { L"radic", 0x221A },
+    { L"prime", 0x2032 },
+    { L"ocirc", 0x00F4 },
+    { L"Theta", 0x0398 },
+    { L"ccedil", 0x00E7 },
+    { L"Ouml", 0x00D6 },
+    { L"raquo", 0x00BB },
+    { L"Chi", 0x03A7 },
+    { L"egrave", 0x00E8 },
+    { L"rang", 0x232A },
     { L"Iuml", 0x00CF },
-    { L"Kappa", 0x039A },
+    { L"darr", 0x2193 },
+    { L"thorn", 0x00FE },
+    { L"zwj", 0x200D },
+    { L"Zeta", 0x0396 },
+    { L"plusmn", 0x00B1 },
+    { L"brvbar", 0x00A6 },
+    { L"sdot", 0x22C5 },
+    { L"igrave", 0x00EC },
+    { L"larr", 0x2190 },
+    { L"thinsp", 0x2009 },
     { L"Lambda", 0x039B },
-    { L"Mu", 0x039C },
-    { L"Ntilde", 0x00D1 },
-    { L"Nu", 0x039D },
-    { L"OElig", 0x0152 },
-    { L"Oacute", 0x00D3 },
-    { L"Ocirc", 0x00D4 },
-    { L"Ograve", 0x00D2 },
-    { L"Omega", 0x03A9 },
-    { L"Omicron", 0x039F },
-    { L"Oslash", 0x00D8 },
+    { L"iuml", 0x00EF },
+    { L"Ccedil", 0x00C7 },
     { L"Otilde", 0x00D5 },
-    { L"Ouml", 0x00D6 },
-    { L"Phi", 0x03A6 },
-    { L"Pi", 0x03A0 },
-    { L"Prime", 0x2033 },
-    { L"Psi", 0x03A8 },
-    { L"Rho", 0x03A1 },
-    { L"Scaron", 0x0160 },
-    { L"Sigma", 0x03A3 },
+    { L"auml", 0x00E4 },
+    { L"circ", 0x02C6 },
     { L"THORN", 0x00DE },
-    { L"Tau", 0x03A4 },
-    { L"Theta", 0x0398 },
-    { L"Uacute", 0x00DA },
-    { L"Ucirc", 0x00DB },
-    { L"Ugrave", 0x00D9 },
-    { L"Upsilon", 0x03A5 },
-    { L"Uuml", 0x00DC },
-    { L"Xi", 0x039E },
-    { L"Yacute", 0x00DD },
-    { L"Yuml", 0x0178 },
-    { L"Zeta", 0x0396 },
-    { L"acirc", 0x00E2 },
-    { L"acute", 0x00B4 },
-    { L"aelig", 0x00E6 },
-    { L"agrave", 0x00E0 },
-    { L"alefsym", 0x2135 },
-    { L"alpha", 0x03B1 },
-    { L"amp", 0x0026 },
-    { L"and", 0x2227 },
-    { L"ang", 0x2220 },
-    { L"apos", 0x0027 },
+    { L"uuml", 0x00FC },
+    { L"Epsilon", 0x0395 },
+    { L"rarr", 0x2192 },
+    { L"equiv", 0x2261 },
+    { L"bull", 0x2022 },
+    { L"Iota", 0x0399 },
+    { L"ntilde", 0x00F1 },
+    { L"middot", 0x00B7 },
+    { L"sim", 0x223C },
+    { L"Ocirc", 0x00D4 },
+    { L"permil", 0x2030 },
+    { L"frac34", 0x00BE },
+    { L"there4", 0x2234 },
+    { L"uacute", 0x00FA },
+    { L"Igrave", 0x00CC },
+    { L"tilde", 0x02DC },
+    { L"Omega", 0x03A9 },
+    { L"theta", 0x03B8 },
+    { L"int", 0x222B },
+    { L"Gamma", 0x0393 },
+    { L"shy", 0x00AD },
+    { L"sum", 0x2211 },
     { L"aring", 0x00E5 },
-    { L"asymp", 0x2248 },
-    { L"atilde", 0x00E3 },
-    { L"auml", 0x00E4 },
-    { L"bdquo", 0x201E },
+    { L"yuml", 0x00FF },
+    { L"hearts", 0x2665 },
+    { L"reg", 0x00AE },
+    { L"sigma", 0x03C3 },
+    { L"ge", 0x2265 },
+    { L"rdquo", 0x201D },
+    { L"uarr", 0x2191 },
+    { L"acute", 0x00B4 },
+    { L"empty", 0x2205 },
+    { L"upsih", 0x03D2 },
+    { L"ecirc", 0x00EA },
+    { L"Ecirc", 0x00CA },
     { L"beta", 0x03B2 },
-    { L"brvbar", 0x00A6 },
-    { L"bull", 0x2022 },
-    { L"cap", 0x2229 },
-    { L"ccedil", 0x00E7 },
+    { L"fnof", 0x0192 },
+    { L"Yuml", 0x0178 },
+    { L"ucirc", 0x00FB },
+    { L"frac12", 0x00BD },
+    { L"ouml", 0x00F6 },
+    { L"curren", 0x00A4 },
+    { L"piv", 0x03D6 },
+    { L"nbsp", 0x00A0 },
+    { L"ugrave", 0x00F9 },
+    { L"thetasym", 0x03D1 },
+    { L"lrm", 0x200E },
+    { L"ordm", 0x00BA },
+    { L"and", 0x2227 },
     { L"cedil", 0x00B8 },
-    { L"cent", 0x00A2 },
-    { L"chi", 0x03C7 },
-    { L"circ", 0x02C6 },
-    { L"clubs", 0x2663 },
-    { L"cong", 0x2245 },
-    { L"copy", 0x00A9 },
+    { L"aelig", 0x00E6 },
+    { L"lsaquo", 0x2039 },
+    { L"lowast", 0x2217 },
+    { L"xi", 0x03BE },
+    { L"rArr", 0x21D2 },
+    { L"euml", 0x00EB },
+    { L"zwnj", 0x200C },
+    { L"asymp", 0x2248 },
+    { L"iacute", 0x00ED },
+    { L"pound", 0x00A3 },
+    { L"gt", 0x003E },
+    { L"apos", 0x0027 },
+    { L"Aring", 0x00C5 },
+    { L"Eta", 0x0397 },
+    { L"lArr", 0x21D0 },
     { L"crarr", 0x21B5 },
-    { L"cup", 0x222A },
-    { L"curren", 0x00A4 },
-    { L"dArr", 0x21D3 },
-    { L"dagger", 0x2020 },
-    { L"darr", 0x2193 },
-    { L"deg", 0x00B0 },
     { L"delta", 0x03B4 },
-    { L"diams", 0x2666 },
-    { L"divide", 0x00F7 },
-    { L"eacute", 0x00E9 },
-    { L"ecirc", 0x00EA },
-    { L"egrave", 0x00E8 },
-    { L"empty", 0x2205 },
-    { L"emsp", 0x2003 },
-    { L"ensp", 0x2002 },
-    { L"epsilon", 0x03B5 },
-    { L"equiv", 0x2261 },
-    { L"eta", 0x03B7 },
-    { L"eth", 0x00F0 },
-    { L"euml", 0x00EB },
-    { L"euro", 0x20AC },
-    { L"exist", 0x2203 },
-    { L"fnof", 0x0192 },
-    { L"forall", 0x2200 },
-    { L"frac12", 0x00BD },
-    { L"frac14", 0x00BC },
-    { L"frac34", 0x00BE },
-    { L"frasl", 0x2044 },
+    { L"sect", 0x00A7 },
+    { L"mdash", 0x2014 },
+    { L"notin", 0x2209 },
+    { L"bdquo", 0x201E },
+    { L"iota", 0x03B9 },
+    { L"Phi", 0x03A6 },
+    { L"Agrave", 0x00C0 },
+    { L"Uacute", 0x00DA },
     { L"gamma", 0x03B3 },
-    { L"ge", 0x2265 },
-    { L"gt", 0x003E },
     { L"hArr", 0x21D4 },
-    { L"harr", 0x2194 },
-    { L"hearts", 0x2665 },
-    { L"hellip", 0x2026 },
-    { L"iacute", 0x00ED },
-    { L"icirc", 0x00EE },
-    { L"iexcl", 0x00A1 },
-    { L"igrave", 0x00EC },
-    { L"image", 0x2111 },
-    { L"infin", 0x221E },
-    { L"int", 0x222B },
-    { L"iota", 0x03B9 },
-    { L"iquest", 0x00BF },
-    { L"isin", 0x2208 },
-    { L"iuml", 0x00EF },
-    { L"kappa", 0x03BA },
-    { L"lArr", 0x21D0 },
-    { L"lambda", 0x03BB },
-    { L"lang", 0x2329 },
-    { L"laquo", 0x00AB },
-    { L"larr", 0x2190 },
-    { L"lceil", 0x2308 },
-    { L"ldquo", 0x201C },
-    { L"le", 0x2264 },
-    { L"lfloor", 0x230A },
-    { L"lowast", 0x2217 },
     { L"loz", 0x25CA },
-    { L"lrm", 0x200E },
-    { L"lsaquo", 0x2039 },
-    { L"lsquo", 0x2018 },
-    { L"lt", 0x003C },
-    { L"macr", 0x00AF },
-    { L"mdash", 0x2014 },
-    { L"micro", 0x00B5 },
-    { L"middot", 0x00B7 },
-    { L"minus", 0x2212 },
+    { L"phi", 0x03C6 },
     { L"mu", 0x03BC },
-    { L"nabla", 0x2207 },
-    { L"nbsp", 0x00A0 },
+    { L"forall", 0x2200 },
+    { L"Iacute", 0x00CD },
+    { L"psi", 0x03C8 },
+    { L"isin", 0x2208 },
+    { L"atilde", 0x00E3 },
+    { L"uArr", 0x21D1 },
+    { L"sub", 0x2282 },
+    { L"amp", 0x0026 },
+    { L"prop", 0x221D },
+    { L"oline", 0x203E },
+    { L"eta", 0x03B7 },
+    { L"zeta", 0x03B6 },
+    { L"lang", 0x2329 },
+    { L"frac14", 0x00BC },
     { L"ndash", 0x2013 },
-    { L"ne", 0x2260 },
-    { L"ni", 0x220B },
-    { L"not", 0x00AC },
-    { L"notin", 0x2209 },
-    { L"nsub", 0x2284 },
-    { L"ntilde", 0x00F1 },
+    { L"dagger", 0x2020 },
+    { L"supe", 0x2287 },
+    { L"emsp", 0x2003 },
+    { L"yen", 0x00A5 },
+    { L"frasl", 0x2044 },
+    { L"Scaron", 0x0160 },
+    { L"real", 0x211C },
+    { L"epsilon", 0x03B5 },
+    { L"Auml", 0x00C4 },
+    { L"Xi", 0x039E },
+    { L"deg", 0x00B0 },
+    { L"Upsilon", 0x03A5 },
+    { L"Oacute", 0x00D3 },
+    { L"ordf", 0x00AA },
+    { L"micro", 0x00B5 },
+    { L"kappa", 0x03BA },
+    { L"sube", 0x2286 },
+    { L"sup", 0x2283 },
+    { L"sup3", 0x00B3 },
     { L"nu", 0x03BD },
-    { L"oacute", 0x00F3 },
-    { L"ocirc", 0x00F4 },
+    { L"image", 0x2111 },
+    { L"not", 0x00AC },
+    { L"oslash", 0x00F8 },
+    { L"Sigma", 0x03A3 },
+    { L"Egrave", 0x00C8 },
+    { L"laquo", 0x00AB },
+    { L"eth", 0x00F0 },
+    { L"scaron", 0x0161 },
+    { L"cent", 0x00A2 },
     { L"oelig", 0x0153 },
     { L"ograve", 0x00F2 },
-    { L"oline", 0x203E },
-    { L"omega", 0x03C9 },
-    { L"omicron", 0x03BF },
-    { L"oplus", 0x2295 },
-    { L"or", 0x2228 },
-    { L"ordf", 0x00AA },
-    { L"ordm", 0x00BA },
-    { L"oslash", 0x00F8 },
-    { L"otilde", 0x00F5 },
-    { L"otimes", 0x2297 },
-    { L"ouml", 0x00F6 },
-    { L"para", 0x00B6 },
-    { L"part", 0x2202 },
-    { L"permil", 0x2030 },
-    { L"perp", 0x22A5 },
-    { L"phi", 0x03C6 },
+    { L"alpha", 0x03B1 },
+    { L"sbquo", 0x201A },
+    { L"Atilde", 0x00C3 },
+    { L"acirc", 0x00E2 },
+    { L"Prime", 0x2033 },
     { L"pi", 0x03C0 },
-    { L"piv", 0x03D6 },
-    { L"plusmn", 0x00B1 },
-    { L"pound", 0x00A3 },
-    { L"prime", 0x2032 },
-    { L"prod", 0x220F },
-    { L"prop", 0x221D },
-    { L"psi", 0x03C8 },
-    { L"quot", 0x0022 },
-    { L"rArr", 0x21D2 },
-    { L"radic", 0x221A },
-    { L"rang", 0x232A },
-    { L"raquo", 0x00BB },
-    { L"rarr", 0x2192 },
-    { L"rceil", 0x2309 },
-    { L"rdquo", 0x201D },
-    { L"real", 0x211C },
-    { L"reg", 0x00AE },
+    { L"Ograve", 0x00D2 },
+    { L"ni", 0x220B },
+    { L"sigmaf", 0x03C2 },
+    { L"sup2", 0x00B2 },
+    { L"harr", 0x2194 },
+    { L"Tau", 0x03A4 },
+    { L"Dagger", 0x2021 },
+    { L"cong", 0x2245 },
+    { L"euro", 0x20AC },
+    { L"diams", 0x2666 },
+    { L"Omicron", 0x039F },
+    { L"minus", 0x2212 },
+    { L"chi", 0x03C7 },
+    { L"Pi", 0x03A0 },
+    { L"ldquo", 0x201C },
     { L"rfloor", 0x230B },
+    { L"or", 0x2228 },
+    { L"ne", 0x2260 },
+    { L"weierp", 0x2118 },
+    { L"spades", 0x2660 },
+    { L"divide", 0x00F7 },
+    { L"iquest", 0x00BF },
+    { L"nsub", 0x2284 },
+    { L"rceil", 0x2309 },
+    { L"trade", 0x2122 },
+    { L"Psi", 0x03A8 },
+    { L"nabla", 0x2207 },
+    { L"Ugrave", 0x00D9 },
+    { L"iexcl", 0x00A1 },
+    { L"cap", 0x2229 },
+    { L"sup1", 0x00B9 },
+    { L"Nu", 0x039D },
+    { L"ensp", 0x2002 },
+    { L"exist", 0x2203 },
+    { L"omicron", 0x03BF },
+    { L"Acirc", 0x00C2 },
+    { L"Alpha", 0x0391 },
     { L"rho", 0x03C1 },
+    { L"lambda", 0x03BB },
+    { L"prod", 0x220F },
+    { L"omega", 0x03C9 },
+    { L"oplus", 0x2295 },
+    { L"Yacute", 0x00DD },
+    { L"agrave", 0x00E0 },
+    { L"Mu", 0x039C },
     { L"rlm", 0x200F },
-    { L"rsaquo", 0x203A },
+    { L"dArr", 0x21D3 },
     { L"rsquo", 0x2019 },
-    { L"sbquo", 0x201A },
-    { L"scaron", 0x0161 },
-    { L"sdot", 0x22C5 },
-    { L"sect", 0x00A7 },
-    { L"shy", 0x00AD },
-    { L"sigma", 0x03C3 },
-    { L"sigmaf", 0x03C2 },
-    { L"sim", 0x223C },
-    { L"spades", 0x2660 },
-    { L"sub", 0x2282 },
-    { L"sube", 0x2286 },
-    { L"sum", 0x2211 },
-    { L"sup", 0x2283 },
-    { L"sup1", 0x00B9 },
-    { L"sup2", 0x00B2 },
-    { L"sup3", 0x00B3 },
-    { L"supe", 0x2287 },
-    { L"szlig", 0x00DF },
-    { L"tau", 0x03C4 },
-    { L"there4", 0x2234 },
-    { L"theta", 0x03B8 },
-    { L"thetasym", 0x03D1 },
-    { L"thinsp", 0x2009 },
-    { L"thorn", 0x00FE },
-    { L"tilde", 0x02DC },
-    { L"times", 0x00D7 },
-    { L"trade", 0x2122 },
-    { L"uArr", 0x21D1 },
-    { L"uacute", 0x00FA },
-    { L"uarr", 0x2191 },
-    { L"ucirc", 0x00FB },
-    { L"ugrave", 0x00F9 },
-    { L"uml", 0x00A8 },
-    { L"upsih", 0x03D2 },
-    { L"upsilon", 0x03C5 },
-    { L"uuml", 0x00FC },
-    { L"weierp", 0x2118 },
-    { L"xi", 0x03BE },
-    { L"yacute", 0x00FD },
-    { L"yen", 0x00A5 },
-    { L"yuml", 0x00FF },
-    { L"zeta", 0x03B6 },
-    { L"zwj", 0x200D },
-    { L"zwnj", 0x200C }
+    { L"copy", 0x00A9 },
+    { L"Ucirc", 0x00DB },
+    { L"lt", 0x003C },
+    { L"OElig", 0x0152 }
+  };
+
+  static const int entDisplacement[] = {
+    2, 2, 0, 1, 0, -8, -9, 0, -12, 3,
+    -15, -20, 3, 0, -23, 0, -33, 0, -35, -38,
+    1, 1, 5, 1, 0, -40, 4, 3, -41, -47,
+    0, 2, 0, 7, 1, 4, 2, 0, 0, -49,
+    -51, 6, 4, 1, -52, 2, -62, -63, 0, -64,
+    0, -67, -71, 0, -72, 3, 3, -73, 0, 3,
+    1, 0, -74, 0, 0, -75, 2, 0, -80, 2,
+    1, 0, 0, -81, -86, 3, -88, -96, -98, 0,
+    -99, -102, 0, 1, -103, 0, -105, 0, 0, 1,
+    0, 4, 0, 0, 0, 0, 0, 4, 0, -107,
+    0, 0, -115, 1, -118, 0, -119, -121, 0, 0,
+    9, -124, 3, -133, 0, -135, 0, 0, 0, 0,
+    0, 0, -141, 0, 17, -144, 0, 0, 0, 0,
+    -145, -146, 0, 0, -148, 4, -152, 0, -154, 0,
+    0, 0, 0, -156, -158, 0, 0, 0, 5, 4,
+    -160, -161, 0, -162, 0, 0, -165, 0, 0, 0,
+    1, 1, 2, 5, 2, 1, -169, -171, -174, 1,
+    0, -176, -180, 1, 0, -182, 1, -184, 2, -186,
+    0, 0, -190, 0, -191, 2, -192, 0, 0, 7,
+    0, 0, -195, -201, 0, -203, 0, 0, 0, -204,
+    4, 1, -205, 0, 0, 0, -211, -213, 0, 0,
+    1, -218, 0, -219, 3, 15, 2, 0, 0, -220,
+    3, -230, 0, 1, 1, 2, 0, 0, 22, 4,
+    -233, 0, -235, -238, 0, 0, 0, -240, 9, 1,
+    21, -244, -246, 0, 0, 8, 0, -247, 1, 0,
+    0
   };
 
   static const Ent rent[] = {
@@ -305,12 +335,57 @@ namespace
     { L"gt", 0x003E }
   };
 
+  const unsigned entCount = sizeof(ent)/sizeof(Ent);
+
+  // must match the hash function in utils/entityhash.pl
+  uint32_t entityHash(uint32_t d, const String& entity)
+  {
+      if (d == 0)
+          d = 0x811c9dc5;
+      for (String::const_iterator it = entity.begin(); it != entity.end(); ++it)
+          d = (d ^ static_cast<uint32_t>(it->value())) * 0x01000193;
+      return d;
+  }
+
+  const Ent* findEntity(const String& entity)
+  {
+      int d = entDisplacement[entityHash(0, entity) % entCount];
+      unsigned idx = d < 0 ? static_cast<unsigned>(-d - 1)
+                           : entityHash(static_cast<uint32_t>(d), entity) % entCount;
+      return entity.compare(ent[idx].entity) == 0 ? &ent[idx] : 0;
+  }
+
+  // returns true, if the character can be output without replacing it by an entity
+  inline bool isPlain(Char::value_type ch)
+  {
+      return ch >= ' ' && ch <= 0x7F
+          && ch != '"' && ch != '&' && ch != '\'' && ch != '<' && ch != '>';
+  }
+
   void printEntity(std::basic_ostream<Char>& os, const wchar_t* p)
   {
-      os << Char('&');
+      Char buffer[16];
+      unsigned n = 0;
+      buffer[n++] = Char('&');
       while (*p)
-          os << Char(*p++);
-      os << Char(';');
+          buffer[n++] = Char(*p++);
+      buffer[n++] = Char(';');
+      os.write(buffer, n);
+  }
+
+  void printNumericEntity(std::basic_ostream<Char>& os, uint32_t code)
+  {
+      Char buffer[16];
+      Char* p = buffer + sizeof(buffer)/sizeof(Char);
+      *--p = Char(';');
+      do
+      {
+          *--p = Char('0' + code % 10);
+          code /= 10;
+      } while (code > 0);
+      *--p = Char('#');
+      *--p = Char('&');
+      os.write(p, buffer + sizeof(buffer)/sizeof(Char) - p);
   }
 }
 
@@ -350,33 +425,13 @@ String EntityResolver::resolveEntity(const String& entity) const
         return String( 1, Char(code) );
     }
 
-    unsigned u = 0;
-    unsigned o = sizeof(ent)/sizeof(Ent) - 1;
-    while (o - u > 1)
-    {
-        unsigned m = (o + u) / 2;
-        int c = entity.compare(ent[m].entity);
-        if (c == 0)
-            return String(1, Char(ent[m].charValue));
-        else if (c < 0)
-            o = m;
-        else
-            u = m;
-    }
-
-    if (entity.compare(ent[u].entity) == 0)
-        return String(1, Char(ent[u].charValue));
-
-    if (entity.compare(ent[o].entity) == 0)
-        return String(1, Char(ent[o].charValue));
+    const Ent* e = findEntity(entity);
+    if (e)
+        return String(1, Char(e->charValue));
 
     EntityMap::const_iterator it = _entityMap.find(entity);
     if( it == _entityMap.end() )
-    {
-        it = _entityMap.find(entity);
-        if( it == _entityMap.end() )
-            throw std::runtime_error("invalid entity " + entity.narrow());
-    }
+        throw std::runtime_error("invalid entity " + entity.narrow());
 
     return it->second;
 }
@@ -416,7 +471,28 @@ void EntityResolver::getEntity(std::basic_ostream<Char>& os, Char ch) const
     else if (ch.value() >= ' ' && ch.value() <= 0x7F)
         os << ch;
     else
-        os << Char('&') << Char('#') << static_cast<uint32_t>(ch.value()) << Char(';');
+        printNumericEntity(os, static_cast<uint32_t>(ch.value()));
+}
+
+
+void EntityResolver::getEntities(std::basic_ostream<Char>& os, const String& str) const
+{
+    const Char* p = str.data();
+    const Char* e = p + str.size();
+
+    while (p != e)
+    {
+        // write characters, which need no replacement, in one block
+        const Char* b = p;
+        while (p != e && isPlain(p->value()))
+            ++p;
+
+        if (p != b)
+            os.write(b, p - b);
+
+        if (p != e)
+            getEntity(os, *p++);
+    }
 }
 
 
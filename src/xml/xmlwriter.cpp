@@ -177,10 +177,7 @@ void XmlWriter::writeElement(const String& localName, const Attribute* attr, siz
 void XmlWriter::writeCharacters(const String& text)
 {
     static EntityResolver resolver;
-
-    String::const_iterator it;
-    for(it = text.begin(); it != text.end(); ++it)
-        resolver.getEntity(_tos, *it);
+    resolver.getEntities(_tos, text);
 }
 
 
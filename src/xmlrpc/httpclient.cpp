@@ -54,7 +54,7 @@ HttpClient::HttpClient(SelectorBase& selector, const std::string& server,
                              unsigned short port, const std::string& url)
 : _impl(0)
 {
-    prepareConnect(net::AddrInfo(server, port), url);
+    prepareConnect(net::AddrInfo::beginResolve(server, port), url);
     setSelector(selector);
 }
 
@@ -62,7 +62,7 @@ HttpClient::HttpClient(SelectorBase& selector, const std::string& server,
 HttpClient::HttpClient(SelectorBase& selector, const net::Uri& uri)
 : _impl(0)
 {
-    prepareConnect(net::AddrInfo(uri.host(), uri.port()), uri.path());
+    prepareConnect(net::AddrInfo::beginResolve(uri.host(), uri.port()), uri.path());
     setSelector(selector);
     auth(uri.user(), uri.password());
 }
@@ -71,14 +71,14 @@ HttpClient::HttpClient(SelectorBase& selector, const net::Uri& uri)
 HttpClient::HttpClient(const std::string& server, unsigned short port, const std::string& url)
 : _impl(0)
 {
-    prepareConnect(net::AddrInfo(server, port), url);
+    prepareConnect(net::AddrInfo::beginResolve(server, port), url);
 }
 
 
 HttpClient::HttpClient(const net::Uri& uri)
 : _impl(0)
 {
-    prepareConnect(net::AddrInfo(uri.host(), uri.port()), uri.path());
+    prepareConnect(net::AddrInfo::beginResolve(uri.host(), uri.port()), uri.path());
     auth(uri.user(), uri.password());
 }
 
@@ -126,13 +126,13 @@ void HttpClient::prepareConnect(const net::Uri& uri)
 {
     if (uri.protocol() != "http")
         throw std::runtime_error("only http is supported by http client");
-    prepareConnect(net::AddrInfo(uri.host(), uri.port()), uri.path());
+    prepareConnect(net::AddrInfo::beginResolve(uri.host(), uri.port()), uri.path());
 }
 
 void HttpClient::prepareConnect(const std::string& host, unsigned short port,
              const std::string& url)
 {
-    prepareConnect(net::AddrInfo(host, port), url);
+    prepareConnect(net::AddrInfo::beginResolve(host, port), url);
 }
 
 void HttpClient::connect()
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/net/addrinfo.h"
+#include "cxxtools/net/tcpserver.h"
+#include "cxxtools/net/tcpsocket.h"
+#include "cxxtools/selector.h"
+
+namespace
+{
+    const unsigned short testPort = 7005;
+}
+
+class AddrInfoTest : public cxxtools::unit::TestSuite
+{
+        bool _connected;
+        bool _connectFailed;
+
+        void onConnect(cxxtools::net::TcpSocket& socket)
+        {
+            try
+            {
+                socket.endConnect();
+                _connected = true;
+            }
+            catch (const std::exception&)
+            {
+                _connectFailed = true;
+            }
+        }
+
+    public:
+        AddrInfoTest()
+        : cxxtools::unit::TestSuite("addrinfo")
+        {
+            registerMethod("numericHost", *this, &AddrInfoTest::numericHost);
+            registerMethod("resolve", *this, &AddrInfoTest::resolve);
+            registerMethod("cache", *this, &AddrInfoTest::cache);
+            registerMethod("asyncConnect", *this, &AddrInfoTest::asyncConnect);
+        }
+
+        void setUp()
+        {
+            cxxtools::net::AddrInfo::clearCache();
+            _connected = false;
+            _connectFailed = false;
+        }
+
+        void numericHost()
+        {
+            cxxtools::net::AddrInfo ai = cxxtools::net::AddrInfo::beginResolve("127.0.0.1", testPort);
+            CXXTOOLS_UNIT_ASSERT(ai.isResolved());
+            ai.endResolve();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(ai.host(), "127.0.0.1");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(ai.port(), testPort);
+        }
+
+        void resolve()
+        {
+            cxxtools::net::AddrInfo ai = cxxtools::net::AddrInfo::beginResolve("localhost", testPort);
+            ai.endResolve();
+            CXXTOOLS_UNIT_ASSERT(ai.isResolved());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(ai.host(), "localhost");
+        }
+
+        void cache()
+        {
+            cxxtools::net::AddrInfo ai1("localhost", testPort);
+            cxxtools::net::AddrInfo ai2 = cxxtools::net::AddrInfo::beginResolve("localhost", testPort);
+            CXXTOOLS_UNIT_ASSERT(ai2.isResolved());
+
+            cxxtools::Timespan timeout = cxxtools::net::AddrInfo::cacheTimeout();
+            cxxtools::net::AddrInfo::cacheTimeout(cxxtools::Timespan(0));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::net::AddrInfo::cacheTimeout(), cxxtools::Timespan(0));
+            cxxtools::net::AddrInfo::cacheTimeout(timeout);
+        }
+
+        void asyncConnect()
+        {
+            cxxtools::Selector selector;
+
+            cxxtools::net::TcpServer server("127.0.0.1", testPort);
+            selector.add(server);
+
+            cxxtools::net::TcpSocket client;
+            connect(client.connected, *this, &AddrInfoTest::onConnect);
+            client.beginConnect("localhost", testPort);
+            selector.add(client);
+
+            for (unsigned n = 0; n < 10 && !_connected && !_connectFailed; ++n)
+                selector.wait(1000);
+
+            CXXTOOLS_UNIT_ASSERT(_connected);
+            CXXTOOLS_UNIT_ASSERT(!_connectFailed);
+        }
+};
+
+cxxtools::unit::RegisterTest<AddrInfoTest> register_AddrInfoTest;
@@ -27,6 +27,7 @@
  */
 
 #include <iostream>
+#include <sstream>
 #include "cxxtools/base64stream.h"
 #include "cxxtools/unit/testsuite.h"
 #include "cxxtools/unit/registertest.h"
@@ -57,6 +58,9 @@ class Base64Test : public cxxtools::unit::TestSuite
             registerMethod("whitespaceDecodeTest", *this, &Base64Test::whitespaceDecodeTest);
             registerMethod("binaryTest", *this, &Base64Test::binaryTest);
             registerMethod("artemTest", *this, &Base64Test::artemTest);
+            registerMethod("lineWrapTest", *this, &Base64Test::lineWrapTest);
+            registerMethod("longWhitespaceDecodeTest", *this, &Base64Test::longWhitespaceDecodeTest);
+            registerMethod("streamTest", *this, &Base64Test::streamTest);
         }
 
         void encodeTest0()
@@ -206,6 +210,61 @@ class Base64Test : public cxxtools::unit::TestSuite
                 CXXTOOLS_UNIT_ASSERT_EQUALS(data, data2);
             }
         }
+
+        void lineWrapTest()
+        {
+            // 57 bytes fill exactly one line of 76 characters
+            std::string data(114, '\0');
+            std::string b64 = cxxtools::Base64Codec::encode(data);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(b64, std::string(76, 'A') + "\r\n" + std::string(76, 'A'));
+
+            data += '\0';
+            b64 = cxxtools::Base64Codec::encode(data);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(b64, std::string(76, 'A') + "\r\n" + std::string(76, 'A') + "\r\nAA==");
+        }
+
+        void longWhitespaceDecodeTest()
+        {
+            std::string data;
+            for (unsigned n = 0; n < 1000; ++n)
+                data += static_cast<char>(n * 7 + n / 256);
+
+            std::string b64 = cxxtools::Base64Codec::encode(data);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::Base64Codec::decode(b64), data);
+
+            // white space inside of groups
+            std::string spaced;
+            for (unsigned n = 0; n < b64.size(); ++n)
+            {
+                spaced += b64[n];
+                if (n % 37 == 0)
+                    spaced += " \t";
+            }
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::Base64Codec::decode(spaced), data);
+
+            CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::Base64Codec::decode(b64.substr(0, 131)), cxxtools::ConversionError);
+        }
+
+        void streamTest()
+        {
+            std::string data;
+            for (unsigned n = 0; n < 10000; ++n)
+                data += static_cast<char>(n * 13 + n / 100);
+
+            std::ostringstream out;
+            cxxtools::Base64ostream encoder(out);
+            for (unsigned n = 0; n < data.size(); n += 1000)
+                encoder.write(data.data() + n, 1000);
+            encoder.terminate();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out.str(), cxxtools::Base64Codec::encode(data));
+
+            std::istringstream in(out.str());
+            cxxtools::Base64istream decoder(in);
+            std::ostringstream decoded;
+            decoded << decoder.rdbuf();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(decoded.str(), data);
+        }
 };
 
 cxxtools::unit::RegisterTest<Base64Test> register_Base64Test;
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2016 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+   Benchmark for base64 encoding and decoding.
+
+   Random binary data is encoded with Base64Codec::encode and through a
+   Base64ostream and decoded again with Base64Codec::decode and through a
+   Base64istream.
+ */
+
+#include <cxxtools/base64codec.h>
+#include <cxxtools/base64stream.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <stdint.h>
+
+namespace
+{
+  void report(const char* what, cxxtools::Timespan t, unsigned long iterations, std::size_t bytes)
+  {
+    double mb = static_cast<double>(bytes) * iterations / 1024 / 1024;
+    std::cout << '\t' << what << ": " << t
+              << " (" << static_cast<unsigned long>(mb / t.totalSeconds()) << " MB/s)" << std::endl;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    cxxtools::Arg<std::size_t> size(argc, argv, 's', 1024 * 1024);
+    cxxtools::Arg<unsigned long> iterations(argc, argv, 'n', 100);
+
+    if (argc > 1)
+    {
+      std::cerr << "usage: " << argv[0] << " [options]\n"
+                   "options:\n"
+                   "  -s <size>     size of the binary data in bytes (default 1048576)\n"
+                   "  -n <count>    number of iterations (default 100)\n";
+      return -1;
+    }
+
+    std::string data;
+    data.reserve(size);
+    uint64_t x = 88172645463325252ull;
+    while (data.size() < size)
+    {
+      x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+      data += static_cast<char>(x);
+    }
+
+    std::cout << "base64 (" << data.size() << " bytes)" << std::endl;
+
+    cxxtools::Clock clock;
+    std::string encoded;
+
+    clock.start();
+    for (unsigned long n = 0; n < iterations; ++n)
+      encoded = cxxtools::Base64Codec::encode(data);
+    report("Base64Codec::encode", clock.stop(), iterations, data.size());
+
+    std::string decoded;
+    clock.start();
+    for (unsigned long n = 0; n < iterations; ++n)
+      decoded = cxxtools::Base64Codec::decode(encoded);
+    report("Base64Codec::decode", clock.stop(), iterations, data.size());
+
+    if (decoded != data)
+      std::cout << "\tdecoded data differs from input" << std::endl;
+
+    clock.start();
+    for (unsigned long n = 0; n < iterations; ++n)
+    {
+      std::ostringstream out;
+      cxxtools::Base64ostream encoder(out);
+      encoder.write(data.data(), data.size());
+      encoder.terminate();
+      encoded = out.str();
+    }
+    report("Base64ostream", clock.stop(), iterations, data.size());
+
+    clock.start();
+    for (unsigned long n = 0; n < iterations; ++n)
+    {
+      std::istringstream in(encoded);
+      cxxtools::Base64istream decoder(in);
+      std::ostringstream out;
+      out << decoder.rdbuf();
+      decoded = out.str();
+    }
+    report("Base64istream", clock.stop(), iterations, data.size());
+
+    if (decoded != data)
+      std::cout << "\tdecoded stream data differs from input" << std::endl;
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return -1;
+  }
+}
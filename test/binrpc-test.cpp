@@ -31,6 +31,8 @@
 #include "cxxtools/bin/rpcserver.h"
 #include "cxxtools/remoteexception.h"
 #include "cxxtools/remoteprocedure.h"
+#include "cxxtools/bin/remotestream.h"
+#include "cxxtools/resultstream.h"
 #include "cxxtools/eventloop.h"
 #include "cxxtools/log.h"
 #include "cxxtools/ioerror.h"
@@ -49,6 +51,30 @@ namespace
     typedef std::multiset<int> IntMultiset;
     typedef std::map<int, int> IntMap;
     typedef std::multimap<int, int> IntMultimap;
+
+    class Counter : public cxxtools::ResultGenerator<int>
+    {
+            int _n;
+            int _count;
+            int _failAt;
+
+        public:
+            Counter(int count, int failAt = -1)
+                : _n(0),
+                  _count(count),
+                  _failAt(failAt)
+            { }
+
+            bool next(int& value)
+            {
+                if (_n == _failAt)
+                    throw cxxtools::RemoteException("Stream failed", 5);
+                if (_n >= _count)
+                    return false;
+                value = _n++;
+                return true;
+            }
+    };
 }
 
 class BinRpcTest : public cxxtools::unit::TestSuite
@@ -57,6 +83,9 @@ class BinRpcTest : public cxxtools::unit::TestSuite
         cxxtools::EventLoop _loop;
         cxxtools::bin::RpcServer* _server;
         unsigned _count;
+        std::vector<int> _elements;
+        cxxtools::bin::RemoteStream<int, int>* _pauseStream;
+        int _stored;
         std::string _listen;
         unsigned short _port;
 
@@ -89,6 +118,13 @@ class BinRpcTest : public cxxtools::unit::TestSuite
             registerMethod("PrepareConnect", *this, &BinRpcTest::PrepareConnect);
             registerMethod("Connect", *this, &BinRpcTest::Connect);
             registerMethod("Multiple", *this, &BinRpcTest::Multiple);
+            registerMethod("Stream", *this, &BinRpcTest::Stream);
+            registerMethod("SyncStream", *this, &BinRpcTest::SyncStream);
+            registerMethod("StreamPause", *this, &BinRpcTest::StreamPause);
+            registerMethod("StreamWriteTimeout", *this, &BinRpcTest::StreamWriteTimeout);
+            registerMethod("StreamFault", *this, &BinRpcTest::StreamFault);
+            registerMethod("StreamArray", *this, &BinRpcTest::StreamArray);
+            registerMethod("Oneway", *this, &BinRpcTest::Oneway);
 
             char* PORT = getenv("UTEST_PORT");
             if (PORT)
@@ -802,6 +838,256 @@ class BinRpcTest : public cxxtools::unit::TestSuite
 
         }
 
+        ////////////////////////////////////////////////////////////
+        // Stream
+        //
+        void Stream()
+        {
+            _server->registerMethod("count", *this, &BinRpcTest::count);
+
+            cxxtools::bin::RpcClient client(_loop, _listen, _port);
+            cxxtools::bin::RemoteStream<int, int> count(client, "count");
+            cxxtools::connect(count.element, *this, &BinRpcTest::onElement);
+
+            _elements.clear();
+            count.begin(20000);
+            count.end(2000);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_elements.size(), 20000);
+            for (unsigned n = 0; n < _elements.size(); ++n)
+                CXXTOOLS_UNIT_ASSERT_EQUALS(_elements[n], static_cast<int>(n));
+        }
+
+        cxxtools::ResultStream<int> count(int n)
+        {
+            return cxxtools::ResultStream<int>(new Counter(n));
+        }
+
+        void onElement(const int& value)
+        {
+            _elements.push_back(value);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // SyncStream
+        //
+        void SyncStream()
+        {
+            _server->registerMethod("count", *this, &BinRpcTest::count);
+            _server->registerMethod("fetch", *this, &BinRpcTest::fetch);
+
+            // the server is started in the event loop
+            {
+                cxxtools::bin::RpcClient client(_loop, _listen, _port);
+                cxxtools::RemoteProcedure<int> fetch(client, "fetch");
+                fetch.begin();
+                fetch.end(2000);
+            }
+
+            cxxtools::bin::RpcClient client(_listen, _port);
+            client.timeout(2000);
+            cxxtools::bin::RemoteStream<int, int> count(client, "count");
+            cxxtools::connect(count.element, *this, &BinRpcTest::onElement);
+
+            _elements.clear();
+            count.call(100);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_elements.size(), 100);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_elements.back(), 99);
+
+            // the connection is reused for the next stream
+            _elements.clear();
+            count.call(3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_elements.size(), 3);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // StreamPause
+        //
+        void StreamPause()
+        {
+            _server->registerMethod("count", *this, &BinRpcTest::count);
+
+            cxxtools::bin::RpcClient client(_loop, _listen, _port);
+            cxxtools::bin::RemoteStream<int, int> count(client, "count");
+            _pauseStream = &count;
+            cxxtools::connect(count.element, *this, &BinRpcTest::onElementPause);
+
+            _elements.clear();
+            count.begin(50000);
+
+            try
+            {
+                count.end(500);
+                CXXTOOLS_UNIT_ASSERT_MSG(false, "cxxtools::IOTimeout exception expected");
+            }
+            catch (const cxxtools::IOTimeout&)
+            {
+            }
+
+            CXXTOOLS_UNIT_ASSERT(count.paused());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_elements.size(), 10);
+
+            count.resume();
+            count.end(2000);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_elements.size(), 50000);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_elements.back(), 49999);
+        }
+
+        void onElementPause(const int& value)
+        {
+            _elements.push_back(value);
+            if (_elements.size() == 10)
+                _pauseStream->pause();
+        }
+
+        ////////////////////////////////////////////////////////////
+        // StreamWriteTimeout
+        //
+        void StreamWriteTimeout()
+        {
+            _server->registerMethod("count", *this, &BinRpcTest::count);
+            _server->writeTimeout(cxxtools::Milliseconds(200));
+
+            cxxtools::bin::RpcClient client(_loop, _listen, _port);
+            cxxtools::bin::RemoteStream<int, int> count(client, "count");
+            _pauseStream = &count;
+            cxxtools::connect(count.element, *this, &BinRpcTest::onElementPause);
+
+            // the stream is much larger than the socket buffers
+            _elements.clear();
+            count.begin(10000000);
+
+            try
+            {
+                count.end(1000);
+                CXXTOOLS_UNIT_ASSERT_MSG(false, "cxxtools::IOTimeout exception expected");
+            }
+            catch (const cxxtools::IOTimeout&)
+            {
+            }
+
+            // the server gave up and closed the connection meanwhile, so
+            // the client gets the buffered elements and then an error
+            count.resume();
+            try
+            {
+                count.end(2000);
+                CXXTOOLS_UNIT_ASSERT_MSG(false, "cxxtools::IOError exception expected");
+            }
+            catch (const cxxtools::IOTimeout&)
+            {
+                CXXTOOLS_UNIT_ASSERT_MSG(false, "server did not close the connection");
+            }
+            catch (const cxxtools::IOError&)
+            {
+            }
+
+            CXXTOOLS_UNIT_ASSERT(_elements.size() < 10000000);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // StreamFault
+        //
+        void StreamFault()
+        {
+            _server->registerMethod("count", *this, &BinRpcTest::countFault);
+
+            cxxtools::bin::RpcClient client(_loop, _listen, _port);
+            cxxtools::bin::RemoteStream<int, int> count(client, "count");
+            cxxtools::connect(count.element, *this, &BinRpcTest::onElement);
+
+            _elements.clear();
+            count.begin(10);
+
+            try
+            {
+                count.end(2000);
+                CXXTOOLS_UNIT_ASSERT_MSG(false, "cxxtools::RemoteException exception expected");
+            }
+            catch (const cxxtools::RemoteException& e)
+            {
+                CXXTOOLS_UNIT_ASSERT_EQUALS(e.rc(), 5);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(e.text(), "Stream failed");
+            }
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_elements.size(), 5);
+        }
+
+        cxxtools::ResultStream<int> countFault(int n)
+        {
+            return cxxtools::ResultStream<int>(new Counter(n, 5));
+        }
+
+        ////////////////////////////////////////////////////////////
+        // StreamArray
+        //
+        void StreamArray()
+        {
+            _server->registerMethod("array", *this, &BinRpcTest::countArray);
+
+            cxxtools::bin::RpcClient client(_loop, _listen, _port);
+            cxxtools::bin::RemoteStream<int, int> array(client, "array");
+            cxxtools::connect(array.element, *this, &BinRpcTest::onElement);
+
+            _elements.clear();
+            array.begin(4);
+            array.end(2000);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_elements.size(), 4);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_elements[3], 3);
+
+            // a stream result can be received as a whole as well
+            _server->registerMethod("count", *this, &BinRpcTest::count);
+            cxxtools::RemoteProcedure<std::vector<int>, int> count(client, "count");
+            count.begin(3);
+            const std::vector<int>& v = count.end(2000);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(v.size(), 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(v[2], 2);
+        }
+
+        std::vector<int> countArray(int n)
+        {
+            std::vector<int> v;
+            for (int i = 0; i < n; ++i)
+                v.push_back(i);
+            return v;
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Oneway
+        //
+        void Oneway()
+        {
+            _server->registerMethod("store", *this, &BinRpcTest::store);
+            _server->registerMethod("fetch", *this, &BinRpcTest::fetch);
+
+            cxxtools::bin::RpcClient client(_loop, _listen, _port);
+            cxxtools::RemoteProcedure<int> fetch(client, "fetch");
+
+            _count = 0;
+            client.notify("store", 17);
+            client.notify("unknownMethod", 4);
+            client.notify("store", 42);
+
+            // requests of a connection are processed in order
+            fetch.begin();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(fetch.end(2000), 42);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_count, 2);
+        }
+
+        bool store(int value)
+        {
+            _stored = value;
+            ++_count;
+            return true;
+        }
+
+        int fetch()
+        {
+            return _stored;
+        }
+
 };
 
 cxxtools::unit::RegisterTest<BinRpcTest> register_BinRpcTest;
@@ -30,6 +30,8 @@
 #include "cxxtools/cache.h"
 #include "cxxtools/unit/testsuite.h"
 #include "cxxtools/unit/registertest.h"
+#include "cxxtools/string.h"
+#include <string>
 
 class CacheTest : public cxxtools::unit::TestSuite
 {
@@ -41,6 +43,7 @@ class CacheTest : public cxxtools::unit::TestSuite
             registerMethod("erase", *this, &CacheTest::erase);
             registerMethod("resize", *this, &CacheTest::resize);
             registerMethod("stats", *this, &CacheTest::stats);
+            registerMethod("keyTypes", *this, &CacheTest::keyTypes);
         }
 
         void cacheTest()
@@ -176,6 +179,32 @@ class CacheTest : public cxxtools::unit::TestSuite
           CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getMisses(), 1);
         }
 
+        void keyTypes()
+        {
+          // keys need just a less than operator by default
+          cxxtools::Cache<cxxtools::String, int> strings(2);
+          strings.put(cxxtools::String(L"foo"), 1);
+          strings.put(cxxtools::String(L"bar"), 2);
+          strings.put(cxxtools::String(L"baz"), 3);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(strings.size(), 2);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(strings.get(cxxtools::String(L"baz")), 3);
+
+          cxxtools::Cache<std::pair<int, int>, int> pairs(2);
+          pairs.put(std::pair<int, int>(1, 2), 12);
+          pairs.put(std::pair<int, int>(2, 1), 21);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(pairs.get(std::pair<int, int>(1, 2)), 12);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(pairs.get(std::pair<int, int>(2, 1)), 21);
+
+#if __cplusplus >= 201103L
+          cxxtools::Cache<std::string, int, cxxtools::HashedCacheIndex<std::string> > hashed(2);
+          hashed.put("foo", 1);
+          hashed.put("bar", 2);
+          hashed.put("baz", 3);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(hashed.size(), 2);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(hashed.get("baz"), 3);
+#endif
+        }
+
 };
 
 cxxtools::unit::RegisterTest<CacheTest> register_CacheTest;
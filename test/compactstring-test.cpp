@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/compactstring.h"
+#include "cxxtools/conversionerror.h"
+#include "cxxtools/serializationinfo.h"
+#include "cxxtools/json.h"
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include <sstream>
+#include <vector>
+
+class CompactStringTest : public cxxtools::unit::TestSuite
+{
+    public:
+        CompactStringTest()
+        : cxxtools::unit::TestSuite("compactstring")
+        {
+            registerMethod("shortString", *this, &CompactStringTest::shortString);
+            registerMethod("longString", *this, &CompactStringTest::longString);
+            registerMethod("latin1ToUtf8", *this, &CompactStringTest::latin1ToUtf8);
+            registerMethod("conversion", *this, &CompactStringTest::conversion);
+            registerMethod("fromUtf8", *this, &CompactStringTest::fromUtf8);
+            registerMethod("invalidChars", *this, &CompactStringTest::invalidChars);
+            registerMethod("compare", *this, &CompactStringTest::compare);
+            registerMethod("copyAndMove", *this, &CompactStringTest::copyAndMove);
+            registerMethod("serialization", *this, &CompactStringTest::serialization);
+        }
+
+        void shortString()
+        {
+            cxxtools::CompactString s(cxxtools::String(L"Hello"));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s.length(), 5);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s.byteSize(), 5);
+            CXXTOOLS_UNIT_ASSERT(s.isLatin1());
+            CXXTOOLS_UNIT_ASSERT(s.isAscii());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s.capacity(), 23);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(s.data()), "Hello");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s[1], cxxtools::Char('e'));
+            CXXTOOLS_UNIT_ASSERT_THROW(s.at(5), std::out_of_range);
+
+            cxxtools::CompactString e;
+            CXXTOOLS_UNIT_ASSERT(e.empty());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(e.data()), "");
+        }
+
+        void longString()
+        {
+            cxxtools::String str;
+            for (unsigned n = 0; n < 1000; ++n)
+                str += cxxtools::Char(0x20 + n % 200);
+
+            cxxtools::CompactString s(str);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s.length(), 1000);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s.byteSize(), 1000);
+            CXXTOOLS_UNIT_ASSERT(s.isLatin1());
+            CXXTOOLS_UNIT_ASSERT(!s.isAscii());
+            CXXTOOLS_UNIT_ASSERT(s.capacity() >= 1000);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s[999], cxxtools::Char(0x20 + 999 % 200));
+            CXXTOOLS_UNIT_ASSERT(s.toString() == str);
+
+            s.clear();
+            CXXTOOLS_UNIT_ASSERT(s.empty());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s.byteSize(), 0);
+        }
+
+        void latin1ToUtf8()
+        {
+            cxxtools::CompactString s(cxxtools::String(L"K\xf6ln"));
+            CXXTOOLS_UNIT_ASSERT(s.isLatin1());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s.byteSize(), 4);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s.toUtf8(), "K\xc3\xb6ln");
+
+            s += cxxtools::Char(0x20ac);
+            CXXTOOLS_UNIT_ASSERT(!s.isLatin1());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s.length(), 5);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s.byteSize(), 8);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(s.data(), s.byteSize()), "K\xc3\xb6ln\xe2\x82\xac");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s[1], cxxtools::Char(0xf6));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s[4], cxxtools::Char(0x20ac));
+
+            // latin-1 data appended to an utf-8 string is encoded
+            s += cxxtools::CompactString(cxxtools::String(L"\xe4"));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s.length(), 6);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s.toUtf8(), "K\xc3\xb6ln\xe2\x82\xac\xc3\xa4");
+
+            // a long latin-1 string is converted in place
+            cxxtools::CompactString l = cxxtools::CompactString::fromLatin1(std::string(100, '\xe9'));
+            l.append(cxxtools::String(1, cxxtools::Char(0x1f600)));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(l.length(), 101);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(l.byteSize(), 204);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(l[99], cxxtools::Char(0xe9));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(l[100], cxxtools::Char(0x1f600));
+        }
+
+        void conversion()
+        {
+            cxxtools::String str;
+            for (unsigned n = 0; n < 300; ++n)
+                str += cxxtools::Char(n % 7 == 0 ? 0x10000 + n : n % 5 == 0 ? 0x400 + n : 0x20 + n % 90);
+
+            cxxtools::CompactString s(str);
+            CXXTOOLS_UNIT_ASSERT(!s.isLatin1());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s.length(), str.length());
+            CXXTOOLS_UNIT_ASSERT(s.toString() == str);
+            CXXTOOLS_UNIT_ASSERT(s == str);
+
+            std::vector<cxxtools::Char> chars(s.begin(), s.end());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(chars.size(), str.length());
+            CXXTOOLS_UNIT_ASSERT(cxxtools::String(chars.data(), chars.size()) == str);
+
+            cxxtools::CompactString u = cxxtools::CompactString::fromUtf8(s.toUtf8());
+            CXXTOOLS_UNIT_ASSERT(u == s);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::CompactString(cxxtools::String(L"a\x20ac" L"b")).narrow(), "a?b");
+
+            std::ostringstream out;
+            out << s;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out.str(), s.toUtf8());
+        }
+
+        void fromUtf8()
+        {
+            // utf-8 encoded latin-1 characters are stored latin-1 encoded
+            cxxtools::CompactString s = cxxtools::CompactString::fromUtf8("\xc3\xa4pfel");
+            CXXTOOLS_UNIT_ASSERT(s.isLatin1());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s.length(), 5);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(s.data()), "\xe4pfel");
+
+            s = cxxtools::CompactString::fromUtf8("\xf0\x9f\x98\x80!");
+            CXXTOOLS_UNIT_ASSERT(!s.isLatin1());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s.length(), 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s[0], cxxtools::Char(0x1f600));
+
+            CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::CompactString::fromUtf8("a\xc3"), cxxtools::ConversionError);
+            CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::CompactString::fromUtf8("\xc0\xaf"), cxxtools::ConversionError);
+            CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::CompactString::fromUtf8("\xed\xa0\x80"), cxxtools::ConversionError);
+            CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::CompactString::fromUtf8("\xf4\x90\x80\x80"), cxxtools::ConversionError);
+        }
+
+        void invalidChars()
+        {
+            cxxtools::CompactString s;
+            s += cxxtools::Char(-5);
+            s += cxxtools::Char(0xd800);
+            s += cxxtools::Char(0x110000);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s.length(), 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s[0], cxxtools::Char(0xfffd));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s[1], cxxtools::Char(0xfffd));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s[2], cxxtools::Char(0xfffd));
+        }
+
+        void compare()
+        {
+            cxxtools::CompactString a(cxxtools::String(L"abc"));
+            cxxtools::CompactString b(cxxtools::String(L"ab\xe4"));
+            cxxtools::CompactString c(cxxtools::String(L"ab\x20ac"));
+            cxxtools::CompactString d(cxxtools::String(L"ab"));
+
+            CXXTOOLS_UNIT_ASSERT(a < b);
+            CXXTOOLS_UNIT_ASSERT(b < c);
+            CXXTOOLS_UNIT_ASSERT(a < c);
+            CXXTOOLS_UNIT_ASSERT(d < a);
+            CXXTOOLS_UNIT_ASSERT(c > d);
+            CXXTOOLS_UNIT_ASSERT(a != b);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(c.compare(cxxtools::String(L"ab\x20ac")), 0);
+            CXXTOOLS_UNIT_ASSERT(c.compare(cxxtools::String(L"ab\x20ad")) < 0);
+            CXXTOOLS_UNIT_ASSERT(c.compare(cxxtools::String(L"ab")) > 0);
+            CXXTOOLS_UNIT_ASSERT(a == cxxtools::String(L"abc"));
+        }
+
+        void copyAndMove()
+        {
+            cxxtools::CompactString a = cxxtools::CompactString::fromLatin1(std::string(50, 'x'));
+            cxxtools::CompactString b(a);
+            CXXTOOLS_UNIT_ASSERT(a == b);
+            CXXTOOLS_UNIT_ASSERT(a.data() != b.data());
+
+            const char* data = a.data();
+            cxxtools::CompactString c(std::move(a));
+            CXXTOOLS_UNIT_ASSERT(c.data() == data);
+            CXXTOOLS_UNIT_ASSERT(a.empty());
+
+            c += c;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(c.length(), 100);
+
+            cxxtools::CompactString d(cxxtools::String(L"short"));
+            d = c;
+            CXXTOOLS_UNIT_ASSERT(d == c);
+            swap(b, d);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(b.length(), 100);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(d.length(), 50);
+        }
+
+        void serialization()
+        {
+            std::vector<cxxtools::CompactString> v;
+            v.push_back(cxxtools::CompactString(cxxtools::String(L"plain")));
+            v.push_back(cxxtools::CompactString(cxxtools::String(L"K\xf6ln")));
+            v.push_back(cxxtools::CompactString(cxxtools::String(L"\x20ac 10")));
+
+            std::stringstream data;
+            data << cxxtools::Json(v);
+
+            std::vector<cxxtools::String> s;
+            data >> cxxtools::Json(s);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s.size(), 3);
+            CXXTOOLS_UNIT_ASSERT(s[0] == v[0]);
+            CXXTOOLS_UNIT_ASSERT(s[1] == v[1]);
+            CXXTOOLS_UNIT_ASSERT(s[2] == v[2]);
+
+            std::vector<cxxtools::CompactString> r;
+            data.clear();
+            data.seekg(0);
+            data >> cxxtools::Json(r);
+            CXXTOOLS_UNIT_ASSERT(r == v);
+
+            cxxtools::SerializationInfo si;
+            si <<= std::string("\xe9t\xe9");
+            cxxtools::CompactString l;
+            si >>= l;
+            CXXTOOLS_UNIT_ASSERT(l.isLatin1());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(l[0], cxxtools::Char(0xe9));
+        }
+};
+
+cxxtools::unit::RegisterTest<CompactStringTest> register_CompactStringTest;
@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/concurrentcache.h"
+#include "cxxtools/thread.h"
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    // std::pair has no std::hash specialization
+    struct PairHash
+    {
+        std::size_t operator() (const std::pair<int, int>& p) const
+        { return std::hash<int>()(p.first) * 31 + std::hash<int>()(p.second); }
+    };
+}
+
+class ConcurrentCacheTest : public cxxtools::unit::TestSuite
+{
+        typedef cxxtools::ConcurrentCache<int, int> CacheType;
+
+        CacheType* _cache;
+        std::atomic<unsigned> _computations;
+        std::atomic<unsigned> _errors;
+        bool _fail;
+
+        int compute(int key)
+        {
+            ++_computations;
+            cxxtools::Thread::sleep(cxxtools::Milliseconds(50));
+            if (_fail)
+                throw std::runtime_error("compute failed");
+            return key * 10;
+        }
+
+        void worker()
+        {
+            for (int key = 0; key < 4; ++key)
+            {
+                try
+                {
+                    int value = _cache->getOrCompute(key, [this, key] () { return this->compute(key); });
+                    if (value != key * 10)
+                        ++_errors;
+                }
+                catch (const std::runtime_error&)
+                {
+                    ++_errors;
+                }
+            }
+        }
+
+        void runWorkers(unsigned count)
+        {
+            std::vector<cxxtools::AttachedThread*> threads;
+            for (unsigned n = 0; n < count; ++n)
+                threads.push_back(new cxxtools::AttachedThread(cxxtools::callable(*this, &ConcurrentCacheTest::worker)));
+
+            for (unsigned n = 0; n < count; ++n)
+                threads[n]->start();
+
+            for (unsigned n = 0; n < count; ++n)
+            {
+                threads[n]->join();
+                delete threads[n];
+            }
+        }
+
+    public:
+        ConcurrentCacheTest()
+        : cxxtools::unit::TestSuite("concurrentcache"),
+          _cache(0),
+          _computations(0),
+          _errors(0),
+          _fail(false)
+        {
+            registerMethod("putGet", *this, &ConcurrentCacheTest::putGet);
+            registerMethod("eviction", *this, &ConcurrentCacheTest::eviction);
+            registerMethod("ttl", *this, &ConcurrentCacheTest::ttl);
+            registerMethod("getOrCompute", *this, &ConcurrentCacheTest::getOrCompute);
+            registerMethod("collapseMisses", *this, &ConcurrentCacheTest::collapseMisses);
+            registerMethod("computeFails", *this, &ConcurrentCacheTest::computeFails);
+            registerMethod("customHash", *this, &ConcurrentCacheTest::customHash);
+        }
+
+        void putGet()
+        {
+            cxxtools::ConcurrentCache<std::string, int> cache(100, 4);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.shards(), 4);
+
+            cache.put("one", 1);
+            cache.put("two", 2);
+            cache.put("three", 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), 3);
+
+            std::pair<bool, int> result = cache.getx("two");
+            CXXTOOLS_UNIT_ASSERT(result.first);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(result.second, 2);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.get("four", -1), -1);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.get("one"), 1);
+
+            CXXTOOLS_UNIT_ASSERT(cache.erase("one"));
+            CXXTOOLS_UNIT_ASSERT(!cache.erase("one"));
+            CXXTOOLS_UNIT_ASSERT(!cache.getx("one").first);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getHits(), 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getMisses(), 2);
+
+            // the statistics are kept unless requested
+            cache.clear();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getHits(), 2);
+
+            cache.clear(true);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getHits(), 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getMisses(), 0);
+        }
+
+        void eviction()
+        {
+            CacheType cache(128, 4);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getMaxElements(), 128);
+
+            // an element, which is found, stays in the cache
+            cache.put(-1, -1);
+            for (int n = 0; n < 10000; ++n)
+            {
+                cache.put(n, n);
+                CXXTOOLS_UNIT_ASSERT(cache.getx(-1).first);
+            }
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), 128);
+        }
+
+        void ttl()
+        {
+            CacheType cache(100, 4, cxxtools::Milliseconds(20));
+            cache.put(1, 10);
+            cache.put(2, 20, cxxtools::Seconds(60));
+            CXXTOOLS_UNIT_ASSERT(cache.getx(1).first);
+
+            cxxtools::Thread::sleep(cxxtools::Milliseconds(40));
+
+            CXXTOOLS_UNIT_ASSERT(!cache.getx(1).first);
+            CXXTOOLS_UNIT_ASSERT(cache.getx(2).first);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), 1);
+        }
+
+        void getOrCompute()
+        {
+            CacheType cache(100);
+            _computations = 0;
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getOrCompute(7, [this] () { return this->compute(7); }), 70);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getOrCompute(7, [this] () { return this->compute(7); }), 70);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_computations.load(), 1);
+        }
+
+        void collapseMisses()
+        {
+            CacheType cache(100);
+            _cache = &cache;
+            _computations = 0;
+            _errors = 0;
+            _fail = false;
+
+            runWorkers(8);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_errors.load(), 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_computations.load(), 4);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), 4);
+        }
+
+        void computeFails()
+        {
+            CacheType cache(100);
+            _cache = &cache;
+            _computations = 0;
+            _errors = 0;
+            _fail = true;
+
+            runWorkers(4);
+
+            // every thread gets an exception and nothing is cached
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_errors.load(), 16);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), 0);
+        }
+
+        void customHash()
+        {
+            cxxtools::ConcurrentCache<std::pair<int, int>, int, PairHash> cache(100, 4);
+
+            cache.put(std::pair<int, int>(1, 2), 12);
+            cache.put(std::pair<int, int>(2, 1), 21);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.get(std::pair<int, int>(1, 2)), 12);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.get(std::pair<int, int>(2, 1)), 21);
+
+            std::pair<int, int> key(3, 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getOrCompute(key, [] () { return 33; }), 33);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), 3);
+        }
+};
+
+cxxtools::unit::RegisterTest<ConcurrentCacheTest> register_ConcurrentCacheTest;
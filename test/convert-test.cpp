@@ -33,6 +33,8 @@
 #include "cxxtools/log.h"
 #include <limits>
 #include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
 
 log_define("cxxtools.test.convert")
 
@@ -57,6 +59,10 @@ class ConvertTest : public cxxtools::unit::TestSuite
             registerMethod("infTest", *this, &ConvertTest::infTest);
             registerMethod("emptyTest", *this, &ConvertTest::emptyTest);
             registerMethod("floatTest", *this, &ConvertTest::floatTest);
+            registerMethod("shortestTest", *this, &ConvertTest::shortestTest);
+            registerMethod("roundTripTest", *this, &ConvertTest::roundTripTest);
+            registerMethod("floatRoundTripTest", *this, &ConvertTest::floatRoundTripTest);
+            registerMethod("parseCorpusTest", *this, &ConvertTest::parseCorpusTest);
         }
 
         void successTest()
@@ -281,6 +287,144 @@ class ConvertTest : public cxxtools::unit::TestSuite
           t(12);
         }
 
+        void shortestTest()
+        {
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(0.1), "0.1");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(0.3), "0.3");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(1.0 / 3), "0.3333333333333333");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(-2.5), "-2.5");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(100.0), "100");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(1e22), "10000000000000000000000");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(0.0), "0");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(123456789.55555555), "123456789.55555555");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(1.5e-7), "0.00000015");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(0.1f), "0.1");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(3.4028235e38f), "340282350000000000000000000000000000000");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(static_cast<long double>(0.1)), "0.1");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<cxxtools::String>(0.25).narrow(), "0.25");
+        }
+
+        void roundTripTest()
+        {
+          static const double corpus[] = {
+            5e-324, 1e-323, 2.2250738585072009e-308, 2.2250738585072014e-308,
+            1.7976931348623157e308, 9007199254740991.0, 9007199254740992.0,
+            9007199254740994.0, 1e23, 8.41e21, 5.0216813883093446e-301,
+            2.9802322387695312e-8, 4.35091429e-319, 1.2345678901234567e-300,
+            0.1, 0.7, 1.1, 2.675, 123.456, 1e15, 1e16, 1e17, 1.0 / 3, 2.0 / 3 };
+
+          for (unsigned n = 0; n < sizeof(corpus) / sizeof(corpus[0]); ++n)
+            roundTrip(corpus[n]);
+
+          // random bit patterns with a fixed seed
+          uint64_t x = 88172645463325252ull;
+          for (unsigned n = 0; n < 100000; ++n)
+          {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            double d;
+            memcpy(&d, &x, sizeof(d));
+            if (d == d && d - d == 0)
+              roundTrip(d);
+          }
+        }
+
+        void floatRoundTripTest()
+        {
+          uint32_t x = 2463534242u;
+          for (unsigned n = 0; n < 100000; ++n)
+          {
+            x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+            float f;
+            memcpy(&f, &x, sizeof(f));
+            if (f != f || f - f != 0)
+              continue;
+
+            std::string s = cxxtools::convert<std::string>(f);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(strtof(s.c_str(), 0), f);
+
+            float r = cxxtools::convert<float>(s);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(r, f);
+          }
+        }
+
+        void parseCorpusTest()
+        {
+          // values, which are close to the middle of two doubles or need more than 19 digits
+          static const char* corpus[] = {
+            "9007199254740993",
+            "9007199254740993.0000000000000000001",
+            "2.2250738585072011e-308",
+            "2.2250738585072012e-308",
+            "4.9406564584124654e-324",
+            "2.4703282292062327e-324",
+            "2.4703282292062328e-324",
+            "1.7976931348623158e308",
+            "1.7976931348623159e308",
+            "7.2057594037927933e16",
+            "0.500000000000000166533453693773481063544750213623046875",
+            "3.518437208883201171875e13",
+            "62.5364939768271845828",
+            "8.10109172351e-10",
+            "1.00000000000000011102230246251565404236316680908203125",
+            "1.00000000000000011102230246251565404236316680908203124",
+            "1.00000000000000011102230246251565404236316680908203126",
+            "123456789012345678901234567890e-20",
+            "0.000000000000000000000000000000000000000000001e300",
+            "1e-400",
+            "-0.0",
+            "000123.4500" };
+
+          for (unsigned n = 0; n < sizeof(corpus) / sizeof(corpus[0]); ++n)
+          {
+            double d = cxxtools::convert<double>(corpus[n]);
+            log_debug("parse \"" << corpus[n] << "\" => " << d);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(d, strtod(corpus[n], 0));
+
+            float f = cxxtools::convert<float>(corpus[n]);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(f, strtof(corpus[n], 0));
+          }
+
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>("1e400"), std::numeric_limits<double>::infinity());
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>(" -12 "), -12);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>(cxxtools::String(L"0.1")), 0.1);
+          CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::convert<double>("."), cxxtools::ConversionError);
+          CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::convert<double>("1e"), cxxtools::ConversionError);
+        }
+
+    private:
+        void roundTrip(double d)
+        {
+          std::string s = cxxtools::convert<std::string>(d);
+          log_debug("round trip " << d << " => \"" << s << '"');
+
+          // the output must be the shortest, which reads back by strtod
+          char buffer[32];
+          int precision;
+          for (precision = 1; precision < 17; ++precision)
+          {
+            snprintf(buffer, sizeof(buffer), "%.*e", precision - 1, d);
+            if (strtod(buffer, 0) == d)
+              break;
+          }
+
+          unsigned digits = 0;
+          bool leading = true;
+          std::string::size_type end = s.find_last_not_of("0.");
+          for (std::string::size_type p = 0; p <= end && p < s.size(); ++p)
+          {
+            if (s[p] >= '1' && s[p] <= '9')
+              leading = false;
+            if (!leading && s[p] >= '0' && s[p] <= '9')
+              ++digits;
+          }
+
+          if (strtod(s.c_str(), 0) != d || digits != static_cast<unsigned>(precision))
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s, buffer);
+
+          double r = cxxtools::convert<double>(s);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(r, d);
+        }
+
 };
 
 cxxtools::unit::RegisterTest<ConvertTest> register_ConvertTest;
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2016 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/csvreader.h"
+#include "cxxtools/serializationerror.h"
+#include "cxxtools/conversionerror.h"
+#include <sstream>
+
+class CsvReaderTest : public cxxtools::unit::TestSuite
+{
+    public:
+        CsvReaderTest()
+            : cxxtools::unit::TestSuite("csvreader")
+        {
+            registerMethod("testSimple", *this, &CsvReaderTest::testSimple);
+            registerMethod("testNoTitle", *this, &CsvReaderTest::testNoTitle);
+            registerMethod("testQuoted", *this, &CsvReaderTest::testQuoted);
+            registerMethod("testCr", *this, &CsvReaderTest::testCr);
+            registerMethod("testTypes", *this, &CsvReaderTest::testTypes);
+            registerMethod("testColumnCount", *this, &CsvReaderTest::testColumnCount);
+            registerMethod("testUnterminatedQuote", *this, &CsvReaderTest::testUnterminatedQuote);
+            registerMethod("testParallel", *this, &CsvReaderTest::testParallel);
+        }
+
+        void testSimple()
+        {
+            std::string data =
+                "A|B|C\n"
+                "Hello|World|\n"
+                "34|67|23\n";
+
+            cxxtools::CsvReader reader(data.data(), data.size());
+            reader.parse();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.delimiter(), '|');
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.columnCount(), 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.rowCount(), 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.titles()[1], "B");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.column("A")[0].str(), "Hello");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.column("B")[0].str(), "World");
+            CXXTOOLS_UNIT_ASSERT(reader.column("C")[0].empty());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.column(2).title(), "C");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.field(1, 2).str(), "23");
+            CXXTOOLS_UNIT_ASSERT_THROW(reader.column("D"), std::out_of_range);
+        }
+
+        void testNoTitle()
+        {
+            std::string data =
+                "1,2\n"
+                "3,4";
+
+            cxxtools::CsvReader reader(data.data(), data.size());
+            reader.readTitle(false);
+            reader.delimiter(',');
+            reader.parse();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.columnCount(), 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.rowCount(), 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.column(1).get<int>(1), 4);
+        }
+
+        void testQuoted()
+        {
+            std::string data =
+                "\"a,1\",b\n"
+                "\"x\"\"y\",\"multi\nline\"\n"
+                "\"\",z\n";
+
+            cxxtools::CsvReader reader(data.data(), data.size());
+            reader.parse();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.columnCount(), 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.titles()[0], "a,1");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.rowCount(), 2);
+            CXXTOOLS_UNIT_ASSERT(reader.field(0, 0).quoted());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.field(0, 0).str(), "x\"y");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.field(0, 1).str(), "multi\nline");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.field(1, 0).str(), "");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.field(1, 1).str(), "z");
+        }
+
+        void testCr()
+        {
+            std::string data =
+                "a,b\r\n"
+                "1,\"2\"\r\n"
+                "\r\n"
+                "3,4\r\n";
+
+            cxxtools::CsvReader reader(data.data(), data.size());
+            reader.parse();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.titles()[1], "b");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.rowCount(), 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.field(0, 1).str(), "2");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.field(1, 1).str(), "4");
+        }
+
+        void testTypes()
+        {
+            std::string data =
+                "int;double;bool;string\n"
+                "-42;3.5;true;\xc3\xa4\n";
+
+            cxxtools::CsvReader reader(data.data(), data.size());
+            reader.parse();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.column("int").get<int>(0), -42);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.column("double").get<double>(0), 3.5);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.column("bool").get<bool>(0), true);
+            CXXTOOLS_UNIT_ASSERT(reader.column("string")[0].toString() == cxxtools::String(1, cxxtools::Char(0xe4)));
+            CXXTOOLS_UNIT_ASSERT_THROW(reader.column("string").get<int>(0), cxxtools::ConversionError);
+
+            std::vector<double> values;
+            reader.column("double").values(values);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(values.size(), 1);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(values[0], 3.5);
+        }
+
+        void testColumnCount()
+        {
+            std::string data =
+                "a,b\n"
+                "1,2\n"
+                "3\n";
+
+            cxxtools::CsvReader reader(data.data(), data.size());
+            CXXTOOLS_UNIT_ASSERT_THROW(reader.parse(), cxxtools::SerializationError);
+        }
+
+        void testUnterminatedQuote()
+        {
+            std::string data =
+                "a,b\n"
+                "1,\"2\n";
+
+            cxxtools::CsvReader reader(data.data(), data.size());
+            CXXTOOLS_UNIT_ASSERT_THROW(reader.parse(), cxxtools::SerializationError);
+        }
+
+        void testParallel()
+        {
+            std::ostringstream s;
+            s << "id,text,value\n";
+            for (unsigned n = 0; n < 100000; ++n)
+            {
+                s << n << ',';
+                if (n % 3 == 0)
+                    s << "\"quoted, \"\"text\"\"\nwith linefeed\"";
+                else
+                    s << "plain text";
+                s << ',' << (n * 0.5) << '\n';
+            }
+
+            std::string data = s.str();
+
+            cxxtools::CsvReader reader(data.data(), data.size());
+            reader.threads(4);
+            reader.parse();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.rowCount(), 100000);
+
+            cxxtools::CsvReader::Column id = reader.column("id");
+            cxxtools::CsvReader::Column text = reader.column("text");
+            cxxtools::CsvReader::Column value = reader.column("value");
+            for (unsigned n = 0; n < 100000; ++n)
+            {
+                CXXTOOLS_UNIT_ASSERT_EQUALS(id.get<unsigned>(n), n);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(value.get<double>(n), n * 0.5);
+                if (n % 3 == 0)
+                    CXXTOOLS_UNIT_ASSERT_EQUALS(text[n].str(), "quoted, \"text\"\nwith linefeed");
+                else
+                    CXXTOOLS_UNIT_ASSERT_EQUALS(text[n].str(), "plain text");
+            }
+        }
+};
+
+cxxtools::unit::RegisterTest<CsvReaderTest> register_CsvReaderTest;
@@ -0,0 +1,304 @@
+/*
+ * Copyright (C) 2016 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/csvwriter.h"
+#include "cxxtools/csvserializer.h"
+#include "cxxtools/serializationerror.h"
+#include <sstream>
+
+namespace
+{
+    struct TestObject
+    {
+        int intValue;
+        std::string stringValue;
+        double doubleValue;
+        bool boolValue;
+    };
+
+    void operator<<= (cxxtools::SerializationInfo& si, const TestObject& obj)
+    {
+        si.addMember("intValue") <<= obj.intValue;
+        si.addMember("stringValue") <<= obj.stringValue;
+        si.addMember("doubleValue") <<= obj.doubleValue;
+        si.addMember("boolValue") <<= obj.boolValue;
+        si.setTypeName("TestObject");
+    }
+
+    // serializes the members in a different order for odd int values
+    struct ShuffledObject
+    {
+        int intValue;
+        cxxtools::String stringValue;
+    };
+
+    void operator<<= (cxxtools::SerializationInfo& si, const ShuffledObject& obj)
+    {
+        if (obj.intValue & 1)
+        {
+            si.addMember("stringValue") <<= obj.stringValue;
+            si.addMember("intValue") <<= obj.intValue;
+        }
+        else
+        {
+            si.addMember("intValue") <<= obj.intValue;
+            si.addMember("stringValue") <<= obj.stringValue;
+        }
+    }
+
+    // serializes the given members in the given order
+    struct MemberList
+    {
+        std::vector<std::pair<std::string, int> > members;
+
+        MemberList& add(const std::string& name, int value)
+        {
+            members.push_back(std::make_pair(name, value));
+            return *this;
+        }
+    };
+
+    void operator<<= (cxxtools::SerializationInfo& si, const MemberList& obj)
+    {
+        for (unsigned n = 0; n < obj.members.size(); ++n)
+            si.addMember(obj.members[n].first) <<= obj.members[n].second;
+    }
+
+    std::vector<TestObject> testData()
+    {
+        std::vector<TestObject> data(2);
+        data[0].intValue = 17;
+        data[0].stringValue = "Hi";
+        data[0].doubleValue = 7.5;
+        data[0].boolValue = true;
+        data[1].intValue = -2;
+        data[1].stringValue = "Foo";
+        data[1].doubleValue = -8;
+        data[1].boolValue = false;
+        return data;
+    }
+}
+
+class CsvWriterTest : public cxxtools::unit::TestSuite
+{
+    public:
+        CsvWriterTest()
+            : cxxtools::unit::TestSuite("csvwriter")
+        {
+            registerMethod("testVectorVector", *this, &CsvWriterTest::testVectorVector);
+            registerMethod("testObjectVector", *this, &CsvWriterTest::testObjectVector);
+            registerMethod("testPartialObject", *this, &CsvWriterTest::testPartialObject);
+            registerMethod("testCustomTitles", *this, &CsvWriterTest::testCustomTitles);
+            registerMethod("testCustomChars", *this, &CsvWriterTest::testCustomChars);
+            registerMethod("testMemberOrder", *this, &CsvWriterTest::testMemberOrder);
+            registerMethod("testOutOfOrderMembers", *this, &CsvWriterTest::testOutOfOrderMembers);
+            registerMethod("testDuplicateMember", *this, &CsvWriterTest::testDuplicateMember);
+            registerMethod("testUtf8", *this, &CsvWriterTest::testUtf8);
+            registerMethod("testCompareFormatter", *this, &CsvWriterTest::testCompareFormatter);
+        }
+
+        void testVectorVector()
+        {
+            std::vector<std::vector<std::string> > data(2);
+            data[0].push_back("Hello");
+            data[0].push_back("World");
+            data[1].push_back("34");
+            data[1].push_back("foo\nbar");
+
+            std::ostringstream out;
+            cxxtools::CsvWriter writer(out);
+            writer.serialize(data);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out.str(),
+                "Hello,World\n"
+                "34,\"foo\nbar\"\n");
+        }
+
+        void testObjectVector()
+        {
+            std::ostringstream out;
+            cxxtools::CsvWriter writer(out);
+            writer.serialize(testData());
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out.str(),
+                "intValue,stringValue,doubleValue,boolValue\n"
+                "17,Hi,7.5,true\n"
+                "-2,Foo,-8,false\n");
+        }
+
+        void testPartialObject()
+        {
+            std::ostringstream out;
+            cxxtools::CsvWriter writer(out);
+            writer.selectColumn("stringValue");
+            writer.selectColumn("intValue");
+            writer.serialize(testData());
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out.str(),
+                "stringValue,intValue\n"
+                "Hi,17\n"
+                "Foo,-2\n");
+        }
+
+        void testCustomTitles()
+        {
+            std::ostringstream out;
+            cxxtools::CsvWriter writer(out);
+            writer.selectColumn("boolValue", "col1");
+            writer.selectColumn("doubleValue", "col2");
+            writer.serialize(testData());
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out.str(),
+                "col1,col2\n"
+                "true,7.5\n"
+                "false,-8\n");
+        }
+
+        void testCustomChars()
+        {
+            std::vector<std::vector<std::string> > data(2);
+            data[0].push_back("Hello");
+            data[0].push_back("fWorld");
+            data[1].push_back("34");
+            data[1].push_back("67");
+
+            std::ostringstream out;
+            cxxtools::CsvWriter writer(out);
+            writer.delimiter('l');
+            writer.quote('f');
+            writer.lineEnding("Tab");
+            writer.serialize(data);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out.str(),
+                "fHelloflfffWorldfTab"
+                "34l67Tab");
+        }
+
+        void testMemberOrder()
+        {
+            std::vector<ShuffledObject> data(3);
+            for (unsigned n = 0; n < data.size(); ++n)
+            {
+                data[n].intValue = n;
+                data[n].stringValue = cxxtools::String(L"s,") + cxxtools::Char('0' + n);
+            }
+
+            std::ostringstream out;
+            cxxtools::CsvWriter writer(out);
+            writer.serialize(data);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out.str(),
+                "intValue,stringValue\n"
+                "0,\"s,0\"\n"
+                "1,\"s,1\"\n"
+                "2,\"s,2\"\n");
+        }
+
+        void testOutOfOrderMembers()
+        {
+            std::vector<MemberList> data(3);
+            data[0].add("a", 1).add("b", 2).add("c", 3);
+            data[1].add("c", 6).add("b", 5);
+            data[2].add("b", 8).add("a", 7).add("c", 9);
+
+            std::ostringstream out;
+            cxxtools::CsvWriter writer(out);
+            writer.serialize(data);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out.str(),
+                "a,b,c\n"
+                "1,2,3\n"
+                ",5,6\n"
+                "7,8,9\n");
+        }
+
+        void testDuplicateMember()
+        {
+            // repeated after the column is written
+            {
+                std::vector<MemberList> data(2);
+                data[0].add("a", 1).add("b", 2);
+                data[1].add("a", 3).add("a", 4).add("b", 5);
+
+                std::ostringstream out;
+                cxxtools::CsvWriter writer(out);
+                CXXTOOLS_UNIT_ASSERT_THROW(writer.serialize(data), cxxtools::SerializationError);
+            }
+
+            // repeated while the column waits for output
+            {
+                std::vector<MemberList> data(2);
+                data[0].add("a", 1).add("b", 2);
+                data[1].add("b", 3).add("b", 4).add("a", 5);
+
+                std::ostringstream out;
+                cxxtools::CsvWriter writer(out);
+                CXXTOOLS_UNIT_ASSERT_THROW(writer.serialize(data), cxxtools::SerializationError);
+            }
+        }
+
+        void testUtf8()
+        {
+            std::vector<std::vector<cxxtools::String> > data(1);
+            data[0].push_back(cxxtools::String(L"\u00e4\u20ac"));
+            data[0].push_back(cxxtools::String(L"\"q\""));
+
+            std::ostringstream out;
+            cxxtools::CsvWriter writer(out);
+            writer.serialize(data);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out.str(),
+                "\xc3\xa4\xe2\x82\xac,\"\"\"q\"\"\"\n");
+        }
+
+        void testCompareFormatter()
+        {
+            std::vector<TestObject> data(100);
+            for (unsigned n = 0; n < data.size(); ++n)
+            {
+                data[n].intValue = n * 7 - 50;
+                data[n].stringValue = std::string(n % 5, 'x') + (n % 3 == 0 ? "a,\"b\"" : "");
+                data[n].doubleValue = n / 8.0;
+                data[n].boolValue = n & 1;
+            }
+
+            std::ostringstream out1;
+            cxxtools::CsvSerializer serializer(out1);
+            serializer.serialize(data);
+
+            std::ostringstream out2;
+            cxxtools::CsvWriter writer(out2);
+            writer.serialize(data);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out1.str(), out2.str());
+        }
+};
+
+cxxtools::unit::RegisterTest<CsvWriterTest> register_CsvWriterTest;
@@ -0,0 +1,281 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/directorywalker.h"
+#include "cxxtools/directory.h"
+#include "cxxtools/systemerror.h"
+#include "cxxtools/convert.h"
+#include "cxxtools/mutex.h"
+#include "cxxtools/function.h"
+#include "cxxtools/method.h"
+#include <fstream>
+#include <set>
+#include <vector>
+#include <stdexcept>
+#include <stdio.h>
+#include <unistd.h>
+
+namespace
+{
+    const std::string root = "directorywalker-test.tmp";
+
+    void writeFile(const std::string& path, const std::string& content)
+    {
+        std::ofstream f((root + '/' + path).c_str());
+        f << content;
+    }
+
+    void mkdir(const std::string& path)
+    {
+        cxxtools::Directory::create(root + '/' + path);
+    }
+
+    std::set<std::string> walk(cxxtools::DirectoryWalker& walker)
+    {
+        std::set<std::string> result;
+        cxxtools::DirectoryWalker::Entry entry;
+        while (walker.next(entry))
+            result.insert(entry.path().substr(root.size() + 1));
+        return result;
+    }
+
+    class Collector
+    {
+            cxxtools::Mutex _mutex;
+
+        public:
+            std::set<std::string> paths;
+
+            void onEntry(const cxxtools::DirectoryWalker::Entry& entry)
+            {
+                cxxtools::MutexLock lock(_mutex);
+                paths.insert(entry.path().substr(root.size() + 1));
+            }
+
+            void failOnEntry(const cxxtools::DirectoryWalker::Entry& entry)
+            {
+                if (entry.isFile())
+                    throw std::runtime_error("failed");
+            }
+    };
+}
+
+class DirectoryWalkerTest : public cxxtools::unit::TestSuite
+{
+    public:
+        DirectoryWalkerTest()
+            : cxxtools::unit::TestSuite("directorywalker")
+        {
+            registerMethod("testWalk", *this, &DirectoryWalkerTest::testWalk);
+            registerMethod("testTypes", *this, &DirectoryWalkerTest::testTypes);
+            registerMethod("testOrder", *this, &DirectoryWalkerTest::testOrder);
+            registerMethod("testSkipHidden", *this, &DirectoryWalkerTest::testSkipHidden);
+            registerMethod("testMaxDepth", *this, &DirectoryWalkerTest::testMaxDepth);
+            registerMethod("testStat", *this, &DirectoryWalkerTest::testStat);
+            registerMethod("testNotFound", *this, &DirectoryWalkerTest::testNotFound);
+            registerMethod("testParallel", *this, &DirectoryWalkerTest::testParallel);
+            registerMethod("testParallelException", *this, &DirectoryWalkerTest::testParallelException);
+        }
+
+        void setUp()
+        {
+            cxxtools::Directory::create(root);
+            writeFile("a", "Hello");
+            writeFile(".hidden", "");
+            mkdir("sub");
+            writeFile("sub/b", "");
+            mkdir("sub/deep");
+            writeFile("sub/deep/c", "");
+            mkdir("sub/.hiddendir");
+            writeFile("sub/.hiddendir/d", "");
+            mkdir("empty");
+            ::symlink("sub", (root + "/link").c_str());
+        }
+
+        void tearDown()
+        {
+            // remove the tree in reverse pre-order, so that the contents of a
+            // directory are removed before the directory itself
+            std::vector<std::string> paths;
+            {
+                cxxtools::DirectoryWalker walker(root);
+                cxxtools::DirectoryWalker::Entry entry;
+                while (walker.next(entry))
+                    paths.push_back(entry.path());
+            }
+
+            for (std::vector<std::string>::reverse_iterator it = paths.rbegin(); it != paths.rend(); ++it)
+                ::remove(it->c_str());
+
+            ::remove(root.c_str());
+        }
+
+        void testWalk()
+        {
+            cxxtools::DirectoryWalker walker(root);
+            std::set<std::string> paths = walk(walker);
+
+            const char* expected[] = { ".hidden", "a", "empty", "link", "sub", "sub/.hiddendir",
+                "sub/.hiddendir/d", "sub/b", "sub/deep", "sub/deep/c" };
+            CXXTOOLS_UNIT_ASSERT(paths == std::set<std::string>(expected, expected + sizeof(expected)/sizeof(expected[0])));
+        }
+
+        void testTypes()
+        {
+            cxxtools::DirectoryWalker walker(root);
+            cxxtools::DirectoryWalker::Entry entry;
+            unsigned count = 0;
+            while (walker.next(entry))
+            {
+                std::string name = entry.name();
+                if (name == "a")
+                {
+                    CXXTOOLS_UNIT_ASSERT(entry.isFile());
+                    CXXTOOLS_UNIT_ASSERT_EQUALS(entry.depth(), 0);
+                    ++count;
+                }
+                else if (name == "sub")
+                {
+                    CXXTOOLS_UNIT_ASSERT(entry.isDirectory());
+                    ++count;
+                }
+                else if (name == "link")
+                {
+                    CXXTOOLS_UNIT_ASSERT_EQUALS(entry.type(), cxxtools::FileInfo::Symlink);
+                    ++count;
+                }
+                else if (name == "c")
+                {
+                    CXXTOOLS_UNIT_ASSERT(entry.isFile());
+                    CXXTOOLS_UNIT_ASSERT_EQUALS(entry.path(), root + "/sub/deep/c");
+                    CXXTOOLS_UNIT_ASSERT_EQUALS(entry.depth(), 2);
+                    ++count;
+                }
+            }
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(count, 4);
+        }
+
+        void testOrder()
+        {
+            cxxtools::DirectoryWalker walker(root);
+            cxxtools::DirectoryWalker::Entry entry;
+            std::set<std::string> seen;
+            while (walker.next(entry))
+            {
+                std::string path = entry.path();
+                std::string::size_type p = path.rfind('/');
+                std::string dir = path.substr(0, p);
+                if (dir != root)
+                    CXXTOOLS_UNIT_ASSERT(seen.count(dir) > 0);
+                seen.insert(path);
+            }
+        }
+
+        void testSkipHidden()
+        {
+            cxxtools::DirectoryWalker walker(root);
+            walker.skipHidden();
+            std::set<std::string> paths = walk(walker);
+
+            const char* expected[] = { "a", "empty", "link", "sub", "sub/b", "sub/deep", "sub/deep/c" };
+            CXXTOOLS_UNIT_ASSERT(paths == std::set<std::string>(expected, expected + sizeof(expected)/sizeof(expected[0])));
+        }
+
+        void testMaxDepth()
+        {
+            cxxtools::DirectoryWalker walker(root);
+            walker.maxDepth(0);
+            std::set<std::string> paths = walk(walker);
+
+            const char* expected[] = { ".hidden", "a", "empty", "link", "sub" };
+            CXXTOOLS_UNIT_ASSERT(paths == std::set<std::string>(expected, expected + sizeof(expected)/sizeof(expected[0])));
+        }
+
+        void testStat()
+        {
+            cxxtools::DirectoryWalker walker(root);
+            walker.statEntries();
+
+            cxxtools::DirectoryWalker::Entry entry;
+            bool found = false;
+            while (walker.next(entry))
+            {
+                if (std::string(entry.name()) == "a")
+                {
+                    CXXTOOLS_UNIT_ASSERT(entry.isFile());
+                    CXXTOOLS_UNIT_ASSERT_EQUALS(entry.size(), 5);
+                    CXXTOOLS_UNIT_ASSERT(entry.mtime() > cxxtools::Timespan(0));
+                    found = true;
+                }
+            }
+
+            CXXTOOLS_UNIT_ASSERT(found);
+        }
+
+        void testNotFound()
+        {
+            CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::DirectoryWalker("directorywalker-test.notfound"), cxxtools::SystemError);
+        }
+
+        void testParallel()
+        {
+            for (unsigned d = 0; d < 20; ++d)
+            {
+                std::string dir = "many" + cxxtools::convert<std::string>(d);
+                mkdir(dir);
+                for (unsigned f = 0; f < 20; ++f)
+                    writeFile(dir + "/f" + cxxtools::convert<std::string>(f), "");
+            }
+
+            std::set<std::string> expected;
+            {
+                cxxtools::DirectoryWalker walker(root);
+                expected = walk(walker);
+            }
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(expected.size(), 10 + 20 * 21);
+
+            Collector collector;
+            cxxtools::DirectoryWalker walker(root);
+            walker.walk(cxxtools::callable(collector, &Collector::onEntry), 4);
+
+            CXXTOOLS_UNIT_ASSERT(collector.paths == expected);
+        }
+
+        void testParallelException()
+        {
+            Collector collector;
+            cxxtools::DirectoryWalker walker(root);
+            CXXTOOLS_UNIT_ASSERT_THROW(walker.walk(cxxtools::callable(collector, &Collector::failOnEntry), 4), std::runtime_error);
+        }
+};
+
+cxxtools::unit::RegisterTest<DirectoryWalkerTest> register_DirectoryWalkerTest;
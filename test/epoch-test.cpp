@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/epoch.h"
+#include "cxxtools/thread.h"
+#include "cxxtools/mutex.h"
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    std::atomic<unsigned> destroyed(0);
+
+    struct Object
+    {
+        unsigned values[16];
+        bool valid;
+
+        explicit Object(unsigned value)
+            : valid(true)
+        {
+            for (unsigned n = 0; n < 16; ++n)
+                values[n] = value;
+        }
+
+        ~Object()
+        {
+            valid = false;
+            ++destroyed;
+        }
+    };
+}
+
+class EpochTest : public cxxtools::unit::TestSuite
+{
+        std::atomic<bool> _entered;
+        std::atomic<bool> _left;
+        std::atomic<bool> _stop;
+        std::atomic<unsigned> _errors;
+        cxxtools::SnapshotPtr<Object>* _snapshot;
+        cxxtools::Mutex _writerMutex;
+
+        void reader()
+        {
+            cxxtools::EpochReadLock lock;
+            _entered = true;
+            cxxtools::Thread::sleep(cxxtools::Milliseconds(100));
+            _left = true;
+        }
+
+        void lockingReader()
+        {
+            cxxtools::EpochReadLock lock;
+            _entered = true;
+            cxxtools::MutexLock writerLock(_writerMutex);
+            _left = true;
+        }
+
+        void snapshotReader()
+        {
+            while (!_stop)
+            {
+                cxxtools::EpochReadLock lock;
+                const Object* obj = _snapshot->get();
+                for (unsigned n = 1; n < 16; ++n)
+                    if (!obj->valid || obj->values[n] != obj->values[0])
+                        ++_errors;
+            }
+        }
+
+    public:
+        EpochTest()
+        : cxxtools::unit::TestSuite("epoch"),
+          _entered(false),
+          _left(false),
+          _stop(false),
+          _errors(0),
+          _snapshot(0)
+        {
+            registerMethod("nesting", *this, &EpochTest::nesting);
+            registerMethod("deferDelete", *this, &EpochTest::deferDelete);
+            registerMethod("waitForReader", *this, &EpochTest::waitForReader);
+            registerMethod("deferWhileLocked", *this, &EpochTest::deferWhileLocked);
+            registerMethod("reclaimLater", *this, &EpochTest::reclaimLater);
+            registerMethod("snapshot", *this, &EpochTest::snapshot);
+        }
+
+        void nesting()
+        {
+            {
+                cxxtools::EpochReadLock lock;
+                {
+                    cxxtools::EpochReadLock lock2;
+                }
+
+                CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::Epoch::synchronize(), std::logic_error);
+            }
+
+            cxxtools::Epoch::synchronize();
+        }
+
+        void deferDelete()
+        {
+            cxxtools::Epoch::synchronize();
+            destroyed = 0;
+
+            {
+                cxxtools::EpochReadLock lock;
+                cxxtools::Epoch::deferDelete(new Object(1));
+                cxxtools::Epoch::deferDelete(new Object(2));
+
+                // the background thread may have taken them already, but
+                // they are not destroyed as long as we are reading
+                CXXTOOLS_UNIT_ASSERT(cxxtools::Epoch::pending() <= 2);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(destroyed, 0);
+            }
+
+            cxxtools::Epoch::synchronize();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::Epoch::pending(), 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(destroyed, 2);
+        }
+
+        void waitForReader()
+        {
+            _entered = false;
+            _left = false;
+
+            cxxtools::AttachedThread thread(cxxtools::callable(*this, &EpochTest::reader));
+            thread.start();
+
+            while (!_entered)
+                cxxtools::Thread::yield();
+
+            cxxtools::Epoch::synchronize();
+            CXXTOOLS_UNIT_ASSERT(_left);
+
+            thread.join();
+        }
+
+        // A writer queues many objects while holding a lock, which a reader
+        // waits for within its read section.
+        void deferWhileLocked()
+        {
+            _entered = false;
+            _left = false;
+
+            cxxtools::AttachedThread thread(cxxtools::callable(*this, &EpochTest::lockingReader));
+
+            {
+                cxxtools::MutexLock lock(_writerMutex);
+                thread.start();
+
+                while (!_entered)
+                    cxxtools::Thread::yield();
+
+                for (unsigned n = 0; n < 200; ++n)
+                    cxxtools::Epoch::deferDelete(new Object(n));
+            }
+
+            thread.join();
+            CXXTOOLS_UNIT_ASSERT(_left);
+
+            cxxtools::Epoch::synchronize();
+        }
+
+        // A few queued objects are destroyed without an explicit
+        // synchronization.
+        void reclaimLater()
+        {
+            cxxtools::Epoch::synchronize();
+            destroyed = 0;
+
+            cxxtools::Epoch::deferDelete(new Object(1));
+
+            for (unsigned n = 0; n < 200 && destroyed == 0; ++n)
+                cxxtools::Thread::sleep(cxxtools::Milliseconds(10));
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(destroyed, 1);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::Epoch::pending(), 0);
+        }
+
+        void snapshot()
+        {
+            cxxtools::SnapshotPtr<Object> snapshot(new Object(0));
+            _snapshot = &snapshot;
+            _stop = false;
+            _errors = 0;
+
+            std::vector<cxxtools::AttachedThread*> threads;
+            for (unsigned n = 0; n < 4; ++n)
+            {
+                threads.push_back(new cxxtools::AttachedThread(cxxtools::callable(*this, &EpochTest::snapshotReader)));
+                threads.back()->start();
+            }
+
+            for (unsigned n = 1; n <= 1000; ++n)
+            {
+                snapshot.update(new Object(n));
+                if (n % 100 == 0)
+                    cxxtools::Epoch::synchronize();
+            }
+
+            _stop = true;
+
+            for (unsigned n = 0; n < threads.size(); ++n)
+            {
+                threads[n]->join();
+                delete threads[n];
+            }
+
+            _snapshot = 0;
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_errors, 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(snapshot->values[0], 1000);
+        }
+};
+
+cxxtools::unit::RegisterTest<EpochTest> register_EpochTest;
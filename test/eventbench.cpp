@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+   Benchmark for passing events between threads.
+
+   The ping pong test runs two event loops in separate threads. Each event
+   loop answers an event by committing an event to the other loop, so that
+   each round trip costs two wakes of a sleeping thread.
+
+   The burst test commits events from a number of threads to one event loop
+   as fast as possible. Wakes are coalesced, so that the sender threads do
+   not need a system call for each event, while the loop is busy.
+ */
+
+#include <cxxtools/eventloop.h>
+#include <cxxtools/event.h>
+#include <cxxtools/thread.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+  class CountEvent : public cxxtools::BasicEvent<CountEvent>
+  {
+    public:
+      explicit CountEvent(unsigned long count_)
+        : count(count_)
+        { }
+
+      unsigned long count;
+  };
+
+  class Player : public cxxtools::Connectable
+  {
+      cxxtools::EventLoop _loop;
+      Player* _partner;
+      unsigned long _count;
+      cxxtools::AttachedThread _thread;
+
+      void onEvent(const CountEvent& ev)
+      {
+        if (ev.count >= _count)
+        {
+          _partner->_loop.exit();
+          _loop.exit();
+        }
+        else
+          _partner->_loop.commitEvent(CountEvent(ev.count + 1));
+      }
+
+      void run()
+      {
+        _loop.run();
+      }
+
+    public:
+      explicit Player(unsigned long count)
+        : _partner(0),
+          _count(count),
+          _thread(cxxtools::callable(*this, &Player::run))
+      {
+        _loop.event.subscribe(cxxtools::slot(*this, &Player::onEvent));
+      }
+
+      void partner(Player& p)   { _partner = &p; }
+      void serve()              { _loop.commitEvent(CountEvent(0)); }
+
+      void start()  { _thread.start(); }
+      void join()   { _thread.join(); }
+  };
+
+  void pingPong(unsigned long count)
+  {
+    Player ping(count);
+    Player pong(count);
+    ping.partner(pong);
+    pong.partner(ping);
+
+    cxxtools::Clock clock;
+    clock.start();
+
+    ping.start();
+    pong.start();
+    ping.serve();
+
+    ping.join();
+    pong.join();
+
+    cxxtools::Timespan t = clock.stop();
+
+    std::cout << "ping pong: " << t
+              << " (" << static_cast<double>(t.totalUSecs()) * 1000.0 / count << " ns per event)" << std::endl;
+  }
+
+  class Receiver : public cxxtools::Connectable
+  {
+      cxxtools::EventLoop& _loop;
+      unsigned long _expected;
+      unsigned long _received;
+
+      void onEvent(const CountEvent&)
+      {
+        if (++_received == _expected)
+          _loop.exit();
+      }
+
+    public:
+      Receiver(cxxtools::EventLoop& loop, unsigned long expected)
+        : _loop(loop),
+          _expected(expected),
+          _received(0)
+      {
+        _loop.event.subscribe(cxxtools::slot(*this, &Receiver::onEvent));
+      }
+  };
+
+  class Sender
+  {
+      cxxtools::EventLoop& _loop;
+      unsigned long _count;
+      cxxtools::AttachedThread _thread;
+
+      void run()
+      {
+        for (unsigned long n = 0; n < _count; ++n)
+          _loop.commitEvent(CountEvent(n));
+      }
+
+    public:
+      Sender(cxxtools::EventLoop& loop, unsigned long count)
+        : _loop(loop),
+          _count(count),
+          _thread(cxxtools::callable(*this, &Sender::run))
+        { }
+
+      void start()  { _thread.start(); }
+      void join()   { _thread.join(); }
+  };
+
+  void burst(unsigned threads, unsigned long count)
+  {
+    cxxtools::EventLoop loop;
+    Receiver receiver(loop, threads * count);
+
+    std::vector<Sender*> senders;
+    for (unsigned n = 0; n < threads; ++n)
+      senders.push_back(new Sender(loop, count));
+
+    cxxtools::Clock clock;
+    clock.start();
+
+    for (unsigned n = 0; n < threads; ++n)
+      senders[n]->start();
+
+    loop.run();
+
+    cxxtools::Timespan t = clock.stop();
+
+    for (unsigned n = 0; n < threads; ++n)
+    {
+      senders[n]->join();
+      delete senders[n];
+    }
+
+    unsigned long events = static_cast<unsigned long>(threads) * count;
+    std::cout << "burst (" << threads << " threads): " << t
+              << " (" << static_cast<double>(t.totalUSecs()) * 1000.0 / events << " ns per event)" << std::endl;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    cxxtools::Arg<unsigned> threads(argc, argv, 't', 4);
+    cxxtools::Arg<unsigned long> count(argc, argv, 'n', 100000);
+
+    if (argc > 1)
+    {
+      std::cerr << "usage: " << argv[0] << " [options]\n"
+                   "options:\n"
+                   "  -t <threads>  number of sender threads for the burst test (default 4)\n"
+                   "  -n <count>    number of events (default 100000)\n";
+      return -1;
+    }
+
+    pingPong(count);
+    burst(threads, count);
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return -1;
+  }
+}
@@ -31,6 +31,8 @@
 #include "cxxtools/unit/registertest.h"
 #include "cxxtools/event.h"
 #include "cxxtools/eventloop.h"
+#include "cxxtools/thread.h"
+#include <vector>
 
 namespace
 {
@@ -39,12 +41,63 @@ namespace
 
     class TestEvent2 : public cxxtools::BasicEvent<TestEvent2>
     { };
+
+    // does not fit into the buffer of the event queue
+    class LargeEvent : public cxxtools::BasicEvent<LargeEvent>
+    {
+    public:
+        std::string text[8];
+    };
+
+    class SenderEvent : public cxxtools::BasicEvent<SenderEvent>
+    {
+    public:
+        SenderEvent(unsigned sender_, unsigned seq_)
+            : sender(sender_),
+              seq(seq_)
+              { }
+
+        unsigned sender;
+        unsigned seq;
+    };
+
+    const unsigned senderCount = 4;
+    const unsigned senderEvents = 10000;
+
+    class Sender
+    {
+        cxxtools::EventLoop& _loop;
+        unsigned _no;
+        cxxtools::AttachedThread _thread;
+
+        void run()
+        {
+            for (unsigned n = 0; n < senderEvents; ++n)
+                _loop.commitEvent(SenderEvent(_no, n));
+        }
+
+    public:
+        Sender(cxxtools::EventLoop& loop, unsigned no)
+            : _loop(loop),
+              _no(no),
+              _thread(cxxtools::callable(*this, &Sender::run))
+              { }
+
+        void start()  { _thread.start(); }
+        void join()   { _thread.join(); }
+    };
 }
 
 class EventLoopTest : public cxxtools::unit::TestSuite
 {
     cxxtools::EventLoop _loop;
     std::string _events;
+    std::string _largeText;
+
+    cxxtools::EventLoop _senderLoop;
+    std::vector<unsigned> _nextSeq;
+    unsigned _received;
+    bool _ordered;
 
     void onTestEvent1(const TestEvent1&)
     {
@@ -56,15 +109,34 @@ class EventLoopTest : public cxxtools::unit::TestSuite
         _events += "2";
     }
 
+    void onLargeEvent(const LargeEvent& ev)
+    {
+        _largeText = ev.text[7];
+    }
+
+    void onSenderEvent(const SenderEvent& ev)
+    {
+        if (_nextSeq[ev.sender] != ev.seq)
+            _ordered = false;
+        _nextSeq[ev.sender] = ev.seq + 1;
+
+        if (++_received == senderCount * senderEvents)
+            _senderLoop.exit();
+    }
+
 public:
     EventLoopTest()
     : cxxtools::unit::TestSuite("eventloop")
     {
         registerMethod("commitEvent", *this, &EventLoopTest::commitEvent);
         registerMethod("priorityEvent", *this, &EventLoopTest::priorityEvent);
+        registerMethod("largeEvent", *this, &EventLoopTest::largeEvent);
+        registerMethod("severalSenders", *this, &EventLoopTest::severalSenders);
 
         _loop.event.subscribe(slot(*this, &EventLoopTest::onTestEvent1));
         _loop.event.subscribe(slot(*this, &EventLoopTest::onTestEvent2));
+        _loop.event.subscribe(slot(*this, &EventLoopTest::onLargeEvent));
+        _senderLoop.event.subscribe(slot(*this, &EventLoopTest::onSenderEvent));
     }
 
     void setUp()
@@ -88,6 +160,42 @@ public:
         CXXTOOLS_UNIT_ASSERT_EQUALS(_events, "21");
     }
 
+    void largeEvent()
+    {
+        LargeEvent ev;
+        ev.text[7] = "large event";
+        _loop.commitEvent(TestEvent1());
+        _loop.commitEvent(ev);
+        _loop.commitEvent(TestEvent2());
+        _loop.processEvents();
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_events, "12");
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_largeText, "large event");
+    }
+
+    void severalSenders()
+    {
+        _nextSeq.assign(senderCount, 0);
+        _received = 0;
+        _ordered = true;
+
+        std::vector<Sender*> senders;
+        for (unsigned n = 0; n < senderCount; ++n)
+            senders.push_back(new Sender(_senderLoop, n));
+
+        for (unsigned n = 0; n < senderCount; ++n)
+            senders[n]->start();
+
+        _senderLoop.run();
+
+        for (unsigned n = 0; n < senderCount; ++n)
+        {
+            senders[n]->join();
+            delete senders[n];
+        }
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_received, senderCount * senderEvents);
+        CXXTOOLS_UNIT_ASSERT(_ordered);
+    }
 };
 
 cxxtools::unit::RegisterTest<EventLoopTest> register_EventLoopTest;
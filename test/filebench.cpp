@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+   Benchmark for reading many files concurrently.
+
+   Like a log shipper, which follows a number of log files, the benchmark
+   opens a number of files and reads all of them at the same time using
+   asynchronous reads and a single selector. It runs once using io_uring
+   and once using the poll based path, where each read is a system call
+   done in the event handler.
+
+   The files are created in the current directory and removed afterwards.
+   They are usually in the page cache, so the benchmark measures the
+   overhead of submitting and completing the reads.
+ */
+
+#include <cxxtools/filedevice.h>
+#include <cxxtools/fileinfo.h>
+#include <cxxtools/selector.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/convert.h>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+  std::string fileName(unsigned n)
+  {
+    return "filebench-" + cxxtools::convert<std::string>(n) + ".tmp";
+  }
+
+  class Reader : public cxxtools::Connectable
+  {
+      cxxtools::FileDevice _device;
+      std::vector<char> _buffer;
+      unsigned long _bytes;
+
+      void onInput(cxxtools::IODevice&)
+      {
+        _bytes += _device.endRead();
+        if (!_device.eof())
+          _device.beginRead(&_buffer[0], _buffer.size());
+      }
+
+    public:
+      Reader(const std::string& fname, std::size_t bufsize, cxxtools::Selector& selector)
+        : _device(fname, cxxtools::IODevice::Read | cxxtools::IODevice::Async),
+          _buffer(bufsize),
+          _bytes(0)
+      {
+        selector.add(_device);
+        connect(_device.inputReady, *this, &Reader::onInput);
+        _device.beginRead(&_buffer[0], _buffer.size());
+      }
+
+      bool eof() const              { return _device.eof(); }
+      unsigned long bytes() const   { return _bytes; }
+  };
+
+  void readFiles(const char* name, unsigned files, std::size_t bufsize)
+  {
+    cxxtools::Clock clock;
+    clock.start();
+
+    cxxtools::Selector selector;
+    std::vector<Reader*> readers;
+    for (unsigned n = 0; n < files; ++n)
+      readers.push_back(new Reader(fileName(n), bufsize, selector));
+
+    unsigned running = files;
+    unsigned long waits = 0;
+    while (running > 0)
+    {
+      selector.wait();
+      ++waits;
+
+      running = 0;
+      for (unsigned n = 0; n < files; ++n)
+        if (!readers[n]->eof())
+          ++running;
+    }
+
+    unsigned long bytes = 0;
+    for (unsigned n = 0; n < files; ++n)
+    {
+      bytes += readers[n]->bytes();
+      delete readers[n];
+    }
+
+    cxxtools::Timespan t = clock.stop();
+
+    std::cout << name << ": " << t << " " << bytes << " bytes in " << waits << " waits ("
+              << static_cast<double>(bytes) / t.totalUSecs() << " MB/s)" << std::endl;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    cxxtools::Arg<unsigned> files(argc, argv, 'f', 64);
+    cxxtools::Arg<std::size_t> size(argc, argv, 's', 4 * 1024 * 1024);
+    cxxtools::Arg<std::size_t> bufsize(argc, argv, 'b', 16 * 1024);
+    cxxtools::Arg<unsigned> repeat(argc, argv, 'r', 3);
+
+    if (argc > 1)
+    {
+      std::cerr << "usage: " << argv[0] << " [options]\n"
+                   "options:\n"
+                   "  -f <files>    number of files (default 64)\n"
+                   "  -s <size>     size of each file (default 4194304)\n"
+                   "  -b <size>     read buffer size (default 16384)\n"
+                   "  -r <count>    number of runs (default 3)\n";
+      return -1;
+    }
+
+    std::string data(size, 'x');
+    for (std::size_t n = 79; n < data.size(); n += 80)
+      data[n] = '\n';
+
+    for (unsigned n = 0; n < files; ++n)
+    {
+      std::ofstream out(fileName(n).c_str());
+      out << data;
+    }
+
+    bool ioUring = cxxtools::FileDevice::ioUring();
+    if (!ioUring)
+      std::cout << "io_uring is not available" << std::endl;
+
+    for (unsigned r = 0; r < repeat; ++r)
+    {
+      if (ioUring)
+      {
+        cxxtools::FileDevice::ioUring(true);
+        readFiles("io_uring", files, bufsize);
+      }
+
+      cxxtools::FileDevice::ioUring(false);
+      readFiles("poll    ", files, bufsize);
+    }
+
+    for (unsigned n = 0; n < files; ++n)
+      cxxtools::FileInfo(fileName(n)).remove();
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return -1;
+  }
+}
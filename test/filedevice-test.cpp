@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/filedevice.h"
+#include "cxxtools/fileinfo.h"
+#include "cxxtools/selector.h"
+#include "cxxtools/log.h"
+#include <fstream>
+#include <sstream>
+
+log_define("cxxtools.test.filedevice")
+
+namespace
+{
+    const std::string tmpFileName = "filedevice-test.tmp";
+
+    std::string testData()
+    {
+        std::string data;
+        for (unsigned n = 0; n < 100003; ++n)
+            data += static_cast<char>(n * 7);
+        return data;
+    }
+
+    std::string readFile(const std::string& fname)
+    {
+        std::ifstream in(fname.c_str());
+        std::ostringstream s;
+        s << in.rdbuf();
+        return s.str();
+    }
+}
+
+class FileDeviceTest : public cxxtools::unit::TestSuite
+{
+        bool _ioUring;
+        std::string _data;
+        std::string _result;
+        char _buffer[8192];
+        std::string::size_type _written;
+        unsigned _signals;
+
+    public:
+        FileDeviceTest()
+            : cxxtools::unit::TestSuite("filedevice"),
+              _ioUring(cxxtools::FileDevice::ioUring())
+        {
+            registerMethod("testAsyncRead", *this, &FileDeviceTest::testAsyncRead);
+            registerMethod("testAsyncReadPlain", *this, &FileDeviceTest::testAsyncReadPlain);
+            registerMethod("testAsyncWrite", *this, &FileDeviceTest::testAsyncWrite);
+            registerMethod("testAsyncWritePlain", *this, &FileDeviceTest::testAsyncWritePlain);
+            registerMethod("testSyncRead", *this, &FileDeviceTest::testSyncRead);
+            registerMethod("testCancel", *this, &FileDeviceTest::testCancel);
+            registerMethod("testOtherDevice", *this, &FileDeviceTest::testOtherDevice);
+        }
+
+        void setUp()
+        {
+            _data = testData();
+            _result.clear();
+            _written = 0;
+            _signals = 0;
+
+            std::ofstream out(tmpFileName.c_str());
+            out << _data;
+        }
+
+        void tearDown()
+        {
+            cxxtools::FileDevice::ioUring(_ioUring);
+            cxxtools::FileInfo(tmpFileName).remove();
+        }
+
+        void onInput(cxxtools::IODevice& device)
+        {
+            ++_signals;
+            std::size_t n = device.endRead();
+            _result.append(_buffer, n);
+            if (!device.eof())
+                device.beginRead(_buffer, sizeof(_buffer));
+        }
+
+        void onOutput(cxxtools::IODevice& device)
+        {
+            ++_signals;
+            _written += device.endWrite();
+            if (_written < _data.size())
+                device.beginWrite(_data.data() + _written, _data.size() - _written);
+        }
+
+        void asyncRead()
+        {
+            cxxtools::FileDevice device(tmpFileName, cxxtools::IODevice::Read | cxxtools::IODevice::Async);
+            cxxtools::Selector selector;
+            selector.add(device);
+            connect(device.inputReady, *this, &FileDeviceTest::onInput);
+
+            device.beginRead(_buffer, sizeof(_buffer));
+            while (!device.eof())
+                selector.wait(1000);
+
+            CXXTOOLS_UNIT_ASSERT(_signals > 1);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_result.size(), _data.size());
+            CXXTOOLS_UNIT_ASSERT(_result == _data);
+        }
+
+        void asyncWrite()
+        {
+            std::ofstream(tmpFileName.c_str()) << "garbage";
+
+            {
+                cxxtools::FileDevice device(tmpFileName,
+                    cxxtools::IODevice::Write | cxxtools::IODevice::Trunc | cxxtools::IODevice::Async);
+                cxxtools::Selector selector;
+                selector.add(device);
+                connect(device.outputReady, *this, &FileDeviceTest::onOutput);
+
+                _written = device.beginWrite(_data.data(), _data.size());
+                while (_written < _data.size())
+                    selector.wait(1000);
+            }
+
+            CXXTOOLS_UNIT_ASSERT(readFile(tmpFileName) == _data);
+        }
+
+        void testAsyncRead()
+        {
+            cxxtools::FileDevice::ioUring(true);
+            asyncRead();
+        }
+
+        void testAsyncReadPlain()
+        {
+            cxxtools::FileDevice::ioUring(false);
+            asyncRead();
+        }
+
+        void testAsyncWrite()
+        {
+            cxxtools::FileDevice::ioUring(true);
+            asyncWrite();
+        }
+
+        void testAsyncWritePlain()
+        {
+            cxxtools::FileDevice::ioUring(false);
+            asyncWrite();
+        }
+
+        void testSyncRead()
+        {
+            cxxtools::FileDevice device(tmpFileName, cxxtools::IODevice::Read | cxxtools::IODevice::Async);
+            std::size_t n = device.read(_buffer, sizeof(_buffer));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(n, sizeof(_buffer));
+            CXXTOOLS_UNIT_ASSERT(_data.compare(0, n, _buffer, n) == 0);
+        }
+
+        void testCancel()
+        {
+            cxxtools::FileDevice device(tmpFileName, cxxtools::IODevice::Read | cxxtools::IODevice::Async);
+            cxxtools::Selector selector;
+            selector.add(device);
+            connect(device.inputReady, *this, &FileDeviceTest::onInput);
+
+            device.beginRead(_buffer, sizeof(_buffer));
+            device.cancel();
+
+            CXXTOOLS_UNIT_ASSERT(!device.reading());
+            selector.wait(0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_signals, 0);
+
+            // the read may have completed before it was canceled
+            device.seek(0, std::ios::beg);
+            std::size_t n = device.read(_buffer, sizeof(_buffer));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(n, sizeof(_buffer));
+            CXXTOOLS_UNIT_ASSERT(_data.compare(0, n, _buffer, n) == 0);
+        }
+
+        // Both devices share the ring of the thread. The completion of the
+        // other device must not wake the selector of the first device again
+        // and again and must still be reported to the other device.
+        void testOtherDevice()
+        {
+            cxxtools::FileDevice::ioUring(true);
+
+            cxxtools::FileDevice other(tmpFileName, cxxtools::IODevice::Read | cxxtools::IODevice::Async);
+            cxxtools::Selector otherSelector;
+            otherSelector.add(other);
+            char otherBuffer[16];
+            other.beginRead(otherBuffer, sizeof(otherBuffer));
+
+            cxxtools::FileDevice device(tmpFileName, cxxtools::IODevice::Read | cxxtools::IODevice::Async);
+            cxxtools::Selector selector;
+            selector.add(device);
+            connect(device.inputReady, *this, &FileDeviceTest::onInput);
+
+            unsigned idle = 0;
+            device.beginRead(_buffer, sizeof(_buffer));
+            while (!device.eof())
+            {
+                if (!selector.wait(1000))
+                    ++idle;
+            }
+
+            CXXTOOLS_UNIT_ASSERT(_result == _data);
+            CXXTOOLS_UNIT_ASSERT(idle < 3);
+
+            CXXTOOLS_UNIT_ASSERT(otherSelector.wait(1000));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(other.endRead(), sizeof(otherBuffer));
+            CXXTOOLS_UNIT_ASSERT(_data.compare(0, sizeof(otherBuffer), otherBuffer, sizeof(otherBuffer)) == 0);
+        }
+};
+
+cxxtools::unit::RegisterTest<FileDeviceTest> register_FileDeviceTest;
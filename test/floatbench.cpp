@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2016 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+/*
+   Benchmark for formatting and parsing floating point numbers.
+
+   Random doubles are formatted with the shortest representation and with
+   the fixed precision algorithm and compared to snprintf. The formatted
+   values are parsed back with getFloat and with strtod. The results are
+   checked to read back to the original values.
+ */
+
+#include <cxxtools/convert.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+
+namespace
+{
+  // values with few digits like in typical json or csv data
+  std::vector<double> shortValues(unsigned long count)
+  {
+    std::vector<double> values;
+    values.reserve(count);
+    uint64_t x = 88172645463325252ull;
+    for (unsigned long n = 0; n < count; ++n)
+    {
+      x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+      values.push_back(static_cast<double>(x % 10000000) / 100.0);
+    }
+    return values;
+  }
+
+  // random bit patterns, which need up to 17 digits
+  std::vector<double> randomValues(unsigned long count)
+  {
+    std::vector<double> values;
+    values.reserve(count);
+    uint64_t x = 88172645463325252ull;
+    while (values.size() < count)
+    {
+      x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+      double d;
+      std::memcpy(&d, &x, sizeof(d));
+      if (d == d && d - d == 0)
+        values.push_back(d);
+    }
+    return values;
+  }
+
+  void report(const char* what, cxxtools::Timespan t, unsigned long count, std::size_t bytes)
+  {
+    std::cout << '\t' << what << ": " << t
+              << " (" << static_cast<unsigned long>(count / t.totalSeconds()) << " values/s, "
+              << bytes << " bytes)" << std::endl;
+  }
+
+  void runBench(const char* title, const std::vector<double>& values, bool fixed)
+  {
+    std::cout << title << std::endl;
+
+    cxxtools::Clock clock;
+    std::vector<std::string> str(values.size());
+
+    clock.start();
+    std::size_t bytes = 0;
+    for (std::size_t n = 0; n < values.size(); ++n)
+    {
+      char buffer[32];
+      bytes += std::snprintf(buffer, sizeof(buffer), "%.17g", values[n]);
+    }
+    report("snprintf %.17g", clock.stop(), values.size(), bytes);
+
+    if (fixed)
+    {
+      // fixed precision formatting creates long strings for large exponents
+      clock.start();
+      bytes = 0;
+      for (std::size_t n = 0; n < values.size(); ++n)
+      {
+        std::string& s = str[n];
+        s.clear();
+        cxxtools::putFloat(std::back_inserter(s), values[n], cxxtools::FloatFormat<char>(), 14);
+        bytes += s.size();
+      }
+      report("putFloat precision 14", clock.stop(), values.size(), bytes);
+    }
+
+    clock.start();
+    bytes = 0;
+    for (std::size_t n = 0; n < values.size(); ++n)
+    {
+      std::string& s = str[n];
+      s.clear();
+      cxxtools::putFloat(std::back_inserter(s), values[n]);
+      bytes += s.size();
+    }
+    report("putFloat shortest", clock.stop(), values.size(), bytes);
+
+    double sum = 0;
+    clock.start();
+    for (std::size_t n = 0; n < str.size(); ++n)
+      sum += std::strtod(str[n].c_str(), 0);
+    report("strtod", clock.stop(), values.size(), 0);
+
+    std::size_t errors = 0;
+    clock.start();
+    for (std::size_t n = 0; n < str.size(); ++n)
+    {
+      bool ok;
+      double d;
+      cxxtools::getFloat(str[n].begin(), str[n].end(), ok, d);
+      if (!ok || d != values[n])
+        ++errors;
+    }
+    report("getFloat", clock.stop(), values.size(), 0);
+
+    if (errors > 0)
+      std::cout << "\t" << errors << " values did not read back" << std::endl;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    cxxtools::Arg<unsigned long> count(argc, argv, 'n', 1000000);
+
+    if (argc > 1)
+    {
+      std::cerr << "usage: " << argv[0] << " [options]\n"
+                   "options:\n"
+                   "  -n <count>    number of values (default 1000000)\n";
+      return -1;
+    }
+
+    runBench("short values", shortValues(count), true);
+    runBench("random values", randomValues(count), false);
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return -1;
+  }
+}
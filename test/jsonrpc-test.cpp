@@ -80,6 +80,7 @@ class JsonRpcTest : public cxxtools::unit::TestSuite
         cxxtools::EventLoop _loop;
         cxxtools::json::RpcServer* _server;
         unsigned _count;
+        int _stored;
         std::string _listen;
         unsigned short _port;
 
@@ -111,6 +112,9 @@ class JsonRpcTest : public cxxtools::unit::TestSuite
             registerMethod("PrepareConnect", *this, &JsonRpcTest::PrepareConnect);
             registerMethod("Connect", *this, &JsonRpcTest::Connect);
             registerMethod("Multiple", *this, &JsonRpcTest::Multiple);
+            registerMethod("Batch", *this, &JsonRpcTest::Batch);
+            registerMethod("SyncBatch", *this, &JsonRpcTest::SyncBatch);
+            registerMethod("Notification", *this, &JsonRpcTest::Notification);
 
             char* PORT = getenv("UTEST_PORT");
             if (PORT)
@@ -803,6 +807,117 @@ class JsonRpcTest : public cxxtools::unit::TestSuite
 
         }
 
+        ////////////////////////////////////////////////////////////
+        // Batch
+        //
+        void Batch()
+        {
+            _server->registerMethod("multiply", *this, &JsonRpcTest::multiplyInt);
+
+            cxxtools::json::RpcClient client(_loop, _listen, _port);
+            cxxtools::RemoteProcedure<int, int, int> multiply1(client, "multiply");
+            cxxtools::RemoteProcedure<int, int, int> multiply2(client, "multiply");
+            cxxtools::RemoteProcedure<int, int, int> unknown(client, "unknown");
+
+            client.beginBatch();
+            multiply1.begin(2, 3);
+            unknown.begin(1, 1);
+            multiply2.begin(4, 5);
+            client.endBatch();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(multiply1.end(2000), 6);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(multiply2.end(2000), 20);
+            CXXTOOLS_UNIT_ASSERT_THROW(unknown.end(2000), cxxtools::RemoteException);
+
+            // the connection can be used for normal calls after a batch
+            multiply1.begin(3, 4);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(multiply1.end(2000), 12);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // SyncBatch
+        //
+        void SyncBatch()
+        {
+            _server->registerMethod("multiply", *this, &JsonRpcTest::multiplyInt);
+
+            // the server is started in the event loop
+            {
+                cxxtools::json::RpcClient client(_loop, _listen, _port);
+                cxxtools::RemoteProcedure<int, int, int> multiply(client, "multiply");
+                multiply.begin(2, 3);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(multiply.end(2000), 6);
+            }
+
+            cxxtools::json::RpcClient client(_listen, _port);
+            client.timeout(2000);
+
+            std::vector<cxxtools::RemoteProcedure<int, int, int> > procs;
+            procs.reserve(20);
+
+            client.beginBatch();
+            for (int i = 0; i < 20; ++i)
+            {
+                procs.push_back(cxxtools::RemoteProcedure<int, int, int>(client, "multiply"));
+                procs.back().begin(i, i);
+            }
+            client.endBatch();
+
+            for (int i = 0; i < 20; ++i)
+                CXXTOOLS_UNIT_ASSERT_EQUALS(procs[i].result(), i * i);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Notification
+        //
+        void Notification()
+        {
+            _server->registerMethod("store", *this, &JsonRpcTest::store);
+            _server->registerMethod("fetch", *this, &JsonRpcTest::fetch);
+            _server->registerMethod("multiply", *this, &JsonRpcTest::multiplyInt);
+
+            _stored = 0;
+
+            cxxtools::json::RpcClient client(_loop, _listen, _port);
+            cxxtools::RemoteProcedure<int> fetch(client, "fetch");
+            cxxtools::RemoteProcedure<int, int, int> multiply(client, "multiply");
+
+            // the server processes the requests of a connection in order
+            client.notify("store", 17);
+            fetch.begin();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(fetch.end(2000), 17);
+
+            // only the call in the batch is answered
+            client.beginBatch();
+            client.notify("store", 42);
+            multiply.begin(6, 7);
+            client.endBatch();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(multiply.end(2000), 42);
+
+            fetch.begin();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(fetch.end(2000), 42);
+
+            // a batch of notifications is not answered
+            client.beginBatch();
+            client.notify("store", 5);
+            client.notify("store", 5);
+            client.endBatch();
+
+            fetch.begin();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(fetch.end(2000), 5);
+        }
+
+        bool store(int value)
+        {
+            _stored = value;
+            return true;
+        }
+
+        int fetch()
+        {
+            return _stored;
+        }
+
 };
 
 cxxtools::unit::RegisterTest<JsonRpcTest> register_JsonRpcTest;
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/lightmutex.h"
+#include "cxxtools/thread.h"
+#include "cxxtools/clock.h"
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include <vector>
+
+class LightMutexTest : public cxxtools::unit::TestSuite
+{
+        cxxtools::LightMutex _mutex;
+        cxxtools::LightCondition _condition;
+        unsigned long _counter;
+        unsigned _ready;
+        bool _go;
+
+        void increment()
+        {
+            for (unsigned n = 0; n < 100000; ++n)
+            {
+                cxxtools::LightMutexLock lock(_mutex);
+                ++_counter;
+            }
+        }
+
+        void waitForGo()
+        {
+            cxxtools::LightMutexLock lock(_mutex);
+            ++_ready;
+            _condition.broadcast();
+            while (!_go)
+                _condition.wait(lock);
+            ++_counter;
+        }
+
+        void runThreads(unsigned count, void (LightMutexTest::*method)(), bool signal)
+        {
+            std::vector<cxxtools::AttachedThread*> threads;
+            for (unsigned n = 0; n < count; ++n)
+            {
+                threads.push_back(new cxxtools::AttachedThread(cxxtools::callable(*this, method)));
+                threads.back()->start();
+            }
+
+            if (signal)
+            {
+                cxxtools::LightMutexLock lock(_mutex);
+                while (_ready < count)
+                    _condition.wait(lock);
+                _go = true;
+                _condition.broadcast();
+            }
+
+            for (unsigned n = 0; n < count; ++n)
+            {
+                threads[n]->join();
+                delete threads[n];
+            }
+        }
+
+    public:
+        LightMutexTest()
+        : cxxtools::unit::TestSuite("lightmutex"),
+          _counter(0),
+          _ready(0),
+          _go(false)
+        {
+            registerMethod("lock", *this, &LightMutexTest::lock);
+            registerMethod("contention", *this, &LightMutexTest::contention);
+            registerMethod("condition", *this, &LightMutexTest::condition);
+            registerMethod("timeout", *this, &LightMutexTest::timeout);
+        }
+
+        void lock()
+        {
+            cxxtools::LightMutex mutex;
+            CXXTOOLS_UNIT_ASSERT(mutex.tryLock());
+            CXXTOOLS_UNIT_ASSERT(!mutex.tryLock());
+            mutex.unlock();
+
+            {
+                cxxtools::LightMutexLock lock(mutex);
+                CXXTOOLS_UNIT_ASSERT(!mutex.tryLock());
+            }
+
+            CXXTOOLS_UNIT_ASSERT(mutex.tryLock());
+            mutex.unlock();
+        }
+
+        void contention()
+        {
+            _counter = 0;
+            runThreads(4, &LightMutexTest::increment, false);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_counter, 400000);
+        }
+
+        void condition()
+        {
+            _counter = 0;
+            _ready = 0;
+            _go = false;
+            runThreads(4, &LightMutexTest::waitForGo, true);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_counter, 4);
+        }
+
+        void timeout()
+        {
+            cxxtools::LightMutexLock lock(_mutex);
+
+            cxxtools::Clock clock;
+            clock.start();
+            bool signaled = _condition.wait(lock, cxxtools::Milliseconds(50));
+            cxxtools::Timespan t = clock.stop();
+
+            CXXTOOLS_UNIT_ASSERT(!signaled);
+            CXXTOOLS_UNIT_ASSERT(t >= cxxtools::Milliseconds(40));
+
+            // the mutex is locked again after the wait
+            CXXTOOLS_UNIT_ASSERT(!_mutex.tryLock());
+        }
+};
+
+cxxtools::unit::RegisterTest<LightMutexTest> register_LightMutexTest;
@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+   Benchmark for locks and reference counts.
+
+   Each test is run by one thread without contention and by a number of
+   threads, which use the same object. The Mutex, the SpinMutex and the
+   futex based LightMutex are locked and unlocked. The reference count of an
+   AtomicRefCounted object and of SmartPtrs with the ExternalAtomicRefCounted,
+   CoAllocatedRefCounted and LocalRefCounted policies are incremented and
+   decremented. The LocalRefCounted policy is not thread safe and hence run
+   by one thread only.
+ */
+
+#include <cxxtools/mutex.h>
+#include <cxxtools/lightmutex.h>
+#include <cxxtools/refcounted.h>
+#include <cxxtools/smartptr.h>
+#include <cxxtools/thread.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+  unsigned long sharedCounter = 0;
+
+  template <typename MutexType, typename LockType>
+  struct LockOp
+  {
+    MutexType mutex;
+
+    void operator() ()
+    {
+      LockType lock(mutex);
+      ++sharedCounter;
+    }
+  };
+
+  struct RefCountOp
+  {
+    cxxtools::AtomicRefCounted object;
+
+    void operator() ()
+    {
+      object.addRef();
+      object.release();
+    }
+  };
+
+  struct Object
+  {
+    int value;
+  };
+
+  struct SmartPtrOp
+  {
+    typedef cxxtools::SmartPtr<Object, cxxtools::ExternalAtomicRefCounted> Ptr;
+    Ptr object;
+
+    SmartPtrOp()
+      : object(new Object())
+      { }
+
+    void operator() ()
+    {
+      Ptr p(object);
+    }
+  };
+
+  template <template <class> class OwnershipPolicy>
+  struct CoAllocatedOp
+  {
+    typedef cxxtools::SmartPtr<Object, OwnershipPolicy> Ptr;
+    Ptr object;
+
+    CoAllocatedOp()
+      : object(Ptr::create())
+      { }
+
+    void operator() ()
+    {
+      Ptr p(object);
+    }
+  };
+
+  template <typename Op>
+  class Worker
+  {
+      Op& _op;
+      unsigned long _count;
+      cxxtools::AttachedThread _thread;
+
+    public:
+      Worker(Op& op, unsigned long count)
+        : _op(op),
+          _count(count),
+          _thread(cxxtools::callable(*this, &Worker::run))
+        { }
+
+      void start()  { _thread.start(); }
+      void join()   { _thread.join(); }
+
+      void run()
+      {
+        for (unsigned long n = 0; n < _count; ++n)
+          _op();
+      }
+  };
+
+  template <typename Op>
+  void runBench(const char* title, unsigned threads, unsigned long count)
+  {
+    Op op;
+    std::vector<Worker<Op>*> workers;
+    for (unsigned n = 0; n < threads; ++n)
+      workers.push_back(new Worker<Op>(op, count));
+
+    cxxtools::Clock clock;
+    clock.start();
+
+    for (unsigned n = 0; n < threads; ++n)
+      workers[n]->start();
+    for (unsigned n = 0; n < threads; ++n)
+      workers[n]->join();
+
+    cxxtools::Timespan t = clock.stop();
+
+    for (unsigned n = 0; n < threads; ++n)
+      delete workers[n];
+
+    unsigned long ops = static_cast<unsigned long>(threads) * count;
+    std::cout << title << " (" << threads << " threads): " << t
+              << " (" << static_cast<double>(t.totalUSecs()) * 1000.0 / ops << " ns per operation)" << std::endl;
+  }
+
+  template <typename Op>
+  void runBench(const char* title, unsigned threads, unsigned long count, bool contended)
+  {
+    runBench<Op>(title, 1, count);
+    if (contended)
+      runBench<Op>(title, threads, count);
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    cxxtools::Arg<unsigned> threads(argc, argv, 't', 4);
+    cxxtools::Arg<unsigned long> count(argc, argv, 'n', 10000000);
+
+    if (argc > 1)
+    {
+      std::cerr << "usage: " << argv[0] << " [options]\n"
+                   "options:\n"
+                   "  -t <threads>  number of threads for the contended runs (default 4)\n"
+                   "  -n <count>    number of iterations per thread (default 10000000)\n";
+      return -1;
+    }
+
+    bool contended = threads > 1;
+
+    runBench<LockOp<cxxtools::Mutex, cxxtools::MutexLock> >("Mutex", threads, count, contended);
+    runBench<LockOp<cxxtools::SpinMutex, cxxtools::SpinLock> >("SpinMutex", threads, count, contended);
+    runBench<LockOp<cxxtools::LightMutex, cxxtools::LightMutexLock> >("LightMutex", threads, count, contended);
+    runBench<RefCountOp>("AtomicRefCounted", threads, count, contended);
+    runBench<SmartPtrOp>("ExternalAtomicRefCounted", threads, count, contended);
+    runBench<CoAllocatedOp<cxxtools::CoAllocatedRefCounted> >("CoAllocatedRefCounted", threads, count, contended);
+    runBench<CoAllocatedOp<cxxtools::LocalRefCounted> >("LocalRefCounted", threads, count, false);
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return -1;
+  }
+}
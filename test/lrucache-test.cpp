@@ -29,6 +29,8 @@
 #include "cxxtools/lrucache.h"
 #include "cxxtools/unit/testsuite.h"
 #include "cxxtools/unit/registertest.h"
+#include "cxxtools/string.h"
+#include <string>
 
 class LruCacheTest : public cxxtools::unit::TestSuite
 {
@@ -40,6 +42,7 @@ class LruCacheTest : public cxxtools::unit::TestSuite
             registerMethod("erase", *this, &LruCacheTest::erase);
             registerMethod("resize", *this, &LruCacheTest::resize);
             registerMethod("stats", *this, &LruCacheTest::stats);
+            registerMethod("keyTypes", *this, &LruCacheTest::keyTypes);
         }
 
         void cacheTest()
@@ -158,6 +161,32 @@ class LruCacheTest : public cxxtools::unit::TestSuite
           CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getMisses(), 1);
         }
 
+        void keyTypes()
+        {
+          // keys need just a less than operator by default
+          cxxtools::LruCache<cxxtools::String, int> strings(2);
+          strings.put(cxxtools::String(L"foo"), 1);
+          strings.put(cxxtools::String(L"bar"), 2);
+          strings.put(cxxtools::String(L"baz"), 3);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(strings.size(), 2);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(strings.get(cxxtools::String(L"baz")), 3);
+
+          cxxtools::LruCache<std::pair<int, int>, int> pairs(2);
+          pairs.put(std::pair<int, int>(1, 2), 12);
+          pairs.put(std::pair<int, int>(2, 1), 21);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(pairs.get(std::pair<int, int>(1, 2)), 12);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(pairs.get(std::pair<int, int>(2, 1)), 21);
+
+#if __cplusplus >= 201103L
+          cxxtools::LruCache<std::string, int, cxxtools::HashedCacheIndex<std::string> > hashed(2);
+          hashed.put("foo", 1);
+          hashed.put("bar", 2);
+          hashed.put("baz", 3);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(hashed.size(), 2);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(hashed.get("baz"), 3);
+#endif
+        }
+
 };
 
 cxxtools::unit::RegisterTest<LruCacheTest> register_LruCacheTest;
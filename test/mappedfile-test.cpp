@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/mappedfile.h"
+#include "cxxtools/jsondeserializer.h"
+#include "cxxtools/ioerror.h"
+#include <fstream>
+#include <vector>
+#include <stdio.h>
+
+namespace
+{
+    const std::string tmpFileName = "mappedfile-test.tmp";
+
+    void writeFile(const std::string& content)
+    {
+        std::ofstream f(tmpFileName.c_str());
+        f << content;
+    }
+}
+
+class MappedFileTest : public cxxtools::unit::TestSuite
+{
+    public:
+        MappedFileTest()
+            : cxxtools::unit::TestSuite("mappedfile")
+        {
+            registerMethod("testMap", *this, &MappedFileTest::testMap);
+            registerMethod("testEmpty", *this, &MappedFileTest::testEmpty);
+            registerMethod("testNotFound", *this, &MappedFileTest::testNotFound);
+            registerMethod("testStream", *this, &MappedFileTest::testStream);
+            registerMethod("testSeek", *this, &MappedFileTest::testSeek);
+            registerMethod("testDeserialize", *this, &MappedFileTest::testDeserialize);
+            registerMethod("testLarge", *this, &MappedFileTest::testLarge);
+        }
+
+        void tearDown()
+        {
+            ::remove(tmpFileName.c_str());
+        }
+
+        void testMap()
+        {
+            writeFile("Hello World");
+
+            cxxtools::MappedFile file(tmpFileName, cxxtools::MappedFile::Random);
+            CXXTOOLS_UNIT_ASSERT(file.isOpen());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(file.size(), 11);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(file.begin(), file.end()), "Hello World");
+
+            file.advise(cxxtools::MappedFile::WillNeed, 6, 5);
+
+            file.close();
+            CXXTOOLS_UNIT_ASSERT(!file.isOpen());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(file.size(), 0);
+        }
+
+        void testEmpty()
+        {
+            writeFile("");
+
+            cxxtools::MappedFile file(tmpFileName);
+            CXXTOOLS_UNIT_ASSERT(file.isOpen());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(file.size(), 0);
+            CXXTOOLS_UNIT_ASSERT(file.begin() == file.end());
+
+            cxxtools::MappedIstream in(tmpFileName);
+            CXXTOOLS_UNIT_ASSERT(in.get() == std::char_traits<char>::eof());
+        }
+
+        void testNotFound()
+        {
+            CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::MappedFile("mappedfile-test-missing.tmp"), cxxtools::FileNotFound);
+        }
+
+        void testStream()
+        {
+            writeFile("line 1\nline 2\nline 3\n");
+
+            cxxtools::MappedIstream in(tmpFileName);
+
+            std::vector<std::string> lines;
+            std::string line;
+            while (std::getline(in, line))
+                lines.push_back(line);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(lines.size(), 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(lines[0], "line 1");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(lines[2], "line 3");
+        }
+
+        void testSeek()
+        {
+            writeFile("0123456789");
+
+            cxxtools::MappedIstream in(tmpFileName);
+
+            in.seekg(5);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(in.get(), '5');
+            CXXTOOLS_UNIT_ASSERT_EQUALS(in.tellg(), std::streampos(6));
+
+            in.seekg(-2, std::ios_base::end);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(in.get(), '8');
+
+            in.seekg(-3, std::ios_base::cur);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(in.get(), '6');
+
+            in.seekg(11);
+            CXXTOOLS_UNIT_ASSERT(in.fail());
+        }
+
+        void testDeserialize()
+        {
+            writeFile("{\"a\": [1, 2, 3], \"b\": \"hello\"}");
+
+            cxxtools::MappedIstream in(tmpFileName);
+            cxxtools::JsonDeserializer deserializer(in);
+
+            std::vector<int> a;
+            std::string b;
+            deserializer.deserialize(a, "a");
+            deserializer.deserialize(b, "b");
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(a.size(), 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(a[2], 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(b, "hello");
+        }
+
+        void testLarge()
+        {
+            // a file, which is mapped to a huge page, with a size, which is
+            // not a multiple of the page size
+            std::size_t size = cxxtools::MappedFile::hugePageThreshold + 1;
+            {
+                std::ofstream f(tmpFileName.c_str());
+                f.seekp(size - 1);
+                f << 'x';
+            }
+
+            cxxtools::MappedFile file(tmpFileName);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(file.size(), size);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(file.begin()[0], '\0');
+            CXXTOOLS_UNIT_ASSERT_EQUALS(file.begin()[size - 1], 'x');
+        }
+};
+
+cxxtools::unit::RegisterTest<MappedFileTest> register_MappedFileTest;
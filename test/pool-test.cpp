@@ -27,15 +27,19 @@
  */
 
 #include "cxxtools/pool.h"
+#include "cxxtools/magazinepool.h"
+#include "cxxtools/thread.h"
 #include "cxxtools/unit/testsuite.h"
 #include "cxxtools/unit/registertest.h"
+#include <atomic>
+#include <vector>
 
 class PoolTest : public cxxtools::unit::TestSuite
 {
     struct Object
     {
-      static unsigned instCount;
-      static unsigned ctorCount;
+      static std::atomic<unsigned> instCount;
+      static std::atomic<unsigned> ctorCount;
 
       Object()
       { ++instCount; ++ctorCount; }
@@ -47,8 +51,11 @@ class PoolTest : public cxxtools::unit::TestSuite
     PoolTest()
     : cxxtools::unit::TestSuite("pool")
     {
-      registerMethod("poolTest", *this, &PoolTest::poolTest);
-      registerMethod("maxspareTest", *this, &PoolTest::maxspareTest);
+      registerMethod("poolTest", *this, &PoolTest::poolTest<cxxtools::Pool<Object> >);
+      registerMethod("maxspareTest", *this, &PoolTest::maxspareTest<cxxtools::Pool<Object> >);
+      registerMethod("magazinePoolTest", *this, &PoolTest::poolTest<cxxtools::MagazinePool<Object> >);
+      registerMethod("magazineMaxspareTest", *this, &PoolTest::maxspareTest<cxxtools::MagazinePool<Object> >);
+      registerMethod("magazineThreadTest", *this, &PoolTest::magazineThreadTest);
     }
 
     void setUp()
@@ -57,14 +64,14 @@ class PoolTest : public cxxtools::unit::TestSuite
       Object::ctorCount = 0;
     }
 
+    template <typename PoolType>
     void poolTest()
     {
       {
-        typedef cxxtools::Pool<Object> PoolType;
         PoolType pool;
 
         {
-          PoolType::Ptr p = pool.get();
+          typename PoolType::Ptr p = pool.get();
           CXXTOOLS_UNIT_ASSERT_EQUALS(pool.size(), 0);
           CXXTOOLS_UNIT_ASSERT_EQUALS(Object::ctorCount, 1);
         }
@@ -72,7 +79,7 @@ class PoolTest : public cxxtools::unit::TestSuite
         CXXTOOLS_UNIT_ASSERT_EQUALS(pool.size(), 1);
 
         {
-          PoolType::Ptr p = pool.get();
+          typename PoolType::Ptr p = pool.get();
           CXXTOOLS_UNIT_ASSERT_EQUALS(pool.size(), 0);
         }
 
@@ -83,13 +90,13 @@ class PoolTest : public cxxtools::unit::TestSuite
       CXXTOOLS_UNIT_ASSERT_EQUALS(Object::instCount, 0);
     }
 
+    template <typename PoolType>
     void maxspareTest()
     {
-      typedef cxxtools::Pool<Object> PoolType;
       PoolType pool(3);
 
       {
-        std::vector<PoolType::Ptr> p;
+        std::vector<typename PoolType::Ptr> p;
         while (p.size() < 10)
           p.push_back(pool.get());
         CXXTOOLS_UNIT_ASSERT_EQUALS(pool.size(), 0);
@@ -103,7 +110,7 @@ class PoolTest : public cxxtools::unit::TestSuite
       CXXTOOLS_UNIT_ASSERT_EQUALS(pool.size(), 3);
 
       {
-        PoolType::Ptr b = pool.get();
+        typename PoolType::Ptr b = pool.get();
         CXXTOOLS_UNIT_ASSERT_EQUALS(pool.size(), 2);
       }
       CXXTOOLS_UNIT_ASSERT_EQUALS(pool.size(), 3);
@@ -117,9 +124,55 @@ class PoolTest : public cxxtools::unit::TestSuite
 
       CXXTOOLS_UNIT_ASSERT_EQUALS(Object::instCount, 0);
     }
+
+    typedef cxxtools::MagazinePool<Object> MagazinePoolType;
+    MagazinePoolType* magazinePool;
+
+    void worker()
+    {
+      std::vector<MagazinePoolType::Ptr> p;
+      for (unsigned n = 0; n < 2000; ++n)
+      {
+        // hold more objects than fit into the magazines of a thread
+        while (p.size() < n % 50)
+          p.push_back(magazinePool->get());
+        p.clear();
+      }
+    }
+
+    void magazineThreadTest()
+    {
+      MagazinePoolType pool(100, cxxtools::DefaultCreator<Object>(), 2);
+      magazinePool = &pool;
+
+      std::vector<cxxtools::AttachedThread*> threads;
+      for (unsigned n = 0; n < 4; ++n)
+        threads.push_back(new cxxtools::AttachedThread(cxxtools::callable(*this, &PoolTest::worker)));
+      for (unsigned n = 0; n < threads.size(); ++n)
+        threads[n]->start();
+      for (unsigned n = 0; n < threads.size(); ++n)
+      {
+        threads[n]->join();
+        delete threads[n];
+      }
+
+      CXXTOOLS_UNIT_ASSERT(pool.size() <= 100);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(Object::instCount, pool.size());
+
+      pool.drop(10);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(pool.size(), 10);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(Object::instCount, 10);
+
+      pool.setMaximumSize(5);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(pool.size(), 5);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(Object::instCount, 5);
+
+      pool.drop();
+      CXXTOOLS_UNIT_ASSERT_EQUALS(Object::instCount, 0);
+    }
 };
 
-unsigned PoolTest::Object::instCount = 0;
-unsigned PoolTest::Object::ctorCount = 0;
+std::atomic<unsigned> PoolTest::Object::instCount(0);
+std::atomic<unsigned> PoolTest::Object::ctorCount(0);
 
 cxxtools::unit::RegisterTest<PoolTest> register_PoolTest;
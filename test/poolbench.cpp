@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+   Benchmark for the object pools.
+
+   A number of threads get objects from a pool and release them again. The
+   same is run with the mutex based Pool and with the MagazinePool.
+ */
+
+#include <cxxtools/pool.h>
+#include <cxxtools/magazinepool.h>
+#include <cxxtools/thread.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+  struct Object
+  {
+    char data[64];
+  };
+
+  template <typename PoolType>
+  class Worker
+  {
+      PoolType& _pool;
+      unsigned long _count;
+      unsigned _hold;
+      cxxtools::AttachedThread _thread;
+
+    public:
+      Worker(PoolType& pool, unsigned long count, unsigned hold)
+        : _pool(pool),
+          _count(count),
+          _hold(hold),
+          _thread(cxxtools::callable(*this, &Worker::run))
+        { }
+
+      void start()  { _thread.start(); }
+      void join()   { _thread.join(); }
+
+      void run()
+      {
+        std::vector<typename PoolType::Ptr> objects(_hold);
+        for (unsigned long n = 0; n < _count; ++n)
+        {
+          for (unsigned k = 0; k < _hold; ++k)
+            objects[k] = _pool.get();
+          for (unsigned k = 0; k < _hold; ++k)
+            objects[k] = typename PoolType::Ptr();
+        }
+      }
+  };
+
+  template <typename PoolType>
+  void runBench(const char* title, PoolType& pool, unsigned threads, unsigned long count, unsigned hold)
+  {
+    std::vector<Worker<PoolType>*> workers;
+    for (unsigned n = 0; n < threads; ++n)
+      workers.push_back(new Worker<PoolType>(pool, count, hold));
+
+    cxxtools::Clock clock;
+    clock.start();
+
+    for (unsigned n = 0; n < threads; ++n)
+      workers[n]->start();
+    for (unsigned n = 0; n < threads; ++n)
+      workers[n]->join();
+
+    cxxtools::Timespan t = clock.stop();
+
+    for (unsigned n = 0; n < threads; ++n)
+      delete workers[n];
+
+    unsigned long ops = static_cast<unsigned long>(threads) * count * hold;
+    std::cout << title << ": " << t
+              << " (" << static_cast<unsigned long>(ops / t.totalSeconds()) << " get/release per second, "
+              << pool.size() << " spare objects)" << std::endl;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    cxxtools::Arg<unsigned> threads(argc, argv, 't', 4);
+    cxxtools::Arg<unsigned long> count(argc, argv, 'n', 1000000);
+    cxxtools::Arg<unsigned> hold(argc, argv, 'k', 1);
+    cxxtools::Arg<unsigned> maxSpare(argc, argv, 'm', 0);
+
+    if (argc > 1)
+    {
+      std::cerr << "usage: " << argv[0] << " [options]\n"
+                   "options:\n"
+                   "  -t <threads>  number of threads (default 4)\n"
+                   "  -n <count>    number of iterations per thread (default 1000000)\n"
+                   "  -k <number>   objects held at once by each thread (default 1)\n"
+                   "  -m <number>   maximum number of spare objects (default 0 - unlimited)\n";
+      return -1;
+    }
+
+    {
+      cxxtools::Pool<Object> pool(maxSpare);
+      runBench("Pool", pool, threads, count, hold);
+    }
+
+    {
+      cxxtools::MagazinePool<Object> pool(maxSpare);
+      runBench("MagazinePool", pool, threads, count, hold);
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return -1;
+  }
+}
@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/posix/process.h"
+#include "cxxtools/eventloop.h"
+#include "cxxtools/iostream.h"
+#include "cxxtools/systemerror.h"
+#include "cxxtools/convert.h"
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+    std::string readAll(cxxtools::IODevice& device)
+    {
+        std::string result;
+        char buffer[64];
+        size_t n;
+        while ((n = device.read(buffer, sizeof(buffer))) > 0)
+            result.append(buffer, n);
+        return result;
+    }
+
+    class Reader : public cxxtools::Connectable
+    {
+            cxxtools::IODevice& _device;
+            char _buffer[16];
+
+        public:
+            std::string data;
+            bool finished;
+
+            Reader(cxxtools::IODevice& device, cxxtools::SelectorBase& selector)
+                : _device(device),
+                  finished(false)
+            {
+                _device.setSelector(&selector);
+                cxxtools::connect(_device.inputReady, *this, &Reader::onInput);
+                _device.beginRead(_buffer, sizeof(_buffer));
+            }
+
+            void onInput(cxxtools::IODevice& device)
+            {
+                size_t n = device.endRead();
+                data.append(_buffer, n);
+
+                if (device.eof())
+                    finished = true;
+                else
+                    device.beginRead(_buffer, sizeof(_buffer));
+            }
+    };
+}
+
+class ProcessTest : public cxxtools::unit::TestSuite
+{
+        cxxtools::EventLoop _loop;
+
+    public:
+        ProcessTest()
+            : cxxtools::unit::TestSuite("process")
+        {
+            registerMethod("testOutput", *this, &ProcessTest::testOutput);
+            registerMethod("testInput", *this, &ProcessTest::testInput);
+            registerMethod("testStream", *this, &ProcessTest::testStream);
+            registerMethod("testEnv", *this, &ProcessTest::testEnv);
+            registerMethod("testExitStatus", *this, &ProcessTest::testExitStatus);
+            registerMethod("testStderr", *this, &ProcessTest::testStderr);
+            registerMethod("testNotFound", *this, &ProcessTest::testNotFound);
+            registerMethod("testEventLoop", *this, &ProcessTest::testEventLoop);
+        }
+
+        void testOutput()
+        {
+            cxxtools::posix::Process echo("echo");
+            echo.arg("Hello").arg("World");
+            echo.start();
+
+            CXXTOOLS_UNIT_ASSERT(echo.running());
+            CXXTOOLS_UNIT_ASSERT(echo.pid() > 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readAll(echo.stdOut()), "Hello World\n");
+
+            int status = echo.wait();
+            CXXTOOLS_UNIT_ASSERT(WIFEXITED(status));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(WEXITSTATUS(status), 0);
+            CXXTOOLS_UNIT_ASSERT(!echo.running());
+        }
+
+        void testInput()
+        {
+            cxxtools::posix::Process cat("cat");
+            cat.start();
+
+            cat.stdIn().write("foo\nbar\n", 8);
+            cat.stdIn().close();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readAll(cat.stdOut()), "foo\nbar\n");
+        }
+
+        void testStream()
+        {
+            cxxtools::posix::Process seq("seq");
+            seq.arg("1000");
+            seq.start();
+
+            cxxtools::IOStream in(seq.stdOut());
+
+            unsigned count = 0;
+            unsigned sum = 0;
+            unsigned n;
+            while (in >> n)
+            {
+                ++count;
+                sum += n;
+            }
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(count, 1000);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(sum, 500500);
+        }
+
+        void testEnv()
+        {
+            cxxtools::posix::Process sh("sh");
+            sh.arg("-c").arg("echo $CXXTOOLS_PROCESS_TEST");
+            sh.setEnv("CXXTOOLS_PROCESS_TEST", "foo");
+            sh.setEnv("CXXTOOLS_PROCESS_TEST", "bar");
+            sh.start();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readAll(sh.stdOut()), "bar\n");
+        }
+
+        void testExitStatus()
+        {
+            cxxtools::posix::Process sh("sh");
+            sh.arg("-c").arg("exit 3");
+            sh.setStdin(cxxtools::posix::Process::Discard);
+            sh.setStdout(cxxtools::posix::Process::Discard);
+            sh.start();
+
+            int status;
+            while (!sh.tryWait(status))
+                ::usleep(1000);
+
+            CXXTOOLS_UNIT_ASSERT(WIFEXITED(status));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(WEXITSTATUS(status), 3);
+            CXXTOOLS_UNIT_ASSERT(!sh.running());
+        }
+
+        void testStderr()
+        {
+            {
+                cxxtools::posix::Process sh("sh");
+                sh.arg("-c").arg("echo out; echo err >&2");
+                sh.setStderr(cxxtools::posix::Process::Capture);
+                sh.start();
+
+                CXXTOOLS_UNIT_ASSERT_EQUALS(readAll(sh.stdOut()), "out\n");
+                CXXTOOLS_UNIT_ASSERT_EQUALS(readAll(sh.stdErr()), "err\n");
+            }
+
+            {
+                cxxtools::posix::Process sh("sh");
+                sh.arg("-c").arg("echo out; echo err >&2");
+                sh.setStderr(cxxtools::posix::Process::Combine);
+                sh.start();
+
+                CXXTOOLS_UNIT_ASSERT_EQUALS(readAll(sh.stdOut()), "out\nerr\n");
+            }
+        }
+
+        void testNotFound()
+        {
+            cxxtools::posix::Process p("cxxtools-process-test-does-not-exist");
+            CXXTOOLS_UNIT_ASSERT_THROW(p.start(), cxxtools::SystemError);
+            CXXTOOLS_UNIT_ASSERT(!p.running());
+        }
+
+        void testEventLoop()
+        {
+            static const unsigned count = 8;
+
+            std::vector<cxxtools::posix::Process*> processes;
+            std::vector<Reader*> readers;
+
+            for (unsigned n = 0; n < count; ++n)
+            {
+                cxxtools::posix::Process* p = new cxxtools::posix::Process("seq");
+                p->arg(cxxtools::convert<std::string>(n * 100));
+                p->setStdin(cxxtools::posix::Process::Discard);
+                p->start();
+                processes.push_back(p);
+                readers.push_back(new Reader(p->stdOut(), _loop));
+            }
+
+            unsigned finished = 0;
+            while (finished < count)
+            {
+                if (!_loop.wait(cxxtools::Milliseconds(5000)))
+                    CXXTOOLS_UNIT_FAIL("timeout");
+
+                finished = 0;
+                for (unsigned n = 0; n < count; ++n)
+                    if (readers[n]->finished)
+                        ++finished;
+            }
+
+            for (unsigned n = 0; n < count; ++n)
+            {
+                std::string expected;
+                for (unsigned i = 1; i <= n * 100; ++i)
+                    expected += cxxtools::convert<std::string>(i) + '\n';
+                CXXTOOLS_UNIT_ASSERT_EQUALS(readers[n]->data, expected);
+
+                int status = processes[n]->wait();
+                CXXTOOLS_UNIT_ASSERT_EQUALS(WEXITSTATUS(status), 0);
+
+                delete readers[n];
+                delete processes[n];
+            }
+        }
+};
+
+cxxtools::unit::RegisterTest<ProcessTest> register_ProcessTest;
@@ -34,6 +34,7 @@
 #include <cxxtools/bin/rpcclient.h>
 #include <cxxtools/json/rpcclient.h>
 #include <cxxtools/json/httpclient.h>
+#include <cxxtools/net/tcpsocket.h>
 #include <cxxtools/thread.h>
 #include <cxxtools/mutex.h>
 #include <cxxtools/clock.h>
@@ -46,6 +47,7 @@
 class BenchClient
 {
     void exec();
+    void execBatch(cxxtools::json::RpcClient& client);
 
     cxxtools::RemoteClient* client;
     cxxtools::AttachedThread thread;
@@ -53,6 +55,7 @@ class BenchClient
     static unsigned _numRequests;
     static unsigned _vectorSize;
     static unsigned _objectsSize;
+    static unsigned _batchSize;
     static cxxtools::atomic_t _requestsStarted;
     static cxxtools::atomic_t _requestsFinished;
     static cxxtools::atomic_t _requestsFailed;
@@ -84,6 +87,19 @@ class BenchClient
     static void objectsSize(unsigned n)
     { _objectsSize = n; }
 
+    static unsigned batchSize()
+    { return _batchSize; }
+
+    static void batchSize(unsigned n)
+    { _batchSize = n; }
+
+    static void reset()
+    {
+      cxxtools::atomicSet(_requestsStarted, 0);
+      cxxtools::atomicSet(_requestsFinished, 0);
+      cxxtools::atomicSet(_requestsFailed, 0);
+    }
+
     static unsigned requestsStarted()
     { return static_cast<unsigned>(cxxtools::atomicGet(_requestsStarted)); }
 
@@ -106,12 +122,20 @@ cxxtools::atomic_t BenchClient::_requestsFailed(0);
 unsigned BenchClient::_numRequests = 0;
 unsigned BenchClient::_vectorSize = 0;
 unsigned BenchClient::_objectsSize = 0;
+unsigned BenchClient::_batchSize = 1;
 typedef std::vector<BenchClient*> BenchClients;
 
 static cxxtools::Mutex mutex;
 
 void BenchClient::exec()
 {
+  cxxtools::json::RpcClient* jsonClient = dynamic_cast<cxxtools::json::RpcClient*>(client);
+  if (jsonClient && _batchSize > 1)
+  {
+    execBatch(*jsonClient);
+    return;
+  }
+
   cxxtools::RemoteProcedure<std::string, std::string> echo(*client, "echo");
   cxxtools::RemoteProcedure<std::vector<int>, int, int> seq(*client, "seq");
   cxxtools::RemoteProcedure<std::vector<Color>, unsigned> objects(*client, "objects");
@@ -163,6 +187,103 @@ void BenchClient::exec()
   }
 }
 
+// sends the echo requests in batches of _batchSize calls
+void BenchClient::execBatch(cxxtools::json::RpcClient& client)
+{
+  typedef cxxtools::RemoteProcedure<std::string, std::string> Echo;
+  std::vector<Echo> echo(_batchSize, Echo(client, "echo"));
+
+  while (true)
+  {
+    unsigned count = 0;
+    while (count < _batchSize
+        && static_cast<unsigned>(cxxtools::atomicIncrement(_requestsStarted)) <= _numRequests)
+      ++count;
+
+    if (count == 0)
+      break;
+
+    try
+    {
+      client.beginBatch();
+      for (unsigned n = 0; n < count; ++n)
+        echo[n].begin("hi");
+      client.endBatch();
+    }
+    catch (const std::exception& e)
+    {
+      {
+        cxxtools::MutexLock lock(mutex);
+        std::cerr << "batch request failed with error message \"" << e.what() << '"' << std::endl;
+      }
+
+      cxxtools::atomicExchangeAdd(_requestsFailed, count);
+      continue;
+    }
+
+    for (unsigned n = 0; n < count; ++n)
+    {
+      try
+      {
+        std::string ret = echo[n].result();
+        cxxtools::atomicIncrement(_requestsFinished);
+        if (ret != "hi")
+        {
+          std::cerr << "wrong response result \"" << ret << '"' << std::endl;
+          cxxtools::atomicIncrement(_requestsFailed);
+        }
+      }
+      catch (const std::exception& e)
+      {
+        {
+          cxxtools::MutexLock lock(mutex);
+          std::cerr << "request failed with error message \"" << e.what() << '"' << std::endl;
+        }
+
+        cxxtools::atomicIncrement(_requestsFailed);
+      }
+    }
+  }
+}
+
+cxxtools::Timespan runBench(unsigned threads, char protocol, const std::string& ip, unsigned short port)
+{
+  BenchClient::reset();
+
+  BenchClients clients;
+
+  while (clients.size() < threads)
+  {
+    cxxtools::RemoteClient* client;
+    if (protocol == 'b')
+      client = new cxxtools::bin::RpcClient(ip, port);
+    else if (protocol == 'j')
+      client = new cxxtools::json::RpcClient(ip, port);
+    else if (protocol == 'J')
+      client = new cxxtools::json::HttpClient(ip, port, "/jsonrpc");
+    else // if (protocol == 'x')
+      client = new cxxtools::xmlrpc::HttpClient(ip, port, "/xmlrpc");
+
+    clients.push_back(new BenchClient(client));
+  }
+
+  cxxtools::Clock cl;
+  cl.start();
+
+  for (BenchClients::iterator it = clients.begin(); it != clients.end(); ++it)
+    (*it)->start();
+
+  for (BenchClients::iterator it = clients.begin(); it != clients.end(); ++it)
+    (*it)->join();
+
+  cxxtools::Timespan t = cl.stop();
+
+  for (BenchClients::iterator it = clients.begin(); it != clients.end(); ++it)
+    delete *it;
+
+  return t;
+}
+
 int main(int argc, char* argv[])
 {
   try
@@ -179,6 +300,11 @@ int main(int argc, char* argv[])
     BenchClient::numRequests(cxxtools::Arg<unsigned>(argc, argv, 'n', 10000));
     BenchClient::vectorSize(cxxtools::Arg<unsigned>(argc, argv, 'v', 0));
     BenchClient::objectsSize(cxxtools::Arg<unsigned>(argc, argv, 'o', 0));
+    cxxtools::Arg<bool> noDelay(argc, argv, 'N');
+    cxxtools::Arg<bool> quickAck(argc, argv, 'Q');
+    cxxtools::Arg<unsigned> busyPoll(argc, argv, 'B');
+    BenchClient::batchSize(cxxtools::Arg<unsigned>(argc, argv, 's', 1));
+    cxxtools::Arg<bool> batchSweep(argc, argv, 'S');
 
     if (!xmlrpc && !binary && !json && !jsonhttp)
     {
@@ -192,44 +318,46 @@ int main(int argc, char* argv[])
                      "   -J         use json rpc over http protocol\n"
                      "   -t number  set number of threads (default: 4)\n"
                      "   -n number  set number of requests (default: 10000)\n"
+                     "   -N         set TCP_NODELAY on the client sockets\n"
+                     "   -Q         set TCP_QUICKACK on the client sockets\n"
+                     "   -B usecs   set SO_BUSY_POLL on the client sockets\n"
+                     "   -s number  send echo requests in json rpc batches of this size (default: 1)\n"
+                     "   -S         run the benchmark with json rpc batch sizes 1 to 64\n"
                      "one protocol must be selected\n"
                   << std::endl;
         return -1;
     }
 
-    BenchClients clients;
+    cxxtools::net::SocketOptions options;
+    if (noDelay)
+      options.noDelay(true);
+    if (quickAck)
+      options.quickAck(true);
+    if (busyPoll > 0)
+      options.busyPoll(cxxtools::Microseconds(busyPoll.getValue()));
+    cxxtools::net::TcpSocket::defaultSocketOptions(options);
 
-    while (clients.size() < threads)
-    {
-      cxxtools::RemoteClient* client;
-      if (binary)
-        client = new cxxtools::bin::RpcClient(ip, port);
-      else if (json)
-        client = new cxxtools::json::RpcClient(ip, port);
-      else if (jsonhttp)
-        client = new cxxtools::json::HttpClient(ip, port, "/jsonrpc");
-      else // if (xmlrpc)
-        client = new cxxtools::xmlrpc::HttpClient(ip, port, "/xmlrpc");
-
-      clients.push_back(new BenchClient(client));
-    }
+    char protocol = binary ? 'b' : json ? 'j' : jsonhttp ? 'J' : 'x';
 
-    cxxtools::Clock cl;
-    cl.start();
-
-    for (BenchClients::iterator it = clients.begin(); it != clients.end(); ++it)
-      (*it)->start();
+    if (batchSweep)
+    {
+      // run the benchmark with batch sizes 1, 2, 4, ... 64
+      for (unsigned batch = 1; batch <= 64; batch *= 2)
+      {
+        BenchClient::batchSize(batch);
+        cxxtools::Timespan t = runBench(threads, protocol, ip, port);
+        std::cout << "batch size " << batch << ": " << BenchClient::numRequests() << " requests in " << t.totalMSecs()/1e3 << " s => " << (BenchClient::numRequests() / (t.totalMSecs()/1e3)) << "#/s; "
+                  << BenchClient::requestsFailed() << " failed" << std::endl;
+      }
 
-    for (BenchClients::iterator it = clients.begin(); it != clients.end(); ++it)
-      (*it)->join();
+      return 0;
+    }
 
-    cxxtools::Timespan t = cl.stop();
+    cxxtools::Timespan t = runBench(threads, protocol, ip, port);
 
     std::cout << BenchClient::numRequests() << " requests in " << t.totalMSecs()/1e3 << " s => " << (BenchClient::requestsStarted() / (t.totalMSecs()/1e3)) << "#/s\n"
-              << BenchClient::requestsFinished() << " finished " << BenchClient::requestsFailed() << " failed" << std::endl;
-
-    for (BenchClients::iterator it = clients.begin(); it != clients.end(); ++it)
-      delete *it;
+              << BenchClient::requestsFinished() << " finished " << BenchClient::requestsFailed() << " failed\n"
+              << "average latency " << (t.totalUSecs() * threads / BenchClient::numRequests()) << " us" << std::endl;
   }
   catch (const std::exception& e)
   {
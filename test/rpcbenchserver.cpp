@@ -78,6 +78,9 @@ int main(int argc, char* argv[])
     cxxtools::Arg<unsigned short> jport(argc, argv, 'j', 7004);
     cxxtools::Arg<unsigned> threads(argc, argv, 't', 4);
     cxxtools::Arg<unsigned> maxThreads(argc, argv, 'T', 200);
+    cxxtools::Arg<bool> noDelay(argc, argv, 'N');
+    cxxtools::Arg<bool> quickAck(argc, argv, 'Q');
+    cxxtools::Arg<unsigned> busyPoll(argc, argv, 'B');
 
     std::cout << "rpc echo server running on port " << port.getValue() << "\n\n"
                  "options:\n\n"
@@ -87,11 +90,24 @@ int main(int argc, char* argv[])
                  "   -j number  set port number run json rpc server (default: 7004)\n"
                  "   -t number  set minimum number of threads (default: 4)\n"
                  "   -T number  set maximum number of threads (default: 200)\n"
+                 "   -N         set TCP_NODELAY on accepted sockets\n"
+                 "   -Q         set TCP_QUICKACK on accepted sockets\n"
+                 "   -B usecs   set SO_BUSY_POLL on accepted sockets\n"
               << std::endl;
 
+    cxxtools::net::SocketOptions options;
+    if (noDelay)
+      options.noDelay(true);
+    if (quickAck)
+      options.quickAck(true);
+    if (busyPoll > 0)
+      options.busyPoll(cxxtools::Microseconds(busyPoll.getValue()));
+
     cxxtools::EventLoop loop;
 
-    cxxtools::http::Server server(loop, ip, port);
+    cxxtools::http::Server server(loop);
+    server.socketOptions(options);
+    server.listen(ip, port);
     server.minThreads(threads);
     server.maxThreads(maxThreads);
     cxxtools::xmlrpc::Service service;
@@ -100,12 +116,16 @@ int main(int argc, char* argv[])
     service.registerFunction("objects", objects);
     server.addService("/xmlrpc", service);
 
-    cxxtools::bin::RpcServer binServer(loop, ip, bport);
+    cxxtools::bin::RpcServer binServer(loop);
+    binServer.socketOptions(options);
+    binServer.listen(ip, bport);
     binServer.minThreads(threads);
     binServer.maxThreads(maxThreads);
     binServer.addService(service);
 
-    cxxtools::json::RpcServer jsonServer(loop, ip, jport);
+    cxxtools::json::RpcServer jsonServer(loop);
+    jsonServer.socketOptions(options);
+    jsonServer.listen(ip, jport);
     jsonServer.minThreads(threads);
     jsonServer.maxThreads(maxThreads);
     jsonServer.addService("", service);
@@ -35,6 +35,8 @@
 #include <cxxtools/jsondeserializer.h>
 #include <cxxtools/bin/serializer.h>
 #include <cxxtools/bin/deserializer.h>
+#include <cxxtools/csvserializer.h>
+#include <cxxtools/csvwriter.h>
 #include <cxxtools/arg.h>
 #include <cxxtools/clock.h>
 #include <cxxtools/convert.h>
@@ -77,6 +79,7 @@ namespace
     bool runXml = true;
     bool runJson = true;
     bool runBin = true;
+    bool runCsv = true;
 }
 
 // Function, which calls the serializer.
@@ -151,6 +154,37 @@ void benchBinSerialization(const T& d, const char* fname = 0)
     benchSerialization<T, cxxtools::bin::Serializer, cxxtools::bin::Deserializer>(d, fname);
 }
 
+// Compare the csv serializer with the byte oriented csv writer. Csv needs
+// rows, so it is run only for the custom objects.
+template <typename T>
+void benchCsvSerialization(const T& d, const char* fname = 0)
+{
+    std::stringstream data;
+    cxxtools::CsvSerializer serializer(data);
+
+    cxxtools::Clock clock;
+    clock.start();
+    serializer.serialize(d);
+    cxxtools::Timespan ts = clock.stop();
+
+    std::stringstream data2;
+    cxxtools::CsvWriter writer(data2);
+
+    clock.start();
+    writer.serialize(d);
+    cxxtools::Timespan tw = clock.stop();
+
+    if (fname)
+    {
+        std::ofstream f(fname);
+        f << data2.str();
+    }
+
+    std::cout << "\tserialization: " << ts << "\n"
+                 "\twriter: " << tw << "\n"
+                 "\tsize: " << data.str().size() << " bytes" << std::endl;
+}
+
 template <typename T>
 void benchVector(const char* typeName, unsigned N, T increment, bool fileoutput)
 {
@@ -197,12 +231,13 @@ int main(int argc, char* argv[])
         runXml  = cxxtools::Arg<bool>(argc, argv, 'x');
         runJson = cxxtools::Arg<bool>(argc, argv, 'j');
         runBin  = cxxtools::Arg<bool>(argc, argv, 'b');
+        runCsv  = cxxtools::Arg<bool>(argc, argv, 'c');
 
         std::cout << "size of SerializationInfo: " << sizeof(cxxtools::SerializationInfo) << std::endl;
 
-        if (!runXml && !runJson && !runBin)
+        if (!runXml && !runJson && !runBin && !runCsv)
         {
-            runXml  = runJson = runBin  = true;
+            runXml  = runJson = runBin  = runCsv = true;
         }
 
         std::cout << "benchmark serializer with " << I.getValue() << " int vector " << D.getValue() << " double vector and " << C.getValue() << " custom vector iterations\n\n"
@@ -211,7 +246,8 @@ int main(int argc, char* argv[])
                      "   -I <number>       specify number of iterations for int vector\n"
                      "   -D <number>       specify number of iterations for double vector\n"
                      "   -C <number>       specify number of iterations for custom object\n"
-                     "   -f                write serialized output to files\n" << std::endl;
+                     "   -f                write serialized output to files\n"
+                     "   -x -j -b -c       run only xml, json, bin or csv benchmarks\n" << std::endl;
 
         if (I.getValue() > 0)
             benchVector<int>("int", I, 1, fileoutput);
@@ -251,6 +287,12 @@ int main(int argc, char* argv[])
                 std::cout << "bin:" << std::endl;
                 benchBinSerialization(v, fileoutput ? "custobject.bin" : 0);
             }
+
+            if (runCsv)
+            {
+                std::cout << "csv:" << std::endl;
+                benchCsvSerialization(v, fileoutput ? "custobject.csv" : 0);
+            }
         }
 
     }
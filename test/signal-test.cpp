@@ -0,0 +1,435 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/signal.h"
+#include "cxxtools/event.h"
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include <vector>
+
+namespace
+{
+    class Receiver : public cxxtools::Connectable
+    {
+        public:
+            Receiver()
+                : count(0),
+                  sum(0)
+            { }
+
+            void onValue(int value)
+            {
+                ++count;
+                sum += value;
+            }
+
+            unsigned count;
+            int sum;
+    };
+
+    class FooEvent : public cxxtools::BasicEvent<FooEvent>
+    {
+    };
+
+    class BarEvent : public cxxtools::BasicEvent<BarEvent>
+    {
+    };
+
+    unsigned functionCalls = 0;
+
+    void onFunction(int)
+    {
+        ++functionCalls;
+    }
+
+    unsigned connectCalls = 0;
+
+    class CountingSlot : public cxxtools::FunctionSlot<void, int>
+    {
+        public:
+            CountingSlot()
+                : cxxtools::FunctionSlot<void, int>(cxxtools::Function<void, int>(onFunction))
+            { }
+
+            cxxtools::Slot* clone() const
+            { return new CountingSlot(*this); }
+
+            void onConnect(const cxxtools::Connection&)
+            { ++connectCalls; }
+    };
+}
+
+class SignalTest : public cxxtools::unit::TestSuite
+{
+        cxxtools::Signal<int>* _signal;
+        cxxtools::Signal<const cxxtools::Event&>* _eventSignal;
+        Receiver* _receiver;
+        cxxtools::Connection _conn;
+        std::vector<int> _calls;
+        unsigned _foo;
+        unsigned _bar;
+        unsigned _all;
+
+    public:
+        SignalTest()
+            : cxxtools::unit::TestSuite("signal"),
+              _signal(0),
+              _eventSignal(0),
+              _receiver(0),
+              _foo(0),
+              _bar(0),
+              _all(0)
+        {
+            registerMethod("send", *this, &SignalTest::send);
+            registerMethod("order", *this, &SignalTest::order);
+            registerMethod("disconnect", *this, &SignalTest::disconnect);
+            registerMethod("destroyReceiver", *this, &SignalTest::destroyReceiver);
+            registerMethod("disconnectWhileSending", *this, &SignalTest::disconnectWhileSending);
+            registerMethod("destroyReceiverWhileSending", *this, &SignalTest::destroyReceiverWhileSending);
+            registerMethod("destroySignalWhileSending", *this, &SignalTest::destroySignalWhileSending);
+            registerMethod("connectWhileSending", *this, &SignalTest::connectWhileSending);
+            registerMethod("recursiveSend", *this, &SignalTest::recursiveSend);
+            registerMethod("chain", *this, &SignalTest::chain);
+            registerMethod("copy", *this, &SignalTest::copy);
+            registerMethod("derivedSlot", *this, &SignalTest::derivedSlot);
+            registerMethod("events", *this, &SignalTest::events);
+            registerMethod("eventUnsubscribeWhileSending", *this, &SignalTest::eventUnsubscribeWhileSending);
+        }
+
+        void setUp()
+        {
+            _calls.clear();
+            functionCalls = 0;
+            _foo = _bar = _all = 0;
+        }
+
+        void send()
+        {
+            cxxtools::Signal<int> signal;
+            Receiver receiver;
+
+            cxxtools::connect(signal, receiver, &Receiver::onValue);
+            cxxtools::connect(signal, onFunction);
+
+            signal.send(3);
+            signal(4);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(receiver.count, 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(receiver.sum, 7);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(functionCalls, 2);
+        }
+
+        void first(int)   { _calls.push_back(1); }
+        void second(int)  { _calls.push_back(2); }
+        void third(int)   { _calls.push_back(3); }
+
+        void order()
+        {
+            cxxtools::Signal<int> signal;
+            cxxtools::connect(signal, *this, &SignalTest::first);
+            cxxtools::connect(signal, *this, &SignalTest::second);
+            cxxtools::connect(signal, *this, &SignalTest::third);
+
+            signal.send(0);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_calls.size(), 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_calls[0], 1);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_calls[1], 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_calls[2], 3);
+        }
+
+        void disconnect()
+        {
+            cxxtools::Signal<int> signal;
+            Receiver receiver;
+
+            cxxtools::connect(signal, receiver, &Receiver::onValue);
+            cxxtools::Connection c = cxxtools::connect(signal, onFunction);
+            cxxtools::connect(signal, *this, &SignalTest::first);
+
+            cxxtools::disconnect(signal, receiver, &Receiver::onValue);
+            c.close();
+
+            signal.send(1);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(receiver.count, 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(functionCalls, 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_calls.size(), 1);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(receiver.connectionCount(), 0);
+        }
+
+        void destroyReceiver()
+        {
+            cxxtools::Signal<int> signal;
+
+            {
+                Receiver receiver;
+                cxxtools::connect(signal, receiver, &Receiver::onValue);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(receiver.connectionCount(), 1);
+            }
+
+            cxxtools::connect(signal, *this, &SignalTest::first);
+            signal.send(1);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_calls.size(), 1);
+
+            Receiver receiver;
+            {
+                cxxtools::Signal<int> signal2;
+                cxxtools::connect(signal2, receiver, &Receiver::onValue);
+            }
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(receiver.connectionCount(), 0);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // modifications while sending
+        //
+        void closeConnection(int)
+        {
+            _calls.push_back(0);
+            _conn.close();
+        }
+
+        void disconnectWhileSending()
+        {
+            cxxtools::Signal<int> signal;
+            cxxtools::connect(signal, *this, &SignalTest::closeConnection);
+            _conn = cxxtools::connect(signal, *this, &SignalTest::first);
+            cxxtools::connect(signal, *this, &SignalTest::second);
+
+            signal.send(0);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_calls.size(), 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_calls[1], 2);
+
+            _calls.clear();
+            signal.send(0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_calls.size(), 2);
+        }
+
+        void deleteReceiver(int)
+        {
+            delete _receiver;
+            _receiver = 0;
+        }
+
+        void destroyReceiverWhileSending()
+        {
+            cxxtools::Signal<int> signal;
+            _receiver = new Receiver();
+            cxxtools::connect(signal, *this, &SignalTest::deleteReceiver);
+            cxxtools::connect(signal, *_receiver, &Receiver::onValue);
+            cxxtools::connect(signal, *this, &SignalTest::first);
+
+            signal.send(0);
+
+            CXXTOOLS_UNIT_ASSERT(_receiver == 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_calls.size(), 1);
+        }
+
+        void deleteSignal(int)
+        {
+            delete _signal;
+            _signal = 0;
+        }
+
+        void destroySignalWhileSending()
+        {
+            _signal = new cxxtools::Signal<int>();
+            cxxtools::connect(*_signal, *this, &SignalTest::first);
+            cxxtools::connect(*_signal, *this, &SignalTest::deleteSignal);
+            cxxtools::connect(*_signal, *this, &SignalTest::second);
+
+            _signal->send(0);
+
+            CXXTOOLS_UNIT_ASSERT(_signal == 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_calls.size(), 1);
+        }
+
+        void connectSecond(int)
+        {
+            _calls.push_back(0);
+            if (_calls.size() == 1)
+                cxxtools::connect(*_signal, *this, &SignalTest::second);
+        }
+
+        void connectWhileSending()
+        {
+            cxxtools::Signal<int> signal;
+            _signal = &signal;
+
+            // enough connections to let the storage grow while sending
+            for (unsigned n = 0; n < 3; ++n)
+                cxxtools::connect(signal, onFunction);
+            cxxtools::connect(signal, *this, &SignalTest::connectSecond);
+
+            signal.send(0);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(functionCalls, 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_calls.size(), 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_calls[1], 2);
+            _signal = 0;
+        }
+
+        void resend(int value)
+        {
+            _calls.push_back(value);
+            if (value > 0)
+            {
+                _conn.close();
+                _signal->send(value - 1);
+            }
+        }
+
+        void recursiveSend()
+        {
+            cxxtools::Signal<int> signal;
+            _signal = &signal;
+
+            cxxtools::connect(signal, *this, &SignalTest::resend);
+            _conn = cxxtools::connect(signal, *this, &SignalTest::first);
+
+            signal.send(2);
+
+            // the inner send must not remove the connection closed while
+            // the outer send is running
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_calls.size(), 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_calls[0], 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_calls[1], 1);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_calls[2], 0);
+
+            _calls.clear();
+            signal.send(0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_calls.size(), 1);
+            _signal = 0;
+        }
+
+        void chain()
+        {
+            cxxtools::Signal<int> sender;
+            Receiver receiver;
+
+            {
+                cxxtools::Signal<int> receiverSignal;
+                cxxtools::connect(sender, receiverSignal);
+                cxxtools::connect(receiverSignal, receiver, &Receiver::onValue);
+
+                sender.send(5);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(receiver.sum, 5);
+            }
+
+            sender.send(5);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(receiver.sum, 5);
+        }
+
+        void copy()
+        {
+            cxxtools::Signal<int> signal;
+            Receiver receiver;
+            cxxtools::connect(signal, receiver, &Receiver::onValue);
+
+            cxxtools::Signal<int> signal2(signal);
+            signal2.send(1);
+            signal.send(2);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(receiver.count, 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(receiver.sum, 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(receiver.connectionCount(), 2);
+        }
+
+        void derivedSlot()
+        {
+            // the connection must hold a CountingSlot and not a copy of
+            // its FunctionSlot part
+            cxxtools::Signal<int> signal;
+            functionCalls = 0;
+            connectCalls = 0;
+
+            signal.connect(CountingSlot());
+            signal.send(1);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(functionCalls, 1);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(connectCalls, 1);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // events
+        //
+        void onFoo(const FooEvent&)                 { ++_foo; }
+        void onBar(const BarEvent&)                 { ++_bar; }
+        void onEvent(const cxxtools::Event&)        { ++_all; }
+
+        void events()
+        {
+            cxxtools::Signal<const cxxtools::Event&> signal;
+            signal.subscribe(cxxtools::slot(*this, &SignalTest::onFoo));
+            signal.subscribe(cxxtools::slot(*this, &SignalTest::onBar));
+            cxxtools::connect(signal, *this, &SignalTest::onEvent);
+
+            signal.send(FooEvent());
+            signal.send(FooEvent());
+            signal.send(BarEvent());
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_foo, 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_bar, 1);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_all, 3);
+
+            signal.unsubscribe(cxxtools::slot(*this, &SignalTest::onFoo));
+            cxxtools::disconnect(signal, *this, &SignalTest::onEvent);
+
+            signal.send(FooEvent());
+            signal.send(BarEvent());
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_foo, 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_bar, 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_all, 3);
+        }
+
+        void unsubscribeBar(const FooEvent&)
+        {
+            ++_foo;
+            _eventSignal->unsubscribe(cxxtools::slot(*this, &SignalTest::onBar));
+            _eventSignal->send(BarEvent());
+        }
+
+        void eventUnsubscribeWhileSending()
+        {
+            cxxtools::Signal<const cxxtools::Event&> signal;
+            _eventSignal = &signal;
+            signal.subscribe(cxxtools::slot(*this, &SignalTest::unsubscribeBar));
+            signal.subscribe(cxxtools::slot(*this, &SignalTest::onBar));
+
+            signal.send(FooEvent());
+            signal.send(BarEvent());
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_foo, 1);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_bar, 0);
+        }
+};
+
+cxxtools::unit::RegisterTest<SignalTest> register_SignalTest;
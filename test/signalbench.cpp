@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+   Benchmark for signals and slots.
+
+   The send test sends a signal connected to a number of member functions.
+   The event test sends events through a Signal<const Event&> with slots
+   subscribed to different event types. The connect test connects and
+   disconnects a slot repeatedly.
+ */
+
+#include <cxxtools/signal.h>
+#include <cxxtools/event.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+  class Receiver : public cxxtools::Connectable
+  {
+    public:
+      Receiver()
+        : count(0)
+        { }
+
+      void onValue(int value)
+        { count += value; }
+
+      unsigned long count;
+  };
+
+  class FooEvent : public cxxtools::BasicEvent<FooEvent> { };
+  class BarEvent : public cxxtools::BasicEvent<BarEvent> { };
+  class BazEvent : public cxxtools::BasicEvent<BazEvent> { };
+
+  class EventReceiver : public cxxtools::Connectable
+  {
+    public:
+      EventReceiver()
+        : count(0)
+        { }
+
+      void onFoo(const FooEvent&)   { ++count; }
+      void onBar(const BarEvent&)   { ++count; }
+      void onBaz(const BazEvent&)   { ++count; }
+
+      unsigned long count;
+  };
+
+  void report(const char* name, cxxtools::Timespan t, unsigned long count)
+  {
+    std::cout << name << ": " << t
+              << " (" << static_cast<double>(t.totalUSecs()) * 1000.0 / count << " ns per operation)" << std::endl;
+  }
+
+  void send(unsigned slots, unsigned long count)
+  {
+    cxxtools::Signal<int> signal;
+    std::vector<Receiver> receivers(slots);
+    for (unsigned n = 0; n < slots; ++n)
+      cxxtools::connect(signal, receivers[n], &Receiver::onValue);
+
+    cxxtools::Clock clock;
+    clock.start();
+
+    for (unsigned long n = 0; n < count; ++n)
+      signal.send(1);
+
+    cxxtools::Timespan t = clock.stop();
+
+    std::cout << slots << " slots ";
+    report("send", t, count);
+  }
+
+  void events(unsigned long count)
+  {
+    cxxtools::Signal<const cxxtools::Event&> signal;
+    EventReceiver receiver;
+    signal.subscribe(cxxtools::slot(receiver, &EventReceiver::onFoo));
+    signal.subscribe(cxxtools::slot(receiver, &EventReceiver::onBar));
+    signal.subscribe(cxxtools::slot(receiver, &EventReceiver::onBaz));
+
+    FooEvent foo;
+    BarEvent bar;
+
+    cxxtools::Clock clock;
+    clock.start();
+
+    for (unsigned long n = 0; n < count; ++n)
+    {
+      signal.send(foo);
+      signal.send(bar);
+    }
+
+    cxxtools::Timespan t = clock.stop();
+
+    report("events", t, count * 2);
+  }
+
+  void connect(unsigned long count)
+  {
+    cxxtools::Signal<int> signal;
+    Receiver receiver;
+
+    cxxtools::Clock clock;
+    clock.start();
+
+    for (unsigned long n = 0; n < count; ++n)
+    {
+      cxxtools::Connection c = cxxtools::connect(signal, receiver, &Receiver::onValue);
+      c.close();
+    }
+
+    cxxtools::Timespan t = clock.stop();
+
+    report("connect", t, count);
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    cxxtools::Arg<unsigned> slots(argc, argv, 's', 4);
+    cxxtools::Arg<unsigned long> count(argc, argv, 'n', 1000000);
+
+    if (argc > 1)
+    {
+      std::cerr << "usage: " << argv[0] << " [options]\n"
+                   "options:\n"
+                   "  -s <slots>    number of slots connected to the signal (default 4)\n"
+                   "  -n <count>    number of operations (default 1000000)\n";
+      return -1;
+    }
+
+    send(1, count);
+    send(slots, count);
+    events(count);
+    connect(count);
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return -1;
+  }
+}
@@ -63,6 +63,23 @@ class AtomicObject : public cxxtools::AtomicRefCounted
 
 std::size_t AtomicObject::objectRefs = 0;
 
+class PlainObject
+{
+    public:
+        explicit PlainObject(int value_ = 0)
+        : value(value_)
+        { ++objectRefs; }
+
+        ~PlainObject()
+        { --objectRefs; }
+
+        int value;
+
+        static std::size_t objectRefs;
+};
+
+std::size_t PlainObject::objectRefs = 0;
+
 
 class SmartPtrTest : public cxxtools::unit::TestSuite
 {
@@ -74,6 +91,8 @@ class SmartPtrTest : public cxxtools::unit::TestSuite
             registerMethod( "InternalRefCounted", *this, &SmartPtrTest::InternalRefCounted );
             registerMethod( "AtomicInternalRefCounted", *this, &SmartPtrTest::AtomicInternalRefCounted );
             registerMethod( "RefLinked", *this, &SmartPtrTest::RefLinked );
+            registerMethod( "CoAllocatedRefCounted", *this, &SmartPtrTest::CoAllocatedRefCounted );
+            registerMethod( "LocalRefCounted", *this, &SmartPtrTest::LocalRefCounted );
         }
 
     public:
@@ -84,6 +103,8 @@ class SmartPtrTest : public cxxtools::unit::TestSuite
         void InternalRefCounted();
         void AtomicInternalRefCounted();
         void RefLinked();
+        void CoAllocatedRefCounted();
+        void LocalRefCounted();
 };
 
 cxxtools::unit::RegisterTest<SmartPtrTest> register_SmartPtrTest;
@@ -93,6 +114,7 @@ void SmartPtrTest::setUp()
 {
     Object::objectRefs = 0;
     AtomicObject::objectRefs = 0;
+    PlainObject::objectRefs = 0;
 }
 
 
@@ -189,3 +211,53 @@ void SmartPtrTest::RefLinked()
     CXXTOOLS_UNIT_ASSERT(Object::objectRefs == 0);
 }
 
+
+
+void SmartPtrTest::CoAllocatedRefCounted()
+{
+    typedef cxxtools::SmartPtr<PlainObject, cxxtools::CoAllocatedRefCounted> Ptr;
+
+    {
+        Ptr smartPtr = Ptr::create(42);
+        CXXTOOLS_UNIT_ASSERT_EQUALS( smartPtr->value, 42 );
+        CXXTOOLS_UNIT_ASSERT_EQUALS( Ptr::refs(smartPtr.getPointer()), 1 );
+
+        Ptr second(smartPtr);
+        CXXTOOLS_UNIT_ASSERT_EQUALS( Ptr::refs(second.getPointer()), 2);
+
+        Ptr third;
+        third = second;
+        CXXTOOLS_UNIT_ASSERT_EQUALS( Ptr::refs(third.getPointer()), 3);
+
+        third = third;
+        CXXTOOLS_UNIT_ASSERT_EQUALS( Ptr::refs(third.getPointer()), 3);
+
+        third = Ptr::create();
+        CXXTOOLS_UNIT_ASSERT_EQUALS( Ptr::refs(smartPtr.getPointer()), 2);
+        CXXTOOLS_UNIT_ASSERT_EQUALS( Ptr::refs(third.getPointer()), 1);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(PlainObject::objectRefs, 2);
+    }
+
+    CXXTOOLS_UNIT_ASSERT_EQUALS(PlainObject::objectRefs, 0);
+}
+
+
+void SmartPtrTest::LocalRefCounted()
+{
+    typedef cxxtools::SmartPtr<PlainObject, cxxtools::LocalRefCounted> Ptr;
+
+    {
+        Ptr smartPtr = Ptr::create(7);
+        CXXTOOLS_UNIT_ASSERT_EQUALS( smartPtr->value, 7 );
+        CXXTOOLS_UNIT_ASSERT_EQUALS( Ptr::refs(smartPtr.getPointer()), 1 );
+
+        Ptr second(smartPtr);
+        CXXTOOLS_UNIT_ASSERT_EQUALS( Ptr::refs(second.getPointer()), 2);
+
+        second = Ptr();
+        CXXTOOLS_UNIT_ASSERT_EQUALS( Ptr::refs(smartPtr.getPointer()), 1);
+        CXXTOOLS_UNIT_ASSERT_EQUALS( Ptr::refs(second.getPointer()), 0);
+    }
+
+    CXXTOOLS_UNIT_ASSERT_EQUALS(PlainObject::objectRefs, 0);
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2024 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/net/socketoptions.h"
+#include "cxxtools/net/tcpserver.h"
+#include "cxxtools/net/tcpsocket.h"
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+namespace
+{
+    const unsigned short testPort = 7006;
+
+    int getOption(int fd, int level, int option)
+    {
+        int value = 0;
+        socklen_t len = sizeof(value);
+        if (::getsockopt(fd, level, option, &value, &len) != 0)
+            return -1;
+        return value;
+    }
+}
+
+class SocketOptionsTest : public cxxtools::unit::TestSuite
+{
+    public:
+        SocketOptionsTest()
+            : cxxtools::unit::TestSuite("socketoptions")
+        {
+            registerMethod("testDefaults", *this, &SocketOptionsTest::testDefaults);
+            registerMethod("testAccepted", *this, &SocketOptionsTest::testAccepted);
+            registerMethod("testConnect", *this, &SocketOptionsTest::testConnect);
+        }
+
+        void testDefaults()
+        {
+            cxxtools::net::SocketOptions options;
+            CXXTOOLS_UNIT_ASSERT(options.noDelay() < 0);
+            CXXTOOLS_UNIT_ASSERT(options.busyPoll() < cxxtools::Timespan(0));
+            CXXTOOLS_UNIT_ASSERT(options.keepIdle() < cxxtools::Timespan(0));
+
+            options.noDelay(false);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(options.noDelay(), 0);
+        }
+
+        void testAccepted()
+        {
+            cxxtools::net::SocketOptions options;
+            options.noDelay(true);
+            options.keepAlive(true);
+#ifdef TCP_KEEPIDLE
+            options.keepIdle(cxxtools::Seconds(77));
+#endif
+
+            cxxtools::net::TcpServer server("127.0.0.1", testPort);
+            server.socketOptions(options);
+
+            cxxtools::net::TcpSocket client("127.0.0.1", testPort);
+            cxxtools::net::TcpSocket accepted(server);
+
+            CXXTOOLS_UNIT_ASSERT(getOption(accepted.getFd(), IPPROTO_TCP, TCP_NODELAY) != 0);
+            CXXTOOLS_UNIT_ASSERT(getOption(accepted.getFd(), SOL_SOCKET, SO_KEEPALIVE) != 0);
+#ifdef TCP_KEEPIDLE
+            CXXTOOLS_UNIT_ASSERT_EQUALS(getOption(accepted.getFd(), IPPROTO_TCP, TCP_KEEPIDLE), 77);
+#endif
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(getOption(client.getFd(), IPPROTO_TCP, TCP_NODELAY), 0);
+        }
+
+        void testConnect()
+        {
+            cxxtools::net::TcpServer server("127.0.0.1", testPort);
+
+            cxxtools::net::SocketOptions options;
+            options.noDelay(true);
+
+            cxxtools::net::SocketOptions defaults = cxxtools::net::TcpSocket::defaultSocketOptions();
+            cxxtools::net::TcpSocket::defaultSocketOptions(options);
+
+            cxxtools::net::TcpSocket client;
+            cxxtools::net::TcpSocket::defaultSocketOptions(defaults);
+
+            client.connect("127.0.0.1", testPort);
+            cxxtools::net::TcpSocket accepted(server);
+
+            CXXTOOLS_UNIT_ASSERT(getOption(client.getFd(), IPPROTO_TCP, TCP_NODELAY) != 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(getOption(accepted.getFd(), IPPROTO_TCP, TCP_NODELAY), 0);
+
+            options.noDelay(false);
+            client.socketOptions(options);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(getOption(client.getFd(), IPPROTO_TCP, TCP_NODELAY), 0);
+        }
+};
+
+cxxtools::unit::RegisterTest<SocketOptionsTest> register_SocketOptionsTest;
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2016 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/streambuffer.h"
+#include "cxxtools/pipe.h"
+#include <string>
+#include <ostream>
+#include <sstream>
+
+class StreamBufferTest : public cxxtools::unit::TestSuite
+{
+        static std::string readAll(cxxtools::Pipe& pipe, size_t size)
+        {
+            std::string ret;
+            char buffer[256];
+            while (ret.size() < size)
+            {
+                size_t n = pipe.read(buffer, sizeof(buffer));
+                ret.append(buffer, n);
+            }
+            return ret;
+        }
+
+    public:
+        StreamBufferTest()
+            : cxxtools::unit::TestSuite("streambuffer")
+        {
+            registerMethod("writev", *this, &StreamBufferTest::writev);
+            registerMethod("readv", *this, &StreamBufferTest::readv);
+            registerMethod("borrow", *this, &StreamBufferTest::borrow);
+            registerMethod("segmented", *this, &StreamBufferTest::segmented);
+        }
+
+        void writev()
+        {
+            cxxtools::Pipe pipe;
+
+            struct iovec iov[3];
+            iov[0].iov_base = const_cast<char*>("Hello");
+            iov[0].iov_len = 5;
+            iov[1].iov_base = 0;
+            iov[1].iov_len = 0;
+            iov[2].iov_base = const_cast<char*>(" World");
+            iov[2].iov_len = 6;
+
+            size_t n = pipe.in().writev(iov, 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(n, 11);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readAll(pipe, 11), "Hello World");
+        }
+
+        void readv()
+        {
+            cxxtools::Pipe pipe;
+            pipe.write("Hello World", 11);
+
+            char b1[6];
+            char b2[16];
+            struct iovec iov[2];
+            iov[0].iov_base = b1;
+            iov[0].iov_len = sizeof(b1);
+            iov[1].iov_base = b2;
+            iov[1].iov_len = sizeof(b2);
+
+            size_t n = pipe.out().readv(iov, 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(n, 11);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(b1, 6), "Hello ");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(b2, 5), "World");
+        }
+
+        void borrow()
+        {
+            cxxtools::Pipe pipe;
+            cxxtools::StreamBuffer sb(pipe.in(), 16);
+            std::ostream out(&sb);
+
+            std::string body(1000, 'x');
+
+            out << "header\n";
+            sb.borrow(body.data(), body.size());
+            out << "\ntrailer";
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(sb.pendingOutput(), 1015);
+
+            out.flush();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(sb.pendingOutput(), 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readAll(pipe, 1015), "header\n" + body + "\ntrailer");
+        }
+
+        void segmented()
+        {
+            cxxtools::Pipe pipe;
+            cxxtools::StreamBuffer sb(pipe.in(), 16);
+            sb.segmented(true);
+            std::ostream out(&sb);
+
+            std::ostringstream expected;
+            for (unsigned n = 0; n < 100; ++n)
+            {
+                out << "line " << n << '\n';
+                expected << "line " << n << '\n';
+            }
+
+            // the data is queued until the stream is flushed
+            CXXTOOLS_UNIT_ASSERT_EQUALS(static_cast<size_t>(sb.pendingOutput()), expected.str().size());
+
+            out.flush();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(sb.pendingOutput(), 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readAll(pipe, expected.str().size()), expected.str());
+        }
+};
+
+cxxtools::unit::RegisterTest<StreamBufferTest> register_StreamBufferTest;
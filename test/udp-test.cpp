@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2016 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/net/udp.h"
+#include "cxxtools/net/udpstream.h"
+#include "cxxtools/ioerror.h"
+#include <string>
+#include <string.h>
+#include <vector>
+
+class UdpTest : public cxxtools::unit::TestSuite
+{
+    unsigned short _port;
+
+    // receives until count datagrams are read
+    std::vector<std::string> recvAll(cxxtools::net::UdpReceiver& receiver, unsigned count)
+    {
+      std::vector<std::string> ret;
+      char buffer[8][256];
+      cxxtools::net::UdpMessage messages[8];
+
+      while (ret.size() < count)
+      {
+        for (unsigned n = 0; n < 8; ++n)
+          messages[n] = cxxtools::net::UdpMessage(buffer[n], sizeof(buffer[n]));
+
+        unsigned c = receiver.recv(messages, 8);
+        for (unsigned n = 0; n < c; ++n)
+          ret.push_back(std::string(static_cast<char*>(messages[n].data), messages[n].size));
+      }
+
+      return ret;
+    }
+
+  public:
+    UdpTest()
+      : cxxtools::unit::TestSuite("udp"),
+        _port(7010)
+    {
+      registerMethod("batchSendRecv", *this, &UdpTest::batchSendRecv);
+      registerMethod("batchAddress", *this, &UdpTest::batchAddress);
+      registerMethod("batchReply", *this, &UdpTest::batchReply);
+      registerMethod("streamBatch", *this, &UdpTest::streamBatch);
+    }
+
+    void batchSendRecv()
+    {
+      cxxtools::net::UdpReceiver receiver("127.0.0.1", _port);
+      receiver.setTimeout(2000);
+
+      cxxtools::net::UdpSender sender("127.0.0.1", _port);
+
+      const char* data[] = { "Hello", "", "World" };
+      cxxtools::net::UdpMessage messages[3];
+      for (unsigned n = 0; n < 3; ++n)
+        messages[n] = cxxtools::net::UdpMessage(data[n], strlen(data[n]));
+
+      CXXTOOLS_UNIT_ASSERT_EQUALS(sender.send(messages, 3), 3);
+
+      std::vector<std::string> result = recvAll(receiver, 3);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(result.size(), 3);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(result[0], "Hello");
+      CXXTOOLS_UNIT_ASSERT_EQUALS(result[1], "");
+      CXXTOOLS_UNIT_ASSERT_EQUALS(result[2], "World");
+    }
+
+    void batchAddress()
+    {
+      cxxtools::net::UdpReceiver receiver1("127.0.0.1", _port);
+      cxxtools::net::UdpReceiver receiver2("127.0.0.1", _port + 1);
+      receiver1.setTimeout(2000);
+      receiver2.setTimeout(2000);
+
+      cxxtools::net::UdpSender sender("127.0.0.1", _port);
+
+      cxxtools::net::UdpMessage messages[3];
+      messages[0] = cxxtools::net::UdpMessage("one", 3);
+      messages[1] = cxxtools::net::UdpMessage("two", 3);
+      messages[1].setAddress("127.0.0.1", _port + 1);
+      messages[2] = cxxtools::net::UdpMessage("three", 5);
+
+      CXXTOOLS_UNIT_ASSERT_EQUALS(sender.send(messages, 3), 3);
+
+      std::vector<std::string> result1 = recvAll(receiver1, 2);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(result1.size(), 2);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(result1[0], "one");
+      CXXTOOLS_UNIT_ASSERT_EQUALS(result1[1], "three");
+
+      std::vector<std::string> result2 = recvAll(receiver2, 1);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(result2.size(), 1);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(result2[0], "two");
+    }
+
+    void batchReply()
+    {
+      cxxtools::net::UdpReceiver receiver("127.0.0.1", _port);
+      receiver.setTimeout(2000);
+
+      cxxtools::net::UdpSender sender("127.0.0.1", _port);
+      sender.setTimeout(2000);
+      sender.send("ping");
+
+      char buffer[16];
+      cxxtools::net::UdpMessage message(buffer, sizeof(buffer));
+      CXXTOOLS_UNIT_ASSERT_EQUALS(receiver.recv(&message, 1), 1);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(message.getAddress(), "127.0.0.1");
+
+      cxxtools::net::UdpMessage replies[2];
+      replies[0] = cxxtools::net::UdpMessage("pong1", 5);
+      replies[1] = cxxtools::net::UdpMessage("pong2", 5);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(receiver.send(replies, 2), 2);
+
+      CXXTOOLS_UNIT_ASSERT_EQUALS(sender.recv(16), "pong1");
+      CXXTOOLS_UNIT_ASSERT_EQUALS(sender.recv(16), "pong2");
+    }
+
+    void streamBatch()
+    {
+      cxxtools::net::UdpReceiver receiver("127.0.0.1", _port);
+      receiver.setTimeout(0);
+
+      cxxtools::net::UdpSender sender("127.0.0.1", _port);
+      cxxtools::net::UdpOStream out(sender, 0, 3);
+
+      out << "Hello" << std::flush;
+      out << "World" << std::flush;
+
+      CXXTOOLS_UNIT_ASSERT_THROW(receiver.recv(16), cxxtools::IOTimeout);
+
+      out << '!';
+      out.flushBatch();
+
+      receiver.setTimeout(2000);
+      std::vector<std::string> result = recvAll(receiver, 3);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(result.size(), 3);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(result[0], "Hello");
+      CXXTOOLS_UNIT_ASSERT_EQUALS(result[1], "World");
+      CXXTOOLS_UNIT_ASSERT_EQUALS(result[2], "!");
+    }
+};
+
+cxxtools::unit::RegisterTest<UdpTest> register_UdpTest;
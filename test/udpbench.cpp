@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2016 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+   Loopback benchmark for udp datagrams.
+
+   A receiver thread counts the datagrams sent by the main thread. Each run
+   sends the datagrams once with a system call per datagram and once using
+   the batch functions of UdpSender and UdpReceiver.
+ */
+
+#include <cxxtools/net/udp.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/thread.h>
+#include <cxxtools/ioerror.h>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+  class Receiver
+  {
+      cxxtools::net::UdpReceiver _receiver;
+      cxxtools::AttachedThread _thread;
+      unsigned _batch;
+      unsigned _size;
+      unsigned long _count;
+      cxxtools::Clock _clock;
+      cxxtools::Timespan _time;
+
+    public:
+      Receiver(const std::string& ip, unsigned short port, unsigned batch, unsigned size)
+        : _receiver(ip, port),
+          _thread(cxxtools::callable(*this, &Receiver::run)),
+          _batch(batch),
+          _size(size),
+          _count(0)
+      {
+        _receiver.setTimeout(500);
+      }
+
+      void start()
+      { _thread.start(); }
+
+      void join()
+      { _thread.join(); }
+
+      unsigned long count() const
+      { return _count; }
+
+      cxxtools::Timespan time() const
+      { return _time; }
+
+      void run();
+  };
+
+  void Receiver::run()
+  {
+    std::vector<char> buffer(_batch * _size);
+    std::vector<cxxtools::net::UdpMessage> messages(_batch);
+
+    try
+    {
+      bool first = true;
+      while (true)
+      {
+        unsigned n;
+        if (_batch <= 1)
+        {
+          _receiver.recv(&buffer[0], _size);
+          n = 1;
+        }
+        else
+        {
+          for (unsigned i = 0; i < _batch; ++i)
+            messages[i] = cxxtools::net::UdpMessage(&buffer[i * _size], _size);
+          n = _receiver.recv(&messages[0], _batch);
+        }
+
+        if (first)
+        {
+          _clock.start();
+          first = false;
+        }
+
+        _count += n;
+        _time = _clock.stop();
+      }
+    }
+    catch (const cxxtools::IOTimeout&)
+    {
+    }
+  }
+
+  void runBench(const std::string& ip, unsigned short port, unsigned long count,
+                unsigned size, unsigned batch)
+  {
+    Receiver receiver(ip, port, batch, size);
+    receiver.start();
+
+    cxxtools::net::UdpSender sender(ip, port);
+
+    std::vector<char> data(size, 'X');
+    std::vector<cxxtools::net::UdpMessage> messages(batch,
+        cxxtools::net::UdpMessage(&data[0], size));
+
+    cxxtools::Clock clock;
+    clock.start();
+
+    if (batch <= 1)
+    {
+      for (unsigned long n = 0; n < count; ++n)
+        sender.send(&data[0], size);
+    }
+    else
+    {
+      for (unsigned long n = 0; n < count; n += batch)
+        sender.send(&messages[0], count - n < batch ? count - n : batch);
+    }
+
+    cxxtools::Timespan ts = clock.stop();
+
+    receiver.join();
+
+    std::cout << "batch " << batch
+              << "\tsent " << count << " in " << ts.totalMSecs() << " ms: "
+              << static_cast<unsigned long>(count / ts.totalSeconds()) << " packets/s"
+              << "\treceived " << receiver.count() << ": "
+              << static_cast<unsigned long>(receiver.count() / receiver.time().totalSeconds()) << " packets/s"
+              << std::endl;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    cxxtools::Arg<std::string> ip(argc, argv, 'i', "127.0.0.1");
+    cxxtools::Arg<unsigned short> port(argc, argv, 'p', 7011);
+    cxxtools::Arg<unsigned long> count(argc, argv, 'n', 1000000);
+    cxxtools::Arg<unsigned> size(argc, argv, 's', 64);
+    cxxtools::Arg<unsigned> batch(argc, argv, 'b', 64);
+
+    if (argc > 1)
+    {
+      std::cerr << "usage: " << argv[0] << " [options]\n"
+                   "options:\n"
+                   "  -i <ip>       ip address (default 127.0.0.1)\n"
+                   "  -p <port>     udp port (default 7011)\n"
+                   "  -n <count>    number of datagrams (default 1000000)\n"
+                   "  -s <size>     size of datagrams (default 64)\n"
+                   "  -b <batch>    datagrams per system call (default 64)\n";
+      return -1;
+    }
+
+    runBench(ip, port, count, size, 1);
+    runBench(ip, port, count, size, batch);
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return -1;
+  }
+}
@@ -31,6 +31,8 @@
 #include "cxxtools/unit/testsuite.h"
 #include "cxxtools/unit/registertest.h"
 #include "cxxtools/string.h"
+#include "cxxtools/conversionerror.h"
+#include <algorithm>
 
 class Utf8Test : public cxxtools::unit::TestSuite
 {
@@ -44,6 +46,11 @@ class Utf8Test : public cxxtools::unit::TestSuite
       registerMethod("byteordermark", *this, &Utf8Test::byteordermarkTest);
       registerMethod("incompleteBom", *this, &Utf8Test::incompleteBomTest);
       registerMethod("partialBom", *this, &Utf8Test::partialBomTest);
+      registerMethod("decodeLong", *this, &Utf8Test::decodeLongTest);
+      registerMethod("decodeChunked", *this, &Utf8Test::decodeChunkedTest);
+      registerMethod("decodeInvalid", *this, &Utf8Test::decodeInvalidTest);
+      registerMethod("encodeLong", *this, &Utf8Test::encodeLongTest);
+      registerMethod("widenNarrow", *this, &Utf8Test::widenNarrowTest);
     }
 
     void encodeTest()
@@ -107,6 +114,112 @@ class Utf8Test : public cxxtools::unit::TestSuite
       CXXTOOLS_UNIT_ASSERT_EQUALS(to[0].narrow(), 'A');   // now output
     }
 
+    void decodeLongTest()
+    {
+      // long ascii runs are converted in blocks
+      std::string bstr;
+      cxxtools::String expected;
+      for (unsigned n = 0; n < 100; ++n)
+      {
+        bstr.append(n, 'a' + n % 26);
+        expected.append(n, cxxtools::Char('a' + n % 26));
+        bstr += "\xc3\xa4\xe6\x97\xa5\xf0\x9f\x98\x80";
+        expected += cxxtools::Char(0xe4);
+        expected += cxxtools::Char(0x65e5);
+        expected += cxxtools::Char(0x1f600);
+      }
+
+      cxxtools::String ustr = cxxtools::Utf8Codec::decode(bstr);
+      CXXTOOLS_UNIT_ASSERT(ustr == expected);
+    }
+
+    void decodeChunkedTest()
+    {
+      std::string bstr;
+      for (unsigned n = 0; n < 20; ++n)
+        bstr += "0123456789abcdef\xc3\xa4\xe6\x97\xa5\xf0\x9f\x98\x80";
+      cxxtools::String expected = cxxtools::Utf8Codec::decode(bstr);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(expected.size(), 20u * 19u);
+
+      // feed the codec with chunks of every size, so that sequences are split
+      for (unsigned chunk = 1; chunk < 24; ++chunk)
+      {
+        cxxtools::Utf8Codec codec;
+        cxxtools::MBState state;
+        cxxtools::String ustr;
+        const char* p = bstr.data();
+        const char* end = p + bstr.size();
+        while (p < end)
+        {
+          const char* chunkEnd = p + std::min<std::size_t>(chunk, end - p);
+          cxxtools::Char to[7];
+          const char* fromNext;
+          cxxtools::Char* toNext;
+          cxxtools::Utf8Codec::result r = codec.in(state, p, chunkEnd, fromNext, to, to + 7, toNext);
+          CXXTOOLS_UNIT_ASSERT(r != cxxtools::Utf8Codec::error);
+          CXXTOOLS_UNIT_ASSERT(fromNext > p || toNext > to);
+          ustr.append(to, toNext - to);
+          p = fromNext;
+        }
+
+        CXXTOOLS_UNIT_ASSERT(ustr == expected);
+      }
+    }
+
+    void decodeInvalidTest()
+    {
+      std::string prefix(40, 'a');
+      CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::Utf8Codec::decode(prefix + "\xc3("), cxxtools::ConversionError);
+      CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::Utf8Codec::decode(prefix + "\xc0\xaf"), cxxtools::ConversionError);
+      CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::Utf8Codec::decode(prefix + "\xe0\x80\xaf"), cxxtools::ConversionError);
+      CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::Utf8Codec::decode(prefix + "\xed\xa0\x80"), cxxtools::ConversionError);
+      CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::Utf8Codec::decode(prefix + "\xf4\x90\x80\x80"), cxxtools::ConversionError);
+      CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::Utf8Codec::decode(prefix + "\x80" + prefix), cxxtools::ConversionError);
+      CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::Utf8Codec::decode(prefix + "\xf8\x88\x80\x80\x80"), cxxtools::ConversionError);
+    }
+
+    void encodeLongTest()
+    {
+      cxxtools::String ustr;
+      std::string expected;
+      for (unsigned n = 0; n < 100; ++n)
+      {
+        ustr.append(n, cxxtools::Char('A' + n % 26));
+        expected.append(n, 'A' + n % 26);
+        ustr += cxxtools::Char(0xe4);
+        ustr += cxxtools::Char(0x65e5);
+        expected += "\xc3\xa4\xe6\x97\xa5";
+      }
+
+      std::string bstr = cxxtools::Utf8Codec::encode(ustr);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(bstr, expected);
+
+      ustr += cxxtools::Char(0xd800);
+      CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::Utf8Codec::encode(ustr), cxxtools::ConversionError);
+    }
+
+    void widenNarrowTest()
+    {
+      std::string str;
+      for (unsigned n = 0; n < 200; ++n)
+        str += static_cast<char>(n * 7);
+
+      cxxtools::String ustr = cxxtools::String::widen(str);
+      CXXTOOLS_UNIT_ASSERT_EQUALS(ustr.size(), str.size());
+      for (unsigned n = 0; n < str.size(); ++n)
+        CXXTOOLS_UNIT_ASSERT(ustr[n] == cxxtools::Char(str[n]));
+
+      CXXTOOLS_UNIT_ASSERT_EQUALS(ustr.narrow(), str);
+
+      ustr[50] = cxxtools::Char(0x65e5);
+      ustr[150] = cxxtools::Char(0x100);
+      std::string nstr = ustr.narrow('?');
+      CXXTOOLS_UNIT_ASSERT_EQUALS(nstr.size(), str.size());
+      CXXTOOLS_UNIT_ASSERT_EQUALS(nstr[50], '?');
+      CXXTOOLS_UNIT_ASSERT_EQUALS(nstr[150], '?');
+      CXXTOOLS_UNIT_ASSERT_EQUALS(nstr.substr(51, 99), str.substr(51, 99));
+    }
+
 };
 
 cxxtools::unit::RegisterTest<Utf8Test> register_Utf8Test;
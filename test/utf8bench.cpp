@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2016 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+   Benchmark for utf-8 decoding and encoding.
+
+   Text corpora with only ascii characters, with latin characters mixed into
+   ascii and with cjk characters are decoded with Utf8Codec::decode and
+   encoded again with Utf8Codec::encode. String::widen and String::narrow
+   are measured on the ascii corpus.
+ */
+
+#include <cxxtools/utf8codec.h>
+#include <cxxtools/string.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <iostream>
+#include <string>
+
+namespace
+{
+  std::string repeat(const char* text, std::size_t size)
+  {
+    std::string ret;
+    ret.reserve(size + 256);
+    while (ret.size() < size)
+      ret += text;
+    return ret;
+  }
+
+  void report(const char* what, cxxtools::Timespan t, unsigned long iterations, std::size_t bytes)
+  {
+    double mb = static_cast<double>(bytes) * iterations / 1024 / 1024;
+    std::cout << '\t' << what << ": " << t
+              << " (" << static_cast<unsigned long>(mb / t.totalSeconds()) << " MB/s)" << std::endl;
+  }
+
+  void runBench(const char* title, const std::string& utf8, unsigned long iterations)
+  {
+    std::cout << title << " (" << utf8.size() << " bytes)" << std::endl;
+
+    cxxtools::Clock clock;
+    cxxtools::String str;
+
+    clock.start();
+    for (unsigned long n = 0; n < iterations; ++n)
+      str = cxxtools::Utf8Codec::decode(utf8);
+    report("decode", clock.stop(), iterations, utf8.size());
+
+    std::string encoded;
+    clock.start();
+    for (unsigned long n = 0; n < iterations; ++n)
+      encoded = cxxtools::Utf8Codec::encode(str);
+    report("encode", clock.stop(), iterations, utf8.size());
+
+    if (encoded != utf8)
+      std::cout << "\tencoded data differs from input" << std::endl;
+  }
+
+  void runWidenNarrow(const std::string& ascii, unsigned long iterations)
+  {
+    std::cout << "widen/narrow (" << ascii.size() << " bytes)" << std::endl;
+
+    cxxtools::Clock clock;
+    cxxtools::String str;
+
+    clock.start();
+    for (unsigned long n = 0; n < iterations; ++n)
+      str = cxxtools::String::widen(ascii);
+    report("String::widen", clock.stop(), iterations, ascii.size());
+
+    std::string narrowed;
+    clock.start();
+    for (unsigned long n = 0; n < iterations; ++n)
+      narrowed = str.narrow();
+    report("String::narrow", clock.stop(), iterations, ascii.size());
+
+    if (narrowed != ascii)
+      std::cout << "\tnarrowed data differs from input" << std::endl;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    cxxtools::Arg<std::size_t> size(argc, argv, 's', 1024 * 1024);
+    cxxtools::Arg<unsigned long> iterations(argc, argv, 'n', 100);
+
+    if (argc > 1)
+    {
+      std::cerr << "usage: " << argv[0] << " [options]\n"
+                   "options:\n"
+                   "  -s <size>     size of the corpora in bytes (default 1048576)\n"
+                   "  -n <count>    number of iterations (default 100)\n";
+      return -1;
+    }
+
+    std::string ascii = repeat(
+      "The quick brown fox jumps over the lazy dog. "
+      "Pack my box with five dozen liquor jugs.\n", size);
+
+    std::string latin = repeat(
+      "Franz jagt im komplett verwahrlosten Taxi quer durch Bayern. "
+      "Zw\xc3\xb6lf Boxk\xc3\xa4mpfer jagen Viktor quer \xc3\xbc" "ber den gro\xc3\x9f" "en Sylter Deich. "
+      "Portez ce vieux whisky au juge blond qui fume \xc3\xa0 c\xc3\xb4t\xc3\xa9 du caf\xc3\xa9.\n", size);
+
+    std::string cjk = repeat(
+      "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e\xe3\x81\xae\xe6\x96\x87\xe7\xab\xa0\xe3\x81\xa7\xe3\x81\x99\xe3\x80\x82"
+      "\xe4\xb8\xad\xe6\x96\x87\xe7\x9a\x84\xe6\x96\x87\xe6\x9c\xac\xe3\x80\x82"
+      "\xed\x95\x9c\xea\xb5\xad\xec\x96\xb4 \xeb\xac\xb8\xec\x9e\xa5\xec\x9e\x85\xeb\x8b\x88\xeb\x8b\xa4.\n", size);
+
+    runBench("ascii", ascii, iterations);
+    runBench("latin", latin, iterations);
+    runBench("cjk", cjk, iterations);
+    runWidenNarrow(ascii, iterations);
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return -1;
+  }
+}
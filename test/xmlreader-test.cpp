@@ -30,6 +30,7 @@
 #include "cxxtools/xml/xmlreader.h"
 #include "cxxtools/xml/startelement.h"
 #include "cxxtools/xml/entityresolver.h"
+#include "cxxtools/stringstream.h"
 #include "cxxtools/unit/testsuite.h"
 #include "cxxtools/unit/registertest.h"
 
@@ -47,6 +48,7 @@ class XmlReaderTest : public cxxtools::unit::TestSuite
             registerMethod("XmlEntity", *this, &XmlReaderTest::XmlEntity);
             registerMethod("ReverseEntity", *this, &XmlReaderTest::ReverseEntity);
             registerMethod("AllEntities", *this, &XmlReaderTest::AllEntities);
+            registerMethod("BulkEntities", *this, &XmlReaderTest::BulkEntities);
         }
 
         void setUp()
@@ -216,6 +218,24 @@ class XmlReaderTest : public cxxtools::unit::TestSuite
             }
         }
 
+        void BulkEntities()
+        {
+            cxxtools::xml::EntityResolver resolver;
+
+            cxxtools::String s(L"plain text <tag attr=\"v\"> & 'x'\n\u00e4\u20ac end");
+
+            cxxtools::String expected;
+            for (cxxtools::String::const_iterator it = s.begin(); it != s.end(); ++it)
+                expected += resolver.getEntity(*it);
+
+            cxxtools::OStringStream out;
+            resolver.getEntities(out, s);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out.str().narrow(), expected.narrow());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out.str().narrow(),
+                "plain text &lt;tag attr=&quot;v&quot;&gt; &amp; &apos;x&apos;&#10;&#228;&#8364; end");
+        }
+
 };
 
 cxxtools::unit::RegisterTest<XmlReaderTest> register_XmlReaderTest;
@@ -0,0 +1,131 @@
+#!/usr/bin/perl -w
+
+=head1 NAME
+
+entityhash.pl
+
+=head1 SYNOPSIS
+
+entityhash.pl src/xml/entityresolver.cpp
+
+=head1 DESCRIPTION
+
+Generates the perfect hash table of named entities used by
+cxxtools::xml::EntityResolver.
+
+The input is scanned for entity definitions in the form
+
+    { L"name", 0x00C6 },
+
+so the table in src/xml/entityresolver.cpp can be fed back after adding
+entities. Duplicate names are ignored.
+
+The hash function is FNV-1a over the unicode values of the entity name. Keys
+are distributed into buckets using seed 0. For each bucket a displacement is
+searched, so that all keys of the bucket hash to distinct free slots using the
+displacement as seed. Buckets with just one key get a free slot assigned
+directly, which is marked by a negative displacement.
+
+The generated code is printed to stdout and must match entityHash() in
+src/xml/entityresolver.cpp.
+
+=head1 AUTHOR
+
+Tommi ME<auml>kitalo, Tntnet.org
+
+=cut
+
+use strict;
+
+my %entities;
+my @names;
+
+while (<>)
+{
+  while (/\{\s*L"(\w+)",\s*(0x[0-9A-Fa-f]+)\s*\}/g)
+  {
+    next if exists $entities{$1};
+    $entities{$1} = $2;
+    push @names, $1;
+  }
+}
+
+die "no entities found in input\n" unless @names;
+
+sub entityHash {
+  my ($d, $key) = @_;
+  $d = 0x811c9dc5 if $d == 0;
+  foreach my $c (unpack('C*', $key))
+  {
+    $d = (($d ^ $c) * 0x01000193) & 0xffffffff;
+  }
+  return $d;
+}
+
+my $size = @names;
+
+my @buckets = map { [] } (1..$size);
+foreach my $name (@names)
+{
+  push @{$buckets[entityHash(0, $name) % $size]}, $name;
+}
+
+my @G = (0) x $size;
+my @values = (undef) x $size;
+
+my @order = sort { @{$buckets[$b]} <=> @{$buckets[$a]} } (0..$size-1);
+
+my $b;
+while (@order && @{$buckets[$order[0]]} > 1)
+{
+  $b = shift @order;
+  my @bucket = @{$buckets[$b]};
+
+  my $d = 1;
+  my @slots;
+  ITEM: while (1)
+  {
+    my %used;
+    @slots = ();
+    foreach my $name (@bucket)
+    {
+      my $slot = entityHash($d, $name) % $size;
+      if (defined($values[$slot]) || $used{$slot})
+      {
+        ++$d;
+        next ITEM;
+      }
+      $used{$slot} = 1;
+      push @slots, $slot;
+    }
+    last;
+  }
+
+  $G[$b] = $d;
+  for (my $i = 0; $i < @bucket; ++$i)
+  {
+    $values[$slots[$i]] = $bucket[$i];
+  }
+}
+
+my @free = grep { !defined($values[$_]) } (0..$size-1);
+while (@order && @{$buckets[$order[0]]} == 1)
+{
+  $b = shift @order;
+  my $slot = shift @free;
+  $G[$b] = -$slot - 1;
+  $values[$slot] = $buckets[$b]->[0];
+}
+
+print "  // generated by utils/entityhash.pl - do not edit\n";
+print "  static const Ent ent[] = {\n";
+print join(",\n", map { sprintf("    { L\"%s\", %s }", $_, $entities{$_}) } @values), "\n";
+print "  };\n\n";
+
+print "  static const int entDisplacement[] = {\n";
+for (my $i = 0; $i < $size; $i += 10)
+{
+  my $e = $i + 9 < $size - 1 ? $i + 9 : $size - 1;
+  print "    ", join(", ", @G[$i..$e]), ($e < $size - 1 ? ",\n" : "\n");
+}
+print "  };\n";
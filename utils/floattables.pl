@@ -0,0 +1,123 @@
+#!/usr/bin/perl -w
+
+=head1 NAME
+
+floattables.pl
+
+=head1 SYNOPSIS
+
+floattables.pl > src/floattables.h
+
+=head1 DESCRIPTION
+
+Generates the tables of powers of 5 used by the shortest float formatter and
+the float parser in src/floatconv.cpp.
+
+The formatter follows the algorithm of Ulf Adams (Ryu, PLDI 2018). It needs
+the normalized powers of 5 and the rounded up reciprocals of them for double
+with 125 bit precision and for float with 61 and 59 bit precision.
+
+The parser follows the algorithm of Daniel Lemire and Michael Eisel (Number
+Parsing at a Gigabyte per Second, 2021). It needs the most significant 128
+bits of the powers of 5 from 5^-342 to 5^308.
+
+128 bit values are written as pairs of 64 bit values with the low part first.
+
+=head1 AUTHOR
+
+Tommi ME<auml>kitalo, Tntnet.org
+
+=cut
+
+use strict;
+use Math::BigInt;
+
+my $two64 = Math::BigInt->new(1)->blsft(64);
+
+sub hex64
+{
+  my $v = shift;
+  my $h = substr($v->as_hex(), 2);
+  return '0x' . ('0' x (16 - length($h))) . $h . 'ull';
+}
+
+sub split128
+{
+  my $v = shift;
+  my ($high, $low) = $v->copy()->bdiv($two64);
+  return '{ ' . hex64($low) . ', ' . hex64($high) . ' }';
+}
+
+# number of bits of 5^e
+sub pow5bits
+{
+  my $e = shift;
+  return length(Math::BigInt->new(5)->bpow($e)->as_bin()) - 2;
+}
+
+sub pow5
+{
+  return Math::BigInt->new(5)->bpow(shift);
+}
+
+# 5^i normalized to the given number of bits
+sub pow5Split
+{
+  my ($i, $bits) = @_;
+  my $p = pow5($i);
+  my $shift = pow5bits($i) - $bits;
+  return $shift >= 0 ? $p->brsft($shift) : $p->blsft(-$shift);
+}
+
+# 2^(pow5bits(i) - 1 + bits) / 5^i rounded up
+sub pow5InvSplit
+{
+  my ($i, $bits) = @_;
+  my $p = Math::BigInt->new(1)->blsft(pow5bits($i) - 1 + $bits);
+  return $p->bdiv(pow5($i))->binc();
+}
+
+sub printTable
+{
+  my ($decl, @values) = @_;
+  print "    $decl = {\n";
+  print join(",\n", map { "        $_" } @values), "\n";
+  print "    };\n\n";
+}
+
+print "// generated by utils/floattables.pl - do not edit\n\n";
+
+printTable('const uint64_t doublePow5InvSplit[342][2]',
+  map { split128(pow5InvSplit($_, 125)) } (0..341));
+
+printTable('const uint64_t doublePow5Split[326][2]',
+  map { split128(pow5Split($_, 125)) } (0..325));
+
+printTable('const uint64_t floatPow5InvSplit[32]',
+  map { hex64(pow5InvSplit($_, 59)) } (0..31));
+
+printTable('const uint64_t floatPow5Split[48]',
+  map { hex64(pow5Split($_, 61)) } (0..47));
+
+my $two127 = Math::BigInt->new(1)->blsft(127);
+my $two128 = Math::BigInt->new(1)->blsft(128);
+my @powers;
+
+for (my $q = -342; $q < 0; ++$q)
+{
+  my $p = pow5(-$q);
+  my $z = length($p->copy()->bdec()->as_bin()) - 2;
+  my $c = Math::BigInt->new(1)->blsft($q >= -27 ? $z + 127 : 2 * $z + 128)->bdiv($p)->binc();
+  $c->brsft(1) while $c >= $two128;
+  push @powers, split128($c);
+}
+
+for (my $q = 0; $q <= 308; ++$q)
+{
+  my $p = pow5($q);
+  $p->blsft(1) while $p < $two127;
+  $p->brsft(1) while $p >= $two128;
+  push @powers, split128($p);
+}
+
+printTable('const uint64_t pow5_128[651][2]', @powers);